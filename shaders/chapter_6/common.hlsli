@@ -0,0 +1,24 @@
+#ifndef CHAPTER_6_COMMON_HLSLI
+#define CHAPTER_6_COMMON_HLSLI
+
+// mirrored by PrimaryConstants in src/application/layer/chapter_6/generated/shader_layouts.h,
+// build the shader_layouts target after changing it
+cbuffer cbPrimary : register(b0)
+{
+    float4x4 u_WorldViewProjectMatrix;
+
+    float2 u_resolution;
+    float2 u_mouse;
+
+    float3 u_EyePosW;
+    float u_time;
+
+    float3 u_DirLightDirection;
+    float u_PointLightRange;
+    float3 u_DirLightColor;
+
+    float3 u_PointLightPosition;
+    float3 u_PointLightColor;
+};
+
+#endif
@@ -1,24 +1,4 @@
-cbuffer Primiary : register(b0)
-{
-    float u_time;
-    float3 padding;
-    float2 u_resolution;
-    float2 u_mouse;
-    float4x4 u_WorldViewProjectMatrix;
-
-    float3 u_EyePosW;
-    float padEye;
-
-    float3 u_DirLightDirection;
-    float padDir0;
-    float3 u_DirLightColor;
-    float padDir1;
-
-    float3 u_PointLightPosition;
-    float u_PointLightRange;
-    float3 u_PointLightColor;
-    float padPoint;
-};
+#include "common.hlsli"
 
 struct VertexInput
 {
@@ -0,0 +1,24 @@
+#ifndef CHAPTER_7_COMMON_HLSLI
+#define CHAPTER_7_COMMON_HLSLI
+
+// mirrored by PassConstants in src/application/layer/chapter_7/generated/shader_layouts.h,
+// build the shader_layouts target after changing it
+cbuffer cbPass : register(b1)
+{
+    float4x4 gView;
+    float4x4 gInvView;
+    float4x4 gProj;
+    float4x4 gInvProj;
+    float4x4 gViewProj;
+    float4x4 gInvViewProj;
+    float3 gEyePosW;
+    float gNearZ;
+    float2 gRenderTargetSize;
+    float2 gInvRenderTargetSize;
+    float2 gMousePosition;
+    float gFarZ;
+    float gTotalTime;
+    float gDeltaTime;
+};
+
+#endif
@@ -1,11 +1,4 @@
-cbuffer Primiary : register(b0)
-{
-    float  u_time;
-    float3 padding;
-    float2  u_resolution;
-    float2   u_mouse;
-    float4x4 u_WorldViewProjectMatrix;
-};
+#include "common.hlsli"
 
 struct PixelInput
 {
@@ -15,6 +8,6 @@ struct PixelInput
 
 float4 main(PixelInput input) : SV_Target
 {
-    float2 uv = (input.Position / u_resolution);
-    return input.Color * max(0.2, sin(u_time));
+    float2 uv = (input.Position.xy * gInvRenderTargetSize);
+    return input.Color * max(0.2, sin(gTotalTime));
 }
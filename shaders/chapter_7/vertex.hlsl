@@ -1,29 +1,24 @@
-cbuffer Primiary : register(b0)
+#include "common.hlsli"
+
+#if OBJECT_BUFFER
+struct ObjectData
 {
-    float    u_time;
-    float3   padding;
-    float2   u_resolution;
-    float2   u_mouse;
-    float4x4 u_World;
+    float4x4 World;
 };
 
-cbuffer cbPass : register(b1)
+//~ every object of the frame, tightly packed, indexed by the id set per draw
+StructuredBuffer<ObjectData> gObjects : register(t2);
+
+cbuffer cbPerObject : register(b0)
+{
+    uint gObjectId;
+};
+#else
+cbuffer cbPerObject : register(b0)
 {
-    float4x4 gView;
-    float4x4 gInvView;
-    float4x4 gProj;
-    float4x4 gInvProj;
-    float4x4 gViewProj;
-    float4x4 gInvViewProj;
-    float3 gEyePosW;
-    float cbPerObjectPad1;
-    float2 gRenderTargetSize;
-    float2 gInvRenderTargetSize;
-    float gNearZ;
-    float gFarZ;
-    float gTotalTime;
-    float gDeltaTime;
+    float4x4 World;
 };
+#endif
 
 struct VertexInput
 {
@@ -42,7 +37,12 @@ VertexOutput main(VertexInput input)
     VertexOutput output;
 	
     float3 pos = input.Position;
-    float4 posW = mul(float4(pos, 1.0f), u_World);
+#if OBJECT_BUFFER
+    float4x4 world = gObjects[gObjectId].World;
+#else
+    float4x4 world = World;
+#endif
+    float4 posW = mul(float4(pos, 1.0f), world);
     output.Position = mul(posW, gViewProj);
     output.Color = input.Color;
     
@@ -0,0 +1,23 @@
+#include "common.hlsli"
+
+// dynamic debug geometry is generated in world space, no object constants
+struct VertexInput
+{
+    float3 Position : POSITION;
+    float4 Color : COLOR;
+};
+
+struct VertexOutput
+{
+    float4 Position : SV_POSITION;
+    float4 Color    : COLOR;
+};
+
+VertexOutput main(VertexInput input)
+{
+    VertexOutput output;
+    output.Position = mul(float4(input.Position, 1.0f), gViewProj);
+    output.Color = input.Color;
+    
+    return output;
+}
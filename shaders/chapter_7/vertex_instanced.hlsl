@@ -0,0 +1,43 @@
+#include "common.hlsli"
+
+struct InstanceData
+{
+    float4x4 World;
+};
+
+//~ worlds of every instanced item, grouped by batch
+StructuredBuffer<InstanceData> gInstances : register(t0);
+
+//~ instance slots that survived culling, compacted per batch
+StructuredBuffer<uint> gVisibleInstances : register(t1);
+
+//~ first visible slot of the batch being drawn, SV_InstanceID restarts at 0 for every draw
+cbuffer cbInstance : register(b2)
+{
+    uint gInstanceBase;
+};
+
+struct VertexInput
+{
+    float3 Position : POSITION;
+    float4 Color : COLOR;
+};
+
+struct VertexOutput
+{
+    float4 Position : SV_POSITION;
+    float4 Color    : COLOR;
+};
+
+VertexOutput main(VertexInput input, uint instanceId : SV_InstanceID)
+{
+    VertexOutput output;
+	
+    float3 pos = input.Position;
+    float4x4 world = gInstances[gVisibleInstances[gInstanceBase + instanceId]].World;
+    float4 posW = mul(float4(pos, 1.0f), world);
+    output.Position = mul(posW, gViewProj);
+    output.Color = input.Color;
+    
+    return output;
+}
@@ -62,8 +62,8 @@ void InitDirectX::Draw(float deltaTime)
 	ID3D12CommandList* cmdLists[] = { m_pRender->m_pCommandList.Get() };
 	
 	m_pRender->m_pCommandQueue->ExecuteCommandLists(_countof(cmdLists), cmdLists);
-	THROW_DX_IF_FAILS(m_pRender->m_pSwapChain->Present(0u, 0u));
+	THROW_DX_IF_FAILS(m_pRender->m_pSwapChain->Present(m_pRender->GetPresentSyncInterval(), m_pRender->GetPresentFlags()));
 
-	m_pRender->m_nCurrentBackBuffer = (m_pRender->m_nCurrentBackBuffer + 1) % m_pRender->SWAP_CHAIN_BUFFER_COUNT;
+	m_pRender->m_nCurrentBackBuffer = (m_pRender->m_nCurrentBackBuffer + 1) % m_pRender->GetSwapChainBufferCount();
 	m_pRender->FlushCommandQueue();
 }
@@ -3,18 +3,20 @@
 #include "imgui_impl_win32.h"
 #include "framework/exception/dx_exception.h"
 #include "framework/windows_manager/windows_manager.h"
+#include "utility/logger/logger.h"
 
 #include "imgui.h"
 #include "imgui_impl_win32.h"
 #include "backends/imgui_impl_dx12.h"
 
+#include <cassert>
+
 Draw3DBox::Draw3DBox(framework::DxRenderManager* manager)
 	: IDrawLayer(manager)
 {
-	CreateImGuiDescriptorHeap();
+	BuildDescriptorHeaps();
 	InitImgui();
 
-	BuildDescriptorHeaps();
 	BuildConstantBuffers();
 	BuildRootSignature  ();
 	BuildShaders		();
@@ -22,15 +24,10 @@ Draw3DBox::Draw3DBox(framework::DxRenderManager* manager)
 
 	//~ Build and Copy Geometry
 	auto* render = m_pRender;
-	render->m_pCommandAlloc->Reset();
-	render->m_pCommandList->Reset(render->m_pCommandAlloc.Get(), nullptr);
-
 	BuildGeometry();
 
-	render->m_pCommandList->Close();
-	ID3D12CommandList* cmdLists[] = { render->m_pCommandList.Get() };
-	render->m_pCommandQueue->ExecuteCommandLists(1u, cmdLists);
 	render->FlushCommandQueue();
+	render->m_pUploadManager->Reclaim(); //~ the flush covered the copy queue wait, staging can go
 
 	BuildPSO();
 
@@ -55,8 +52,20 @@ Draw3DBox::Draw3DBox(framework::DxRenderManager* manager)
 	m_pointLight.Color = DirectX::XMFLOAT3(1.0f, 0.9f, 0.7f);
 }
 
+Draw3DBox::~Draw3DBox()
+{
+	m_pRender->FlushCommandQueue();
+	m_pRender->m_pDescriptorHeap->GetAllocator().FreePersistent(m_descriptors);
+
+	m_pRender->m_pUploadManager->ReleaseBuffer(m_pGeometry->VertexResource);
+	m_pRender->m_pUploadManager->ReleaseBuffer(m_pGeometry->IndexResource);
+}
+
 void Draw3DBox::Draw(float deltaTime)
 {
+	//~ the swap chain is waitable on the low latency profile, block before input is read
+	m_pRender->WaitForFrameLatency();
+
 	ImGui_ImplDX12_NewFrame();
 	ImGui_ImplWin32_NewFrame();
 	ImGui::NewFrame();
@@ -81,81 +90,70 @@ void Draw3DBox::Draw(float deltaTime)
 	Update(deltaTime);
 	UpdateCamera(deltaTime);
 
-	auto* render = m_pRender;
-	auto* cmd = render->m_pCommandList.Get();
+	auto* render	= m_pRender;
+	auto* cmd		= render->m_pCommandList.Get();
+	auto& recorder	= render->m_commandRecorder;
 
 	render->m_pCommandAlloc->Reset();
 	cmd->Reset(render->m_pCommandAlloc.Get(), m_pPipelineState.Get());
 
-	D3D12_RESOURCE_BARRIER barrier;
-	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-	barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
-	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
-	barrier.Transition.pResource = render->GetBackBuffer();
-	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-	cmd->ResourceBarrier(1u, &barrier);
+	using framework::EResourceState;
+	auto* backBuffer = render->GetBackBuffer();
+	framework::ResourceStateTracker barriers(render->m_resourceStates);
+	barriers.Transition(backBuffer, EResourceState::RenderTarget);
+	barriers.Flush(recorder);
 
-	cmd->RSSetScissorRects(1u, &render->m_scissorRect);
-	cmd->RSSetViewports(1u, &render->m_viewport);
+	const auto& vp = render->m_viewport;
+	const auto& sr = render->m_scissorRect;
+	recorder.SetScissorRect({ sr.left, sr.top, sr.right, sr.bottom });
+	recorder.SetViewport   ({ vp.TopLeftX, vp.TopLeftY, vp.Width, vp.Height, vp.MinDepth, vp.MaxDepth });
 
 	constexpr float color[ 4 ]
 	{
 		0.f, 0.f, 0.f, 1.f
 	};
 
-	auto handle = render->GetBackBufferHandle();
-	cmd->ClearRenderTargetView(handle, color, 0u, nullptr);
-
-	auto depthHandle = render->GetDepthStencilHandle();
-	cmd->ClearDepthStencilView(
-		depthHandle,
-		D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL,
-		1.0f,
-		0u,
-		0u,
-		nullptr
-	);
+	auto handle = framework::ToCpuHandle(render->GetBackBufferHandle());
+	recorder.ClearRenderTarget(handle, color);
 
-	cmd->OMSetRenderTargets(1u, &handle, TRUE, &depthHandle);
+	auto depthHandle = framework::ToCpuHandle(render->GetDepthStencilHandle());
+	recorder.ClearDepthStencil(depthHandle, 1.0f, 0u);
 
-	auto index = m_pGeometry->GetIndexViewDesc();
-	auto vertex = m_pGeometry->GetVertexViewDesc();
+	recorder.SetRenderTarget(handle, depthHandle);
 
-	cmd->IASetIndexBuffer(&index);
-	cmd->IASetVertexBuffers(0u, 1u, &vertex);
-	cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	recorder.SetIndexBuffer		 (framework::ToGpuView(m_pGeometry->GetIndexViewDesc()));
+	recorder.SetVertexBuffer	 (0u, framework::ToGpuView(m_pGeometry->GetVertexViewDesc()));
+	recorder.SetPrimitiveTopology(framework::EPrimitiveTopology::TriangleList);
 
-	ID3D12DescriptorHeap* cbvHeaps[]{ m_pCbvHeap.Get() };
-	cmd->SetDescriptorHeaps(1u, cbvHeaps);
-	cmd->SetGraphicsRootSignature(m_pRootSignature.Get());
-	cmd->SetGraphicsRootDescriptorTable(0u, m_pCbvHeap->GetGPUDescriptorHandleForHeapStart());
+	//~ one heap for the box and imgui, bound once
+	auto* heap = render->m_pDescriptorHeap.get();
+	recorder.SetDescriptorHeap		 (heap->GetHeap());
+	recorder.SetGraphicsRootSignature(m_pRootSignature.Get());
+	recorder.SetGraphicsRootDescriptorTable(0u, framework::ToGpuHandle(heap->GetGpuHandle(m_descriptors.Index)));
 
-	cmd->DrawIndexedInstanced(
+	recorder.DrawIndexedInstanced(
 		m_pGeometry->Meshes[ "box" ].IndexCount,
 		1u,
 		0u,
-		0u,
+		0,
 		0u
 	);
 
 	ImGui::Render();
 
-	ID3D12DescriptorHeap* imguiHeaps[]{ m_imguiSrvHeap.Get() };
-	cmd->SetDescriptorHeaps(1u, imguiHeaps);
+	//~ imgui's dx12 backend only takes the native list, its font SRV sits in the heap bound above
 	ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), cmd);
 
-	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
-	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
-
-	cmd->ResourceBarrier(1u, &barrier);
+	barriers.Transition(backBuffer, EResourceState::Present);
+	barriers.Flush(recorder);
+	barriers.Commit();
 	cmd->Close();
 
-	ID3D12CommandList* cmdLists[]{ cmd };
-	render->m_pCommandQueue->ExecuteCommandLists(1u, cmdLists);
+	framework::ICommandRecorder* recorders[]{ &recorder };
+	render->m_pRenderDevice->ExecuteCommandLists(recorders, 1u);
 
-	render->m_pSwapChain->Present(0u, 0u);
-	render->m_nCurrentBackBuffer = (render->m_nCurrentBackBuffer + 1u) % render->SWAP_CHAIN_BUFFER_COUNT;
+	render->m_pRenderDevice->Present(render->GetPresentSyncInterval(), render->GetPresentFlags());
+	render->m_nCurrentBackBuffer = (render->m_nCurrentBackBuffer + 1u) % render->GetSwapChainBufferCount();
 
 	render->FlushCommandQueue();
 }
@@ -164,14 +162,14 @@ void Draw3DBox::Update(float deltaTime, bool f)
 {
 	m_nTimeElapsed += deltaTime;
 
-	ConstantBufferDesc cb{};
+	PrimaryConstants cb{};
 
-	cb.TimeElapsed = m_nTimeElapsed;
-	cb.Resolution = DirectX::XMFLOAT2(
+	cb.u_time = m_nTimeElapsed;
+	cb.u_resolution = DirectX::XMFLOAT2(
 		static_cast<float>(m_pRender->m_pWindowsManager->GetWindowsWidth()),
 		static_cast<float>(m_pRender->m_pWindowsManager->GetWindowsHeight())
 	);
-	cb.Mouse = DirectX::XMFLOAT2(
+	cb.u_mouse = DirectX::XMFLOAT2(
 		static_cast<float>(m_lastMousePosition.x),
 		static_cast<float>(m_lastMousePosition.y)
 	);
@@ -187,22 +185,22 @@ void Draw3DBox::Update(float deltaTime, bool f)
 	XMMATRIX proj = XMLoadFloat4x4(&m_projMatrix);
 
 	XMMATRIX wvp = world * view * proj;
-	XMStoreFloat4x4(&cb.WorldViewProjectMatrix, XMMatrixTranspose(wvp));
+	XMStoreFloat4x4(&cb.u_WorldViewProjectMatrix, XMMatrixTranspose(wvp));
 
-	cb.EyePosW = m_eyePos;
+	cb.u_EyePosW = m_eyePos;
 
 	{
 		XMVECTOR dir = XMLoadFloat3(&m_dirLight.Direction);
 		dir = XMVector3Normalize(dir);
 
-		XMStoreFloat3(&cb.DirLight.Direction, dir);
-		cb.DirLight.Color = m_dirLight.Color;
+		XMStoreFloat3(&cb.u_DirLightDirection, dir);
+		cb.u_DirLightColor = m_dirLight.Color;
 	}
 
 	{
-		cb.PointLight.Position = m_pointLight.Position;
-		cb.PointLight.Range = m_pointLight.Range;
-		cb.PointLight.Color = m_pointLight.Color;
+		cb.u_PointLightPosition = m_pointLight.Position;
+		cb.u_PointLightRange = m_pointLight.Range;
+		cb.u_PointLightColor = m_pointLight.Color;
 	}
 	m_pCBResource->CopyData(0, cb);
 }
@@ -292,15 +290,15 @@ void Draw3DBox::InitImgui()
 	ImGui_ImplWin32_Init(m_pRender->m_pWindowsManager->GetWindowsHandle());
 
 	DXGI_FORMAT rtvFormat = m_pRender->m_backBufferFormat;
-	int         framesInFlight = m_pRender->SWAP_CHAIN_BUFFER_COUNT;
+	int         framesInFlight = framework::MAX_SWAP_CHAIN_BUFFER_COUNT; //~ any present profile
 
 	ImGui_ImplDX12_Init(
 		m_pRender->m_pDevice.Get(),
 		framesInFlight,
 		rtvFormat,
-		m_imguiSrvHeap.Get(),
-		m_imguiSrvHeap->GetCPUDescriptorHandleForHeapStart(),
-		m_imguiSrvHeap->GetGPUDescriptorHandleForHeapStart()
+		m_pRender->m_pDescriptorHeap->GetHeap(),
+		m_pRender->m_pDescriptorHeap->GetCpuHandle(m_descriptors.Index + 1u),
+		m_pRender->m_pDescriptorHeap->GetGpuHandle(m_descriptors.Index + 1u)
 	);
 
 	unsigned char* pixels = nullptr;
@@ -310,37 +308,20 @@ void Draw3DBox::InitImgui()
 	ImGui_ImplDX12_CreateDeviceObjects();
 }
 
-void Draw3DBox::CreateImGuiDescriptorHeap()
-{
-	D3D12_DESCRIPTOR_HEAP_DESC desc = {};
-	desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	desc.NumDescriptors = 1;
-	desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-	desc.NodeMask = 0;
-
-	THROW_DX_IF_FAILS(m_pRender->m_pDevice->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&m_imguiSrvHeap)));
-}
-
 void Draw3DBox::BuildDescriptorHeaps()
 {
-	D3D12_DESCRIPTOR_HEAP_DESC desc;
-	desc.Flags			= D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-	desc.Type			= D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	desc.NodeMask		= 0u;
-	desc.NumDescriptors = 1u;
-	
-	THROW_DX_IF_FAILS(m_pRender->m_pDevice->CreateDescriptorHeap(
-		&desc,
-		IID_PPV_ARGS(m_pCbvHeap.GetAddressOf())));
+	//~ [0] box CBV, [1] imgui font SRV, both in the global heap
+	m_descriptors = m_pRender->m_pDescriptorHeap->GetAllocator().AllocatePersistent(2u);
+	assert(m_descriptors.IsValid() && "Global descriptor heap is full!");
 }
 
 void Draw3DBox::BuildConstantBuffers()
 {
-	m_pCBResource = std::make_unique<framework::UploadBuffer<ConstantBufferDesc>>
-		(m_pRender->m_pDevice.Get(),
+	m_pCBResource = std::make_unique<framework::UploadBuffer<PrimaryConstants>>
+		(m_pRender->m_pGpuAllocator.get(),
 		 1u, framework::UploadBufferType::Constant);
 
-    constexpr UINT64		  size = (sizeof(ConstantBufferDesc) + 255u) & ~255u;
+    constexpr UINT64		  size = (sizeof(PrimaryConstants) + 255u) & ~255u;
 	D3D12_GPU_VIRTUAL_ADDRESS addr = m_pCBResource->GetResource()->GetGPUVirtualAddress();
 	UINT64 boxIndex				   = 0u;
 	
@@ -352,7 +333,7 @@ void Draw3DBox::BuildConstantBuffers()
 
 	m_pRender->m_pDevice->CreateConstantBufferView(
 		&desc,
-		m_pCbvHeap->GetCPUDescriptorHandleForHeapStart());
+		m_pRender->m_pDescriptorHeap->GetCpuHandle(m_descriptors.Index));
 }
 
 void Draw3DBox::BuildRootSignature()
@@ -395,20 +376,24 @@ void Draw3DBox::BuildRootSignature()
 	}
 
 	THROW_DX_IF_FAILS(hr);
-	THROW_DX_IF_FAILS(
-		m_pRender->m_pDevice->CreateRootSignature(
-			0u,                                    
-			serializedRootSig->GetBufferPointer(),
-			serializedRootSig->GetBufferSize(),
-			IID_PPV_ARGS(&m_pRootSignature)
-		)
-	);
+	m_pRootSignature = m_pRender->m_pPipelineCache->CreateRootSignature(serializedRootSig.Get());
 }
 
 void Draw3DBox::BuildShaders()
 {
-	m_pCompiledVS = framework::CompileShader(L"shaders/chapter_6/vertex.hlsl", nullptr, "main", "vs_5_0");
-	m_pCompiledPS = framework::CompileShader(L"shaders/chapter_6/pixel.hlsl",  nullptr, "main", "ps_5_0");
+	const auto flags = framework::DxShaderCompiler::GetDefaultFlags();
+	const auto shaders = m_pRender->m_pShaderCache->CompileAll({
+		{ "shaders/chapter_6/vertex.hlsl", "main", "vs_5_0", {}, flags },
+		{ "shaders/chapter_6/pixel.hlsl",  "main", "ps_5_0", {}, flags }
+	});
+
+	m_pCompiledVS = framework::ToShaderBlob(shaders[ 0u ]);
+	m_pCompiledPS = framework::ToShaderBlob(shaders[ 1u ]);
+
+	//~ PrimaryConstants is generated from cbPrimary, a stale copy writes the lights into the wrong registers
+	const auto errors = framework::ValidateGeneratedLayout(PrimaryConstantsLayout);
+	for (const auto& error : errors) logger::warning("Layout {}: {}", PrimaryConstantsLayout.ConstantBuffer, error);
+	assert(errors.empty() && "Generated cbuffer layout is out of date!");
 }
 
 void Draw3DBox::BuildInputLayout()
@@ -500,18 +485,11 @@ void Draw3DBox::BuildGeometry()
 	m_pGeometry->IndexFormat		  = DXGI_FORMAT_R16_UINT;
 	m_pGeometry->IndexBufferByteSize  = ibSize;
 
-	m_pGeometry->VertexResource = framework::CreateDefaultBuffer(
-		m_pRender->m_pDevice	 .Get (),
-		m_pRender->m_pCommandList.Get (),
-		vertices			     .data(),
-		vbSize,
-		m_pGeometry->VertexResourceUploader);
-
-	m_pGeometry->IndexResource = framework::CreateDefaultBuffer(
-		m_pRender->m_pDevice.Get(),
-		m_pRender->m_pCommandList.Get(),
-		indices.data(),
-		ibSize, m_pGeometry->IndexResourceUploader);
+	//~ both buffers go out in one copy queue batch, the direct queue waits on it before the first draw
+	auto* uploads = m_pRender->m_pUploadManager.get();
+	m_pGeometry->VertexResource = uploads->CreateBuffer(vertices.data(), vbSize);
+	m_pGeometry->IndexResource	= uploads->CreateBuffer(indices.data(), ibSize);
+	uploads->QueueWait(m_pRender->m_pCommandQueue.Get(), uploads->Submit());
 
 	framework::SubmeshGeometry submesh;
 	submesh.IndexCount = static_cast<UINT>(indices.size());
@@ -549,7 +527,5 @@ void Draw3DBox::BuildPSO()
 	psoDesc.SampleDesc.Quality		 = 0u;
 	psoDesc.DSVFormat				 = m_pRender->m_depthStencilFormat;
 
-	THROW_DX_IF_FAILS(m_pRender->m_pDevice->CreateGraphicsPipelineState(
-		&psoDesc,
-		IID_PPV_ARGS(&m_pPipelineState)));
+	m_pPipelineState = m_pRender->m_pPipelineCache->GetOrCreate(psoDesc);
 }
@@ -6,6 +6,7 @@
 #include "utility/graphics/upload_buffer.h"
 #include "utility/graphics/dx_utils.h"
 #include "utility/graphics/math.h"
+#include "generated/shader_layouts.h"
 
 struct VertexDesc
 {
@@ -15,12 +16,11 @@ struct VertexDesc
 	DirectX::XMFLOAT2 UV;
 };
 
+//~ ImGui edited light state, copied into PrimaryConstants every frame
 struct DirectionalLightCB
 {
 	DirectX::XMFLOAT3 Direction;
-	float             pad0 = 0.0f;
 	DirectX::XMFLOAT3 Color;
-	float             pad1 = 0.0f;
 };
 
 struct PointLightCB
@@ -28,31 +28,13 @@ struct PointLightCB
 	DirectX::XMFLOAT3 Position;
 	float             Range = 25.0f;
 	DirectX::XMFLOAT3 Color;
-	float             pad = 0.0f;
-};
-
-struct ConstantBufferDesc
-{
-	float TimeElapsed;
-	float padding[ 3 ];
-
-	DirectX::XMFLOAT2 Resolution;
-	DirectX::XMFLOAT2 Mouse;
-
-	DirectX::XMFLOAT4X4 WorldViewProjectMatrix;
-
-	DirectX::XMFLOAT3 EyePosW;
-	float             padEye = 0.0f;
-
-	DirectionalLightCB DirLight;
-	PointLightCB       PointLight;
 };
 
 class Draw3DBox : public IDrawLayer
 {
 public:
 	Draw3DBox(framework::DxRenderManager* manager);
-	~Draw3DBox() override = default;
+	~Draw3DBox() override;
 	void Draw(float deltaTime) override;
 
 private:
@@ -61,7 +43,6 @@ private:
 
 	//~ build box
 	void InitImgui();
-	void CreateImGuiDescriptorHeap();
 	void BuildDescriptorHeaps();
 	void BuildConstantBuffers();
 	void BuildRootSignature();
@@ -72,9 +53,9 @@ private:
 
 private:
 	Microsoft::WRL::ComPtr<ID3D12RootSignature>	 m_pRootSignature{ nullptr };
-	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_pCbvHeap{ nullptr };
+	framework::DESCRIPTOR_RANGE					 m_descriptors{};
 
-	std::unique_ptr<framework::UploadBuffer<ConstantBufferDesc>> m_pCBResource{ nullptr };
+	std::unique_ptr<framework::UploadBuffer<PrimaryConstants>>   m_pCBResource{ nullptr };
 	std::unique_ptr<framework::MeshGeometry>                     m_pGeometry{ nullptr };
 
 	Microsoft::WRL::ComPtr<ID3DBlob> m_pCompiledVS{ nullptr };
@@ -87,7 +68,6 @@ private:
 	DirectX::XMFLOAT4X4 m_worldMatrix{ MathHelper::Identity4x4() };
 	DirectX::XMFLOAT4X4 m_viewMatrix{ MathHelper::Identity4x4() };
 	DirectX::XMFLOAT4X4 m_projMatrix{ MathHelper::Identity4x4() };
-	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_imguiSrvHeap;
 
 	float m_nTheta{ 1.5f * DirectX::XM_PI };
 	float m_nPhi{ DirectX::XM_PIDIV4 };
@@ -0,0 +1,46 @@
+#pragma once
+
+//~ generated by tools/shader_layout_gen.cpp from the cbuffers of the shaders, do not edit.
+//~ run it again after changing one, the layers check these against the sources at startup
+
+#include <DirectXMath.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "framework/render_manager/shader_reflection.h"
+
+//~ cbuffer cbPrimary : register(b0) of shaders/chapter_6/common.hlsli, 156 bytes, 12 of them padding
+struct alignas(16) PrimaryConstants
+{
+	DirectX::XMFLOAT4X4 u_WorldViewProjectMatrix{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+	DirectX::XMFLOAT2 u_resolution{};
+	DirectX::XMFLOAT2 u_mouse{};
+	DirectX::XMFLOAT3 u_EyePosW{};
+	float u_time{};
+	DirectX::XMFLOAT3 u_DirLightDirection{};
+	float u_PointLightRange{};
+	DirectX::XMFLOAT3 u_DirLightColor{};
+	float _pad0[ 1 ]{};
+	DirectX::XMFLOAT3 u_PointLightPosition{};
+	float _pad1[ 1 ]{};
+	DirectX::XMFLOAT3 u_PointLightColor{};
+	float _pad2[ 1 ]{};
+};
+static_assert(offsetof(PrimaryConstants, u_WorldViewProjectMatrix) == 0u, "cbPrimary.u_WorldViewProjectMatrix moved, regenerate the shader layouts");
+static_assert(offsetof(PrimaryConstants, u_resolution) == 64u, "cbPrimary.u_resolution moved, regenerate the shader layouts");
+static_assert(offsetof(PrimaryConstants, u_mouse) == 72u, "cbPrimary.u_mouse moved, regenerate the shader layouts");
+static_assert(offsetof(PrimaryConstants, u_EyePosW) == 80u, "cbPrimary.u_EyePosW moved, regenerate the shader layouts");
+static_assert(offsetof(PrimaryConstants, u_time) == 92u, "cbPrimary.u_time moved, regenerate the shader layouts");
+static_assert(offsetof(PrimaryConstants, u_DirLightDirection) == 96u, "cbPrimary.u_DirLightDirection moved, regenerate the shader layouts");
+static_assert(offsetof(PrimaryConstants, u_PointLightRange) == 108u, "cbPrimary.u_PointLightRange moved, regenerate the shader layouts");
+static_assert(offsetof(PrimaryConstants, u_DirLightColor) == 112u, "cbPrimary.u_DirLightColor moved, regenerate the shader layouts");
+static_assert(offsetof(PrimaryConstants, u_PointLightPosition) == 128u, "cbPrimary.u_PointLightPosition moved, regenerate the shader layouts");
+static_assert(offsetof(PrimaryConstants, u_PointLightColor) == 144u, "cbPrimary.u_PointLightColor moved, regenerate the shader layouts");
+static_assert(sizeof(PrimaryConstants) == 160u, "cbPrimary changed size, regenerate the shader layouts");
+
+inline constexpr framework::SHADER_GENERATED_LAYOUT PrimaryConstantsLayout
+{
+	"shaders/chapter_6/common.hlsli", "cbPrimary", "",
+	156u, 0x2a20226b98749343ull
+};
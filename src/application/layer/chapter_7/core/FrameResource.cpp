@@ -4,12 +4,67 @@
 #include "utility/graphics/dx_utils.h"
 #include "utility/graphics/upload_buffer.h"
 
-FrameResource::FrameResource(ID3D12Device* device, UINT passCount, UINT objectCount)
+FrameResource::FrameResource(ID3D12Device* device, framework::DxGpuAllocator* gpuAllocator, UINT objectCount, UINT workerCount, framework::UploadRing* uploadRing, bool packedObjects)
 {
     THROW_DX_IF_FAILS(device->CreateCommandAllocator(
         D3D12_COMMAND_LIST_TYPE_DIRECT,
         IID_PPV_ARGS(CmdListAlloc.GetAddressOf())));
 
-    PassCB   = std::make_unique<framework::UploadBuffer<PassConstants>>(device, passCount, framework::UploadBufferType::Constant);
-    ObjectCB = std::make_unique<framework::UploadBuffer<ConstantData>> (device, objectCount, framework::UploadBufferType::Constant);
+    //~ every frame records its own list so recording never races a submit
+    THROW_DX_IF_FAILS(device->CreateCommandList(
+        0u,
+        D3D12_COMMAND_LIST_TYPE_DIRECT,
+        CmdListAlloc.Get(),
+        nullptr,
+        IID_PPV_ARGS(CmdList.GetAddressOf())));
+    THROW_DX_IF_FAILS(CmdList->Close());
+
+    THROW_DX_IF_FAILS(device->CreateCommandList(
+        0u,
+        D3D12_COMMAND_LIST_TYPE_DIRECT,
+        CmdListAlloc.Get(),
+        nullptr,
+        IID_PPV_ARGS(PostCmdList.GetAddressOf())));
+    THROW_DX_IF_FAILS(PostCmdList->Close());
+
+    Recorder    .Attach(CmdList.Get());
+    PostRecorder.Attach(PostCmdList.Get());
+
+    WorkerAllocs   .resize(workerCount);
+    WorkerLists    .resize(workerCount);
+    WorkerRecorders.resize(workerCount);
+
+    for (UINT i = 0; i < workerCount; ++i)
+    {
+        THROW_DX_IF_FAILS(device->CreateCommandAllocator(
+            D3D12_COMMAND_LIST_TYPE_DIRECT,
+            IID_PPV_ARGS(WorkerAllocs[ i ].GetAddressOf())));
+
+        THROW_DX_IF_FAILS(device->CreateCommandList(
+            0u,
+            D3D12_COMMAND_LIST_TYPE_DIRECT,
+            WorkerAllocs[ i ].Get(),
+            nullptr,
+            IID_PPV_ARGS(WorkerLists[ i ].GetAddressOf())));
+        THROW_DX_IF_FAILS(WorkerLists[ i ]->Close());
+
+        WorkerRecorders[ i ].Attach(WorkerLists[ i ].Get());
+    }
+
+    ObjectCB = std::make_unique<framework::UploadBuffer<ConstantData>> (gpuAllocator, objectCount,
+        packedObjects ? framework::UploadBufferType::VertexIndexOrStructured : framework::UploadBufferType::Constant);
+
+    //~ tightly packed, bound as a root SRV so it needs no descriptor
+    InstanceBuffer = std::make_unique<framework::UploadBuffer<InstanceData>>(gpuAllocator, objectCount, framework::UploadBufferType::VertexIndexOrStructured);
+    ObjectConstants.resize(objectCount);
+
+    Uploads         = std::make_unique<framework::LinearUploadAllocator>(uploadRing);
+    DynamicGeometry = std::make_unique<framework::DynamicGeometryStream>(Uploads.get());
+
+    //~ nothing has been uploaded yet, every object starts dirty
+    ObjectDirtyBits.assign((objectCount + 63u) / 64u, 0ull);
+    for (UINT i = 0; i < objectCount; ++i)
+    {
+        MarkObjectDirty(i);
+    }
 }
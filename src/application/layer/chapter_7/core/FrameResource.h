@@ -1,40 +1,28 @@
 #pragma once
 #include <d3d12.h>
 #include <wrl/client.h>
+#include <cstdint>
 #include <memory>
+#include <vector>
 #include <DirectXMath.h>
 #include "utility/graphics/math.h"
 #include "utility/graphics/upload_buffer.h"
+#include "framework/render_manager/backend/dx_command_recorder.h"
+#include "framework/render_manager/dynamic_geometry.h"
+#include "framework/render_manager/render_queue.h"
+#include "framework/render_manager/resource_state_tracker.h"
+#include "framework/render_manager/upload_ring.h"
+#include "application/layer/chapter_7/generated/shader_layouts.h"
 
-struct ConstantData
-{
-    float				TimeElapsed;
-    float				padding[ 3 ];
-    DirectX::XMFLOAT2   Resolution;
-    DirectX::XMFLOAT2	MousePosition;
-	DirectX::XMFLOAT4X4 World{ MathHelper::Identity4x4() };
-};
+//~ PassConstants (b1), ConstantData and ObjectIdConstants (b0), generated from the shaders
+static_assert(sizeof(ConstantData) == sizeof(DirectX::XMFLOAT4X4), "Object CB is written as a bare transposed world");
 
-struct alignas(16) PassConstants
+//~ one element of the instance structured buffer, read with SV_InstanceID + gInstanceBase
+struct InstanceData
 {
-    DirectX::XMFLOAT4X4 gView = MathHelper::Identity4x4();
-    DirectX::XMFLOAT4X4 gInvView = MathHelper::Identity4x4();
-    DirectX::XMFLOAT4X4 gProj = MathHelper::Identity4x4();
-    DirectX::XMFLOAT4X4 gInvProj = MathHelper::Identity4x4();
-    DirectX::XMFLOAT4X4 gViewProj = MathHelper::Identity4x4();
-    DirectX::XMFLOAT4X4 gInvViewProj = MathHelper::Identity4x4();
-
-    DirectX::XMFLOAT3   gEyePosW = { 0.0f, 0.0f, 0.0f };
-    float               cbPerObjectPad1 = 0.0f;
-
-    DirectX::XMFLOAT2   gRenderTargetSize = { 0.0f, 0.0f };
-    DirectX::XMFLOAT2   gInvRenderTargetSize = { 0.0f, 0.0f };
-
-    float gNearZ = 0.0f;
-    float gFarZ = 0.0f;
-    float gTotalTime = 0.0f;
-    float gDeltaTime = 0.0f;
+    DirectX::XMFLOAT4X4 World{ MathHelper::Identity4x4() };
 };
+static_assert(sizeof(InstanceData) % 16u == 0u, "Instance data is streamed, keep it 16 byte sized");
 
 struct Vertex
 {
@@ -42,18 +30,74 @@ struct Vertex
     DirectX::XMFLOAT4 Color;
 };
 
+//~ everything the record stage needs to draw one item, built by the packet stage
+struct RenderPacket
+{
+    framework::GpuVertexBufferView VertexView{};
+    framework::GpuIndexBufferView  IndexView {};
+    framework::EPrimitiveTopology  Topology  { framework::EPrimitiveTopology::TriangleList };
+    framework::GpuPipelineHandle   Pipeline  { nullptr };
+
+    //~ ERenderStateChange mask against the previous packet, set by the render queue
+    std::uint32_t StateChanges{ framework::STATE_CHANGE_ALL };
+
+    UINT ObjectCBIndex     { 0u };
+    UINT IndexCount        { 0u };
+    UINT StartIndexLocation{ 0u };
+    UINT BaseVertexLocation{ 0u };
+
+    //~ instanced packets draw InstanceCount slots of the instance buffer from FirstInstance
+    UINT FirstInstance{ 0u };
+    UINT InstanceCount{ 1u };
+};
+
 struct FrameResource
 {
 public:
 
-    FrameResource(ID3D12Device* device, UINT passCount, UINT objectCount);
+    //~ packedObjects: ObjectCB is a tightly packed structured buffer instead of 256 byte constant buffer slots
+    FrameResource(ID3D12Device* device, framework::DxGpuAllocator* gpuAllocator, UINT objectCount, UINT workerCount, framework::UploadRing* uploadRing, bool packedObjects = false);
     FrameResource(const FrameResource& rhs) = delete;
     FrameResource& operator=(const FrameResource& rhs) = delete;
     ~FrameResource() = default;
 
     Microsoft::WRL::ComPtr<ID3D12CommandAllocator>          CmdListAlloc;
-    std::unique_ptr<framework::UploadBuffer<PassConstants>> PassCB   = nullptr;
-    std::unique_ptr<framework::UploadBuffer<ConstantData>>  ObjectCB = nullptr;
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>       CmdList;     //~ opens the frame (barriers, clears)
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>       PostCmdList; //~ closes the frame, shares CmdListAlloc
+    framework::DxCommandRecorder                            Recorder;
+    framework::DxCommandRecorder                            PostRecorder;
+
+    //~ per worker recording, chunk i of the packets is recorded into worker list i
+    std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>>    WorkerAllocs{};
+    std::vector<Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>> WorkerLists {};
+    std::vector<framework::DxCommandRecorder>                      WorkerRecorders{};
+    UINT RecordedChunks = 0u;
+    std::unique_ptr<framework::UploadBuffer<ConstantData>>  ObjectCB = nullptr; //~ indexed by ObjectCBIndex in either layout
+    std::unique_ptr<framework::UploadBuffer<InstanceData>>  InstanceBuffer = nullptr;
+    std::vector<ConstantData> ObjectConstants{}; //~ cached CPU copy of ObjectCB, read when objects are bound as root constants
+
+    //~ transient uploads, rewritten every frame and handed back to the ring with the frame fence at submit
+    std::unique_ptr<framework::LinearUploadAllocator> Uploads = nullptr;
+    framework::GpuVirtualAddress VisibleInstances{ 0u }; //~ compacted instance slots, from Uploads
+    framework::GpuVirtualAddress PassCBAddress{ 0u };    //~ pass constants from Uploads, 0 when the ring was full and the frame skips its draws
+    UINT PassCbv{ 0u }; //~ transient descriptor in the global heap over PassCBAddress, rewritten every frame
+    std::unique_ptr<framework::DynamicGeometryStream> DynamicGeometry = nullptr; //~ CPU generated meshes, from Uploads
+    framework::DYNAMIC_GEOMETRY DebugLines{}; //~ world space line list, empty when debug bounds are off
+
+    //~ one bit per ObjectCBIndex, set while this frame's copy of the object CB is stale
+    std::vector<std::uint64_t> ObjectDirtyBits{};
+
+    void MarkObjectDirty (UINT index) noexcept       { ObjectDirtyBits[ index >> 6u ] |=  (1ull << (index & 63u)); }
+    void ClearObjectDirty(UINT index) noexcept       { ObjectDirtyBits[ index >> 6u ] &= ~(1ull << (index & 63u)); }
+    bool IsObjectDirty   (UINT index) const noexcept { return (ObjectDirtyBits[ index >> 6u ] >> (index & 63u)) & 1ull; }
 
-    UINT64 Fence = 0;
+    //~ hand-off between pipeline stages working on this frame
+    std::vector<float>        ItemDepths{};     //~ view depth per ObjectCBIndex, written by simulate
+    std::vector<std::uint8_t> ItemVisible{};    //~ frustum test per ObjectCBIndex, written by simulate
+    std::vector<RenderPacket> Packets{};        //~ sorted, what the record stage draws
+    framework::RenderQueue    Queue{};
+    framework::RESOURCE_BARRIER_STATS BarrierStats{}; //~ snapshot of the record stage tracker, read once the frame is waited on
+    UINT BackBufferIndex = 0u;
+    bool bWireFrame      = false;
+    bool bInstanced      = false;
 };
@@ -4,9 +4,14 @@
 #include "utility/graphics/geometry_generator.h"
 #include "utility/logger/logger.h"
 
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
 DrawShapes::DrawShapes(framework::DxRenderManager* manager)
 	: IDrawLayer(manager)
 {
+	ValidateShaderLayouts	();
 	BuildRootSignature		();
 	BuildShaders			();
 	BuildInputLayout		();
@@ -27,6 +32,7 @@ DrawShapes::DrawShapes(framework::DxRenderManager* manager)
 	UINT size = ARRAYSIZE(lists);
 	render->m_pCommandQueue->ExecuteCommandLists(size, lists);
 	render->FlushCommandQueue();
+	render->m_pUploadManager->Reclaim(); //~ the flush covered the copy queue wait, staging can go
 
 	m_nRadius = 5.0f;
 	m_nPhi = DirectX::XM_PIDIV4;
@@ -39,106 +45,366 @@ DrawShapes::DrawShapes(framework::DxRenderManager* manager)
 	auto proj = DirectX::XMMatrixPerspectiveFovLH(
 		0.25f * DirectX::XM_PI,
 		m_pRender->m_pWindowsManager->GetAspectRatio(),
-		0.1f, 1000.f
+		nNearZ, nFarZ
 	);
 	DirectX::XMStoreFloat4x4(&m_proj, proj);
+
+	BuildFramePipeline();
+	BuildHotReload	  ();
 }
 
 DrawShapes::~DrawShapes()
 {
+	if (m_pendingReload.valid()) m_pendingReload.wait();
+
+	if (m_pFramePipeline)
+	{
+		m_pFramePipeline->Flush();
+		m_pFramePipeline->Stop ();
+	}
+	m_pRender->FlushCommandQueue();
+	m_pRender->m_pDescriptorHeap->GetAllocator().FreePersistent(m_objectCbvs);
+
+	for (auto& [name, geometry] : m_geometries)
+	{
+		m_pRender->m_pUploadManager->ReleaseBuffer(geometry->VertexResource);
+		m_pRender->m_pUploadManager->ReleaseBuffer(geometry->IndexResource);
+	}
 }
 
 void DrawShapes::Draw(float deltaTime)
 {
-	m_nTimeElapsed += deltaTime;
-	Update(deltaTime);
+	PollShaderReload();
+	if (m_bPresentProfileRequested) ApplyPresentProfile();
+	m_pFramePipeline->Tick(deltaTime);
+}
 
-	auto cmdList = m_pRender->m_pCommandList.Get();
-	auto cmdListAlloc = m_pCurrentFrameResource->CmdListAlloc.Get();
-	THROW_DX_IF_FAILS(cmdListAlloc->Reset());
+void DrawShapes::SimulateStage(const framework::FRAME_TICKET& ticket)
+{
+	//~ on the low latency profile this blocks until the present queue has room, input is read after it
+	const double latencyWaitMs = m_pRender->WaitForFrameLatency();
+	m_latency.BeginFrame(ticket.FrameNumber, framework::LatencyTracker::Clock::now(), latencyWaitMs);
 
-	if (m_bWireFrame)
+	m_nTimeElapsed += ticket.DeltaTime;
+	Update(ticket.DeltaTime, ticket.FrameIndex);
+
+	auto* frame = &m_pFrameRing->GetContext(ticket.FrameIndex);
+	BuildPassDescriptor(ticket.FrameIndex, frame);
+
+	//~ snapshot state the later stages must not read from the live layer
+	frame->bWireFrame	   = m_bWireFrame;
+	frame->bInstanced	   = m_bInstanced;
+	frame->BackBufferIndex = m_nNextBackBuffer;
+	m_nNextBackBuffer	   = (m_nNextBackBuffer + 1u) % m_pRender->GetSwapChainBufferCount();
+
+	m_statsTimer += ticket.DeltaTime;
+	if (m_statsTimer >= 5.0f)
 	{
-		THROW_DX_IF_FAILS(cmdList->Reset(cmdListAlloc, m_pso[ "opaque_wireframe" ].Get()));
-	}else
+		m_statsTimer = 0.0f;
+		for (const auto& stats : m_pFramePipeline->GetStats())
+		{
+			logger::debug("Frame stage {}: last {:.3f} ms, avg {:.3f} ms",
+						  stats.Name, stats.LastMs, stats.AverageMs);
+		}
+		logger::debug("Uploads last frame: {} objects ({} bytes), instances {} bytes, pass {} bytes",
+					  m_uploadStats.ObjectCount, m_uploadStats.ObjectBytes,
+					  m_uploadStats.InstanceBytes, m_uploadStats.PassBytes);
+
+		//~ waits here are GPU bound frames, a high ratio with short waits says a deeper ring would help
+		const auto& frames = m_pFrameRing->GetStats();
+		const auto	arena  = m_pFrameRing->GetArenaStats();
+		logger::debug("Frame ring: depth {}, {} of {} acquires waited ({:.0f}%), avg {:.3f} ms, max {:.3f} ms, arena peak {} of {} bytes, {} overflows",
+					  frames.Depth, frames.Stalls, frames.Acquires, frames.GetStallRatio() * 100.0,
+					  frames.AverageWaitMs, frames.MaxWaitMs, arena.Peak, arena.Capacity, arena.Overflows);
+
+		const auto latency = m_latency.GetStats();
+		logger::debug("Present '{}': input to present avg {:.2f} ms, p50 {:.2f}, p95 {:.2f}, max {:.2f} over {} frames, present {:.2f} ms, latency wait {:.2f} ms, {} dropped",
+					  framework::ToString(m_pRender->GetPresentProfile()), latency.AverageMs, latency.P50Ms, latency.P95Ms,
+					  latency.MaxMs, latency.Frames, latency.AveragePresentMs, latency.AverageWaitMs, latency.Dropped);
+
+		const auto ring = m_pUploadRing->GetStats();
+		logger::debug("Upload ring: {} of {} bytes in {} blocks, peak {}, failed {}",
+					  ring.Used, ring.Capacity, ring.BlocksInFlight, ring.PeakUsed, ring.FailedAllocations);
+
+		const auto uploads = m_pRender->m_pUploadManager->GetStats();
+		logger::debug("Copy queue uploads: {} buffers, {} bytes in {} batches, staging {} (peak {})",
+					  uploads.BuffersUploaded, uploads.BytesUploaded, uploads.BatchesSubmitted,
+					  uploads.StagingBytesInFlight, uploads.PeakStagingBytes);
+
+		const auto gpu = m_pRender->m_pGpuAllocator->GetBudget();
+		logger::debug("GPU memory: {} of {} heap bytes placed in {} blocks, {} dedicated, fragmentation {:.2f}, OS {} of {}",
+					  gpu.PlacedBytes, gpu.HeapBytes, gpu.HeapCount, gpu.DedicatedBytes, gpu.Fragmentation,
+					  gpu.OsUsage, gpu.OsBudget);
+
+		const auto descriptors = m_pRender->m_pDescriptorHeap->GetAllocator().GetStats();
+		logger::debug("Descriptors: {} of {} persistent in {} ranges, transient peak {} of {} per frame, failed {}",
+					  descriptors.PersistentUsed, descriptors.PersistentCapacity, descriptors.PersistentRanges,
+					  descriptors.TransientPeak, descriptors.TransientCapacity, descriptors.FailedAllocations);
+
+		const auto& dynamic = frame->DynamicGeometry->GetStats();
+		logger::debug("Dynamic geometry: {} meshes, {} vertex bytes, {} index bytes, failed {}",
+					  dynamic.MeshCount, dynamic.VertexBytes, dynamic.IndexBytes, dynamic.FailedAllocations);
+
+		const auto& cull = m_culler.GetLastStats();
+		logger::debug("Culling: {} visible, {} culled of {} in {:.3f} ms",
+					  cull.Visible, cull.Culled, cull.Tested, cull.CullMs);
+
+		const auto& occlusion = m_occlusion.GetLastStats();
+		logger::debug("Occlusion: {} occluders ({} of {} triangles) in {:.3f} ms, {} of {} occluded",
+					  occlusion.Occluders, occlusion.TrianglesRasterized, occlusion.Triangles, occlusion.RasterMs,
+					  occlusion.Occluded, occlusion.Tested);
+
+		//~ the frame resource was waited on, its queue still holds the last frame built in it
+		const auto queue = frame->Queue.GetStats();
+		logger::debug("Draws: {} ({} items, {}), state changes: pipeline {}, geometry {}, material {}",
+					  queue.DrawCount, m_ppOpaqueItems.size(), frame->bInstanced ? "instanced" : "per item",
+					  queue.PipelineChanges, queue.GeometryChanges, queue.MaterialChanges);
+
+		const auto& barriers = frame->BarrierStats;
+		logger::debug("Barriers: {} requested, {} emitted in {} batches, {} redundant, {} merged",
+					  barriers.Requested, barriers.Emitted, barriers.Batches, barriers.Redundant, barriers.Merged);
+	}
+}
+
+void DrawShapes::BuildPacketsStage(const framework::FRAME_TICKET& ticket)
+{
+	auto* frame = &m_pFrameRing->GetContext(ticket.FrameIndex);
+	if (!frame->PassCBAddress)
 	{
-		THROW_DX_IF_FAILS(cmdList->Reset(cmdListAlloc, m_pso[ "opaque" ].Get()));
+		frame->Queue.Reset();
+		frame->Packets.clear();
+		return;
 	}
 
-	cmdList->RSSetViewports	  (1u, &m_pRender->m_viewport);
-	cmdList->RSSetScissorRects(1u, &m_pRender->m_scissorRect);
+	//~ unsorted packets, indexed by the queue payloads. The arena was reset when simulate acquired the frame
+	auto* scratch	  = m_pFrameRing->GetArena(ticket.FrameIndex).AllocateArray<RenderPacket>(m_ppOpaqueItems.size());
+	UINT  scratchSize = 0u;
 
-	D3D12_RESOURCE_BARRIER barrier{};
-	barrier.Flags					= D3D12_RESOURCE_BARRIER_FLAG_NONE;
-	barrier.Type					= D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-	barrier.Transition.StateBefore	= D3D12_RESOURCE_STATE_PRESENT;
-	barrier.Transition.StateAfter	= D3D12_RESOURCE_STATE_RENDER_TARGET;
-	barrier.Transition.Subresource	= D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-	barrier.Transition.pResource	= m_pRender->GetBackBuffer();
-	cmdList->ResourceBarrier(1u, &barrier);
+	auto* pso = m_pso.at(frame->bInstanced
+		? (frame->bWireFrame ? "opaque_instanced_wireframe" : "opaque_instanced")
+		: (frame->bWireFrame ? "opaque_wireframe" : "opaque")).Get();
 
-	auto handle = m_pRender->GetBackBufferHandle();
+	auto toPacket = [pso](const RenderItem* item)
+	{
+		RenderPacket packet{};
+		packet.VertexView		  = framework::ToGpuView(item->Geometry->GetVertexViewDesc());
+		packet.IndexView		  = framework::ToGpuView(item->Geometry->GetIndexViewDesc());
+		packet.Topology			  = framework::ToGpuTopology(item->Topology);
+		packet.Pipeline			  = pso;
+		packet.ObjectCBIndex	  = item->ObjectCBIndex;
+		packet.IndexCount		  = item->IndexCount;
+		packet.StartIndexLocation = item->StartIndexLocation;
+		packet.BaseVertexLocation = item->BaseVertexLocation;
+		return packet;
+	};
+
+	const auto& visible = frame->ItemVisible;
+	if (frame->bInstanced)
+	{
+		//~ one packet per batch with its visible slots compacted, the first visible
+		//~ item of the batch stands in for the rest. Fully culled batches are dropped
+		const auto& order = m_instanceBatcher.GetInstanceOrder();
+
+		//~ sized for everything visible, the unused tail just goes back to the ring with the frame
+		const auto upload = frame->Uploads->Allocate(
+			std::max<std::uint64_t>(order.size(), 1u) * sizeof(std::uint32_t), framework::UPLOAD_ALIGN_BUFFER);
+		if (!upload.IsValid())
+		{
+			//~ ring full, the frame draws no instanced packets. FailedAllocations reports it
+			frame->VisibleInstances = 0u;
+		}
+		else
+		{
+			auto* visibleSlots		= static_cast<std::uint32_t*>(upload.Cpu);
+			frame->VisibleInstances = upload.Gpu;
+			UINT cursor				= 0u;
+			for (const auto& batch : m_instanceBatcher.GetBatches())
+			{
+				const UINT first	= cursor;
+				UINT representative = 0u;
+				for (UINT slot = batch.FirstInstance; slot < batch.FirstInstance + batch.InstanceCount; ++slot)
+				{
+					if (!visible[ order[ slot ] ]) continue;
+					if (cursor == first) representative = order[ slot ];
+					visibleSlots[ cursor++ ] = slot;
+				}
+				if (cursor == first) continue;
+
+				RenderPacket packet = toPacket(m_ppOpaqueItems[ representative ]);
+				packet.FirstInstance = first;
+				packet.InstanceCount = cursor - first;
+				scratch[ scratchSize++ ] = packet;
+			}
+		}
+	}
+	else
+	{
+		for (const auto* item : m_ppOpaqueItems)
+		{
+			if (!visible[ item->ObjectCBIndex ]) continue;
+			scratch[ scratchSize++ ] = toPacket(item);
+		}
+	}
+
+	//~ sort by state then front to back, the queue tags what each packet has to rebind.
+	//~ No materials yet, vertex colors only
+	auto& queue = frame->Queue;
+	queue.Reset();
+	queue.Reserve(scratchSize);
+	for (UINT i = 0; i < scratchSize; ++i)
+	{
+		const auto& item = m_renderItems[ scratch[ i ].ObjectCBIndex ];
+
+		framework::SORT_KEY_DESC key{};
+		key.Pipeline = (frame->bInstanced ? 2u : 0u) + (frame->bWireFrame ? 1u : 0u);
+		key.Geometry = item.GeometryId;
+		key.Depth	 = framework::QuantizeDepth(frame->ItemDepths[ item.ObjectCBIndex ], nNearZ, nFarZ);
+		queue.Push(framework::EncodeSortKey(key), i);
+	}
+	queue.Sort();
+
+	frame->Packets.clear();
+	frame->Packets.reserve(scratchSize);
+	for (const auto& entry : queue.GetEntries())
+	{
+		RenderPacket packet = scratch[ entry.Payload ];
+		packet.StateChanges = entry.Changes;
+		frame->Packets.push_back(packet);
+	}
+}
+
+void DrawShapes::RecordStage(const framework::FRAME_TICKET& ticket)
+{
+	auto* frame		  = &m_pFrameRing->GetContext(ticket.FrameIndex);
+	auto cmdList	  = frame->CmdList.Get();
+	auto cmdListAlloc = frame->CmdListAlloc.Get();
+	auto* pso		  = frame->Packets.empty()
+		? m_pso.at("opaque").Get()
+		: static_cast<ID3D12PipelineState*>(frame->Packets.front().Pipeline);
+
+	THROW_DX_IF_FAILS(cmdListAlloc->Reset());
+	THROW_DX_IF_FAILS(cmdList->Reset(cmdListAlloc, pso));
+
+	using framework::EResourceState;
+	auto& preRecorder = frame->Recorder;
+	auto* backBuffer   = m_pRender->GetBackBuffer(frame->BackBufferIndex);
+	m_barriers.Transition(backBuffer, EResourceState::RenderTarget);
+	m_barriers.Transition(m_pRender->m_pDepthStencilBuffer.Get(), EResourceState::DepthWrite);
+	m_barriers.Flush(preRecorder);
+
+	auto handle = framework::ToCpuHandle(m_pRender->GetBackBufferHandle(frame->BackBufferIndex));
 	constexpr float color[]{ 0.25f, 0.26f, 0.71f, 1.0f };
-	cmdList->ClearRenderTargetView(handle, color, 0u, nullptr);
-
-	auto dHandle = m_pRender->GetDepthStencilHandle();
-	cmdList->ClearDepthStencilView(dHandle,
-								   D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL,
-								   1.0f, 0u, 0u, nullptr);
-	cmdList->OMSetRenderTargets(1u,
-								&handle,
-								true,
-								&dHandle);
-	ID3D12DescriptorHeap* heaps[]{ m_pCbHeap.Get() };
-	cmdList->SetDescriptorHeaps(1u, heaps);
-	cmdList->SetGraphicsRootSignature(m_pRootSignature.Get());
-
-	UINT passIndex = m_nPassCBOffset + m_nCurrentFrameIndex;
-	auto passHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_pCbHeap->GetGPUDescriptorHandleForHeapStart());
-	passHandle.Offset(passIndex, m_pRender->m_nCbvSrvUavDescriptorSize);
-	cmdList->SetGraphicsRootDescriptorTable(1u, passHandle);
-
-	DrawRenderItems(cmdList, m_ppOpaqueItems);
+	preRecorder.ClearRenderTarget(handle, color);
+
+	auto dHandle = framework::ToCpuHandle(m_pRender->GetDepthStencilHandle());
+	preRecorder.ClearDepthStencil(dHandle, 1.0f, 0u);
+	THROW_DX_IF_FAILS(cmdList->Close());
+
+	//~ chunk i goes into worker list i, submit order keeps the packet order
+	std::vector<framework::ICommandRecorder*> recorders{};
+	recorders.reserve(frame->WorkerRecorders.size());
+	for (auto& recorder : frame->WorkerRecorders) recorders.push_back(&recorder);
+
+	framework::ParallelRecorder parallel(m_pRender->m_pJobSystem.get());
+	frame->RecordedChunks = parallel.Record(
+		static_cast<std::uint32_t>(frame->Packets.size()),
+		recorders,
+		nMinPacketsPerChunk,
+		[&](framework::ICommandRecorder& recorder, std::uint32_t chunk, const framework::RECORD_RANGE& range)
+	{
+		auto* alloc = frame->WorkerAllocs[ chunk ].Get();
+		auto* list	= frame->WorkerLists [ chunk ].Get();
+		THROW_DX_IF_FAILS(alloc->Reset());
+		auto* chunkPso = static_cast<ID3D12PipelineState*>(frame->Packets[ range.Begin ].Pipeline);
+		THROW_DX_IF_FAILS(list->Reset(alloc, chunkPso));
+
+		BindPassState  (recorder, frame, ticket.FrameIndex);
+		DrawRenderItems(recorder, frame->Packets, range, ticket.FrameIndex, frame->bInstanced);
+
+		THROW_DX_IF_FAILS(list->Close());
+	});
 
 	//~ ready for present
-	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
-	barrier.Transition.StateAfter  = D3D12_RESOURCE_STATE_PRESENT;
-	cmdList->ResourceBarrier(1u, &barrier);
+	auto* postList = frame->PostCmdList.Get();
+	THROW_DX_IF_FAILS(postList->Reset(cmdListAlloc, nullptr));
 
-	THROW_DX_IF_FAILS(cmdList->Close());
-	ID3D12CommandList* cmdLists[]{ cmdList };
-	m_pRender->m_pCommandQueue->ExecuteCommandLists(1u, cmdLists);
-	m_pRender->m_pSwapChain->Present(0u, 0u);
+	//~ debug overlay after every chunk, it only needs the pass constants
+	const auto& lines = frame->DebugLines;
+	if (lines.IndexCount && frame->PassCBAddress)
+	{
+		auto& post = frame->PostRecorder;
+		BindPassState(post, frame, ticket.FrameIndex);
+		post.SetPipelineState	 (m_pso.at("debug_lines").Get());
+		post.SetVertexBuffer	 (0u, lines.VertexView);
+		post.SetIndexBuffer		 (lines.IndexView);
+		post.SetPrimitiveTopology(framework::EPrimitiveTopology::LineList);
+		post.DrawIndexedInstanced(lines.IndexCount, 1u, 0u, 0, 0u);
+	}
 
-	m_pRender->m_nCurrentBackBuffer =
-		(m_pRender->m_nCurrentBackBuffer + 1u) % m_pRender->SWAP_CHAIN_BUFFER_COUNT;
+	m_barriers.Transition(backBuffer, EResourceState::Present);
+	m_barriers.Flush(frame->PostRecorder);
+	m_barriers.Commit();
+	frame->BarrierStats = m_barriers.GetStats();
+
+	THROW_DX_IF_FAILS(postList->Close());
+}
+
+void DrawShapes::SubmitStage(const framework::FRAME_TICKET& ticket)
+{
+	auto* frame = &m_pFrameRing->GetContext(ticket.FrameIndex);
+
+	std::vector<framework::ICommandRecorder*> recorders{};
+	recorders.reserve(frame->RecordedChunks + 2u);
+	recorders.push_back(&frame->Recorder);
+	for (UINT i = 0; i < frame->RecordedChunks; ++i)
+	{
+		recorders.push_back(&frame->WorkerRecorders[ i ]);
+	}
+	recorders.push_back(&frame->PostRecorder);
+
+	auto* device = m_pRender->m_pRenderDevice.get();
+	device->ExecuteCommandLists(recorders.data(), static_cast<std::uint32_t>(recorders.size()));
+	const auto presentBegin = framework::LatencyTracker::Clock::now();
+	device->Present(m_pRender->GetPresentSyncInterval(), m_pRender->GetPresentFlags());
+	m_latency.EndFrame(ticket.FrameNumber, presentBegin, framework::LatencyTracker::Clock::now());
 
-	m_pCurrentFrameResource->Fence = ++m_pRender->m_nCurrentFence;
+	m_pRender->m_nCurrentBackBuffer =
+		(frame->BackBufferIndex + 1u) % m_pRender->GetSwapChainBufferCount();
 
-	m_pRender->m_pCommandQueue->Signal(m_pRender->m_pFence.Get(),
-									   m_pRender->m_nCurrentFence);
+	const auto fence = device->Signal();
+	m_pFrameRing->Retire(ticket.FrameIndex, fence);
+	frame->Uploads->Retire(fence);
+	m_pRender->m_pDescriptorHeap->GetAllocator().EndFrame(ticket.FrameIndex, fence);
 }
 
-void DrawShapes::Update(float deltaTime)
+void DrawShapes::Update(float deltaTime, UINT frameIndex)
 {
 	HandleInput(deltaTime);
 	UpdateCamera(deltaTime);
 
-	m_nCurrentFrameIndex = (m_nCurrentFrameIndex + 1u) % nFrameResourcesMaxCount;
-	m_pCurrentFrameResource = m_ppFrameResources[ m_nCurrentFrameIndex ].get();
+	auto* frame = WaitForFrameResource(frameIndex);
+
+	UpdateObjectCBs (deltaTime, frame);
+	UpdateMainPassCB(deltaTime, frame);
+	UpdateItemDepths(frame);
+	CullRenderItems (frame);
+}
+
+FrameResource* DrawShapes::WaitForFrameResource(UINT frameIndex)
+{
+	auto* device = m_pRender->m_pRenderDevice.get();
+	auto* frame	 = &m_pFrameRing->Acquire(frameIndex);
 
-	auto* fence = m_pRender->m_pFence.Get();
-	if (m_pCurrentFrameResource->Fence != 0 &&
-		fence->GetCompletedValue() < m_pCurrentFrameResource->Fence)
+	//~ this frame's old blocks and anything older are free again
+	const auto completed = device->GetCompletedFenceValue();
+	m_pUploadRing->Reclaim(completed);
+	m_retiredPipelines.Reclaim(completed, [this](Microsoft::WRL::ComPtr<ID3D12PipelineState>& pipeline)
 	{
-		HANDLE event = CreateEventEx(nullptr, FALSE, FALSE, EVENT_ALL_ACCESS);
-		THROW_DX_IF_FAILS(fence->SetEventOnCompletion(m_pCurrentFrameResource->Fence, event));
-		WaitForSingleObject(event, INFINITE);
-		CloseHandle(event);
-	}
-	
-	UpdateObjectCBs (deltaTime);
-	UpdateMainPassCB(deltaTime);
+		m_pRender->m_pPipelineCache->Release(pipeline.Get());
+	});
+	m_pRender->m_pUploadManager->Reclaim();
+	frame->DynamicGeometry->ResetStats();
+	return frame;
 }
 
 void DrawShapes::UpdateCamera(float deltaTime)
@@ -225,34 +491,111 @@ void DrawShapes::HandleInput(float deltaTime)
 		logger::debug("Called Wire Frame to: {}", m_bWireFrame);
 		m_wireToggleTimer = 0.25f;
 	}
+
+	if (keyboard.IsKeyPressed('I') && m_wireToggleTimer <= 0.0f)
+	{
+		m_bInstanced = !m_bInstanced;
+		logger::debug("Called Instancing to: {}", m_bInstanced);
+		m_wireToggleTimer = 0.25f;
+	}
+
+	if (keyboard.IsKeyPressed('O') && m_wireToggleTimer <= 0.0f)
+	{
+		m_bOcclusion = !m_bOcclusion;
+		logger::debug("Called Occlusion Culling to: {}", m_bOcclusion);
+		m_wireToggleTimer = 0.25f;
+	}
+
+	if (keyboard.IsKeyPressed('L') && m_wireToggleTimer <= 0.0f)
+	{
+		m_bDebugBounds = !m_bDebugBounds;
+		logger::debug("Called Debug Bounds to: {}", m_bDebugBounds);
+		m_wireToggleTimer = 0.25f;
+	}
+
+	if (keyboard.IsKeyPressed('P') && m_wireToggleTimer <= 0.0f)
+	{
+		m_bPickRequested = true; //~ resolved after this frame's bounds are refit
+		m_wireToggleTimer = 0.25f;
+	}
+
+	if (keyboard.IsKeyPressed('V') && m_wireToggleTimer <= 0.0f)
+	{
+		m_bPresentProfileRequested = true; //~ the swap chain is recreated before the next frame
+		m_wireToggleTimer = 0.25f;
+	}
+}
+
+void DrawShapes::ApplyPresentProfile()
+{
+	m_bPresentProfileRequested = false;
+
+	const auto count = static_cast<std::uint32_t>(framework::EPresentProfile::Count);
+	const auto next	 = static_cast<framework::EPresentProfile>(
+		(static_cast<std::uint32_t>(m_pRender->GetPresentProfile()) + 1u) % count);
+
+	//~ no frame may hold a back buffer while the swap chain goes away
+	m_pFramePipeline->Flush();
+	m_pRender->SetPresentProfile(next);
+
+	m_nNextBackBuffer = m_pRender->m_nCurrentBackBuffer;
+	m_latency.Reset();
+	logger::debug("Called Present Profile to: {}", framework::ToString(next));
 }
 
-void DrawShapes::UpdateObjectCBs(float deltaTime)
+void DrawShapes::UpdateObjectCBs(float deltaTime, FrameResource* frame)
 {
-	auto currentObjectCB = m_pCurrentFrameResource->ObjectCB.get();
+	m_transforms.Update(m_pRender->m_pJobSystem.get());
 
-	for (auto& item: m_ppRenderItems)
+	//~ a changed world is stale in every in-flight copy, each frame resource clears its own bit on upload
+	if (m_transforms.GetChangedCount() > 0u)
 	{
-			DirectX::XMMATRIX world = XMLoadFloat4x4(&item->World);
-			auto* windows = m_pRender->m_pWindowsManager;
-			auto& mouse = windows->Mouse;
-			int x, y;
-			mouse.GetMousePosition(x, y);
+		for (const auto& item : m_renderItems)
+		{
+			if (!m_transforms.HasWorldChanged(item.Transform)) continue;
+			for (UINT i = 0u; i < m_pFrameRing->GetDepth(); ++i)
+			{
+				m_pFrameRing->GetContext(i).MarkObjectDirty(item.ObjectCBIndex);
+			}
+		}
+	}
 
-			ConstantData data{};
-			DirectX::XMStoreFloat4x4(&data.World, DirectX::XMMatrixTranspose(world));
-			data.MousePosition = { static_cast<float>(x), static_cast<float>(y) };
-			data.Resolution.x = windows->GetWindowsWidth();
-			data.Resolution.y = windows->GetWindowsHeight();
-			data.TimeElapsed  = m_nTimeElapsed;
-			
-			currentObjectCB->CopyData(item->ObjectCBIndex, data);
-			--item->FramesDirty;
-		
+	auto currentObjectCB  = frame->ObjectCB.get();
+	auto currentInstances = frame->InstanceBuffer.get();
+	const auto& slots	  = m_instanceBatcher.GetInstanceSlots();
+	auto& dirtyBits		  = frame->ObjectDirtyBits;
+	const bool rootConstants = nObjectBinding == framework::EObjectBinding::RootConstants;
+
+	UINT uploads = 0u;
+	for (size_t word = 0; word < dirtyBits.size(); ++word)
+	{
+		//~ walk only the set bits, clean words cost one compare
+		std::uint64_t bits = dirtyBits[ word ];
+		while (bits)
+		{
+			UINT index = static_cast<UINT>(word * 64u) + static_cast<UINT>(std::countr_zero(bits));
+			bits &= bits - 1ull;
+
+			//~ straight into the mapped upload heap, no staging ConstantData. Both paths
+			//~ are kept current so toggling instancing never shows a stale world
+			const auto transform = m_renderItems[ index ].Transform;
+			m_transforms.StreamWorldTransposed(transform, currentObjectCB ->GetMappedElement(index));
+			m_transforms.StreamWorldTransposed(transform, currentInstances->GetMappedElement(slots[ index ]));
+
+			//~ the record stage reads this back, keep it in cache instead of reading write combined memory
+			if (rootConstants) m_transforms.WriteWorldTransposed(transform, &frame->ObjectConstants[ index ]);
+			++uploads;
+		}
+		dirtyBits[ word ] = 0ull;
 	}
+	framework::StreamFence();
+
+	m_uploadStats.ObjectCount = uploads;
+	m_uploadStats.ObjectBytes	= uploads * sizeof(ConstantData);
+	m_uploadStats.InstanceBytes = uploads * sizeof(InstanceData);
 }
 
-void DrawShapes::UpdateMainPassCB(float deltaTime)
+void DrawShapes::UpdateMainPassCB(float deltaTime, FrameResource* frame)
 {
 	using namespace DirectX;
 
@@ -272,7 +615,6 @@ void DrawShapes::UpdateMainPassCB(float deltaTime)
 	XMStoreFloat4x4(&m_mainPassCB.gInvViewProj, XMMatrixTranspose(invViewProj));
 
 	m_mainPassCB.gEyePosW = m_eyePos;
-	m_mainPassCB.cbPerObjectPad1 = 0.0f;
 
 	auto* windows = m_pRender->m_pWindowsManager;
 	float w = static_cast<float>(windows->GetWindowsWidth());
@@ -286,74 +628,257 @@ void DrawShapes::UpdateMainPassCB(float deltaTime)
 	m_mainPassCB.gTotalTime = m_nTimeElapsed;
 	m_mainPassCB.gDeltaTime = deltaTime;
 
-	auto currPassCB = m_pCurrentFrameResource->PassCB.get();
-	currPassCB->CopyData(0, m_mainPassCB);
+	int x = 0, y = 0;
+	windows->Mouse.GetMousePosition(x, y);
+	m_mainPassCB.gMousePosition = DirectX::XMFLOAT2(static_cast<float>(x), static_cast<float>(y));
+
+	//~ the CBV reads whole 256 byte slots, the padding belongs to the allocation too
+	const auto upload = frame->Uploads->Allocate(nPassCBByteSize, framework::UPLOAD_ALIGN_CONSTANT);
+	if (!upload.IsValid())
+	{
+		//~ the frame only clears, the packet and record stages skip draws without pass constants
+		logger::warning("Upload ring exhausted, frame skips its draws. Raise nUploadRingSize");
+		frame->PassCBAddress = 0u;
+		return;
+	}
+
+	framework::StreamCopy(upload.Cpu, &m_mainPassCB, sizeof(PassConstants));
+	framework::StreamFence();
+	frame->PassCBAddress = upload.Gpu;
+
+	m_uploadStats.PassBytes = nPassCBByteSize;
+}
+
+void DrawShapes::UpdateItemDepths(FrameResource* frame)
+{
+	using namespace DirectX;
+
+	//~ transforms are only stable on this stage, later stages sort on this snapshot
+	const XMMATRIX view = XMLoadFloat4x4(&m_view);
+	frame->ItemDepths.resize(m_renderItems.size());
+	for (const auto& item : m_renderItems)
+	{
+		const auto& world = m_transforms.GetWorld(item.Transform);
+		const XMVECTOR position = XMVectorSet(world._41, world._42, world._43, 1.0f);
+		frame->ItemDepths[ item.ObjectCBIndex ] = XMVectorGetZ(XMVector3TransformCoord(position, view));
+	}
+}
+
+void DrawShapes::CullRenderItems(FrameResource* frame)
+{
+	using namespace DirectX;
+
+	//~ only moved items need new world bounds, Update already ran this frame
+	const bool buildBvh = m_sceneBvh.IsEmpty();
+	for (const auto& item : m_renderItems)
+	{
+		if (!m_transforms.HasWorldChanged(item.Transform)) continue;
+
+		XMFLOAT3 center{}, extents{};
+		framework::TransformBounds(item.BoundsCenter, item.BoundsExtents, m_transforms.GetWorld(item.Transform), center, extents);
+		m_culler.SetWorldBounds(item.ObjectCBIndex, center, extents);
+
+		m_itemBounds[ item.ObjectCBIndex ] = framework::MakeBoundingBox(center, extents);
+		if (!buildBvh) m_sceneBvh.UpdateBounds(item.ObjectCBIndex, m_itemBounds[ item.ObjectCBIndex ]);
+	}
+
+	//~ the first frame sees every item as changed, build once and refit afterwards
+	if (buildBvh) m_sceneBvh.Build(m_itemBounds, m_pRender->m_pJobSystem.get());
+	else		  m_sceneBvh.Refit();
+
+	if (m_bPickRequested)
+	{
+		PickRenderItem();
+		m_bPickRequested = false;
+	}
+
+	XMFLOAT4X4 viewProj{};
+	XMStoreFloat4x4(&viewProj, XMMatrixMultiply(XMLoadFloat4x4(&m_view), XMLoadFloat4x4(&m_proj)));
+	m_culler.Cull(framework::ExtractFrustumPlanes(viewProj), m_pRender->m_pJobSystem.get());
+
+	//~ snapshot for the packet stage, the culler is reused by the next frame
+	const auto& visibility = m_culler.GetVisibility();
+	frame->ItemVisible.assign(visibility.begin(), visibility.begin() + m_culler.GetCount());
+
+	if (m_bOcclusion) OcclusionCull(frame, viewProj);
+
+	frame->DebugLines = {};
+	if (m_bDebugBounds) BuildDebugBounds(frame);
+}
+
+void DrawShapes::BuildDebugBounds(FrameResource* frame)
+{
+	using namespace DirectX;
+
+	static constexpr std::uint16_t boxEdges[ 24 ]
+	{
+		0, 1, 1, 3, 3, 2, 2, 0, //~ min z face
+		4, 5, 5, 7, 7, 6, 6, 4, //~ max z face
+		0, 4, 1, 5, 2, 6, 3, 7	//~ connecting edges
+	};
+
+	const auto& visible = frame->ItemVisible;
+	//~ 16 bit indices, boxes past the limit are dropped by the batch
+	const UINT count = (std::min)(static_cast<UINT>(std::count_if(visible.begin(), visible.end(), [](std::uint8_t v) { return v != 0u; })),
+								  0x10000u / 8u);
+	if (count == 0u) return;
+
+	//~ written straight into upload memory, one box at a time
+	framework::DynamicGeometryBatch batch{};
+	if (!batch.Begin(*frame->DynamicGeometry, count * 8u, sizeof(Vertex), count * 24u)) return;
+
+	for (const auto& item : m_renderItems)
+	{
+		if (!visible[ item.ObjectCBIndex ]) continue;
+
+		const auto& box	  = m_itemBounds[ item.ObjectCBIndex ];
+		const XMFLOAT4 color = item.Occluder ? XMFLOAT4(1.0f, 0.55f, 0.1f, 1.0f) : XMFLOAT4(0.2f, 1.0f, 0.3f, 1.0f);
+
+		Vertex corners[ 8 ]{};
+		for (UINT corner = 0u; corner < 8u; ++corner)
+		{
+			corners[ corner ].Position = { corner & 1u ? box.Max.x : box.Min.x,
+										   corner & 2u ? box.Max.y : box.Min.y,
+										   corner & 4u ? box.Max.z : box.Min.z };
+			corners[ corner ].Color	   = color;
+		}
+		batch.AppendIndices(boxEdges, 24u, batch.AppendVertices(corners, 8u));
+	}
+	frame->DebugLines = batch.End();
+}
+
+void DrawShapes::OcclusionCull(FrameResource* frame, const DirectX::XMFLOAT4X4& viewProj)
+{
+	auto& visible = frame->ItemVisible;
+
+	//~ only occluders that survived the frustum can hide anything
+	m_occlusion.Begin(viewProj);
+	for (const auto& item : m_renderItems)
+	{
+		if (!item.Occluder || !visible[ item.ObjectCBIndex ]) continue;
+		m_occlusion.RasterizeOccluder(m_occluderPositions.data(), static_cast<std::uint32_t>(m_occluderPositions.size()),
+									  m_occluderIndices.data(),	  static_cast<std::uint32_t>(m_occluderIndices.size()),
+									  m_transforms.GetWorld(item.Transform));
+	}
+	m_occlusion.Finalize();
+
+	if (m_occlusion.GetLastStats().Occluders == 0u) return;
+	for (const auto& item : m_renderItems)
+	{
+		if (item.Occluder || !visible[ item.ObjectCBIndex ]) continue;
+		if (m_occlusion.TestOccludee(m_itemBounds[ item.ObjectCBIndex ])) visible[ item.ObjectCBIndex ] = 0u;
+	}
+}
+
+void DrawShapes::PickRenderItem()
+{
+	using namespace DirectX;
+
+	//~ the view matrix rows hold the camera axes, the third column is forward
+	const XMFLOAT3 forward{ m_view._13, m_view._23, m_view._33 };
+
+	framework::BVH_RAY_HIT hit{};
+	if (!m_sceneBvh.Raycast(m_eyePos, forward, nFarZ, hit))
+	{
+		logger::info("Pick: nothing under the crosshair");
+		return;
+	}
+
+	const auto& box = m_sceneBvh.GetBounds(hit.Object);
+	logger::info("Pick: item {} at {:.2f}, bounds ({:.2f}, {:.2f}, {:.2f}) - ({:.2f}, {:.2f}, {:.2f})",
+				 hit.Object, hit.Distance, box.Min.x, box.Min.y, box.Min.z, box.Max.x, box.Max.y, box.Max.z);
 }
 
 void DrawShapes::BuildDescriptorHeaps()
 {
-	UINT counts		  = static_cast<UINT>(m_ppOpaqueItems.size());
-	UINT nDescriptors = (counts + 1u) * nFrameResourcesMaxCount;
-	m_nPassCBOffset   = counts * nFrameResourcesMaxCount;
+	assert(nFrameResourcesMaxCount <= m_pRender->DESCRIPTOR_FRAME_COUNT && "More frames than transient descriptor slices!");
 
-	D3D12_DESCRIPTOR_HEAP_DESC desc{};
-	desc.Flags			= D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-	desc.Type			= D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	desc.NodeMask		= 0u;
-	desc.NumDescriptors = nDescriptors;
+	//~ root CBVs and root constants bind objects without descriptors
+	if (nObjectBinding != framework::EObjectBinding::DescriptorTable) return;
 
-	THROW_DX_IF_FAILS(m_pRender->m_pDevice->CreateDescriptorHeap(
-		&desc,
-		IID_PPV_ARGS(&m_pCbHeap)));
+	//~ object CBVs live as long as the layer, the pass CBVs are transient
+	const UINT counts = static_cast<UINT>(m_ppOpaqueItems.size());
+	m_objectCbvs = m_pRender->m_pDescriptorHeap->GetAllocator().AllocatePersistent(counts * nFrameResourcesMaxCount);
+	assert(m_objectCbvs.IsValid() && "Global descriptor heap is full!");
 }
 
 void DrawShapes::BuildConstantBufferViews()
 {
+	if (!m_objectCbvs.IsValid()) return;
+
 	UINT objCBByteSize = (static_cast<UINT>(sizeof(ConstantData)) + 255u) & ~255u;
 
 	UINT objCount = static_cast<UINT>(m_ppOpaqueItems.size());
 
 	auto* device = m_pRender->m_pDevice.Get();
+	auto* heap	 = m_pRender->m_pDescriptorHeap.get();
 
-	for (int frameIndex = 0; frameIndex < nFrameResourcesMaxCount; ++frameIndex)
+	for (UINT frameIndex = 0u; frameIndex < m_pFrameRing->GetDepth(); ++frameIndex)
 	{
-		auto objectCB = m_ppFrameResources[ frameIndex ]->ObjectCB->GetResource();
+		auto objectCB = m_pFrameRing->GetContext(frameIndex).ObjectCB->GetResource();
 		for (UINT i = 0; i < objCount; ++i)
 		{
 			D3D12_GPU_VIRTUAL_ADDRESS cbAddress = objectCB->GetGPUVirtualAddress();
 
 			cbAddress += i * objCBByteSize;
 
-			int heapIndex = frameIndex * objCount + i;
-			auto handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_pCbHeap->GetCPUDescriptorHandleForHeapStart());
-			handle.Offset(heapIndex, m_pRender->m_nCbvSrvUavDescriptorSize);
+			UINT heapIndex = m_objectCbvs.Index + frameIndex * objCount + i;
 
 			D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
 			cbvDesc.BufferLocation = cbAddress;
 			cbvDesc.SizeInBytes = objCBByteSize;
 
-			device->CreateConstantBufferView(&cbvDesc, handle);
+			device->CreateConstantBufferView(&cbvDesc, heap->GetCpuHandle(heapIndex));
 		}
 	}
+}
 
-	UINT passCBByteSize = (static_cast<UINT>(sizeof(PassConstants)) + 255u) & ~255u;
+void DrawShapes::BuildPassDescriptor(UINT frameIndex, FrameResource* frame)
+{
+	auto* heap		 = m_pRender->m_pDescriptorHeap.get();
+	auto& allocator = heap->GetAllocator();
 
-	// Last three descriptors are the pass CBVs for each frame resource.
-	for (UINT frameIndex = 0; frameIndex < nFrameResourcesMaxCount; ++frameIndex)
-	{
-		auto passCB = m_ppFrameResources[ frameIndex ]->PassCB->GetResource();
-		D3D12_GPU_VIRTUAL_ADDRESS cbAddress = passCB->GetGPUVirtualAddress();
+	//~ the frame fence was waited on, the slot's transient slice is free again
+	const bool began = allocator.BeginFrame(frameIndex, m_pRender->m_pRenderDevice->GetCompletedFenceValue());
+	assert(began && "Transient descriptors reused before the GPU finished with them!");
+	(void)began;
+
+	const auto range = allocator.AllocateTransient(frameIndex, 1u);
+	assert(range.IsValid() && "Transient descriptor slice is full!");
+	frame->PassCbv = range.Index;
+	if (!frame->PassCBAddress) return; //~ ring was full, nothing draws this frame
 
-		// Offset to the pass cbv in the descriptor heap.
-		UINT heapIndex = m_nPassCBOffset + frameIndex;
-		auto handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_pCbHeap->GetCPUDescriptorHandleForHeapStart());
-		handle.Offset(heapIndex, m_pRender->m_nCbvSrvUavDescriptorSize);
+	D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
+	cbvDesc.BufferLocation = frame->PassCBAddress;
+	cbvDesc.SizeInBytes	   = nPassCBByteSize;
+
+	m_pRender->m_pDevice->CreateConstantBufferView(&cbvDesc, heap->GetCpuHandle(range.Index));
+}
+
+void DrawShapes::ValidateShaderLayouts()
+{
+	//~ cbuffers are generated from the sources, check the sources did not move on since
+	for (const auto* layout : { &PassConstantsLayout, &ConstantDataLayout, &ObjectIdConstantsLayout })
+	{
+		const auto errors = framework::ValidateGeneratedLayout(*layout);
+		for (const auto& error : errors) logger::warning("Layout {}: {}", layout->ConstantBuffer, error);
+		assert(errors.empty() && "Generated cbuffer layout is out of date!");
+	}
 
-		D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
-		cbvDesc.BufferLocation = cbAddress;
-		cbvDesc.SizeInBytes    = passCBByteSize;
+	//~ structured buffers are not generated, declaration order of shaders/chapter_7/*.hlsl
+	std::vector<framework::SHADER_LAYOUT_REPORT> reports{};
+	reports.push_back(framework::ValidateShaderLayout("gObjects", framework::EShaderBufferLayout::StructuredBuffer,
+		{ SHADER_FIELD_OF(ConstantData, World, Float4x4) }, sizeof(ConstantData)));
+	reports.push_back(framework::ValidateShaderLayout("gInstances", framework::EShaderBufferLayout::StructuredBuffer,
+		{ SHADER_FIELD_OF(InstanceData, World, Float4x4) }, sizeof(InstanceData)));
 
-		device->CreateConstantBufferView(&cbvDesc, handle);
+	for (const auto& report : reports)
+	{
+		logger::debug("Layout {}: {} bytes, stride {}, {} bytes padding",
+					  report.Name, report.ShaderSize, report.Stride, report.PaddingBytes);
+		for (const auto& warning : report.Warnings) logger::debug("Layout {}: {}", report.Name, warning);
+		for (const auto& error	 : report.Errors)	logger::warning("Layout {}: {}", report.Name, error);
+		assert(report.IsValid() && "Host struct does not match the shader layout!");
 	}
 }
 
@@ -365,12 +890,40 @@ void DrawShapes::BuildRootSignature()
 	CD3DX12_DESCRIPTOR_RANGE cbvTable1;
 	cbvTable1.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 1);
 
-	CD3DX12_ROOT_PARAMETER slotRootParameter[ 2 ];
+	CD3DX12_ROOT_PARAMETER slotRootParameter[ 6 ];
 
-	slotRootParameter[ 0 ].InitAsDescriptorTable(1, &cbvTable0);
+	//~ b0, only the vertex shader reads the object constants
+	static_assert(sizeof(ConstantData) / 4u <= framework::MAX_OBJECT_ROOT_CONSTANTS, "Object constants too large for the root signature");
+	switch (nObjectBinding)
+	{
+	case framework::EObjectBinding::DescriptorTable:
+		slotRootParameter[ 0 ].InitAsDescriptorTable(1, &cbvTable0);
+		break;
+	case framework::EObjectBinding::RootCbv:
+		slotRootParameter[ 0 ].InitAsConstantBufferView(0, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+		break;
+	case framework::EObjectBinding::RootConstants:
+		slotRootParameter[ 0 ].InitAsConstants(sizeof(ConstantData) / 4u, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+		break;
+	case framework::EObjectBinding::StructuredBuffer:
+		slotRootParameter[ 0 ].InitAsConstants(1, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX); //~ ObjectIdConstants::gObjectId
+		break;
+	default:
+		assert(false && "Unknown object binding!");
+		break;
+	}
 	slotRootParameter[ 1 ].InitAsDescriptorTable(1, &cbvTable1);
 
-	CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(2, slotRootParameter, 0, nullptr,
+	//~ instanced path: instance buffer at t0, the batch base slot at b2 and the
+	//~ compacted visible slots at t1
+	slotRootParameter[ 2 ].InitAsShaderResourceView(0, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+	slotRootParameter[ 3 ].InitAsConstants(1, 2, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+	slotRootParameter[ 4 ].InitAsShaderResourceView(1, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+
+	//~ bindless objects at t2, bound once per frame
+	slotRootParameter[ 5 ].InitAsShaderResourceView(2, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+
+	CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(6, slotRootParameter, 0, nullptr,
 											D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
 	Microsoft::WRL::ComPtr<ID3DBlob> serializedRootSig = nullptr;
@@ -384,26 +937,47 @@ void DrawShapes::BuildRootSignature()
 	}
 	THROW_DX_IF_FAILS(hr);
 
-	THROW_DX_IF_FAILS(m_pRender->m_pDevice->CreateRootSignature(
-		0,
-		serializedRootSig->GetBufferPointer(),
-		serializedRootSig->GetBufferSize(),
-		IID_PPV_ARGS(m_pRootSignature.GetAddressOf())));
+	m_pRootSignature = m_pRender->m_pPipelineCache->CreateRootSignature(serializedRootSig.Get());
+
+	logger::info("Object binding: {}", framework::ToString(nObjectBinding));
 }
 
 void DrawShapes::BuildShaders()
 {
-	m_compiledShaders[ "standardVS" ] = framework::CompileShader(
-		L"shaders/chapter_7/vertex.hlsl",
-		nullptr,
-		"main",
-		"vs_5_0");
+	const auto flags	= framework::DxShaderCompiler::GetDefaultFlags();
+	const bool bindless = nObjectBinding == framework::EObjectBinding::StructuredBuffer;
+
+	//~ the per item path reads the world from the object buffer in bindless mode
+	const auto standardPermutation = StandardVSPermutation{}.With(EStandardVSFeature::ObjectBuffer, bindless);
+	const auto standardDefines	   = STANDARD_VS_FEATURES.ToDefines(standardPermutation);
+	logger::debug("Standard VS permutation: {}", STANDARD_VS_FEATURES.ToString(standardPermutation));
+
+	const std::vector<std::pair<std::string, framework::SHADER_COMPILE_DESC>> shaders
+	{
+		{ "standardVS",	 { "shaders/chapter_7/vertex.hlsl",			  "main", "vs_5_0", standardDefines, flags } },
+		{ "instancedVS", { "shaders/chapter_7/vertex_instanced.hlsl", "main", "vs_5_0", {},				 flags } },
+		{ "debugVS",	 { "shaders/chapter_7/vertex_debug.hlsl",	  "main", "vs_5_0", {},				 flags } },
+		{ "opaquePS",	 { "shaders/chapter_7/pixel.hlsl",			  "main", "ps_5_0", {},				 flags } },
+	};
+
+	std::vector<framework::SHADER_COMPILE_DESC> descs{};
+	for (const auto& [name, desc] : shaders)
+	{
+		descs.push_back(desc);
+		m_shaderDescs[ name ] = desc; //~ hot reload compiles them again
+	}
+
+	const auto compiled = m_pRender->m_pShaderCache->CompileAll(descs);
+	for (std::size_t i = 0u; i < shaders.size(); ++i)
+	{
+		m_compiledShaders[ shaders[ i ].first ] = framework::ToShaderBlob(compiled[ i ]);
+		logger::debug("Shader {} ({}): {}", shaders[ i ].first, framework::ToString(compiled[ i ].Source),
+					  shaders[ i ].second.Path.string());
+	}
 
-	m_compiledShaders[ "opaquePS" ] = framework::CompileShader(
-		L"shaders/chapter_7/pixel.hlsl",
-		nullptr,
-		"main",
-		"ps_5_0");
+	const auto stats = m_pRender->m_pShaderCache->GetStats();
+	logger::info("Shaders: {} requested, {} from memory, {} from disk, {} compiled, {} failed, hash {:.2f} ms, compile {:.2f} ms",
+				 stats.Requests, stats.MemoryHits, stats.DiskHits, stats.Compiled, stats.Failed, stats.HashMs, stats.CompileMs);
 }
 
 void DrawShapes::BuildInputLayout()
@@ -423,7 +997,6 @@ void DrawShapes::BuildInputLayout()
 
 void DrawShapes::BuildGeometry()
 {
-	auto* device = m_pRender->m_pDevice.Get();
 	using namespace DirectX;
 	GeometryGenerator geoGen;
 	GeometryGenerator::MeshData box = geoGen.CreateBox(1.5f, 0.5f, 1.5f, 3);
@@ -431,6 +1004,11 @@ void DrawShapes::BuildGeometry()
 	GeometryGenerator::MeshData sphere = geoGen.CreateSphere(0.5f, 20, 20);
 	GeometryGenerator::MeshData cylinder = geoGen.CreateSphere(0.5f, 20, 20);
 
+	//~ boxes are the occluders, the software rasterizer keeps its own copy of the mesh
+	m_occluderPositions.clear();
+	for (const auto& v : box.Vertices) m_occluderPositions.push_back(v.Position);
+	m_occluderIndices = box.Indices32;
+
 	UINT boxVertexOffset = 0;
 	UINT gridVertexOffset = (UINT)box.Vertices.size();
 	UINT sphereVertexOffset = gridVertexOffset + (UINT)grid.Vertices.size();
@@ -446,21 +1024,33 @@ void DrawShapes::BuildGeometry()
 	boxSubmesh.IndexCount = (UINT)box.Indices32.size();
 	boxSubmesh.StartIndex = boxIndexOffset;
 	boxSubmesh.BaseVertex = boxVertexOffset;
+	boxSubmesh.BoundsCenter  = box.BoundsCenter;
+	boxSubmesh.BoundsExtents = box.BoundsExtents;
+	boxSubmesh.BoundsRadius  = box.BoundsRadius;
 
 	framework::SubmeshGeometry gridSubmesh;
 	gridSubmesh.IndexCount = (UINT)grid.Indices32.size();
 	gridSubmesh.StartIndex = gridIndexOffset;
 	gridSubmesh.BaseVertex = gridVertexOffset;
+	gridSubmesh.BoundsCenter  = grid.BoundsCenter;
+	gridSubmesh.BoundsExtents = grid.BoundsExtents;
+	gridSubmesh.BoundsRadius  = grid.BoundsRadius;
 
 	framework::SubmeshGeometry sphereSubmesh;
 	sphereSubmesh.IndexCount = (UINT)sphere.Indices32.size();
 	sphereSubmesh.StartIndex = sphereIndexOffset;
 	sphereSubmesh.BaseVertex = sphereVertexOffset;
+	sphereSubmesh.BoundsCenter  = sphere.BoundsCenter;
+	sphereSubmesh.BoundsExtents = sphere.BoundsExtents;
+	sphereSubmesh.BoundsRadius  = sphere.BoundsRadius;
 
 	framework::SubmeshGeometry cylinderSubmesh;
 	cylinderSubmesh.IndexCount = (UINT)cylinder.Indices32.size();
 	cylinderSubmesh.StartIndex = cylinderIndexOffset;
 	cylinderSubmesh.BaseVertex = cylinderVertexOffset;
+	cylinderSubmesh.BoundsCenter  = cylinder.BoundsCenter;
+	cylinderSubmesh.BoundsExtents = cylinder.BoundsExtents;
+	cylinderSubmesh.BoundsRadius  = cylinder.BoundsRadius;
 
 	auto totalVertexCount =
 		box.Vertices.size() +
@@ -513,19 +1103,11 @@ void DrawShapes::BuildGeometry()
 	THROW_DX_IF_FAILS(D3DCreateBlob(ibByteSize, &geo->IndexBlob));
 	CopyMemory(geo->IndexBlob->GetBufferPointer(), indices.data(), ibByteSize);
 
-	auto* cmdList = m_pRender->m_pCommandList.Get();
-
-	geo->VertexResource = framework::CreateDefaultBuffer(device,
-														 cmdList,
-														 vertices.data(),
-														 vbByteSize,
-														 geo->VertexResourceUploader);
-
-	geo->IndexResource = framework::CreateDefaultBuffer(device,
-														cmdList,
-														indices.data(),
-														ibByteSize,
-														geo->IndexResourceUploader);
+	//~ both buffers go out in one copy queue batch, the direct queue waits on it before the first draw
+	auto* uploads = m_pRender->m_pUploadManager.get();
+	geo->VertexResource = uploads->CreateBuffer(vertices.data(), vbByteSize);
+	geo->IndexResource	= uploads->CreateBuffer(indices.data(), ibByteSize);
+	uploads->QueueWait(m_pRender->m_pCommandQueue.Get(), uploads->Submit());
 
 	geo->VertexByteStride = sizeof(Vertex);
 	geo->VertexBufferByteSize = vbByteSize;
@@ -540,21 +1122,22 @@ void DrawShapes::BuildGeometry()
 	m_geometries[ geo->Name ] = std::move(geo);
 }
 
-void DrawShapes::BuildPipeline()
+std::vector<std::pair<std::string, D3D12_GRAPHICS_PIPELINE_STATE_DESC>> DrawShapes::BuildPipelineDescs(
+	const ShaderBlobs& shaders) const
 {
+	const auto bytecode = [&shaders](const char* name) -> D3D12_SHADER_BYTECODE
+	{
+		const auto& blob = shaders.at(name);
+		return { blob->GetBufferPointer(), blob->GetBufferSize() };
+	};
+
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC opaquePsoDesc{};
 	ZeroMemory(&opaquePsoDesc, sizeof(D3D12_GRAPHICS_PIPELINE_STATE_DESC));
 
 	opaquePsoDesc.InputLayout = { m_inputLayout.data(), (UINT)m_inputLayout.size() };
 	opaquePsoDesc.pRootSignature = m_pRootSignature.Get();
-	opaquePsoDesc.VS = {
-		reinterpret_cast<BYTE*>(m_compiledShaders[ "standardVS" ]->GetBufferPointer()),
-		m_compiledShaders[ "standardVS" ]->GetBufferSize()
-	};
-	opaquePsoDesc.PS = {
-		reinterpret_cast<BYTE*>(m_compiledShaders[ "opaquePS" ]->GetBufferPointer()),
-		m_compiledShaders[ "opaquePS" ]->GetBufferSize()
-	};
+	opaquePsoDesc.VS = bytecode("standardVS");
+	opaquePsoDesc.PS = bytecode("opaquePS");
 
 	opaquePsoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
 	opaquePsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
@@ -569,134 +1152,385 @@ void DrawShapes::BuildPipeline()
 	opaquePsoDesc.SampleDesc.Quality = 0;
 	opaquePsoDesc.DSVFormat = m_pRender->m_depthStencilFormat;
 
-	THROW_DX_IF_FAILS(m_pRender->m_pDevice->CreateGraphicsPipelineState(
-		&opaquePsoDesc, IID_PPV_ARGS(&m_pso[ "opaque" ])));
-
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC opaqueWireframePsoDesc = opaquePsoDesc;
 	opaqueWireframePsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_WIREFRAME;
 
-	THROW_DX_IF_FAILS(m_pRender->m_pDevice->CreateGraphicsPipelineState(
-		&opaqueWireframePsoDesc, IID_PPV_ARGS(&m_pso[ "opaque_wireframe" ])));
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC instancedPsoDesc = opaquePsoDesc;
+	instancedPsoDesc.VS = bytecode("instancedVS");
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC instancedWireframePsoDesc = instancedPsoDesc;
+	instancedWireframePsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_WIREFRAME;
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC debugLinesPsoDesc = opaquePsoDesc;
+	debugLinesPsoDesc.VS = bytecode("debugVS");
+	debugLinesPsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE;
+
+	return {
+		{ "opaque",						opaquePsoDesc },
+		{ "opaque_wireframe",			opaqueWireframePsoDesc },
+		{ "opaque_instanced",			instancedPsoDesc },
+		{ "opaque_instanced_wireframe", instancedWireframePsoDesc },
+		{ "debug_lines",				debugLinesPsoDesc }
+	};
 }
 
-void DrawShapes::BuildFrameResources()
+void DrawShapes::BuildPipeline()
+{
+	//~ the variants compile side by side on the job system
+	auto* cache = m_pRender->m_pPipelineCache.get();
+	std::vector<std::pair<std::string, std::shared_future<ID3D12PipelineState*>>> pending{};
+
+	for (const auto& [name, desc] : BuildPipelineDescs(m_compiledShaders))
+	{
+		pending.emplace_back(name, cache->GetOrCreateAsync(desc));
+	}
+
+	for (auto& [name, ready] : pending)
+	{
+		m_pso[ name ] = ready.get();
+	}
+
+	const auto stats = cache->GetStats();
+	logger::info("Pipelines: {} requested, {} shared, {} from disk cache, {} compiled, {} rejected blobs, {:.2f} ms",
+				 stats.Requests, stats.Deduplicated, stats.WarmStarts, stats.Compiled, stats.RejectedBlobs, stats.CreateMs);
+}
+
+void DrawShapes::BuildHotReload()
+{
+	for (const auto& [name, desc] : m_shaderDescs)
+	{
+		std::vector<std::filesystem::path> dependencies{};
+		m_pRender->m_pShaderCache->ComputeKey(desc, &dependencies);
+		m_shaderReload.Register(name, dependencies);
+	}
+
+	m_pShaderWatcher = std::make_unique<framework::FileWatcher>(SHADER_DIRECTORY);
+	if (m_pShaderWatcher->IsValid())
+	{
+		logger::info("Shader hot reload watching {}", SHADER_DIRECTORY);
+	}
+	else
+	{
+		logger::warning("Shader hot reload disabled, cannot watch {}", SHADER_DIRECTORY);
+	}
+}
+
+void DrawShapes::PollShaderReload()
+{
+	const auto now = framework::HotReloadScheduler::Clock::now();
+	if (m_pShaderWatcher)
+	{
+		for (const auto& file : m_pShaderWatcher->Poll()) m_shaderReload.OnFileChanged(file, now);
+	}
+
+	if (m_pendingReload.valid())
+	{
+		if (m_pendingReload.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+		ApplyShaderReload(m_pendingReload.get());
+	}
+
+	auto due = m_shaderReload.TakeDue(now);
+	if (due.empty()) return;
+
+	//~ the live blobs are copied, the worker only replaces the ones it compiled
+	m_pendingReload = std::async(std::launch::async,
+		[this, programs = std::move(due), shaders = m_compiledShaders]() mutable
+	{
+		return ReloadShaders(programs, std::move(shaders));
+	});
+}
+
+SHADER_RELOAD DrawShapes::ReloadShaders(const std::vector<std::uint32_t>& programs, ShaderBlobs shaders)
+{
+	SHADER_RELOAD reload{};
+	std::vector<std::uint32_t> compiled{};
+
+	for (const auto program : programs)
+	{
+		const auto name = m_shaderReload.GetName(program);
+		const auto& desc = m_shaderDescs.at(name);
+
+		//~ an edit may have added or removed includes
+		std::vector<std::filesystem::path> dependencies{};
+		m_pRender->m_pShaderCache->ComputeKey(desc, &dependencies);
+		m_shaderReload.SetDependencies(program, dependencies);
+
+		const auto shader = m_pRender->m_pShaderCache->Compile(desc);
+		if (!shader.IsValid())
+		{
+			logger::error("Shader reload of {} failed, keeping the live one:\n{}", name, shader.Errors);
+			m_shaderReload.Complete(program, false);
+			continue;
+		}
+
+		shaders[ name ] = framework::ToShaderBlob(shader);
+		compiled.push_back(program);
+	}
+	if (compiled.empty()) return reload;
+
+	//~ a cbuffer edit needs a rebuild with regenerated structs, the host would write the old layout
+	for (const auto* layout : { &PassConstantsLayout, &ConstantDataLayout, &ObjectIdConstantsLayout })
+	{
+		const auto errors = framework::ValidateGeneratedLayout(*layout);
+		if (errors.empty()) continue;
+
+		for (const auto& error : errors) logger::error("Shader reload rejected, {}", error);
+		for (const auto program : compiled) m_shaderReload.Complete(program, false);
+		return reload;
+	}
+
+	//~ unchanged variants come back from the pipeline cache as the live object
+	bool created = true;
+	try
+	{
+		for (const auto& [name, desc] : BuildPipelineDescs(shaders))
+		{
+			reload.Pipelines[ name ] = m_pRender->m_pPipelineCache->GetOrCreate(desc);
+		}
+	}
+	catch (const std::exception& error)
+	{
+		logger::error("Shader reload could not create its pipelines, keeping the live ones: {}", error.what());
+
+		//~ the variants created before the failure would stay in the cache, the live ones keep their entry
+		for (const auto& [name, pipeline] : reload.Pipelines)
+		{
+			const auto live = m_pso.find(name);
+			if (live != m_pso.end() && live->second.Get() == pipeline.Get()) continue;
+			m_pRender->m_pPipelineCache->Release(pipeline.Get());
+		}
+		reload.Pipelines.clear();
+		created = false;
+	}
+
+	for (const auto program : compiled) m_shaderReload.Complete(program, created);
+	if (created) reload.Shaders = std::move(shaders);
+	return reload;
+}
+
+void DrawShapes::ApplyShaderReload(SHADER_RELOAD&& reload)
 {
-	for (int i = 0; i < nFrameResourcesMaxCount; ++i)
+	const auto ready = m_shaderReload.TakeReady();
+	if (ready.empty() || reload.Pipelines.empty()) return;
+
+	//~ later stages read m_pso from their own threads, swap with the pipeline drained
+	m_pFramePipeline->Flush();
+
+	//~ the old pipelines may still be used by any submitted frame
+	const UINT64 lastFence = m_pFrameRing->GetLastFence();
+
+	UINT swapped = 0u;
+	for (auto& [name, pipeline] : reload.Pipelines)
 	{
-		m_ppFrameResources.push_back(std::make_unique<FrameResource>
-									 (m_pRender->m_pDevice.Get(),
-										1u,
-									  (UINT)m_ppRenderItems.size()));
+		auto& live = m_pso[ name ];
+		if (live.Get() == pipeline.Get()) continue;
+
+		m_retiredPipelines.Retire(std::move(live), lastFence);
+		live = std::move(pipeline);
+		++swapped;
 	}
+	m_compiledShaders = std::move(reload.Shaders);
+
+	logger::info("Shader reload: {} programs, {} pipelines swapped, {} waiting for the GPU",
+				 ready.size(), swapped, m_retiredPipelines.GetSize());
+}
+
+void DrawShapes::BuildFrameResources()
+{
+	//~ one recording lane per job system thread plus the record stage itself
+	UINT workers = std::min(m_pRender->m_pJobSystem->GetWorkerCount() + 1u, nMaxRecordWorkers);
+
+	//~ every frame in flight can hold its visible slots, the pass constants plus a partly used block, twice over
+	const UINT64 perFrame = m_renderItems.size() * sizeof(std::uint32_t) + nPassCBByteSize
+						  + framework::LinearUploadAllocator::DEFAULT_BLOCK_SIZE;
+	const UINT64 ringSize = std::max(nUploadRingSize, 2ull * nFrameResourcesMaxCount * perFrame);
+
+	m_pUploadMemory = std::make_unique<framework::DxUploadMemory>(m_pRender->m_pDevice.Get(), ringSize);
+	m_pUploadRing	= std::make_unique<framework::UploadRing>(m_pUploadMemory.get());
+
+	//~ the arena holds the unsorted packets of the frame, one per item at most
+	const std::size_t arenaBytes = m_renderItems.size() * sizeof(RenderPacket) + 4096u;
+
+	m_pFrameRing = std::make_unique<framework::FrameRing<FrameResource>>(
+		m_pRender->m_pRenderDevice->CreateFenceWaiter(), nFrameResourcesMaxCount, arenaBytes,
+		[&](std::uint32_t)
+		{
+			return std::make_unique<FrameResource>(m_pRender->m_pDevice.Get(),
+												   m_pRender->m_pGpuAllocator.get(),
+												   (UINT)m_renderItems.size(),
+												   workers,
+												   m_pUploadRing.get(),
+												   nObjectBinding == framework::EObjectBinding::StructuredBuffer);
+		});
+
+	const auto* objects = m_pFrameRing->GetContext(0u).ObjectCB.get();
+	logger::info("Object constants: {} bytes per object, {} bytes per frame",
+				 objects->GetElementByteSize(), objects->GetElementByteSize() * m_renderItems.size());
+}
+
+void DrawShapes::BuildFramePipeline()
+{
+	m_nNextBackBuffer = m_pRender->m_nCurrentBackBuffer;
+	m_pFramePipeline  = std::make_unique<framework::FramePipeline>(nFrameResourcesMaxCount);
+
+	using framework::FRAME_TICKET;
+	m_pFramePipeline->AddStage("Simulate",		[this](const FRAME_TICKET& t) { SimulateStage	 (t); });
+	m_pFramePipeline->AddStage("Build Packets", [this](const FRAME_TICKET& t) { BuildPacketsStage(t); });
+	m_pFramePipeline->AddStage("Record",		[this](const FRAME_TICKET& t) { RecordStage		 (t); });
+	m_pFramePipeline->AddStage("Submit",		[this](const FRAME_TICKET& t) { SubmitStage		 (t); });
+	m_pFramePipeline->Start();
 }
 
 void DrawShapes::BuildRenderItems()
 {
 	using namespace DirectX;
 
-	auto boxRitem = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&boxRitem->World, XMMatrixScaling(2.0f, 2.0f, 2.0f) * XMMatrixTranslation(0.0f, 0.5f, 0.0f));
-	boxRitem->ObjectCBIndex = 0;
-	boxRitem->Geometry = m_geometries[ "shapeGeo" ].get();
-	boxRitem->Topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	boxRitem->IndexCount = boxRitem->Geometry->Meshes[ "box" ].IndexCount;
-	boxRitem->StartIndexLocation = boxRitem->Geometry->Meshes[ "box" ].StartIndex;
-	boxRitem->BaseVertexLocation = boxRitem->Geometry->Meshes[ "box" ].BaseVertex;
-	m_ppRenderItems.push_back(std::move(boxRitem));
-
-	auto gridRitem = std::make_unique<RenderItem>();
-	gridRitem->World = MathHelper::Identity4x4();
-	gridRitem->ObjectCBIndex = 1;
-	gridRitem->Geometry = m_geometries[ "shapeGeo" ].get();
-	gridRitem->Topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	gridRitem->IndexCount = gridRitem->Geometry->Meshes[ "grid" ].IndexCount;
-	gridRitem->StartIndexLocation = gridRitem->Geometry->Meshes[ "grid" ].StartIndex;
-	gridRitem->BaseVertexLocation = gridRitem->Geometry->Meshes[ "grid" ].BaseVertex;
-	m_ppRenderItems.push_back(std::move(gridRitem));
-
-	UINT objCBIndex = 2;
-	for (int i = 0; i < 5; ++i)
-	{
-		auto leftCylRitem = std::make_unique<RenderItem>();
-		auto rightCylRitem = std::make_unique<RenderItem>();
-		auto leftSphereRitem = std::make_unique<RenderItem>();
-		auto rightSphereRitem = std::make_unique<RenderItem>();
-
-		XMMATRIX leftCylWorld = XMMatrixTranslation(-5.0f, 1.5f, -10.0f + i * 5.0f);
-		XMMATRIX rightCylWorld = XMMatrixTranslation(+5.0f, 1.5f, -10.0f + i * 5.0f);
-
-		XMMATRIX leftSphereWorld = XMMatrixTranslation(-5.0f, 3.5f, -10.0f + i * 5.0f);
-		XMMATRIX rightSphereWorld = XMMatrixTranslation(+5.0f, 3.5f, -10.0f + i * 5.0f);
-
-		XMStoreFloat4x4(&leftCylRitem->World, rightCylWorld);
-		leftCylRitem->ObjectCBIndex = objCBIndex++;
-		leftCylRitem->Geometry = m_geometries[ "shapeGeo" ].get();
-		leftCylRitem->Topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-		leftCylRitem->IndexCount = leftCylRitem->Geometry->Meshes[ "cylinder" ].IndexCount;
-		leftCylRitem->StartIndexLocation = leftCylRitem->Geometry->Meshes[ "cylinder" ].StartIndex;
-		leftCylRitem->BaseVertexLocation = leftCylRitem->Geometry->Meshes[ "cylinder" ].BaseVertex;
-
-		XMStoreFloat4x4(&rightCylRitem->World, leftCylWorld);
-		rightCylRitem->ObjectCBIndex = objCBIndex++;
-		rightCylRitem->Geometry = m_geometries[ "shapeGeo" ].get();
-		rightCylRitem->Topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-		rightCylRitem->IndexCount = rightCylRitem->Geometry->Meshes[ "cylinder" ].IndexCount;
-		rightCylRitem->StartIndexLocation = rightCylRitem->Geometry->Meshes[ "cylinder" ].StartIndex;
-		rightCylRitem->BaseVertexLocation = rightCylRitem->Geometry->Meshes[ "cylinder" ].BaseVertex;
-
-		XMStoreFloat4x4(&leftSphereRitem->World, leftSphereWorld);
-		leftSphereRitem->ObjectCBIndex = objCBIndex++;
-		leftSphereRitem->Geometry = m_geometries[ "shapeGeo" ].get();
-		leftSphereRitem->Topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-		leftSphereRitem->IndexCount = leftSphereRitem->Geometry->Meshes[ "sphere" ].IndexCount;
-		leftSphereRitem->StartIndexLocation = leftSphereRitem->Geometry->Meshes[ "sphere" ].StartIndex;
-		leftSphereRitem->BaseVertexLocation = leftSphereRitem->Geometry->Meshes[ "sphere" ].BaseVertex;
-
-		XMStoreFloat4x4(&rightSphereRitem->World, rightSphereWorld);
-		rightSphereRitem->ObjectCBIndex = objCBIndex++;
-		rightSphereRitem->Geometry = m_geometries[ "shapeGeo" ].get();
-		rightSphereRitem->Topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-		rightSphereRitem->IndexCount = rightSphereRitem->Geometry->Meshes[ "sphere" ].IndexCount;
-		rightSphereRitem->StartIndexLocation = rightSphereRitem->Geometry->Meshes[ "sphere" ].StartIndex;
-		rightSphereRitem->BaseVertexLocation = rightSphereRitem->Geometry->Meshes[ "sphere" ].BaseVertex;
-
-		m_ppRenderItems.push_back(std::move(leftCylRitem));
-		m_ppRenderItems.push_back(std::move(rightCylRitem));
-		m_ppRenderItems.push_back(std::move(leftSphereRitem));
-		m_ppRenderItems.push_back(std::move(rightSphereRitem));
-	}
-
-	for (auto& e : m_ppRenderItems)
-		m_ppOpaqueItems.push_back(e.get());
+	auto* geometry = m_geometries[ "shapeGeo" ].get();
+
+	//~ render items are stored contiguously, ObjectCBIndex == TransformId == slot
+	auto addItem = [&](const char* mesh, const XMFLOAT3& position, const XMFLOAT3& scale, bool occluder = false)
+	{
+		const auto& submesh = geometry->Meshes[ mesh ];
+
+		RenderItem item{};
+		item.Transform			= m_transforms.Create(position, { 0.f, 0.f, 0.f, 1.f }, scale);
+		item.ObjectCBIndex		= static_cast<UINT>(m_renderItems.size());
+		item.Geometry			= geometry;
+		item.GeometryId			= 0u; //~ single shared vertex/index buffer
+		item.BoundsCenter		= submesh.BoundsCenter;
+		item.BoundsExtents		= submesh.BoundsExtents;
+		item.Occluder			= occluder;
+		item.Topology			= D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+		item.IndexCount			= submesh.IndexCount;
+		item.StartIndexLocation = submesh.StartIndex;
+		item.BaseVertexLocation = submesh.BaseVertex;
+		m_renderItems.push_back(item);
+	};
+
+	constexpr UINT rows = 5u;
+	m_renderItems.reserve(2u + rows * 4u);
+	m_transforms .Reserve(2u + rows * 4u);
+
+	addItem("box",	{ 0.0f, 0.5f, 0.0f }, { 2.0f, 2.0f, 2.0f }, true);
+	addItem("grid", { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });
+
+	for (UINT i = 0; i < rows; ++i)
+	{
+		const float z = -10.0f + i * 5.0f;
+		addItem("cylinder", { +5.0f, 1.5f, z }, { 1.0f, 1.0f, 1.0f });
+		addItem("cylinder", { -5.0f, 1.5f, z }, { 1.0f, 1.0f, 1.0f });
+		addItem("sphere",	{ -5.0f, 3.5f, z }, { 1.0f, 1.0f, 1.0f });
+		addItem("sphere",	{ +5.0f, 3.5f, z }, { 1.0f, 1.0f, 1.0f });
+	}
+
+	//~ the vector is final from here on, pointers into it stay valid
+	for (auto& e : m_renderItems)
+		m_ppOpaqueItems.push_back(&e);
+
+	//~ items sharing geometry, submesh and topology collapse into one instanced draw
+	std::vector<framework::INSTANCE_KEY> keys{};
+	keys.reserve(m_ppOpaqueItems.size());
+	for (const auto* item : m_ppOpaqueItems)
+	{
+		framework::INSTANCE_KEY key{};
+		key.Geometry   = reinterpret_cast<std::uint64_t>(item->Geometry);
+		key.Pipeline   = static_cast<std::uint64_t>(item->Topology);
+		key.StartIndex = item->StartIndexLocation;
+		key.BaseVertex = item->BaseVertexLocation;
+		key.IndexCount = item->IndexCount;
+		keys.push_back(key);
+	}
+	m_instanceBatcher.Build(keys);
+	m_culler.Resize(static_cast<std::uint32_t>(m_renderItems.size()));
+	m_itemBounds.assign(m_renderItems.size(), framework::BOUNDING_BOX{});
+
+	const auto stats = m_instanceBatcher.GetStats();
+	logger::info("Instancing: {} render items in {} draws", stats.ItemCount, stats.DrawCount);
 }
 
-void DrawShapes::DrawRenderItems(
-	ID3D12GraphicsCommandList* cmdList,
-	const std::vector<RenderItem*>& items)
+void DrawShapes::BindPassState(
+	framework::ICommandRecorder& recorder,
+	const FrameResource* frame,
+	UINT frameIndex)
 {
-	UINT objCBByteSize = (static_cast<UINT>(sizeof(ConstantData)) + 255u) & ~255u;
+	const auto& vp = m_pRender->m_viewport;
+	const auto& sr = m_pRender->m_scissorRect;
+	recorder.SetViewport   ({ vp.TopLeftX, vp.TopLeftY, vp.Width, vp.Height, vp.MinDepth, vp.MaxDepth });
+	recorder.SetScissorRect({ sr.left, sr.top, sr.right, sr.bottom });
+
+	recorder.SetRenderTarget(
+		framework::ToCpuHandle(m_pRender->GetBackBufferHandle(frame->BackBufferIndex)),
+		framework::ToCpuHandle(m_pRender->GetDepthStencilHandle()));
+
+	auto* heap = m_pRender->m_pDescriptorHeap.get();
+	recorder.SetDescriptorHeap		 (heap->GetHeap());
+	recorder.SetGraphicsRootSignature(m_pRootSignature.Get());
+	recorder.SetGraphicsRootDescriptorTable(1u, framework::ToGpuHandle(heap->GetGpuHandle(frame->PassCbv)));
 
-	auto objectCB = m_pCurrentFrameResource->ObjectCB->GetResource();
+	if (frame->bInstanced)
+	{
+		recorder.SetGraphicsRootShaderResourceView(2u, frame->InstanceBuffer  ->GetResource()->GetGPUVirtualAddress());
+		recorder.SetGraphicsRootShaderResourceView(4u, frame->VisibleInstances);
+	}
+	else if (nObjectBinding == framework::EObjectBinding::StructuredBuffer)
+	{
+		recorder.SetGraphicsRootShaderResourceView(5u, frame->ObjectCB->GetResource()->GetGPUVirtualAddress());
+	}
+}
 
-	for (size_t i = 0; i < items.size(); ++i)
+void DrawShapes::DrawRenderItems(
+	framework::ICommandRecorder& recorder,
+	const std::vector<RenderPacket>& packets,
+	const framework::RECORD_RANGE& range,
+	UINT frameIndex,
+	bool instanced)
+{
+	//~ once per range, BindObject only offsets into it per draw
+	const auto* frame = &m_pFrameRing->GetContext(frameIndex);
+	framework::OBJECT_BINDING_SOURCE binding{};
+	binding.Binding		  = nObjectBinding;
+	binding.RootParameter = 0u;
+	if (m_objectCbvs.IsValid())
 	{
-		//if (items[ i ]->Geometry->Meshes.contains("sphere")) continue;
+		const UINT first = m_objectCbvs.Index + frameIndex * static_cast<UINT>(m_ppOpaqueItems.size());
+		binding.TableStart	   = framework::ToGpuHandle(m_pRender->m_pDescriptorHeap->GetGpuHandle(first));
+		binding.DescriptorSize = m_pRender->m_pDescriptorHeap->GetIncrement();
+	}
+	binding.BufferStart	  = frame->ObjectCB->GetResource()->GetGPUVirtualAddress();
+	binding.ElementSize	  = frame->ObjectCB->GetElementByteSize();
+	binding.Constants	  = reinterpret_cast<const std::uint8_t*>(frame->ObjectConstants.data());
+	binding.ConstantCount = sizeof(ConstantData) / 4u;
 
-		auto ri = items[ i ];
+	for (UINT i = range.Begin; i < range.End; ++i)
+	{
+		const auto& packet = packets[ i ];
 
-		auto vDesc = ri->Geometry->GetVertexViewDesc();
-		auto iDesc = ri->Geometry->GetIndexViewDesc();
-		cmdList->IASetVertexBuffers(0, 1, &vDesc);
-		cmdList->IASetIndexBuffer(&iDesc);
-		cmdList->IASetPrimitiveTopology(ri->Topology);
+		//~ only what the render queue flagged, a chunk's first packet binds everything.
+		//~ The list was reset with the chunk's pipeline and BindPassState set the root signature
+		const bool first	 = i == range.Begin;
+		const auto changes = framework::RenderQueue::GetRangeChanges(packet.StateChanges, first);
 
-		// Offset to the CBV in the descriptor heap for this object and for this frame resource.
-		UINT cbvIndex = m_nCurrentFrameIndex * (UINT)m_ppOpaqueItems.size() + ri->ObjectCBIndex;
-		auto cbvHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_pCbHeap->GetGPUDescriptorHandleForHeapStart());
-		cbvHandle.Offset(cbvIndex, m_pRender->m_nCbvSrvUavDescriptorSize);
+		if (!first && (changes & framework::STATE_CHANGE_PIPELINE))
+		{
+			recorder.SetPipelineState(packet.Pipeline);
+		}
+		if (changes & framework::STATE_CHANGE_GEOMETRY)
+		{
+			recorder.SetVertexBuffer(0u, packet.VertexView);
+			recorder.SetIndexBuffer(packet.IndexView);
+			recorder.SetPrimitiveTopology(packet.Topology);
+		}
 
-		cmdList->SetGraphicsRootDescriptorTable(0, cbvHandle);
+		if (instanced)
+		{
+			//~ worlds come from the instance buffer bound in BindPassState
+			recorder.SetGraphicsRoot32BitConstant(3u, packet.FirstInstance, 0u);
+			recorder.DrawIndexedInstanced(packet.IndexCount, packet.InstanceCount,
+										  packet.StartIndexLocation, packet.BaseVertexLocation, 0u);
+			continue;
+		}
 
-		cmdList->DrawIndexedInstanced(ri->IndexCount, 1, ri->StartIndexLocation, ri->BaseVertexLocation, 0);
+		framework::BindObject(recorder, binding, packet.ObjectCBIndex);
+		recorder.DrawIndexedInstanced(packet.IndexCount, 1u, packet.StartIndexLocation, packet.BaseVertexLocation, 0u);
 	}
 }
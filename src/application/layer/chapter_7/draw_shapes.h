@@ -3,25 +3,68 @@
 
 #include "application/layer/interface_draw.h"
 #include "core/FrameResource.h"
+#include "shader_features.h"
+#include "framework/render_manager/frame_pipeline.h"
+#include "framework/render_manager/frame_ring.h"
+#include "framework/render_manager/hot_reload.h"
+#include "framework/render_manager/instance_batcher.h"
+#include "framework/render_manager/latency_tracker.h"
+#include "framework/render_manager/object_binding.h"
+#include "framework/render_manager/parallel_recorder.h"
+#include "framework/render_manager/resource_state_tracker.h"
+#include "framework/render_manager/retire_queue.h"
+#include "framework/render_manager/shader_layout.h"
+#include "framework/render_manager/upload_ring.h"
+#include "framework/render_manager/backend/dx_upload_memory.h"
+#include "framework/scene/bvh.h"
+#include "framework/scene/frustum_culler.h"
+#include "framework/scene/occlusion_culler.h"
+#include "framework/scene/transform_system.h"
+#include "utility/file/file_watcher.h"
 #include "utility/graphics/dx_utils.h"
 #include "utility/graphics/math.h"
 
+#include <future>
+
 struct RenderItem
 {
 	RenderItem() = default;
 
-	framework::MeshGeometry* Geometry{ nullptr };
-	D3D12_PRIMITIVE_TOPOLOGY Topology{ D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST };
-	DirectX::XMFLOAT4X4		 World	 { MathHelper::Identity4x4() };
+	framework::MeshGeometry* Geometry { nullptr };
+	D3D12_PRIMITIVE_TOPOLOGY Topology { D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST };
+	framework::TransformId	 Transform{ framework::INVALID_TRANSFORM };
+	UINT					 GeometryId{ 0u }; //~ dense id for the render queue sort key
+
+	//~ local space, from the submesh
+	DirectX::XMFLOAT3 BoundsCenter { 0.0f, 0.0f, 0.0f };
+	DirectX::XMFLOAT3 BoundsExtents{ 0.0f, 0.0f, 0.0f };
+	bool			  Occluder	   { false }; //~ rasterized into the software depth buffer
 
 	//~ Draw Config
-	UINT FramesDirty	   { 3u };
 	UINT ObjectCBIndex	   { 0u };
 	UINT IndexCount		   { 0u };
 	UINT StartIndexLocation{ 0u };
 	UINT BaseVertexLocation{ 0u };
 };
 
+//~ bytes streamed into the upload heap by the last simulated frame
+typedef struct _FRAME_UPLOAD_STATS
+{
+	UINT   ObjectCount{ 0u };
+	UINT64 ObjectBytes{ 0u };
+	UINT64 InstanceBytes{ 0u };
+	UINT64 PassBytes  { 0u };
+} FRAME_UPLOAD_STATS;
+
+using ShaderBlobs = std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3DBlob>>;
+
+//~ output of a background shader reload, swapped in at a frame boundary
+typedef struct _SHADER_RELOAD
+{
+	ShaderBlobs Shaders{}; //~ the whole set, empty when nothing could be swapped
+	std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D12PipelineState>> Pipelines{};
+} SHADER_RELOAD;
+
 class DrawShapes final: public IDrawLayer
 {
 public:
@@ -38,12 +81,32 @@ public:
 	void Draw(float deltaTime) override;
 
 private:
+	//~ Pipeline stages, each one runs on a different frame index
+	void SimulateStage	  (const framework::FRAME_TICKET& ticket);
+	void BuildPacketsStage(const framework::FRAME_TICKET& ticket);
+	void RecordStage	  (const framework::FRAME_TICKET& ticket);
+	void SubmitStage	  (const framework::FRAME_TICKET& ticket);
+
 	//~ Per frame updates
-	void Update			 (float deltaTime);
+	void Update			 (float deltaTime, UINT frameIndex);
 	void UpdateCamera	 (float deltaTime);
 	void HandleInput	 (float deltaTime);
-	void UpdateObjectCBs (float deltaTime);
-	void UpdateMainPassCB(float deltaTime);
+	void UpdateObjectCBs (float deltaTime, FrameResource* frame);
+	void UpdateMainPassCB(float deltaTime, FrameResource* frame);
+	void UpdateItemDepths(FrameResource* frame);
+	void CullRenderItems (FrameResource* frame);
+	void PickRenderItem	 ();
+	void ApplyPresentProfile();
+	void OcclusionCull	 (FrameResource* frame, const DirectX::XMFLOAT4X4& viewProj);
+	void BuildDebugBounds(FrameResource* frame);
+	void BuildPassDescriptor(UINT frameIndex, FrameResource* frame);
+	FrameResource* WaitForFrameResource(UINT frameIndex);
+	void ValidateShaderLayouts();
+
+	//~ shader hot reload, the swap happens on the caller thread before the frame is pushed
+	void		  PollShaderReload ();
+	SHADER_RELOAD ReloadShaders	   (const std::vector<std::uint32_t>& programs, ShaderBlobs shaders);
+	void		  ApplyShaderReload(SHADER_RELOAD&& reload);
 
 	//~ Build/Create Resources
 	void BuildDescriptorHeaps	 ();
@@ -53,30 +116,69 @@ private:
 	void BuildInputLayout		 ();
 	void BuildGeometry			 ();
 	void BuildPipeline			 ();
+	void BuildHotReload			 ();
 	void BuildFrameResources	 ();
 	void BuildRenderItems		 ();
+	void BuildFramePipeline		 ();
 	
+	std::vector<std::pair<std::string, D3D12_GRAPHICS_PIPELINE_STATE_DESC>> BuildPipelineDescs(
+		const ShaderBlobs& shaders) const;
+
 	//~ draws
-	void DrawRenderItems(ID3D12GraphicsCommandList* cmdList,
-						 const std::vector<RenderItem*>& items);
+	void BindPassState	(framework::ICommandRecorder& recorder,
+						 const FrameResource* frame,
+						 UINT frameIndex);
+	void DrawRenderItems(framework::ICommandRecorder& recorder,
+						 const std::vector<RenderPacket>& packets,
+						 const framework::RECORD_RANGE& range,
+						 UINT frameIndex,
+						 bool instanced);
 private:
 	//~ fixed
-	const UINT nFrameResourcesMaxCount{ 3u };
-
-	std::vector<std::unique_ptr<FrameResource>> m_ppFrameResources{};
-	FrameResource* m_pCurrentFrameResource{ nullptr };
-	UINT m_nCurrentFrameIndex{ 0u };
+	const UINT nFrameResourcesMaxCount{ 3u }; //~ ring depth: 2 halves the latency, 3 keeps the GPU fed through CPU spikes
+	const UINT nMaxRecordWorkers	  { 8u };
+	const UINT nMinPacketsPerChunk	  { 16u };
+	const UINT64 nUploadRingSize	  { 4ull * 1024ull * 1024ull };
+	const UINT	 nPassCBByteSize	  { (static_cast<UINT>(sizeof(PassConstants)) + 255u) & ~255u }; //~ whole CBV slots
+	//~ bindless: objects packed in one structured buffer per frame, a 1 dword object id per draw
+	const framework::EObjectBinding nObjectBinding{ framework::EObjectBinding::StructuredBuffer };
+	const float nNearZ{ 0.1f };
+	const float nFarZ { 1000.f };
+	inline static const char* SHADER_DIRECTORY{ "shaders/chapter_7" };
+
+	std::unique_ptr<framework::FrameRing<FrameResource>> m_pFrameRing{ nullptr };
+	std::unique_ptr<framework::DxUploadMemory>	m_pUploadMemory{ nullptr }; //~ shared by every frame resource
+	std::unique_ptr<framework::UploadRing>		m_pUploadRing  { nullptr };
+	std::unique_ptr<framework::FramePipeline>	m_pFramePipeline{ nullptr };
+	UINT  m_nNextBackBuffer{ 0u };
+	float m_statsTimer	   { 0.f };
+	framework::ResourceStateTracker m_barriers{ m_pRender->m_resourceStates }; //~ record stage only, frames record in submit order
+
+	//~ input sampled in simulate to Present returned in submit, per frame number
+	framework::LatencyTracker m_latency{};
+	bool m_bPresentProfileRequested{ false }; //~ applied by Draw between two frames, never inside a stage
 
 	Microsoft::WRL::ComPtr<ID3D12RootSignature>  m_pRootSignature{ nullptr };
-	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_pCbHeap		 { nullptr };
-	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_pSrvHeap		 { nullptr };
+	framework::DESCRIPTOR_RANGE m_objectCbvs{}; //~ frames x objects, persistent in the global heap, DescriptorTable binding only
 
 	//~ resources
-	std::vector<std::unique_ptr<RenderItem>> m_ppRenderItems{};
-	std::vector<RenderItem*>				 m_ppOpaqueItems {};
+	framework::TransformSystem m_transforms	 {};
+	std::vector<RenderItem>	   m_renderItems {};
+	std::vector<RenderItem*>   m_ppOpaqueItems{};
+	framework::InstanceBatcher m_instanceBatcher{};
+	framework::FrustumCuller   m_culler			{};
+	framework::Bvh4			   m_sceneBvh		{};
+	std::vector<framework::BOUNDING_BOX> m_itemBounds{}; //~ world bounds by ObjectCBIndex
+	framework::OcclusionCuller m_occlusion		{};
+	std::vector<DirectX::XMFLOAT3> m_occluderPositions{}; //~ CPU copy of the box mesh
+	std::vector<std::uint32_t>	   m_occluderIndices  {};
+	FRAME_UPLOAD_STATS m_uploadStats{};
 	PassConstants m_mainPassCB{};
-	UINT m_nPassCBOffset{ 0u };
 	bool m_bWireFrame	{ false };
+	bool m_bInstanced	{ true };
+	bool m_bPickRequested{ false };
+	bool m_bOcclusion	{ true };
+	bool m_bDebugBounds	{ false };
 	float m_wireToggleTimer = 0.0f;
 	float m_yaw = 0.0f;
 	float m_pitch = 0.0f;
@@ -94,9 +196,16 @@ private:
 
 	//~ maps
 	std::unordered_map<std::string, std::unique_ptr<framework::MeshGeometry>> m_geometries{};
-	std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3DBlob>> m_compiledShaders   {};
+	ShaderBlobs m_compiledShaders{};
 	std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D12PipelineState>> m_pso    {};
 
 	//~ configurations
 	std::vector<D3D12_INPUT_ELEMENT_DESC> m_inputLayout{};
+
+	//~ shader hot reload, programs are named like m_compiledShaders
+	std::unordered_map<std::string, framework::SHADER_COMPILE_DESC> m_shaderDescs{};
+	std::unique_ptr<framework::FileWatcher> m_pShaderWatcher{ nullptr };
+	framework::HotReloadScheduler			m_shaderReload	{};
+	std::future<SHADER_RELOAD>				m_pendingReload {};
+	framework::RetireQueue<Microsoft::WRL::ComPtr<ID3D12PipelineState>> m_retiredPipelines{}; //~ swapped out, freed once the GPU is past them
 };
@@ -0,0 +1,81 @@
+#pragma once
+
+//~ generated by tools/shader_layout_gen.cpp from the cbuffers of the shaders, do not edit.
+//~ run it again after changing one, the layers check these against the sources at startup
+
+#include <DirectXMath.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "framework/render_manager/shader_reflection.h"
+
+//~ cbuffer cbPass : register(b1) of shaders/chapter_7/common.hlsli, 436 bytes, 12 of them padding
+struct alignas(16) PassConstants
+{
+	DirectX::XMFLOAT4X4 gView{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+	DirectX::XMFLOAT4X4 gInvView{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+	DirectX::XMFLOAT4X4 gProj{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+	DirectX::XMFLOAT4X4 gInvProj{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+	DirectX::XMFLOAT4X4 gViewProj{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+	DirectX::XMFLOAT4X4 gInvViewProj{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+	DirectX::XMFLOAT3 gEyePosW{};
+	float gNearZ{};
+	DirectX::XMFLOAT2 gRenderTargetSize{};
+	DirectX::XMFLOAT2 gInvRenderTargetSize{};
+	DirectX::XMFLOAT2 gMousePosition{};
+	float gFarZ{};
+	float gTotalTime{};
+	float gDeltaTime{};
+	float _pad0[ 3 ]{};
+};
+static_assert(offsetof(PassConstants, gView) == 0u, "cbPass.gView moved, regenerate the shader layouts");
+static_assert(offsetof(PassConstants, gInvView) == 64u, "cbPass.gInvView moved, regenerate the shader layouts");
+static_assert(offsetof(PassConstants, gProj) == 128u, "cbPass.gProj moved, regenerate the shader layouts");
+static_assert(offsetof(PassConstants, gInvProj) == 192u, "cbPass.gInvProj moved, regenerate the shader layouts");
+static_assert(offsetof(PassConstants, gViewProj) == 256u, "cbPass.gViewProj moved, regenerate the shader layouts");
+static_assert(offsetof(PassConstants, gInvViewProj) == 320u, "cbPass.gInvViewProj moved, regenerate the shader layouts");
+static_assert(offsetof(PassConstants, gEyePosW) == 384u, "cbPass.gEyePosW moved, regenerate the shader layouts");
+static_assert(offsetof(PassConstants, gNearZ) == 396u, "cbPass.gNearZ moved, regenerate the shader layouts");
+static_assert(offsetof(PassConstants, gRenderTargetSize) == 400u, "cbPass.gRenderTargetSize moved, regenerate the shader layouts");
+static_assert(offsetof(PassConstants, gInvRenderTargetSize) == 408u, "cbPass.gInvRenderTargetSize moved, regenerate the shader layouts");
+static_assert(offsetof(PassConstants, gMousePosition) == 416u, "cbPass.gMousePosition moved, regenerate the shader layouts");
+static_assert(offsetof(PassConstants, gFarZ) == 424u, "cbPass.gFarZ moved, regenerate the shader layouts");
+static_assert(offsetof(PassConstants, gTotalTime) == 428u, "cbPass.gTotalTime moved, regenerate the shader layouts");
+static_assert(offsetof(PassConstants, gDeltaTime) == 432u, "cbPass.gDeltaTime moved, regenerate the shader layouts");
+static_assert(sizeof(PassConstants) == 448u, "cbPass changed size, regenerate the shader layouts");
+
+inline constexpr framework::SHADER_GENERATED_LAYOUT PassConstantsLayout
+{
+	"shaders/chapter_7/common.hlsli", "cbPass", "",
+	436u, 0x648ef4f0610e68a1ull
+};
+
+//~ cbuffer cbPerObject : register(b0) of shaders/chapter_7/vertex.hlsl with OBJECT_BUFFER=0, 64 bytes, 0 of them padding
+struct alignas(16) ConstantData
+{
+	DirectX::XMFLOAT4X4 World{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+};
+static_assert(offsetof(ConstantData, World) == 0u, "cbPerObject.World moved, regenerate the shader layouts");
+static_assert(sizeof(ConstantData) == 64u, "cbPerObject changed size, regenerate the shader layouts");
+
+inline constexpr framework::SHADER_GENERATED_LAYOUT ConstantDataLayout
+{
+	"shaders/chapter_7/vertex.hlsl", "cbPerObject", "OBJECT_BUFFER=0;",
+	64u, 0x66004cf7359545a0ull
+};
+
+//~ cbuffer cbPerObject : register(b0) of shaders/chapter_7/vertex.hlsl with OBJECT_BUFFER=1, 4 bytes, 12 of them padding
+struct alignas(16) ObjectIdConstants
+{
+	std::uint32_t gObjectId{};
+	float _pad0[ 3 ]{};
+};
+static_assert(offsetof(ObjectIdConstants, gObjectId) == 0u, "cbPerObject.gObjectId moved, regenerate the shader layouts");
+static_assert(sizeof(ObjectIdConstants) == 16u, "cbPerObject changed size, regenerate the shader layouts");
+
+inline constexpr framework::SHADER_GENERATED_LAYOUT ObjectIdConstantsLayout
+{
+	"shaders/chapter_7/vertex.hlsl", "cbPerObject", "OBJECT_BUFFER=1;",
+	4u, 0xeaa7fc3877e9fb1ull
+};
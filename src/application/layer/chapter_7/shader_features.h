@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+#include "framework/render_manager/shader_permutation.h"
+
+//~ feature bits of shaders/chapter_7/vertex.hlsl, one #if per feature in the source
+enum class EStandardVSFeature : std::uint32_t
+{
+	ObjectBuffer = 1u << 0u, //~ world read from gObjects with the id in cbPerObject
+};
+
+using StandardVSPermutation = framework::ShaderPermutation<EStandardVSFeature>;
+
+inline constexpr framework::ShaderFeatureSet<EStandardVSFeature, 1u> STANDARD_VS_FEATURES
+{
+	{ { { EStandardVSFeature::ObjectBuffer, "OBJECT_BUFFER" } } }
+};
+static_assert(STANDARD_VS_FEATURES.IsValid(), "Standard VS features must be distinct single bits");
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+//~ Backend neutral recording interface. Nothing in here may include a platform
+//~ header, the types mirror the D3D12 ones closely enough to convert by value.
+namespace framework
+{
+	using GpuVirtualAddress = std::uint64_t;
+
+	//~ opaque native objects (ID3D12PipelineState*, ID3D12RootSignature*...)
+	using GpuPipelineHandle		  = void*;
+	using GpuRootSignatureHandle  = void*;
+	using GpuDescriptorHeapHandle = void*;
+	using GpuResourceHandle		  = void*;
+
+	enum class EBackendType : std::uint8_t
+	{
+		D3D12 = 0,
+		Recording
+	};
+
+	struct GpuDescriptorHandle
+	{
+		std::uint64_t Ptr{ 0u };
+	};
+
+	struct CpuDescriptorHandle
+	{
+		std::size_t Ptr{ 0u };
+	};
+
+	//~ values match D3D_PRIMITIVE_TOPOLOGY
+	enum class EPrimitiveTopology : std::uint32_t
+	{
+		Undefined	  = 0,
+		PointList	  = 1,
+		LineList	  = 2,
+		LineStrip	  = 3,
+		TriangleList  = 4,
+		TriangleStrip = 5
+	};
+
+	//~ values match DXGI_FORMAT
+	enum class EIndexFormat : std::uint32_t
+	{
+		Uint32 = 42,
+		Uint16 = 57
+	};
+
+	//~ values match D3D12_RESOURCE_STATES, combinable for read states
+	enum class EResourceState : std::uint32_t
+	{
+		Common				   = 0x0,
+		Present				   = 0x0,
+		VertexAndConstant	   = 0x1,
+		IndexBuffer			   = 0x2,
+		RenderTarget		   = 0x4,
+		UnorderedAccess		   = 0x8,
+		DepthWrite			   = 0x10,
+		DepthRead			   = 0x20,
+		NonPixelShaderResource = 0x40,
+		PixelShaderResource	   = 0x80,
+		CopyDest			   = 0x400,
+		CopySource			   = 0x800,
+		GenericRead			   = 0xAC3
+	};
+
+	//~ transition applied to every subresource
+	inline constexpr std::uint32_t ALL_SUBRESOURCES = 0xffffffffu;
+
+	//~ values match D3D12_RESOURCE_BARRIER_TYPE
+	enum class EBarrierType : std::uint32_t
+	{
+		Transition		= 0,
+		UnorderedAccess = 2
+	};
+
+	//~ values match D3D12_RESOURCE_BARRIER_FLAGS, a split barrier is a BeginOnly then an EndOnly with the same states
+	enum class EBarrierFlags : std::uint32_t
+	{
+		None	  = 0x0,
+		BeginOnly = 0x1,
+		EndOnly	  = 0x2
+	};
+
+	struct GpuResourceBarrier
+	{
+		EBarrierType	  Type		 { EBarrierType::Transition };
+		EBarrierFlags	  Flags		 { EBarrierFlags::None };
+		GpuResourceHandle Resource	 { nullptr }; //~ null on a UAV barrier waits for every UAV access
+		EResourceState	  Before	 { EResourceState::Common };
+		EResourceState	  After		 { EResourceState::Common };
+		std::uint32_t	  Subresource{ ALL_SUBRESOURCES };
+	};
+
+	struct GpuVertexBufferView
+	{
+		GpuVirtualAddress Location	  { 0u };
+		std::uint32_t	  SizeInBytes { 0u };
+		std::uint32_t	  StrideInBytes{ 0u };
+	};
+
+	struct GpuIndexBufferView
+	{
+		GpuVirtualAddress Location	 { 0u };
+		std::uint32_t	  SizeInBytes{ 0u };
+		EIndexFormat	  Format	 { EIndexFormat::Uint16 };
+	};
+
+	struct GpuViewport
+	{
+		float TopLeftX{ 0.f };
+		float TopLeftY{ 0.f };
+		float Width	  { 0.f };
+		float Height  { 0.f };
+		float MinDepth{ 0.f };
+		float MaxDepth{ 1.f };
+	};
+
+	struct GpuScissorRect
+	{
+		std::int32_t Left  { 0 };
+		std::int32_t Top   { 0 };
+		std::int32_t Right { 0 };
+		std::int32_t Bottom{ 0 };
+	};
+
+	/// <summary>
+	/// The subset of a graphics command list used by the renderer. Implemented by the
+	/// D3D12 backend and by the recording backend for headless runs.
+	/// </summary>
+	class ICommandRecorder
+	{
+	public:
+		virtual ~ICommandRecorder() = default;
+
+		virtual EBackendType GetBackendType() const noexcept = 0;
+
+		//~ pipeline
+		virtual void SetPipelineState		  (GpuPipelineHandle pso)				   = 0;
+		virtual void SetGraphicsRootSignature (GpuRootSignatureHandle rootSignature)   = 0;
+		virtual void SetDescriptorHeap		  (GpuDescriptorHeapHandle heap)		   = 0;
+		virtual void SetViewport			  (const GpuViewport& viewport)			   = 0;
+		virtual void SetScissorRect			  (const GpuScissorRect& rect)			   = 0;
+		virtual void SetRenderTarget		  (CpuDescriptorHandle rtv,
+											   CpuDescriptorHandle dsv)				   = 0;
+
+		//~ input assembler
+		virtual void SetVertexBuffer		  (std::uint32_t slot,
+											   const GpuVertexBufferView& view)		   = 0;
+		virtual void SetIndexBuffer			  (const GpuIndexBufferView& view)		   = 0;
+		virtual void SetPrimitiveTopology	  (EPrimitiveTopology topology)			   = 0;
+
+		//~ bindings
+		virtual void SetGraphicsRootDescriptorTable(std::uint32_t rootParameter,
+													GpuDescriptorHandle handle)		   = 0;
+		virtual void SetGraphicsRoot32BitConstant  (std::uint32_t rootParameter,
+													std::uint32_t value,
+													std::uint32_t destOffset)		   = 0;
+		virtual void SetGraphicsRootShaderResourceView(std::uint32_t rootParameter,
+													   GpuVirtualAddress address)	   = 0;
+		virtual void SetGraphicsRootConstantBufferView(std::uint32_t rootParameter,
+													   GpuVirtualAddress address)	   = 0;
+		//~ count dwords from data, data only has to live for the call
+		virtual void SetGraphicsRoot32BitConstants (std::uint32_t rootParameter,
+													std::uint32_t count,
+													const void* data,
+													std::uint32_t destOffset)		   = 0;
+
+		//~ resources
+		virtual void TransitionResource(GpuResourceHandle resource,
+										EResourceState before,
+										EResourceState after,
+										std::uint32_t subresource = ALL_SUBRESOURCES) = 0;
+		//~ the whole batch in one call, what ResourceStateTracker emits
+		virtual void ResourceBarriers  (const GpuResourceBarrier* barriers,
+										std::uint32_t count)						  = 0;
+
+		//~ clears
+		virtual void ClearRenderTarget(CpuDescriptorHandle rtv, const float color[ 4 ])			  = 0;
+		virtual void ClearDepthStencil(CpuDescriptorHandle dsv, float depth, std::uint8_t stencil) = 0;
+
+		//~ draws
+		virtual void DrawIndexedInstanced(std::uint32_t indexCount,
+										  std::uint32_t instanceCount,
+										  std::uint32_t startIndex,
+										  std::int32_t  baseVertex,
+										  std::uint32_t startInstance)				   = 0;
+	};
+} // namespace framework
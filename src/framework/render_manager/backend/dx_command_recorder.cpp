@@ -0,0 +1,202 @@
+#include "dx_command_recorder.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace framework;
+
+static_assert(static_cast<UINT>(EPrimitiveTopology::TriangleList) == D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+static_assert(static_cast<UINT>(EPrimitiveTopology::LineList)	  == D3D_PRIMITIVE_TOPOLOGY_LINELIST);
+static_assert(static_cast<UINT>(EIndexFormat::Uint16) == DXGI_FORMAT_R16_UINT);
+static_assert(static_cast<UINT>(EIndexFormat::Uint32) == DXGI_FORMAT_R32_UINT);
+static_assert(static_cast<UINT>(EResourceState::RenderTarget) == D3D12_RESOURCE_STATE_RENDER_TARGET);
+static_assert(static_cast<UINT>(EResourceState::DepthWrite)	  == D3D12_RESOURCE_STATE_DEPTH_WRITE);
+static_assert(static_cast<UINT>(EResourceState::CopyDest)	  == D3D12_RESOURCE_STATE_COPY_DEST);
+static_assert(static_cast<UINT>(EResourceState::GenericRead)  == D3D12_RESOURCE_STATE_GENERIC_READ);
+static_assert(ALL_SUBRESOURCES == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+static_assert(static_cast<UINT>(EBarrierType::Transition)	   == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION);
+static_assert(static_cast<UINT>(EBarrierType::UnorderedAccess) == D3D12_RESOURCE_BARRIER_TYPE_UAV);
+static_assert(static_cast<UINT>(EBarrierFlags::BeginOnly) == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+static_assert(static_cast<UINT>(EBarrierFlags::EndOnly)	  == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY);
+
+void framework::DxCommandRecorder::SetPipelineState(GpuPipelineHandle pso)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	m_pCommandList->SetPipelineState(static_cast<ID3D12PipelineState*>(pso));
+}
+
+void framework::DxCommandRecorder::SetGraphicsRootSignature(GpuRootSignatureHandle rootSignature)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	m_pCommandList->SetGraphicsRootSignature(static_cast<ID3D12RootSignature*>(rootSignature));
+}
+
+void framework::DxCommandRecorder::SetDescriptorHeap(GpuDescriptorHeapHandle heap)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	ID3D12DescriptorHeap* heaps[]{ static_cast<ID3D12DescriptorHeap*>(heap) };
+	m_pCommandList->SetDescriptorHeaps(1u, heaps);
+}
+
+void framework::DxCommandRecorder::SetViewport(const GpuViewport& viewport)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	D3D12_VIEWPORT vp{};
+	vp.TopLeftX = viewport.TopLeftX;
+	vp.TopLeftY = viewport.TopLeftY;
+	vp.Width	= viewport.Width;
+	vp.Height	= viewport.Height;
+	vp.MinDepth = viewport.MinDepth;
+	vp.MaxDepth = viewport.MaxDepth;
+	m_pCommandList->RSSetViewports(1u, &vp);
+}
+
+void framework::DxCommandRecorder::SetScissorRect(const GpuScissorRect& rect)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	D3D12_RECT scissor{ rect.Left, rect.Top, rect.Right, rect.Bottom };
+	m_pCommandList->RSSetScissorRects(1u, &scissor);
+}
+
+void framework::DxCommandRecorder::SetRenderTarget(CpuDescriptorHandle rtv, CpuDescriptorHandle dsv)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ rtv.Ptr };
+	D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle{ dsv.Ptr };
+	m_pCommandList->OMSetRenderTargets(1u, &rtvHandle, TRUE, dsv.Ptr ? &dsvHandle : nullptr);
+}
+
+void framework::DxCommandRecorder::SetVertexBuffer(std::uint32_t slot, const GpuVertexBufferView& view)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	D3D12_VERTEX_BUFFER_VIEW vbv{};
+	vbv.BufferLocation = view.Location;
+	vbv.SizeInBytes	   = view.SizeInBytes;
+	vbv.StrideInBytes  = view.StrideInBytes;
+	m_pCommandList->IASetVertexBuffers(slot, 1u, &vbv);
+}
+
+void framework::DxCommandRecorder::SetIndexBuffer(const GpuIndexBufferView& view)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	D3D12_INDEX_BUFFER_VIEW ibv{};
+	ibv.BufferLocation = view.Location;
+	ibv.SizeInBytes	   = view.SizeInBytes;
+	ibv.Format		   = static_cast<DXGI_FORMAT>(view.Format);
+	m_pCommandList->IASetIndexBuffer(&ibv);
+}
+
+void framework::DxCommandRecorder::SetPrimitiveTopology(EPrimitiveTopology topology)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	m_pCommandList->IASetPrimitiveTopology(static_cast<D3D12_PRIMITIVE_TOPOLOGY>(topology));
+}
+
+void framework::DxCommandRecorder::SetGraphicsRootDescriptorTable(std::uint32_t rootParameter, GpuDescriptorHandle handle)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle{ handle.Ptr };
+	m_pCommandList->SetGraphicsRootDescriptorTable(rootParameter, gpuHandle);
+}
+
+void framework::DxCommandRecorder::SetGraphicsRoot32BitConstant(std::uint32_t rootParameter, std::uint32_t value, std::uint32_t destOffset)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	m_pCommandList->SetGraphicsRoot32BitConstant(rootParameter, value, destOffset);
+}
+
+void framework::DxCommandRecorder::SetGraphicsRootShaderResourceView(std::uint32_t rootParameter, GpuVirtualAddress address)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	m_pCommandList->SetGraphicsRootShaderResourceView(rootParameter, address);
+}
+
+void framework::DxCommandRecorder::SetGraphicsRootConstantBufferView(std::uint32_t rootParameter, GpuVirtualAddress address)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	m_pCommandList->SetGraphicsRootConstantBufferView(rootParameter, address);
+}
+
+void framework::DxCommandRecorder::SetGraphicsRoot32BitConstants(
+	std::uint32_t rootParameter,
+	std::uint32_t count,
+	const void* data,
+	std::uint32_t destOffset)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	m_pCommandList->SetGraphicsRoot32BitConstants(rootParameter, count, data, destOffset);
+}
+
+void framework::DxCommandRecorder::TransitionResource(
+	GpuResourceHandle resource,
+	EResourceState before,
+	EResourceState after,
+	std::uint32_t subresource)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	D3D12_RESOURCE_BARRIER barrier{};
+	barrier.Type				   = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	barrier.Flags				   = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	barrier.Transition.pResource   = static_cast<ID3D12Resource*>(resource);
+	barrier.Transition.StateBefore = static_cast<D3D12_RESOURCE_STATES>(before);
+	barrier.Transition.StateAfter  = static_cast<D3D12_RESOURCE_STATES>(after);
+	barrier.Transition.Subresource = subresource;
+	m_pCommandList->ResourceBarrier(1u, &barrier);
+}
+
+void framework::DxCommandRecorder::ResourceBarriers(const GpuResourceBarrier* barriers, std::uint32_t count)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+
+	//~ converted on the stack, a tracker batch rarely goes past one chunk
+	constexpr std::uint32_t CHUNK = 32u;
+	D3D12_RESOURCE_BARRIER native[ CHUNK ];
+	for (std::uint32_t first = 0u; first < count; first += CHUNK)
+	{
+		const std::uint32_t size = std::min(CHUNK, count - first);
+		for (std::uint32_t i = 0u; i < size; ++i)
+		{
+			const auto& barrier = barriers[ first + i ];
+			auto& out			= native[ i ];
+			out		  = {};
+			out.Type  = static_cast<D3D12_RESOURCE_BARRIER_TYPE>(barrier.Type);
+			out.Flags = static_cast<D3D12_RESOURCE_BARRIER_FLAGS>(barrier.Flags);
+			if (barrier.Type == EBarrierType::UnorderedAccess)
+			{
+				out.UAV.pResource = static_cast<ID3D12Resource*>(barrier.Resource);
+				continue;
+			}
+			out.Transition.pResource   = static_cast<ID3D12Resource*>(barrier.Resource);
+			out.Transition.StateBefore = static_cast<D3D12_RESOURCE_STATES>(barrier.Before);
+			out.Transition.StateAfter  = static_cast<D3D12_RESOURCE_STATES>(barrier.After);
+			out.Transition.Subresource = barrier.Subresource;
+		}
+		m_pCommandList->ResourceBarrier(size, native);
+	}
+}
+
+void framework::DxCommandRecorder::ClearRenderTarget(CpuDescriptorHandle rtv, const float color[ 4 ])
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	m_pCommandList->ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE{ rtv.Ptr }, color, 0u, nullptr);
+}
+
+void framework::DxCommandRecorder::ClearDepthStencil(CpuDescriptorHandle dsv, float depth, std::uint8_t stencil)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	m_pCommandList->ClearDepthStencilView(
+		D3D12_CPU_DESCRIPTOR_HANDLE{ dsv.Ptr },
+		D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL,
+		depth, stencil, 0u, nullptr);
+}
+
+void framework::DxCommandRecorder::DrawIndexedInstanced(
+	std::uint32_t indexCount,
+	std::uint32_t instanceCount,
+	std::uint32_t startIndex,
+	std::int32_t  baseVertex,
+	std::uint32_t startInstance)
+{
+	assert(m_pCommandList && "Recorder has no command list attached!");
+	m_pCommandList->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <d3d12.h>
+
+#include "command_recorder.h"
+
+namespace framework
+{
+	//~ conversion helpers between D3D12 and the neutral recorder types
+	inline GpuVertexBufferView ToGpuView(const D3D12_VERTEX_BUFFER_VIEW& view) noexcept
+	{
+		return { view.BufferLocation, view.SizeInBytes, view.StrideInBytes };
+	}
+
+	inline GpuIndexBufferView ToGpuView(const D3D12_INDEX_BUFFER_VIEW& view) noexcept
+	{
+		return { view.BufferLocation, view.SizeInBytes, static_cast<EIndexFormat>(view.Format) };
+	}
+
+	inline EPrimitiveTopology ToGpuTopology(D3D12_PRIMITIVE_TOPOLOGY topology) noexcept
+	{
+		return static_cast<EPrimitiveTopology>(topology);
+	}
+
+	inline EResourceState ToGpuState(D3D12_RESOURCE_STATES state) noexcept
+	{
+		return static_cast<EResourceState>(state);
+	}
+
+	inline GpuDescriptorHandle ToGpuHandle(D3D12_GPU_DESCRIPTOR_HANDLE handle) noexcept
+	{
+		return { handle.ptr };
+	}
+
+	inline CpuDescriptorHandle ToCpuHandle(D3D12_CPU_DESCRIPTOR_HANDLE handle) noexcept
+	{
+		return { handle.ptr };
+	}
+
+	/// <summary>
+	/// Records straight into an ID3D12GraphicsCommandList, the list is not owned.
+	/// </summary>
+	class DxCommandRecorder final : public ICommandRecorder
+	{
+	public:
+		explicit DxCommandRecorder(ID3D12GraphicsCommandList* cmdList = nullptr)
+			: m_pCommandList(cmdList)
+		{}
+		~DxCommandRecorder() override = default;
+
+		void Attach(ID3D12GraphicsCommandList* cmdList) noexcept { m_pCommandList = cmdList; }
+		ID3D12GraphicsCommandList* GetNative() const noexcept	 { return m_pCommandList; }
+
+		//~ ICommandRecorder Impl
+		EBackendType GetBackendType() const noexcept override { return EBackendType::D3D12; }
+
+		void SetPipelineState		  (GpuPipelineHandle pso)				  override;
+		void SetGraphicsRootSignature (GpuRootSignatureHandle rootSignature)  override;
+		void SetDescriptorHeap		  (GpuDescriptorHeapHandle heap)		  override;
+		void SetViewport			  (const GpuViewport& viewport)			  override;
+		void SetScissorRect			  (const GpuScissorRect& rect)			  override;
+		void SetRenderTarget		  (CpuDescriptorHandle rtv,
+									   CpuDescriptorHandle dsv)				  override;
+
+		void SetVertexBuffer		  (std::uint32_t slot,
+									   const GpuVertexBufferView& view)		  override;
+		void SetIndexBuffer			  (const GpuIndexBufferView& view)		  override;
+		void SetPrimitiveTopology	  (EPrimitiveTopology topology)			  override;
+
+		void SetGraphicsRootDescriptorTable(std::uint32_t rootParameter,
+											GpuDescriptorHandle handle)		  override;
+		void SetGraphicsRoot32BitConstant  (std::uint32_t rootParameter,
+											std::uint32_t value,
+											std::uint32_t destOffset)		  override;
+		void SetGraphicsRootShaderResourceView(std::uint32_t rootParameter,
+											   GpuVirtualAddress address)	  override;
+		void SetGraphicsRootConstantBufferView(std::uint32_t rootParameter,
+											   GpuVirtualAddress address)	  override;
+		void SetGraphicsRoot32BitConstants (std::uint32_t rootParameter,
+											std::uint32_t count,
+											const void* data,
+											std::uint32_t destOffset)		  override;
+
+		void TransitionResource(GpuResourceHandle resource,
+								EResourceState before,
+								EResourceState after,
+								std::uint32_t subresource = ALL_SUBRESOURCES) override;
+		void ResourceBarriers  (const GpuResourceBarrier* barriers,
+								std::uint32_t count)						  override;
+
+		void ClearRenderTarget(CpuDescriptorHandle rtv, const float color[ 4 ])			  override;
+		void ClearDepthStencil(CpuDescriptorHandle dsv, float depth, std::uint8_t stencil) override;
+
+		void DrawIndexedInstanced(std::uint32_t indexCount,
+								  std::uint32_t instanceCount,
+								  std::uint32_t startIndex,
+								  std::int32_t  baseVertex,
+								  std::uint32_t startInstance)				  override;
+
+	private:
+		ID3D12GraphicsCommandList* m_pCommandList{ nullptr };
+	};
+} // namespace framework
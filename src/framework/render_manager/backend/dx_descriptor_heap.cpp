@@ -0,0 +1,40 @@
+#include "dx_descriptor_heap.h"
+
+#include "framework/exception/dx_exception.h"
+
+#include <cassert>
+
+using namespace framework;
+
+framework::DxDescriptorHeap::DxDescriptorHeap(ID3D12Device* device,
+											  std::uint32_t persistentCount,
+											  std::uint32_t transientPerFrame,
+											  std::uint32_t frameCount)
+	: m_allocator(persistentCount, transientPerFrame, frameCount)
+{
+	assert(device && "Descriptor heap needs a device!");
+
+	D3D12_DESCRIPTOR_HEAP_DESC desc{};
+	desc.Flags			= D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+	desc.Type			= D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+	desc.NodeMask		= 0u;
+	desc.NumDescriptors = m_allocator.GetDescriptorCount();
+
+	THROW_DX_IF_FAILS(device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(m_pHeap.GetAddressOf())));
+
+	m_cpuStart	 = m_pHeap->GetCPUDescriptorHandleForHeapStart();
+	m_gpuStart	 = m_pHeap->GetGPUDescriptorHandleForHeapStart();
+	m_nIncrement = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE framework::DxDescriptorHeap::GetCpuHandle(std::uint32_t index) const noexcept
+{
+	assert(index < m_allocator.GetDescriptorCount() && "Descriptor index out of range!");
+	return { m_cpuStart.ptr + static_cast<SIZE_T>(index) * m_nIncrement };
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE framework::DxDescriptorHeap::GetGpuHandle(std::uint32_t index) const noexcept
+{
+	assert(index < m_allocator.GetDescriptorCount() && "Descriptor index out of range!");
+	return { m_gpuStart.ptr + static_cast<UINT64>(index) * m_nIncrement };
+}
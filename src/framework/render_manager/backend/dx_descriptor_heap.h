@@ -0,0 +1,40 @@
+#pragma once
+
+#include <d3d12.h>
+#include <wrl/client.h>
+
+#include "framework/render_manager/descriptor_allocator.h"
+
+namespace framework
+{
+	/// <summary>
+	/// The one shader visible CBV/SRV/UAV heap every layer binds. Allocation is DescriptorAllocator,
+	/// this only owns the heap and turns indices into handles.
+	/// </summary>
+	class DxDescriptorHeap
+	{
+	public:
+		DxDescriptorHeap(ID3D12Device* device,
+						 std::uint32_t persistentCount,
+						 std::uint32_t transientPerFrame,
+						 std::uint32_t frameCount);
+		~DxDescriptorHeap() = default;
+
+		DxDescriptorHeap(const DxDescriptorHeap&) = delete;
+		DxDescriptorHeap& operator=(const DxDescriptorHeap&) = delete;
+
+		//~ Getters
+		ID3D12DescriptorHeap*		GetHeap		() const noexcept { return m_pHeap.Get(); }
+		DescriptorAllocator&		GetAllocator() noexcept		  { return m_allocator; }
+		std::uint32_t				GetIncrement() const noexcept { return m_nIncrement; }
+		D3D12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(std::uint32_t index) const noexcept;
+		D3D12_GPU_DESCRIPTOR_HANDLE GetGpuHandle(std::uint32_t index) const noexcept;
+
+	private:
+		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_pHeap{ nullptr };
+		DescriptorAllocator							 m_allocator;
+		D3D12_CPU_DESCRIPTOR_HANDLE					 m_cpuStart{};
+		D3D12_GPU_DESCRIPTOR_HANDLE					 m_gpuStart{};
+		std::uint32_t								 m_nIncrement{ 0u };
+	};
+} // namespace framework
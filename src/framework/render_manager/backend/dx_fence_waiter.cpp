@@ -0,0 +1,44 @@
+#include "dx_fence_waiter.h"
+
+#include "framework/exception/dx_exception.h"
+#include "utility/logger/logger.h"
+
+#include <cassert>
+
+using namespace framework;
+
+framework::DxFenceWaiter::DxFenceWaiter(ID3D12Fence* fence)
+	: m_pFence(fence)
+{
+	assert(m_pFence && "Fence waiter needs a fence!");
+
+	m_event = CreateEventEx(nullptr, nullptr, 0u, EVENT_ALL_ACCESS);
+	if (!m_event) THROW_DX_IF_FAILS(HRESULT_FROM_WIN32(GetLastError()));
+}
+
+framework::DxFenceWaiter::~DxFenceWaiter()
+{
+	if (m_event) CloseHandle(m_event);
+}
+
+std::uint64_t framework::DxFenceWaiter::GetCompletedValue() const
+{
+	return m_pFence->GetCompletedValue();
+}
+
+bool framework::DxFenceWaiter::Wait(std::uint64_t value)
+{
+	if (value == 0u || m_pFence->GetCompletedValue() >= value) return false;
+
+	THROW_DX_IF_FAILS(m_pFence->SetEventOnCompletion(value, m_event));
+
+	const DWORD waitResult = WaitForSingleObject(m_event, INFINITE);
+	if (waitResult != WAIT_OBJECT_0)
+	{
+		const DWORD winErr = GetLastError();
+		logger::error("Fence wait failed! WaitForSingleObject returned: {}", waitResult);
+		logger::error("Win32 error: {}", winErr);
+		THROW_DX_IF_FAILS(HRESULT_FROM_WIN32(winErr));
+	}
+	return true;
+}
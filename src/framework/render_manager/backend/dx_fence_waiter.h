@@ -0,0 +1,31 @@
+#pragma once
+
+#include <d3d12.h>
+#include <wrl/client.h>
+
+#include "render_device.h"
+
+namespace framework
+{
+	/// <summary>
+	/// D3D12 fence waiter: the auto reset event is created with the waiter and reused by
+	/// every SetEventOnCompletion, instead of a CreateEventEx/CloseHandle pair per stall.
+	/// </summary>
+	class DxFenceWaiter final : public IFenceWaiter
+	{
+	public:
+		explicit DxFenceWaiter(ID3D12Fence* fence);
+		~DxFenceWaiter() override;
+
+		DxFenceWaiter(const DxFenceWaiter&) = delete;
+		DxFenceWaiter& operator=(const DxFenceWaiter&) = delete;
+
+		//~ IFenceWaiter Impl
+		std::uint64_t GetCompletedValue() const override;
+		bool		  Wait				(std::uint64_t value) override;
+
+	private:
+		Microsoft::WRL::ComPtr<ID3D12Fence> m_pFence{ nullptr };
+		HANDLE								m_event { nullptr };
+	};
+} // namespace framework
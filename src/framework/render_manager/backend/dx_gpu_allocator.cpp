@@ -0,0 +1,359 @@
+#include "dx_gpu_allocator.h"
+
+#include "framework/exception/dx_exception.h"
+#include "utility/logger/logger.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace framework;
+
+framework::DxGpuAllocator::DxGpuAllocator(ID3D12Device* device,
+										  IDXGIAdapter* adapter,
+										  std::uint64_t heapBlockSize,
+										  std::uint64_t bufferBlockSize)
+	: m_pDevice(device), m_nHeapBlockSize(heapBlockSize), m_nBufferBlockSize(bufferBlockSize)
+{
+	assert(m_pDevice && "GPU allocator needs a device!");
+	assert(bufferBlockSize <= heapBlockSize && "Buffer blocks must fit in a heap block!");
+
+	//~ budget queries need IDXGIAdapter3, older adapters only lose the OS numbers
+	if (adapter && FAILED(adapter->QueryInterface(IID_PPV_ARGS(m_pAdapter.GetAddressOf()))))
+	{
+		m_pAdapter = nullptr;
+	}
+}
+
+framework::DxGpuAllocator::~DxGpuAllocator()
+{
+	//~ buffer blocks are placed allocations of their own, they are not leaks
+	std::uint32_t bufferBlocks = 0u;
+	for (const auto& pool : m_bufferPools) bufferBlocks += static_cast<std::uint32_t>(pool.size());
+
+	const auto budget = GetBudget();
+	if (budget.AllocationCount > bufferBlocks || budget.DedicatedCount)
+	{
+		logger::warning("GPU allocator destroyed with {} placed and {} dedicated allocations alive",
+						budget.AllocationCount - bufferBlocks, budget.DedicatedCount);
+	}
+
+	//~ buffer blocks are placed in the heaps below
+	for (auto& pool : m_bufferPools) pool.clear();
+	for (auto& pool : m_pools)		 pool.clear();
+}
+
+GPU_ALLOCATION framework::DxGpuAllocator::CreateResource(const D3D12_RESOURCE_DESC& desc,
+														 D3D12_HEAP_TYPE heapType,
+														 D3D12_RESOURCE_STATES initialState,
+														 const D3D12_CLEAR_VALUE* clearValue)
+{
+	std::lock_guard lock(m_mutex);
+	return CreateResourceLocked(desc, heapType, initialState, clearValue);
+}
+
+void framework::DxGpuAllocator::Free(GPU_ALLOCATION& allocation)
+{
+	if (!allocation.IsValid()) return;
+
+	std::lock_guard lock(m_mutex);
+	FreeLocked(allocation);
+}
+
+GPU_BUFFER_ALLOCATION framework::DxGpuAllocator::AllocateBuffer(std::uint64_t size,
+																std::uint64_t alignment,
+																D3D12_HEAP_TYPE heapType)
+{
+	assert(size > 0u && size <= m_nBufferBlockSize && "Small buffer larger than a buffer block, use CreateResource!");
+
+	std::lock_guard lock(m_mutex);
+
+	const std::uint32_t typeIndex = HeapTypeIndex(heapType);
+	auto& pool = m_bufferPools[ typeIndex ];
+
+	TLSF_ALLOCATION range{};
+	std::uint32_t	blockIndex = 0u;
+	for (; blockIndex < pool.size(); ++blockIndex)
+	{
+		range = pool[ blockIndex ].Allocator->Allocate(size, alignment);
+		if (range.IsValid()) break;
+	}
+
+	if (!range.IsValid())
+	{
+		D3D12_RESOURCE_DESC buffer{};
+		buffer.Dimension		  = D3D12_RESOURCE_DIMENSION_BUFFER;
+		buffer.Alignment		  = 0u;
+		buffer.Width			  = m_nBufferBlockSize;
+		buffer.Height			  = 1u;
+		buffer.DepthOrArraySize	  = 1u;
+		buffer.MipLevels		  = 1u;
+		buffer.Format			  = DXGI_FORMAT_UNKNOWN;
+		buffer.SampleDesc.Count	  = 1u;
+		buffer.SampleDesc.Quality = 0u;
+		buffer.Layout			  = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+		buffer.Flags			  = D3D12_RESOURCE_FLAG_NONE;
+
+		const D3D12_RESOURCE_STATES state = heapType == D3D12_HEAP_TYPE_UPLOAD	 ? D3D12_RESOURCE_STATE_GENERIC_READ
+										  : heapType == D3D12_HEAP_TYPE_READBACK ? D3D12_RESOURCE_STATE_COPY_DEST
+																				 : D3D12_RESOURCE_STATE_COMMON;
+
+		BUFFER_BLOCK block{};
+		block.Backing	= CreateResourceLocked(buffer, heapType, state, nullptr);
+		block.Gpu		= block.Backing.Resource->GetGPUVirtualAddress();
+		block.Allocator = std::make_unique<TlsfAllocator>(m_nBufferBlockSize, BUFFER_GRANULARITY);
+		if (heapType != D3D12_HEAP_TYPE_DEFAULT)
+		{
+			THROW_DX_IF_FAILS(block.Backing.Resource->Map(0u, nullptr, reinterpret_cast<void**>(&block.Cpu)));
+		}
+
+		blockIndex = static_cast<std::uint32_t>(pool.size());
+		range	   = block.Allocator->Allocate(size, alignment);
+		pool.push_back(std::move(block));
+	}
+
+	if (!range.IsValid()) return {};
+
+	const auto& block = pool[ blockIndex ];
+
+	GPU_BUFFER_ALLOCATION allocation{};
+	allocation.Resource = block.Backing.Resource.Get();
+	allocation.Gpu		= block.Gpu + range.Offset;
+	allocation.Cpu		= block.Cpu ? block.Cpu + range.Offset : nullptr;
+	allocation.Offset	= range.Offset;
+	allocation.Size		= range.Size;
+	allocation.Pool		= typeIndex;
+	allocation.Block	= blockIndex;
+	allocation.Handle	= range.Handle;
+	return allocation;
+}
+
+void framework::DxGpuAllocator::FreeBuffer(GPU_BUFFER_ALLOCATION& allocation)
+{
+	if (!allocation.IsValid()) return;
+
+	std::lock_guard lock(m_mutex);
+	m_bufferPools[ allocation.Pool ][ allocation.Block ].Allocator->Free(allocation.Handle);
+	allocation = {};
+}
+
+void framework::DxGpuAllocator::Trim()
+{
+	std::lock_guard lock(m_mutex);
+
+	//~ only trailing blocks go, live allocations keep their block indices
+	for (auto& pool : m_bufferPools)
+	{
+		while (pool.size() > 1u && pool.back().Allocator->IsEmpty())
+		{
+			auto& block = pool.back();
+			if (block.Cpu) block.Backing.Resource->Unmap(0u, nullptr);
+			FreeLocked(block.Backing);
+			pool.pop_back();
+		}
+	}
+
+	for (auto& pool : m_pools)
+	{
+		while (pool.size() > 1u && pool.back().Allocator->IsEmpty())
+		{
+			pool.pop_back();
+		}
+	}
+}
+
+GPU_MEMORY_BUDGET framework::DxGpuAllocator::GetBudget() const
+{
+	GPU_MEMORY_BUDGET budget{};
+	{
+		std::lock_guard lock(m_mutex);
+		for (const auto& pool : m_pools)
+		{
+			for (const auto& block : pool)
+			{
+				const auto stats = block.Allocator->GetStats();
+				budget.HeapBytes	   += stats.TotalSize;
+				budget.PlacedBytes	   += stats.UsedBytes;
+				budget.AllocationCount += stats.AllocationCount;
+				budget.Fragmentation	= (std::max)(budget.Fragmentation, stats.Fragmentation());
+				++budget.HeapCount;
+			}
+		}
+		for (const auto& pool : m_bufferPools)
+		{
+			for (const auto& block : pool) budget.BufferBytes += block.Allocator->GetUsedBytes();
+		}
+		budget.DedicatedBytes = m_nDedicatedBytes;
+		budget.DedicatedCount = m_nDedicatedCount;
+	}
+
+	if (m_pAdapter)
+	{
+		DXGI_QUERY_VIDEO_MEMORY_INFO info{};
+		if (SUCCEEDED(m_pAdapter->QueryVideoMemoryInfo(0u, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &info)))
+		{
+			budget.OsBudget = info.Budget;
+			budget.OsUsage	= info.CurrentUsage;
+		}
+	}
+	return budget;
+}
+
+std::uint32_t framework::DxGpuAllocator::HeapTypeIndex(D3D12_HEAP_TYPE type) noexcept
+{
+	switch (type)
+	{
+	case D3D12_HEAP_TYPE_UPLOAD:   return 1u;
+	case D3D12_HEAP_TYPE_READBACK: return 2u;
+	default:					   return 0u;
+	}
+}
+
+EGpuResourceKind framework::DxGpuAllocator::KindOf(const D3D12_RESOURCE_DESC& desc) noexcept
+{
+	if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER) return EGpuResourceKind::Buffer;
+	if (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL))
+	{
+		return EGpuResourceKind::RenderTarget;
+	}
+	return EGpuResourceKind::Texture;
+}
+
+std::uint32_t framework::DxGpuAllocator::PoolIndex(D3D12_HEAP_TYPE type, EGpuResourceKind kind) noexcept
+{
+	return HeapTypeIndex(type) * static_cast<std::uint32_t>(EGpuResourceKind::Count) + static_cast<std::uint32_t>(kind);
+}
+
+GPU_ALLOCATION framework::DxGpuAllocator::CreateResourceLocked(const D3D12_RESOURCE_DESC& desc,
+															   D3D12_HEAP_TYPE heapType,
+															   D3D12_RESOURCE_STATES initialState,
+															   const D3D12_CLEAR_VALUE* clearValue)
+{
+	const auto info = m_pDevice->GetResourceAllocationInfo(0u, 1u, &desc);
+	if (info.SizeInBytes > m_nHeapBlockSize)
+	{
+		return CreateDedicated(desc, heapType, initialState, clearValue, info.SizeInBytes);
+	}
+
+	const EGpuResourceKind kind = KindOf(desc);
+	const std::uint32_t	   pool = PoolIndex(heapType, kind);
+
+	TLSF_ALLOCATION range{};
+	std::uint32_t	blockIndex = 0u;
+	for (; blockIndex < m_pools[ pool ].size(); ++blockIndex)
+	{
+		range = m_pools[ pool ][ blockIndex ].Allocator->Allocate(info.SizeInBytes, info.Alignment);
+		if (range.IsValid()) break;
+	}
+
+	if (!range.IsValid())
+	{
+		blockIndex = AddHeapBlock(pool, heapType, kind);
+		range	   = m_pools[ pool ][ blockIndex ].Allocator->Allocate(info.SizeInBytes, info.Alignment);
+	}
+	assert(range.IsValid() && "Fresh heap block could not hold the resource!");
+
+	auto& block = m_pools[ pool ][ blockIndex ];
+
+	GPU_ALLOCATION allocation{};
+	const HRESULT hr = m_pDevice->CreatePlacedResource(
+		block.Heap.Get(),
+		range.Offset,
+		&desc,
+		initialState,
+		clearValue,
+		IID_PPV_ARGS(allocation.Resource.GetAddressOf()));
+	if (FAILED(hr))
+	{
+		block.Allocator->Free(range.Handle);
+		THROW_DX_IF_FAILS(hr);
+	}
+
+	allocation.Offset = range.Offset;
+	allocation.Size	  = range.Size;
+	allocation.Pool	  = pool;
+	allocation.Block  = blockIndex;
+	allocation.Handle = range.Handle;
+	return allocation;
+}
+
+void framework::DxGpuAllocator::FreeLocked(GPU_ALLOCATION& allocation)
+{
+	//~ the resource goes first, its range must not be reused while it exists
+	allocation.Resource.Reset();
+
+	if (allocation.IsDedicated())
+	{
+		m_nDedicatedBytes -= allocation.Size;
+		--m_nDedicatedCount;
+	}
+	else
+	{
+		m_pools[ allocation.Pool ][ allocation.Block ].Allocator->Free(allocation.Handle);
+	}
+	allocation = {};
+}
+
+GPU_ALLOCATION framework::DxGpuAllocator::CreateDedicated(const D3D12_RESOURCE_DESC& desc,
+														  D3D12_HEAP_TYPE heapType,
+														  D3D12_RESOURCE_STATES initialState,
+														  const D3D12_CLEAR_VALUE* clearValue,
+														  std::uint64_t size)
+{
+	D3D12_HEAP_PROPERTIES properties{};
+	properties.Type					= heapType;
+	properties.CPUPageProperty		= D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	properties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	properties.CreationNodeMask		= 1u;
+	properties.VisibleNodeMask		= 1u;
+
+	GPU_ALLOCATION allocation{};
+	THROW_DX_IF_FAILS(m_pDevice->CreateCommittedResource(
+		&properties,
+		D3D12_HEAP_FLAG_NONE,
+		&desc,
+		initialState,
+		clearValue,
+		IID_PPV_ARGS(allocation.Resource.GetAddressOf())));
+
+	allocation.Size = size;
+	m_nDedicatedBytes += size;
+	++m_nDedicatedCount;
+	return allocation;
+}
+
+std::uint32_t framework::DxGpuAllocator::AddHeapBlock(std::uint32_t pool, D3D12_HEAP_TYPE heapType, EGpuResourceKind kind)
+{
+	D3D12_HEAP_DESC desc{};
+	desc.SizeInBytes					= m_nHeapBlockSize;
+	desc.Properties.Type				= heapType;
+	desc.Properties.CPUPageProperty		= D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	desc.Properties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	desc.Properties.CreationNodeMask	= 1u;
+	desc.Properties.VisibleNodeMask		= 1u;
+
+	switch (kind)
+	{
+	case EGpuResourceKind::Buffer:
+		desc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+		desc.Flags	   = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+		break;
+	case EGpuResourceKind::Texture:
+		desc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+		desc.Flags	   = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+		break;
+	default:
+		//~ MSAA targets need 4MB placement
+		desc.Alignment = D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT;
+		desc.Flags	   = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+		break;
+	}
+
+	HEAP_BLOCK block{};
+	THROW_DX_IF_FAILS(m_pDevice->CreateHeap(&desc, IID_PPV_ARGS(block.Heap.GetAddressOf())));
+	block.Allocator = std::make_unique<TlsfAllocator>(m_nHeapBlockSize, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+
+	logger::debug("GPU allocator: new {} MB heap block in pool {}", m_nHeapBlockSize >> 20u, pool);
+
+	m_pools[ pool ].push_back(std::move(block));
+	return static_cast<std::uint32_t>(m_pools[ pool ].size() - 1u);
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <d3d12.h>
+#include <dxgi1_4.h>
+#include <wrl/client.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "command_recorder.h"
+#include "framework/render_manager/tlsf_allocator.h"
+
+namespace framework
+{
+	//~ resource heap tier 1 keeps these apart, each one gets its own heaps
+	enum class EGpuResourceKind : std::uint8_t
+	{
+		Buffer = 0,
+		Texture,
+		RenderTarget, //~ render target or depth stencil textures
+		Count
+	};
+
+	//~ a placed (or dedicated committed) resource, give it back with Free
+	typedef struct _GPU_ALLOCATION
+	{
+		Microsoft::WRL::ComPtr<ID3D12Resource> Resource{ nullptr };
+		std::uint64_t Offset { 0u }; //~ inside its heap
+		std::uint64_t Size	 { 0u };
+		std::uint32_t Pool	 { 0u };
+		std::uint32_t Block	 { 0u };
+		TlsfHandle	  Handle { INVALID_TLSF_HANDLE }; //~ INVALID for dedicated resources
+
+		bool IsValid	() const noexcept { return Resource != nullptr; }
+		bool IsDedicated() const noexcept { return Handle == INVALID_TLSF_HANDLE; }
+	} GPU_ALLOCATION;
+
+	//~ a range inside one shared buffer, for constants, vertices and other small data
+	typedef struct _GPU_BUFFER_ALLOCATION
+	{
+		ID3D12Resource*	  Resource{ nullptr };
+		GpuVirtualAddress Gpu	  { 0u };
+		std::uint8_t*	  Cpu	  { nullptr }; //~ only for upload heaps
+		std::uint64_t	  Offset  { 0u };
+		std::uint64_t	  Size	  { 0u };
+		std::uint32_t	  Pool	  { 0u };
+		std::uint32_t	  Block	  { 0u };
+		TlsfHandle		  Handle  { INVALID_TLSF_HANDLE };
+
+		bool IsValid() const noexcept { return Handle != INVALID_TLSF_HANDLE; }
+	} GPU_BUFFER_ALLOCATION;
+
+	typedef struct _GPU_MEMORY_BUDGET
+	{
+		std::uint64_t HeapBytes		  { 0u }; //~ reserved by ID3D12Heap blocks
+		std::uint64_t PlacedBytes	  { 0u }; //~ handed out of those heaps
+		std::uint64_t DedicatedBytes  { 0u }; //~ committed resources too large for a block
+		std::uint64_t BufferBytes	  { 0u }; //~ small buffer ranges in use
+		std::uint32_t HeapCount		  { 0u };
+		std::uint32_t AllocationCount { 0u };
+		std::uint32_t DedicatedCount  { 0u };
+		double		  Fragmentation	  { 0.0 }; //~ worst heap block
+		std::uint64_t OsBudget		  { 0u }; //~ local segment, 0 when the adapter can not report it
+		std::uint64_t OsUsage		  { 0u };
+	} GPU_MEMORY_BUDGET;
+
+	/// <summary>
+	/// Placed resource allocator: large ID3D12Heap blocks per heap type and resource kind,
+	/// sub-allocated with TlsfAllocator. Small buffers share big placed buffers and get
+	/// 256 byte aligned ranges instead of a 64KB resource each. Resources larger than a
+	/// block become dedicated committed resources.
+	/// Frees are immediate, the owner makes sure the GPU is done with the resource.
+	/// Defragmentation is left to the owner through TlsfAllocator::Defragment, moving a placed
+	/// resource needs a copy only the owner can record.
+	/// </summary>
+	class DxGpuAllocator
+	{
+	public:
+		static constexpr std::uint64_t DEFAULT_HEAP_BLOCK_SIZE	 = 64ull * 1024ull * 1024ull;
+		static constexpr std::uint64_t DEFAULT_BUFFER_BLOCK_SIZE = 4ull * 1024ull * 1024ull;
+		static constexpr std::uint64_t BUFFER_GRANULARITY		 = 256u;
+
+		DxGpuAllocator(ID3D12Device* device,
+					   IDXGIAdapter* adapter,
+					   std::uint64_t heapBlockSize	 = DEFAULT_HEAP_BLOCK_SIZE,
+					   std::uint64_t bufferBlockSize = DEFAULT_BUFFER_BLOCK_SIZE);
+		~DxGpuAllocator();
+
+		DxGpuAllocator(const DxGpuAllocator&) = delete;
+		DxGpuAllocator& operator=(const DxGpuAllocator&) = delete;
+
+		GPU_ALLOCATION CreateResource(const D3D12_RESOURCE_DESC& desc,
+									  D3D12_HEAP_TYPE heapType,
+									  D3D12_RESOURCE_STATES initialState,
+									  const D3D12_CLEAR_VALUE* clearValue = nullptr);
+		void		   Free			 (GPU_ALLOCATION& allocation);
+
+		//~ alignment is a power of two, 256 for constant buffers
+		GPU_BUFFER_ALLOCATION AllocateBuffer(std::uint64_t size,
+											 std::uint64_t alignment = BUFFER_GRANULARITY,
+											 D3D12_HEAP_TYPE heapType = D3D12_HEAP_TYPE_UPLOAD);
+		void				  FreeBuffer	(GPU_BUFFER_ALLOCATION& allocation);
+
+		//~ releases heap and buffer blocks that are empty, keeps one per pool warm
+		void Trim();
+
+		//~ Getters
+		GPU_MEMORY_BUDGET GetBudget() const;
+
+	private:
+		typedef struct _HEAP_BLOCK
+		{
+			Microsoft::WRL::ComPtr<ID3D12Heap> Heap{ nullptr };
+			std::unique_ptr<TlsfAllocator>	   Allocator{ nullptr };
+		} HEAP_BLOCK;
+
+		typedef struct _BUFFER_BLOCK
+		{
+			GPU_ALLOCATION				   Backing{};
+			std::uint8_t*				   Cpu	  { nullptr };
+			GpuVirtualAddress			   Gpu	  { 0u };
+			std::unique_ptr<TlsfAllocator> Allocator{ nullptr };
+		} BUFFER_BLOCK;
+
+		static constexpr std::uint32_t HEAP_TYPE_COUNT = 3u; //~ default, upload, readback
+
+		static std::uint32_t	HeapTypeIndex(D3D12_HEAP_TYPE type) noexcept;
+		static EGpuResourceKind KindOf		 (const D3D12_RESOURCE_DESC& desc) noexcept;
+		static std::uint32_t	PoolIndex	 (D3D12_HEAP_TYPE type, EGpuResourceKind kind) noexcept;
+
+		//~ callers hold m_mutex
+		GPU_ALLOCATION CreateResourceLocked(const D3D12_RESOURCE_DESC& desc,
+											D3D12_HEAP_TYPE heapType,
+											D3D12_RESOURCE_STATES initialState,
+											const D3D12_CLEAR_VALUE* clearValue);
+		void		   FreeLocked		   (GPU_ALLOCATION& allocation);
+		GPU_ALLOCATION CreateDedicated	   (const D3D12_RESOURCE_DESC& desc,
+											D3D12_HEAP_TYPE heapType,
+											D3D12_RESOURCE_STATES initialState,
+											const D3D12_CLEAR_VALUE* clearValue,
+											std::uint64_t size);
+		std::uint32_t  AddHeapBlock		   (std::uint32_t pool, D3D12_HEAP_TYPE heapType, EGpuResourceKind kind);
+
+	private:
+		ID3D12Device*						  m_pDevice { nullptr };
+		Microsoft::WRL::ComPtr<IDXGIAdapter3> m_pAdapter{ nullptr }; //~ null when budget queries are unsupported
+		std::uint64_t m_nHeapBlockSize  { 0u };
+		std::uint64_t m_nBufferBlockSize{ 0u };
+
+		std::vector<HEAP_BLOCK>	  m_pools	   [ HEAP_TYPE_COUNT * static_cast<std::uint32_t>(EGpuResourceKind::Count) ]{};
+		std::vector<BUFFER_BLOCK> m_bufferPools[ HEAP_TYPE_COUNT ]{};
+
+		std::uint64_t m_nDedicatedBytes{ 0u };
+		std::uint32_t m_nDedicatedCount{ 0u };
+
+		mutable std::mutex m_mutex{};
+	};
+} // namespace framework
@@ -0,0 +1,372 @@
+#include "dx_pipeline_cache.h"
+
+#include "framework/exception/dx_exception.h"
+#include "framework/render_manager/state_hash.h"
+#include "utility/logger/logger.h"
+
+#include <cassert>
+#include <chrono>
+
+using namespace framework;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	//~ adapter and user mode driver, blobs of another driver are refused by it anyway
+	std::uint64_t DeviceIdOf(IDXGIAdapter* adapter)
+	{
+		if (!adapter) return 0u;
+
+		DXGI_ADAPTER_DESC desc{};
+		LARGE_INTEGER	  driver{};
+		if (FAILED(adapter->GetDesc(&desc))) return 0u;
+		adapter->CheckInterfaceSupport(__uuidof(IDXGIDevice), &driver);
+
+		StateHasher hasher{};
+		hasher.Add(desc.VendorId).Add(desc.DeviceId).Add(desc.SubSysId).Add(desc.Revision);
+		hasher.Add(static_cast<std::int64_t>(driver.QuadPart));
+		return hasher.Get();
+	}
+
+	const char* ToString(EPipelineCacheLoad result) noexcept
+	{
+		switch (result)
+		{
+		case EPipelineCacheLoad::Loaded:		  return "loaded";
+		case EPipelineCacheLoad::Missing:		  return "missing, cold start";
+		case EPipelineCacheLoad::VersionMismatch: return "older format, discarded";
+		case EPipelineCacheLoad::DeviceMismatch:  return "other adapter or driver, discarded";
+		case EPipelineCacheLoad::Corrupt:		  return "corrupt, discarded";
+		default:								  return "unknown";
+		}
+	}
+
+	void HashShader(StateHasher& hasher, const D3D12_SHADER_BYTECODE& shader) noexcept
+	{
+		hasher.Add(static_cast<std::uint64_t>(shader.BytecodeLength));
+		if (shader.pShaderBytecode && shader.BytecodeLength)
+		{
+			hasher.Add(HashBytes(shader.pShaderBytecode, shader.BytecodeLength));
+		}
+	}
+
+	//~ field by field, the D3D12 descs have padding bytes with undefined values
+	void HashBlend(StateHasher& hasher, const D3D12_BLEND_DESC& blend) noexcept
+	{
+		hasher.Add(blend.AlphaToCoverageEnable).Add(blend.IndependentBlendEnable);
+		for (const auto& target : blend.RenderTarget)
+		{
+			hasher.Add(target.BlendEnable).Add(target.LogicOpEnable);
+			hasher.Add(target.SrcBlend).Add(target.DestBlend).Add(target.BlendOp);
+			hasher.Add(target.SrcBlendAlpha).Add(target.DestBlendAlpha).Add(target.BlendOpAlpha);
+			hasher.Add(target.LogicOp).Add(target.RenderTargetWriteMask);
+		}
+	}
+
+	void HashRasterizer(StateHasher& hasher, const D3D12_RASTERIZER_DESC& raster) noexcept
+	{
+		hasher.Add(raster.FillMode).Add(raster.CullMode).Add(raster.FrontCounterClockwise);
+		hasher.Add(raster.DepthBias).Add(raster.DepthBiasClamp).Add(raster.SlopeScaledDepthBias);
+		hasher.Add(raster.DepthClipEnable).Add(raster.MultisampleEnable).Add(raster.AntialiasedLineEnable);
+		hasher.Add(raster.ForcedSampleCount).Add(raster.ConservativeRaster);
+	}
+
+	void HashStencilOp(StateHasher& hasher, const D3D12_DEPTH_STENCILOP_DESC& op) noexcept
+	{
+		hasher.Add(op.StencilFailOp).Add(op.StencilDepthFailOp).Add(op.StencilPassOp).Add(op.StencilFunc);
+	}
+
+	void HashDepthStencil(StateHasher& hasher, const D3D12_DEPTH_STENCIL_DESC& depth) noexcept
+	{
+		hasher.Add(depth.DepthEnable).Add(depth.DepthWriteMask).Add(depth.DepthFunc);
+		hasher.Add(depth.StencilEnable).Add(depth.StencilReadMask).Add(depth.StencilWriteMask);
+		HashStencilOp(hasher, depth.FrontFace);
+		HashStencilOp(hasher, depth.BackFace);
+	}
+
+	void HashInputLayout(StateHasher& hasher, const D3D12_INPUT_LAYOUT_DESC& layout) noexcept
+	{
+		hasher.Add(layout.NumElements);
+		for (UINT i = 0u; i < layout.NumElements; ++i)
+		{
+			const auto& element = layout.pInputElementDescs[ i ];
+			hasher.AddString(element.SemanticName ? element.SemanticName : "");
+			hasher.Add(element.SemanticIndex).Add(element.Format).Add(element.InputSlot);
+			hasher.Add(element.AlignedByteOffset).Add(element.InputSlotClass).Add(element.InstanceDataStepRate);
+		}
+	}
+} // namespace
+
+framework::DxPipelineCache::DxPipelineCache(
+	ID3D12Device* device,
+	IDXGIAdapter* adapter,
+	std::filesystem::path path,
+	JobSystem* jobs)
+	: m_pDevice(device), m_pJobs(jobs), m_path(std::move(path)), m_file(DeviceIdOf(adapter))
+{
+	assert(m_pDevice && "Pipeline cache needs a device!");
+
+	const auto result = m_file.Load(m_path);
+	logger::info("Pipeline cache {}: {}, {} blobs", m_path.string(), ToString(result), m_file.GetEntryCount());
+}
+
+framework::DxPipelineCache::~DxPipelineCache()
+{
+	WaitIdle();
+	Save();
+
+	const auto stats = GetStats();
+	logger::info("Pipeline cache: {} requests, {} shared, {} warm, {} compiled, {} rejected blobs, {} root signatures ({} shared)",
+				 stats.Requests, stats.Deduplicated, stats.WarmStarts, stats.Compiled, stats.RejectedBlobs,
+				 stats.RootSignatures, stats.SharedRootSignatures);
+}
+
+Microsoft::WRL::ComPtr<ID3D12RootSignature> framework::DxPipelineCache::CreateRootSignature(ID3DBlob* serialized)
+{
+	assert(serialized && "Root signature needs a serialized blob!");
+	const auto hash = HashBytes(serialized->GetBufferPointer(), serialized->GetBufferSize());
+
+	std::lock_guard lock(m_mutex);
+	if (const auto it = m_rootSignatures.find(hash); it != m_rootSignatures.end())
+	{
+		++m_stats.SharedRootSignatures;
+		return it->second;
+	}
+
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature{ nullptr };
+	THROW_DX_IF_FAILS(m_pDevice->CreateRootSignature(
+		0u,
+		serialized->GetBufferPointer(),
+		serialized->GetBufferSize(),
+		IID_PPV_ARGS(rootSignature.GetAddressOf())));
+
+	m_rootSignatures[ hash ]					= rootSignature;
+	m_rootSignatureHashes[ rootSignature.Get() ] = hash;
+	++m_stats.RootSignatures;
+	return rootSignature;
+}
+
+Microsoft::WRL::ComPtr<ID3D12PipelineState> framework::DxPipelineCache::GetOrCreate(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+{
+	return Request(desc, false).get();
+}
+
+std::shared_future<ID3D12PipelineState*> framework::DxPipelineCache::GetOrCreateAsync(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+{
+	return Request(desc, true);
+}
+
+bool framework::DxPipelineCache::Release(ID3D12PipelineState* pipeline)
+{
+	std::lock_guard lock(m_mutex);
+
+	//~ compiling entries are still referenced by their job
+	const auto erased = std::erase_if(m_pipelines, [pipeline](const auto& entry)
+	{
+		return entry.second->Pipeline.Get() == pipeline
+			&& entry.second->Ready.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	});
+	return erased != 0u;
+}
+
+void framework::DxPipelineCache::WaitIdle()
+{
+	std::vector<std::shared_future<ID3D12PipelineState*>> pending{};
+	{
+		std::lock_guard lock(m_mutex);
+		pending.reserve(m_pipelines.size());
+		for (const auto& [key, entry] : m_pipelines) pending.push_back(entry->Ready);
+	}
+	for (const auto& ready : pending) ready.wait();
+}
+
+bool framework::DxPipelineCache::Save()
+{
+	if (!m_file.IsDirty()) return true;
+
+	if (!m_file.Save(m_path))
+	{
+		logger::warning("Pipeline cache could not be written to {}", m_path.string());
+		return false;
+	}
+	logger::info("Pipeline cache saved {} blobs ({} bytes) to {}", m_file.GetEntryCount(), m_file.GetByteSize(), m_path.string());
+	return true;
+}
+
+std::uint64_t framework::DxPipelineCache::Hash(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc) const
+{
+	assert(desc.StreamOutput.NumEntries == 0u && "Stream output is not supported by the pipeline cache!");
+
+	StateHasher hasher{};
+	hasher.Add(HashRootSignature(desc.pRootSignature));
+	HashShader(hasher, desc.VS);
+	HashShader(hasher, desc.PS);
+	HashShader(hasher, desc.DS);
+	HashShader(hasher, desc.HS);
+	HashShader(hasher, desc.GS);
+	HashBlend(hasher, desc.BlendState);
+	hasher.Add(desc.SampleMask);
+	HashRasterizer(hasher, desc.RasterizerState);
+	HashDepthStencil(hasher, desc.DepthStencilState);
+	HashInputLayout(hasher, desc.InputLayout);
+	hasher.Add(desc.IBStripCutValue).Add(desc.PrimitiveTopologyType).Add(desc.NumRenderTargets);
+	for (UINT i = 0u; i < desc.NumRenderTargets && i < 8u; ++i) hasher.Add(desc.RTVFormats[ i ]);
+	hasher.Add(desc.DSVFormat).Add(desc.SampleDesc.Count).Add(desc.SampleDesc.Quality);
+	hasher.Add(desc.NodeMask).Add(desc.Flags);
+	return hasher.Get();
+}
+
+PIPELINE_CACHE_STATS framework::DxPipelineCache::GetStats() const
+{
+	std::lock_guard lock(m_mutex);
+	return m_stats;
+}
+
+std::shared_future<ID3D12PipelineState*> framework::DxPipelineCache::Request(
+	const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc,
+	bool async)
+{
+	const auto key = Hash(desc);
+
+	auto promise = std::make_shared<std::promise<ID3D12PipelineState*>>();
+	PIPELINE_ENTRY* entry = nullptr;
+	std::shared_future<ID3D12PipelineState*> ready{};
+	{
+		std::lock_guard lock(m_mutex);
+		++m_stats.Requests;
+		if (const auto it = m_pipelines.find(key); it != m_pipelines.end())
+		{
+			++m_stats.Deduplicated;
+			return it->second->Ready;
+		}
+
+		auto& slot	= m_pipelines[ key ];
+		slot		= std::make_unique<PIPELINE_ENTRY>();
+		slot->Ready = promise->get_future().share();
+		entry		= slot.get();
+		ready		= slot->Ready;
+	}
+
+	if (async && m_pJobs)
+	{
+		auto owned = Copy(desc);
+		m_pJobs->Submit([this, key, owned, promise, entry]()
+		{
+			try
+			{
+				promise->set_value(Create(key, owned->Desc, *entry));
+			}
+			catch (...)
+			{
+				Fail(key, *promise);
+			}
+		});
+		return ready;
+	}
+
+	try
+	{
+		promise->set_value(Create(key, desc, *entry));
+	}
+	catch (...)
+	{
+		Fail(key, *promise);
+	}
+	return ready;
+}
+
+void framework::DxPipelineCache::Fail(std::uint64_t key, std::promise<ID3D12PipelineState*>& promise)
+{
+	{
+		std::lock_guard lock(m_mutex);
+		m_pipelines.erase(key);
+		++m_stats.Failed;
+	}
+	promise.set_exception(std::current_exception());
+}
+
+std::shared_ptr<DxPipelineCache::OWNED_PIPELINE_DESC> framework::DxPipelineCache::Copy(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+{
+	auto owned = std::make_shared<OWNED_PIPELINE_DESC>();
+	owned->Desc			 = desc;
+	owned->RootSignature = desc.pRootSignature;
+
+	D3D12_SHADER_BYTECODE* shaders[ 5 ]{ &owned->Desc.VS, &owned->Desc.PS, &owned->Desc.DS, &owned->Desc.HS, &owned->Desc.GS };
+	for (std::size_t i = 0u; i < 5u; ++i)
+	{
+		const auto* bytes = static_cast<const std::uint8_t*>(shaders[ i ]->pShaderBytecode);
+		if (!bytes) continue;
+
+		owned->Shaders[ i ].assign(bytes, bytes + shaders[ i ]->BytecodeLength);
+		shaders[ i ]->pShaderBytecode = owned->Shaders[ i ].data();
+	}
+
+	//~ names first, the element copies point into them
+	const UINT count = desc.InputLayout.NumElements;
+	owned->SemanticNames.reserve(count);
+	owned->InputElements.assign(desc.InputLayout.pInputElementDescs, desc.InputLayout.pInputElementDescs + count);
+	for (auto& element : owned->InputElements)
+	{
+		owned->SemanticNames.emplace_back(element.SemanticName ? element.SemanticName : "");
+		element.SemanticName = owned->SemanticNames.back().c_str();
+	}
+	owned->Desc.InputLayout = { owned->InputElements.data(), count };
+	owned->Desc.CachedPSO	= {};
+	return owned;
+}
+
+std::uint64_t framework::DxPipelineCache::HashRootSignature(ID3D12RootSignature* rootSignature) const
+{
+	std::lock_guard lock(m_mutex);
+	if (const auto it = m_rootSignatureHashes.find(rootSignature); it != m_rootSignatureHashes.end()) return it->second;
+
+	//~ created outside the cache, still deduplicated within this run but never found on disk
+	return HashBytes(&rootSignature, sizeof(rootSignature));
+}
+
+ID3D12PipelineState* framework::DxPipelineCache::Create(
+	std::uint64_t key,
+	const D3D12_GRAPHICS_PIPELINE_STATE_DESC& source,
+	PIPELINE_ENTRY& entry)
+{
+	const auto start = Clock::now();
+
+	auto desc = source;
+	desc.CachedPSO = {};
+
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> pipeline{ nullptr };
+	bool warm	  = false;
+	bool rejected = false;
+
+	std::vector<std::uint8_t> blob{};
+	if (m_file.Find(key, blob))
+	{
+		desc.CachedPSO = { blob.data(), blob.size() };
+		warm	 = SUCCEEDED(m_pDevice->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(pipeline.GetAddressOf())));
+		rejected = !warm;
+		desc.CachedPSO = {};
+		if (!warm) pipeline.Reset();
+	}
+
+	if (!pipeline)
+	{
+		THROW_DX_IF_FAILS(m_pDevice->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(pipeline.GetAddressOf())));
+
+		Microsoft::WRL::ComPtr<ID3DBlob> cached{ nullptr };
+		if (SUCCEEDED(pipeline->GetCachedBlob(cached.GetAddressOf())) && cached)
+		{
+			m_file.Store(key, cached->GetBufferPointer(), cached->GetBufferSize());
+		}
+	}
+
+	const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	std::lock_guard lock(m_mutex);
+	entry.Pipeline = pipeline;
+	m_stats.WarmStarts	  += warm ? 1u : 0u;
+	m_stats.Compiled	  += warm ? 0u : 1u;
+	m_stats.RejectedBlobs += rejected ? 1u : 0u;
+	m_stats.CreateMs	  += ms;
+	return entry.Pipeline.Get();
+}
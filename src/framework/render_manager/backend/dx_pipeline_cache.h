@@ -0,0 +1,113 @@
+#pragma once
+
+#include <d3d12.h>
+#include <dxgi.h>
+#include <wrl/client.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "framework/render_manager/pipeline_cache_file.h"
+#include "utility/thread/job_system.h"
+
+namespace framework
+{
+	typedef struct _PIPELINE_CACHE_STATS
+	{
+		std::uint32_t Requests		{ 0u };
+		std::uint32_t Deduplicated	{ 0u }; //~ answered by a pipeline already created (or compiling) this run
+		std::uint32_t WarmStarts	{ 0u }; //~ created from a blob of the disk cache
+		std::uint32_t Compiled		{ 0u }; //~ compiled from bytecode
+		std::uint32_t RejectedBlobs { 0u }; //~ disk blobs the driver refused, compiled instead
+		std::uint32_t RootSignatures{ 0u };
+		std::uint32_t SharedRootSignatures{ 0u }; //~ requests answered by an identical root signature
+		std::uint32_t Failed		{ 0u }; //~ creations that threw, their entry is dropped
+		double		  CreateMs		{ 0.0 }; //~ summed over creations, workers overlap
+	} PIPELINE_CACHE_STATS;
+
+	/// <summary>
+	/// Graphics pipelines keyed by a hash of the whole D3D12_GRAPHICS_PIPELINE_STATE_DESC, shader
+	/// bytecode included, so identical descriptions from different layers share one PSO.
+	/// Driver blobs (GetCachedBlob) persist in a PipelineCacheFile for warm starts; a blob the
+	/// driver refuses is dropped and the pipeline compiled again. Creation can run on the job system.
+	/// Root signatures go through CreateRootSignature so their serialized form is part of the key.
+	/// </summary>
+	class DxPipelineCache
+	{
+	public:
+		DxPipelineCache(ID3D12Device* device,
+						IDXGIAdapter* adapter,
+						std::filesystem::path path,
+						JobSystem* jobs = nullptr);
+		~DxPipelineCache(); //~ waits for pending compiles and saves
+
+		DxPipelineCache(const DxPipelineCache&) = delete;
+		DxPipelineCache& operator=(const DxPipelineCache&) = delete;
+
+		Microsoft::WRL::ComPtr<ID3D12RootSignature> CreateRootSignature(ID3DBlob* serialized);
+
+		//~ blocks until the pipeline exists
+		Microsoft::WRL::ComPtr<ID3D12PipelineState> GetOrCreate(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+
+		//~ compiles on the job system, desc is deep copied so the caller's bytecode and input
+		//~ layout may go away right after. The pipeline lives as long as the cache
+		std::shared_future<ID3D12PipelineState*> GetOrCreateAsync(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+
+		//~ drops the cache reference of a pipeline replaced for good (hot reload), its disk blob stays
+		bool Release (ID3D12PipelineState* pipeline);
+		void WaitIdle();
+		bool Save	 ();
+
+		//~ Getters
+		std::uint64_t		 Hash	 (const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc) const;
+		PIPELINE_CACHE_STATS GetStats() const;
+
+	private:
+		//~ a description that owns everything it points to
+		typedef struct _OWNED_PIPELINE_DESC
+		{
+			D3D12_GRAPHICS_PIPELINE_STATE_DESC	  Desc{};
+			Microsoft::WRL::ComPtr<ID3D12RootSignature> RootSignature{ nullptr };
+			std::vector<std::uint8_t>			  Shaders[ 5 ]{}; //~ VS, PS, DS, HS, GS
+			std::vector<D3D12_INPUT_ELEMENT_DESC> InputElements{};
+			std::vector<std::string>			  SemanticNames{};
+		} OWNED_PIPELINE_DESC;
+
+		typedef struct _PIPELINE_ENTRY
+		{
+			Microsoft::WRL::ComPtr<ID3D12PipelineState> Pipeline{ nullptr };
+			std::shared_future<ID3D12PipelineState*>	Ready{};
+		} PIPELINE_ENTRY;
+
+		static std::shared_ptr<OWNED_PIPELINE_DESC> Copy(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+
+		//~ finds or registers the entry, then creates it here or on the job system
+		std::shared_future<ID3D12PipelineState*> Request(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, bool async);
+
+		std::uint64_t		 HashRootSignature(ID3D12RootSignature* rootSignature) const;
+		ID3D12PipelineState* Create			  (std::uint64_t key,
+											   const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc,
+											   PIPELINE_ENTRY& entry);
+		//~ called from a catch block, drops the entry so the next request tries again
+		void				 Fail			  (std::uint64_t key, std::promise<ID3D12PipelineState*>& promise);
+
+	private:
+		ID3D12Device*		  m_pDevice{ nullptr };
+		JobSystem*			  m_pJobs  { nullptr };
+		std::filesystem::path m_path   {};
+		PipelineCacheFile	  m_file;
+
+		std::unordered_map<std::uint64_t, std::unique_ptr<PIPELINE_ENTRY>>		 m_pipelines	 {};
+		std::unordered_map<std::uint64_t, Microsoft::WRL::ComPtr<ID3D12RootSignature>> m_rootSignatures{};
+		std::unordered_map<ID3D12RootSignature*, std::uint64_t>				 m_rootSignatureHashes{};
+		PIPELINE_CACHE_STATS m_stats{};
+
+		mutable std::mutex m_mutex{};
+	};
+} // namespace framework
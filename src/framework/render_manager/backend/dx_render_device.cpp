@@ -0,0 +1,60 @@
+#include "dx_render_device.h"
+#include "dx_command_recorder.h"
+
+#include "framework/exception/dx_exception.h"
+#include "framework/render_manager/render_manager.h"
+#include "utility/logger/logger.h"
+
+#include <cassert>
+
+using namespace framework;
+
+framework::DxRenderDevice::DxRenderDevice(DxRenderManager* manager)
+	: m_pRender(manager)
+{
+	assert(m_pRender && "Render device needs a render manager!");
+	m_pWaiter = std::make_unique<DxFenceWaiter>(m_pRender->m_pFence.Get());
+}
+
+void framework::DxRenderDevice::ExecuteCommandLists(ICommandRecorder* const* recorders, std::uint32_t count)
+{
+	m_nativeLists.clear();
+	for (std::uint32_t i = 0u; i < count; ++i)
+	{
+		assert(recorders[ i ] && recorders[ i ]->GetBackendType() == EBackendType::D3D12
+			   && "D3D12 device can only execute D3D12 command lists!");
+		m_nativeLists.push_back(static_cast<DxCommandRecorder*>(recorders[ i ])->GetNative());
+	}
+
+	if (m_nativeLists.empty()) return;
+	m_pRender->m_pCommandQueue->ExecuteCommandLists(
+		static_cast<UINT>(m_nativeLists.size()),
+		m_nativeLists.data());
+}
+
+void framework::DxRenderDevice::Present(std::uint32_t syncInterval, std::uint32_t flags)
+{
+	THROW_DX_IF_FAILS(m_pRender->m_pSwapChain->Present(syncInterval, flags));
+}
+
+std::uint64_t framework::DxRenderDevice::Signal()
+{
+	const auto value = ++m_pRender->m_nCurrentFence;
+	THROW_DX_IF_FAILS(m_pRender->m_pCommandQueue->Signal(m_pRender->m_pFence.Get(), value));
+	return value;
+}
+
+std::uint64_t framework::DxRenderDevice::GetCompletedFenceValue() const
+{
+	return m_pRender->m_pFence->GetCompletedValue();
+}
+
+void framework::DxRenderDevice::WaitForFence(std::uint64_t value)
+{
+	m_pWaiter->Wait(value);
+}
+
+std::unique_ptr<IFenceWaiter> framework::DxRenderDevice::CreateFenceWaiter()
+{
+	return std::make_unique<DxFenceWaiter>(m_pRender->m_pFence.Get());
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <d3d12.h>
+#include <memory>
+#include <vector>
+
+#include "dx_fence_waiter.h"
+#include "render_device.h"
+
+namespace framework
+{
+	class DxRenderManager;
+
+	/// <summary>
+	/// D3D12 submission: executes DxCommandRecorder lists on the manager's direct queue
+	/// and signals its fence, so the fence values stay shared with FlushCommandQueue.
+	/// </summary>
+	class DxRenderDevice final : public IRenderDevice
+	{
+	public:
+		explicit DxRenderDevice(DxRenderManager* manager);
+		~DxRenderDevice() override = default;
+
+		DxRenderDevice(const DxRenderDevice&) = delete;
+		DxRenderDevice& operator=(const DxRenderDevice&) = delete;
+
+		//~ IRenderDevice Impl
+		EBackendType GetBackendType() const noexcept override { return EBackendType::D3D12; }
+
+		void ExecuteCommandLists(ICommandRecorder* const* recorders, std::uint32_t count) override;
+		void Present(std::uint32_t syncInterval, std::uint32_t flags)					   override;
+
+		std::uint64_t Signal				() override;
+		std::uint64_t GetCompletedFenceValue() const override;
+		void		  WaitForFence			(std::uint64_t value) override;
+
+		std::unique_ptr<IFenceWaiter> CreateFenceWaiter() override;
+
+	private:
+		DxRenderManager*				m_pRender{ nullptr };
+		std::vector<ID3D12CommandList*> m_nativeLists{}; //~ reused scratch, submit is single threaded
+		std::unique_ptr<DxFenceWaiter>	m_pWaiter{ nullptr }; //~ WaitForFence, called from one thread at a time
+	};
+} // namespace framework
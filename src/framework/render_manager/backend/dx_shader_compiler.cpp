@@ -0,0 +1,71 @@
+#include "dx_shader_compiler.h"
+
+#include "framework/exception/dx_exception.h"
+#include "framework/render_manager/state_hash.h"
+#include "utility/logger/logger.h"
+
+#include <cstring>
+
+using namespace framework;
+
+std::uint32_t framework::DxShaderCompiler::GetDefaultFlags() noexcept
+{
+	std::uint32_t flags = 0u;
+#if defined(DEBUG) || defined(_DEBUG)
+	flags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+	return flags;
+}
+
+std::uint64_t framework::DxShaderCompiler::GetCompilerId() const noexcept
+{
+	return StateHasher{}.AddString("fxc").Add(static_cast<std::uint32_t>(D3D_COMPILER_VERSION)).Get();
+}
+
+bool framework::DxShaderCompiler::Compile(
+	const SHADER_COMPILE_DESC& desc,
+	std::vector<std::uint8_t>& bytecode,
+	std::string& errors)
+{
+	std::vector<D3D_SHADER_MACRO> macros{};
+	macros.reserve(desc.Defines.size() + 1u);
+	for (const auto& define : desc.Defines)
+	{
+		macros.push_back({ define.Name.c_str(), define.Value.c_str() });
+	}
+	macros.push_back({ nullptr, nullptr });
+
+	Microsoft::WRL::ComPtr<ID3DBlob> byteCode = nullptr;
+	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob = nullptr;
+	const HRESULT hr = D3DCompileFromFile(desc.Path.c_str(), macros.data(), D3D_COMPILE_STANDARD_FILE_INCLUDE,
+										  desc.Entry.c_str(), desc.Target.c_str(), desc.Flags, 0u,
+										  &byteCode, &errorBlob);
+
+	if (errorBlob != nullptr)
+	{
+		errors.assign(static_cast<const char*>(errorBlob->GetBufferPointer()), errorBlob->GetBufferSize());
+	}
+	if (FAILED(hr) || byteCode == nullptr) return false;
+
+	const auto* data = static_cast<const std::uint8_t*>(byteCode->GetBufferPointer());
+	bytecode.assign(data, data + byteCode->GetBufferSize());
+	return true;
+}
+
+Microsoft::WRL::ComPtr<ID3DBlob> framework::ToShaderBlob(const SHADER_BYTECODE& shader)
+{
+	if (!shader.Errors.empty())
+	{
+		OutputDebugStringA(shader.Errors.c_str());
+	}
+	if (!shader.IsValid())
+	{
+		logger::error("Shader {:016x} failed to compile: {}", shader.Key, shader.Errors);
+		THROW_DX_IF_FAILS(E_FAIL);
+	}
+
+	Microsoft::WRL::ComPtr<ID3DBlob> blob = nullptr;
+	THROW_DX_IF_FAILS(D3DCreateBlob(shader.Bytecode->size(), &blob));
+	std::memcpy(blob->GetBufferPointer(), shader.Bytecode->data(), shader.Bytecode->size());
+	return blob;
+}
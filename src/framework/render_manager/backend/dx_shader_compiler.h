@@ -0,0 +1,30 @@
+#pragma once
+
+#include <d3d12.h>
+#include <d3dcompiler.h>
+#include <wrl/client.h>
+
+#include "framework/render_manager/shader_cache.h"
+
+namespace framework
+{
+	/// <summary>
+	/// FXC through D3DCompileFromFile with the standard file include handler, the
+	/// compiler the shader cache hashes against.
+	/// </summary>
+	class DxShaderCompiler final : public IShaderCompiler
+	{
+	public:
+		//~ debug builds skip optimization, the flags are part of the cache key
+		static std::uint32_t GetDefaultFlags() noexcept;
+
+		std::uint64_t GetCompilerId() const noexcept override;
+
+		bool Compile(const SHADER_COMPILE_DESC& desc,
+					 std::vector<std::uint8_t>& bytecode,
+					 std::string& errors) override;
+	};
+
+	//~ copies cached bytecode into a blob for the pipeline descs, throws when the compile failed
+	Microsoft::WRL::ComPtr<ID3DBlob> ToShaderBlob(const SHADER_BYTECODE& shader);
+} // namespace framework
@@ -0,0 +1,219 @@
+#include "dx_upload_manager.h"
+
+#include "framework/exception/dx_exception.h"
+#include "utility/logger/logger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace framework;
+
+namespace
+{
+	D3D12_RESOURCE_DESC MakeBufferDesc(std::uint64_t size) noexcept
+	{
+		D3D12_RESOURCE_DESC resource{};
+		resource.Dimension			= D3D12_RESOURCE_DIMENSION_BUFFER;
+		resource.Alignment			= 0u;
+		resource.Width				= size;
+		resource.Height				= 1u;
+		resource.DepthOrArraySize	= 1u;
+		resource.MipLevels			= 1u;
+		resource.Format				= DXGI_FORMAT_UNKNOWN;
+		resource.SampleDesc.Count	= 1u;
+		resource.SampleDesc.Quality = 0u;
+		resource.Layout				= D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+		resource.Flags				= D3D12_RESOURCE_FLAG_NONE;
+		return resource;
+	}
+} // namespace
+
+framework::DxUploadManager::DxUploadManager(ID3D12Device* device, ID3D12CommandQueue* copyQueue, DxGpuAllocator* allocator)
+	: m_pDevice(device), m_pCopyQueue(copyQueue), m_pAllocator(allocator)
+{
+	assert(m_pDevice && m_pCopyQueue && m_pAllocator && "Upload manager needs a device, a copy queue and an allocator!");
+
+	THROW_DX_IF_FAILS(m_pDevice->CreateFence(
+		0u, D3D12_FENCE_FLAG_NONE,
+		IID_PPV_ARGS(m_pFence.GetAddressOf())));
+	m_pWaiter = std::make_unique<DxFenceWaiter>(m_pFence.Get());
+
+	auto allocator = AcquireAllocator();
+	THROW_DX_IF_FAILS(m_pDevice->CreateCommandList(
+		0u,
+		D3D12_COMMAND_LIST_TYPE_COPY,
+		allocator.Get(),
+		nullptr,
+		IID_PPV_ARGS(m_pCommandList.GetAddressOf())));
+	THROW_DX_IF_FAILS(m_pCommandList->Close());
+
+	m_freeAllocators.push_back(std::move(allocator));
+}
+
+framework::DxUploadManager::~DxUploadManager()
+{
+	//~ staging and allocators must outlive the copies reading them
+	WaitForTicket(m_nLastTicket);
+	Reclaim();
+
+	for (auto& buffer : m_buffers) m_pAllocator->Free(buffer);
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> framework::DxUploadManager::CreateBuffer(const void* data, std::uint64_t size)
+{
+	assert(data && size > 0u && "Upload needs data!");
+
+	auto allocation = m_pAllocator->CreateResource(MakeBufferDesc(size),
+												   D3D12_HEAP_TYPE_DEFAULT,
+												   D3D12_RESOURCE_STATE_COMMON);
+	assert(allocation.IsValid() && "Upload destination allocation failed!");
+	auto buffer = allocation.Resource;
+
+	std::lock_guard lock(m_mutex);
+	m_buffers.push_back(std::move(allocation));
+
+	const std::uint64_t offset = (m_pendingData.size() + STAGING_ALIGNMENT - 1u) & ~(STAGING_ALIGNMENT - 1u);
+	m_pendingData.resize(static_cast<std::size_t>(offset + size));
+	std::memcpy(m_pendingData.data() + offset, data, static_cast<std::size_t>(size));
+
+	m_pendingCopies.push_back({ buffer, offset, size });
+	return buffer;
+}
+
+void framework::DxUploadManager::ReleaseBuffer(Microsoft::WRL::ComPtr<ID3D12Resource>& buffer)
+{
+	if (!buffer) return;
+
+	{
+		std::lock_guard lock(m_mutex);
+		const auto it = std::find_if(m_buffers.begin(), m_buffers.end(),
+									 [&](const GPU_ALLOCATION& allocation) { return allocation.Resource == buffer; });
+		assert(it != m_buffers.end() && "Buffer was not created by this upload manager!");
+
+		if (it != m_buffers.end())
+		{
+			m_pAllocator->Free(*it);
+			*it = std::move(m_buffers.back());
+			m_buffers.pop_back();
+		}
+	}
+	buffer.Reset();
+}
+
+UploadTicket framework::DxUploadManager::Submit()
+{
+	std::lock_guard lock(m_mutex);
+	if (m_pendingCopies.empty()) return 0u;
+
+	UPLOAD_BATCH batch{};
+	batch.Size		= m_pendingData.size();
+	batch.Allocator = AcquireAllocator();
+
+	//~ one staging resource for the whole batch
+	batch.Staging = m_pAllocator->CreateResource(MakeBufferDesc(batch.Size),
+												 D3D12_HEAP_TYPE_UPLOAD,
+												 D3D12_RESOURCE_STATE_GENERIC_READ);
+	assert(batch.Staging.IsValid() && "Upload staging allocation failed!");
+
+	void* mapped = nullptr;
+	const D3D12_RANGE noRead{ 0u, 0u };
+	THROW_DX_IF_FAILS(batch.Staging.Resource->Map(0u, &noRead, &mapped));
+	std::memcpy(mapped, m_pendingData.data(), m_pendingData.size());
+	batch.Staging.Resource->Unmap(0u, nullptr);
+
+	THROW_DX_IF_FAILS(m_pCommandList->Reset(batch.Allocator.Get(), nullptr));
+	for (const auto& copy : m_pendingCopies)
+	{
+		m_pCommandList->CopyBufferRegion(copy.Destination.Get(), 0u,
+										 batch.Staging.Resource.Get(), copy.SourceOffset,
+										 copy.Size);
+		m_stats.BytesUploaded += copy.Size;
+	}
+	THROW_DX_IF_FAILS(m_pCommandList->Close());
+
+	ID3D12CommandList* lists[]{ m_pCommandList.Get() };
+	m_pCopyQueue->ExecuteCommandLists(1u, lists);
+
+	batch.Ticket = ++m_nLastTicket;
+	THROW_DX_IF_FAILS(m_pCopyQueue->Signal(m_pFence.Get(), batch.Ticket));
+
+	m_stats.BuffersUploaded		 += m_pendingCopies.size();
+	m_stats.BatchesSubmitted	 += 1u;
+	m_stats.StagingBytesInFlight += batch.Size;
+	m_stats.PeakStagingBytes	  = (std::max)(m_stats.PeakStagingBytes, m_stats.StagingBytesInFlight);
+
+	logger::debug("Upload batch {}: {} buffers, {} staging bytes",
+				  batch.Ticket, m_pendingCopies.size(), batch.Size);
+
+	//~ destinations are held by the caller now, the batch only needs its staging
+	m_pendingCopies.clear();
+	m_pendingData.clear();
+	m_pendingData.shrink_to_fit();
+
+	const auto ticket = batch.Ticket;
+	m_inFlight.push_back(std::move(batch));
+	m_stats.BatchesInFlight = static_cast<std::uint32_t>(m_inFlight.size());
+	return ticket;
+}
+
+void framework::DxUploadManager::QueueWait(ID3D12CommandQueue* queue, UploadTicket ticket) const
+{
+	assert(queue && "Wait needs a queue!");
+	if (ticket == 0u || IsComplete(ticket)) return;
+
+	THROW_DX_IF_FAILS(queue->Wait(m_pFence.Get(), ticket));
+}
+
+void framework::DxUploadManager::WaitForTicket(UploadTicket ticket) const
+{
+	if (ticket == 0u || IsComplete(ticket)) return;
+
+	std::lock_guard lock(m_waitMutex);
+	m_pWaiter->Wait(ticket);
+}
+
+void framework::DxUploadManager::Reclaim()
+{
+	const UploadTicket completed = m_pFence->GetCompletedValue();
+
+	std::lock_guard lock(m_mutex);
+	while (!m_inFlight.empty() && m_inFlight.front().Ticket <= completed)
+	{
+		auto& batch = m_inFlight.front();
+		m_stats.StagingBytesInFlight -= batch.Size;
+
+		THROW_DX_IF_FAILS(batch.Allocator->Reset());
+		m_freeAllocators.push_back(std::move(batch.Allocator));
+		m_pAllocator->Free(batch.Staging);
+		m_inFlight.pop_front();
+	}
+	m_stats.BatchesInFlight = static_cast<std::uint32_t>(m_inFlight.size());
+}
+
+bool framework::DxUploadManager::IsComplete(UploadTicket ticket) const
+{
+	return m_pFence->GetCompletedValue() >= ticket;
+}
+
+UPLOAD_MANAGER_STATS framework::DxUploadManager::GetStats() const
+{
+	std::lock_guard lock(m_mutex);
+	return m_stats;
+}
+
+Microsoft::WRL::ComPtr<ID3D12CommandAllocator> framework::DxUploadManager::AcquireAllocator()
+{
+	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator{ nullptr };
+	if (!m_freeAllocators.empty())
+	{
+		allocator = std::move(m_freeAllocators.back());
+		m_freeAllocators.pop_back();
+		return allocator;
+	}
+
+	THROW_DX_IF_FAILS(m_pDevice->CreateCommandAllocator(
+		D3D12_COMMAND_LIST_TYPE_COPY,
+		IID_PPV_ARGS(allocator.GetAddressOf())));
+	return allocator;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <d3d12.h>
+#include <wrl/client.h>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "dx_fence_waiter.h"
+#include "dx_gpu_allocator.h"
+
+namespace framework
+{
+	//~ fence value on the copy queue, 0 means nothing to wait for
+	using UploadTicket = std::uint64_t;
+
+	typedef struct _UPLOAD_MANAGER_STATS
+	{
+		std::uint64_t BuffersUploaded	 { 0u };
+		std::uint64_t BytesUploaded		 { 0u };
+		std::uint64_t BatchesSubmitted	 { 0u };
+		std::uint64_t StagingBytesInFlight{ 0u }; //~ upload heap memory still alive
+		std::uint64_t PeakStagingBytes	 { 0u };
+		std::uint32_t BatchesInFlight	 { 0u };
+	} UPLOAD_MANAGER_STATS;
+
+	/// <summary>
+	/// Static buffer uploads on the copy queue. CreateBuffer only queues the data, Submit
+	/// packs every queued buffer into one staging resource and records one copy list for them.
+	/// The staging resource and its allocator are released by Reclaim once the copy fence passes,
+	/// so upload heap memory only lives while a batch is in flight.
+	/// Destinations and staging are placed through DxGpuAllocator; destinations stay owned
+	/// by the manager until ReleaseBuffer, anything left is freed on destruction.
+	/// Buffers are created in the common state: the copy queue promotes them to copy dest and
+	/// they decay back, graphics reads promote them again, so no barriers are recorded.
+	/// </summary>
+	class DxUploadManager
+	{
+	public:
+		static constexpr std::uint64_t STAGING_ALIGNMENT = 256u;
+
+		DxUploadManager(ID3D12Device* device, ID3D12CommandQueue* copyQueue, DxGpuAllocator* allocator);
+		~DxUploadManager();
+
+		DxUploadManager(const DxUploadManager&) = delete;
+		DxUploadManager& operator=(const DxUploadManager&) = delete;
+
+		//~ creates the default heap buffer now, its contents are valid once the batch ticket completes
+		Microsoft::WRL::ComPtr<ID3D12Resource> CreateBuffer(const void* data, std::uint64_t size);
+
+		//~ gives the placed memory back and resets the caller's reference, the GPU must be done with it
+		void ReleaseBuffer(Microsoft::WRL::ComPtr<ID3D12Resource>& buffer);
+
+		//~ sends every queued buffer as one batch, returns 0 when nothing was queued
+		UploadTicket Submit();
+
+		//~ GPU side wait, queue stalls until the batch landed; the CPU does not block
+		void QueueWait(ID3D12CommandQueue* queue, UploadTicket ticket) const;
+
+		//~ CPU side wait, used on shutdown and by callers that need the data right away
+		void WaitForTicket(UploadTicket ticket) const;
+
+		//~ frees staging memory of completed batches, cheap to call every frame
+		void Reclaim();
+
+		//~ Getters
+		bool				 IsComplete(UploadTicket ticket) const;
+		UPLOAD_MANAGER_STATS GetStats  () const;
+
+	private:
+		typedef struct _PENDING_COPY
+		{
+			Microsoft::WRL::ComPtr<ID3D12Resource> Destination{ nullptr };
+			std::uint64_t						   SourceOffset{ 0u };
+			std::uint64_t						   Size		 { 0u };
+		} PENDING_COPY;
+
+		typedef struct _UPLOAD_BATCH
+		{
+			UploadTicket								   Ticket	{ 0u };
+			std::uint64_t								   Size		{ 0u };
+			GPU_ALLOCATION								   Staging	{};
+			Microsoft::WRL::ComPtr<ID3D12CommandAllocator> Allocator{ nullptr };
+		} UPLOAD_BATCH;
+
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> AcquireAllocator();
+
+	private:
+		ID3D12Device*		m_pDevice	{ nullptr };
+		ID3D12CommandQueue* m_pCopyQueue{ nullptr };
+		DxGpuAllocator*		m_pAllocator{ nullptr };
+
+		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_pCommandList{ nullptr };
+		Microsoft::WRL::ComPtr<ID3D12Fence>				  m_pFence		{ nullptr };
+		UploadTicket									  m_nLastTicket { 0u };
+
+		//~ CPU copy of the queued data, written into staging in one pass by Submit
+		std::vector<std::uint8_t> m_pendingData  {};
+		std::vector<PENDING_COPY> m_pendingCopies{};
+
+		std::vector<GPU_ALLOCATION> m_buffers{}; //~ live destinations, until ReleaseBuffer
+
+		std::deque<UPLOAD_BATCH>									m_inFlight	{}; //~ ordered by ticket
+		std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> m_freeAllocators{};
+
+		UPLOAD_MANAGER_STATS m_stats{};
+		mutable std::mutex	 m_mutex{};
+
+		//~ one event for every CPU wait, waits are serialized since they would share it
+		std::unique_ptr<DxFenceWaiter> m_pWaiter  { nullptr };
+		mutable std::mutex			   m_waitMutex{};
+	};
+} // namespace framework
@@ -0,0 +1,54 @@
+#include "dx_upload_memory.h"
+
+#include "framework/exception/dx_exception.h"
+
+#include <cassert>
+
+using namespace framework;
+
+framework::DxUploadMemory::DxUploadMemory(ID3D12Device* device, std::uint64_t size)
+	: m_nSize(size)
+{
+	assert(device && size > 0u && "Upload memory needs a device and a size!");
+
+	D3D12_HEAP_PROPERTIES properties{};
+	properties.Type					= D3D12_HEAP_TYPE_UPLOAD;
+	properties.CPUPageProperty		= D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	properties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	properties.CreationNodeMask		= 1u;
+	properties.VisibleNodeMask		= 1u;
+
+	D3D12_RESOURCE_DESC resource{};
+	resource.Dimension			= D3D12_RESOURCE_DIMENSION_BUFFER;
+	resource.Alignment			= 0u;
+	resource.Width				= size;
+	resource.Height				= 1u;
+	resource.DepthOrArraySize	= 1u;
+	resource.MipLevels			= 1u;
+	resource.Format				= DXGI_FORMAT_UNKNOWN;
+	resource.SampleDesc.Count	= 1u;
+	resource.SampleDesc.Quality = 0u;
+	resource.Layout				= D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	resource.Flags				= D3D12_RESOURCE_FLAG_NONE;
+
+	THROW_DX_IF_FAILS(device->CreateCommittedResource(
+		&properties,
+		D3D12_HEAP_FLAG_NONE,
+		&resource,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&m_pResource)));
+
+	//~ upload heaps may stay mapped, the ring never unmaps between frames
+	THROW_DX_IF_FAILS(m_pResource->Map(0u, nullptr, reinterpret_cast<void**>(&m_pMappedData)));
+	m_nGpuBase = m_pResource->GetGPUVirtualAddress();
+}
+
+framework::DxUploadMemory::~DxUploadMemory()
+{
+	if (m_pResource)
+	{
+		m_pResource->Unmap(0u, nullptr);
+	}
+	m_pMappedData = nullptr;
+}
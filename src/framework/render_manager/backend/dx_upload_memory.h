@@ -0,0 +1,36 @@
+#pragma once
+
+#include <d3d12.h>
+#include <wrl/client.h>
+
+#include "framework/render_manager/upload_ring.h"
+
+namespace framework
+{
+	/// <summary>
+	/// One committed upload heap buffer, mapped for its whole lifetime.
+	/// </summary>
+	class DxUploadMemory final : public IUploadMemory
+	{
+	public:
+		DxUploadMemory(ID3D12Device* device, std::uint64_t size);
+		~DxUploadMemory() override;
+
+		DxUploadMemory(const DxUploadMemory&) = delete;
+		DxUploadMemory& operator=(const DxUploadMemory&) = delete;
+
+		//~ IUploadMemory Impl
+		std::uint8_t*	  GetCpuBase() const noexcept override { return m_pMappedData; }
+		GpuVirtualAddress GetGpuBase() const noexcept override { return m_nGpuBase; }
+		std::uint64_t	  GetSize	() const noexcept override { return m_nSize; }
+
+		//~ Getters
+		ID3D12Resource* GetResource() const noexcept { return m_pResource.Get(); }
+
+	private:
+		Microsoft::WRL::ComPtr<ID3D12Resource> m_pResource  { nullptr };
+		std::uint8_t*						   m_pMappedData{ nullptr };
+		GpuVirtualAddress					   m_nGpuBase	{ 0u };
+		std::uint64_t						   m_nSize		{ 0u };
+	};
+} // namespace framework
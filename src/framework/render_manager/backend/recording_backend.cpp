@@ -0,0 +1,340 @@
+#include "recording_backend.h"
+
+#include <cassert>
+
+using namespace framework;
+
+namespace
+{
+	std::uint64_t ToValue(const void* handle) noexcept
+	{
+		return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(handle));
+	}
+
+	void* ToPointer(std::uint64_t value) noexcept
+	{
+		return reinterpret_cast<void*>(static_cast<std::uintptr_t>(value));
+	}
+
+	template<typename T>
+	T ReadPayload(const RECORDED_COMMAND_HEADER& header, const void* payload) noexcept
+	{
+		assert(header.Size == sizeof(T) && "Recorded payload size mismatch!");
+		T value{};
+		std::memcpy(&value, payload, sizeof(T));
+		return value;
+	}
+} // namespace
+
+//~ RecordingCommandRecorder
+
+void framework::RecordingCommandRecorder::Reset() noexcept
+{
+	m_stream.clear(); //~ keeps capacity, steady state frames do not allocate
+	m_nCommandCount = 0u;
+	m_commandCounts.fill(0u);
+}
+
+void framework::RecordingCommandRecorder::Replay(ICommandRecorder& target) const
+{
+	ForEach([&target](const RECORDED_COMMAND_HEADER& header, const void* payload)
+	{
+		switch (header.Command)
+		{
+		case ERecordedCommand::SetPipelineState:
+			target.SetPipelineState(ToPointer(ReadPayload<recorded::Handle>(header, payload).Value));
+			break;
+		case ERecordedCommand::SetGraphicsRootSignature:
+			target.SetGraphicsRootSignature(ToPointer(ReadPayload<recorded::Handle>(header, payload).Value));
+			break;
+		case ERecordedCommand::SetDescriptorHeap:
+			target.SetDescriptorHeap(ToPointer(ReadPayload<recorded::Handle>(header, payload).Value));
+			break;
+		case ERecordedCommand::SetViewport:
+			target.SetViewport(ReadPayload<GpuViewport>(header, payload));
+			break;
+		case ERecordedCommand::SetScissorRect:
+			target.SetScissorRect(ReadPayload<GpuScissorRect>(header, payload));
+			break;
+		case ERecordedCommand::SetRenderTarget:
+		{
+			const auto data = ReadPayload<recorded::RenderTarget>(header, payload);
+			target.SetRenderTarget({ static_cast<std::size_t>(data.Rtv) }, { static_cast<std::size_t>(data.Dsv) });
+			break;
+		}
+		case ERecordedCommand::SetVertexBuffer:
+		{
+			const auto data = ReadPayload<recorded::VertexBuffer>(header, payload);
+			target.SetVertexBuffer(data.Slot, data.View);
+			break;
+		}
+		case ERecordedCommand::SetIndexBuffer:
+			target.SetIndexBuffer(ReadPayload<GpuIndexBufferView>(header, payload));
+			break;
+		case ERecordedCommand::SetPrimitiveTopology:
+			target.SetPrimitiveTopology(ReadPayload<recorded::Topology>(header, payload).Value);
+			break;
+		case ERecordedCommand::SetGraphicsRootDescriptorTable:
+		{
+			const auto data = ReadPayload<recorded::RootDescriptorTable>(header, payload);
+			target.SetGraphicsRootDescriptorTable(data.RootParameter, { data.Handle });
+			break;
+		}
+		case ERecordedCommand::SetGraphicsRoot32BitConstant:
+		{
+			const auto data = ReadPayload<recorded::RootConstant>(header, payload);
+			target.SetGraphicsRoot32BitConstant(data.RootParameter, data.Value, data.DestOffset);
+			break;
+		}
+		case ERecordedCommand::SetGraphicsRootShaderResourceView:
+		{
+			const auto data = ReadPayload<recorded::RootView>(header, payload);
+			target.SetGraphicsRootShaderResourceView(data.RootParameter, data.Address);
+			break;
+		}
+		case ERecordedCommand::SetGraphicsRootConstantBufferView:
+		{
+			const auto data = ReadPayload<recorded::RootView>(header, payload);
+			target.SetGraphicsRootConstantBufferView(data.RootParameter, data.Address);
+			break;
+		}
+		case ERecordedCommand::SetGraphicsRoot32BitConstants:
+		{
+			recorded::RootConstants data{};
+			std::memcpy(&data, payload, sizeof(data));
+			assert(header.Size == sizeof(data) + data.Count * sizeof(std::uint32_t) && "Recorded payload size mismatch!");
+
+			//~ the values follow the fixed part, the stream outlives the call
+			target.SetGraphicsRoot32BitConstants(data.RootParameter, data.Count,
+												 static_cast<const std::uint8_t*>(payload) + sizeof(data), data.DestOffset);
+			break;
+		}
+		case ERecordedCommand::TransitionResource:
+		{
+			const auto data = ReadPayload<recorded::Transition>(header, payload);
+			target.TransitionResource(ToPointer(data.Resource), data.Before, data.After, data.Subresource);
+			break;
+		}
+		case ERecordedCommand::ResourceBarriers:
+		{
+			recorded::Barriers data{};
+			std::memcpy(&data, payload, sizeof(data));
+			assert(header.Size == sizeof(data) + data.Count * sizeof(recorded::Barrier) && "Recorded payload size mismatch!");
+
+			std::vector<GpuResourceBarrier> barriers(data.Count);
+			const auto* source = static_cast<const std::uint8_t*>(payload) + sizeof(data);
+			for (std::uint32_t i = 0u; i < data.Count; ++i)
+			{
+				recorded::Barrier barrier{};
+				std::memcpy(&barrier, source + i * sizeof(barrier), sizeof(barrier));
+				barriers[ i ] = { barrier.Type, barrier.Flags, ToPointer(barrier.Resource),
+								  barrier.Before, barrier.After, barrier.Subresource };
+			}
+			target.ResourceBarriers(barriers.data(), data.Count);
+			break;
+		}
+		case ERecordedCommand::ClearRenderTarget:
+		{
+			const auto data = ReadPayload<recorded::ClearColor>(header, payload);
+			target.ClearRenderTarget({ static_cast<std::size_t>(data.Rtv) }, data.Color);
+			break;
+		}
+		case ERecordedCommand::ClearDepthStencil:
+		{
+			const auto data = ReadPayload<recorded::ClearDepth>(header, payload);
+			target.ClearDepthStencil({ static_cast<std::size_t>(data.Dsv) }, data.Depth, static_cast<std::uint8_t>(data.Stencil));
+			break;
+		}
+		case ERecordedCommand::DrawIndexedInstanced:
+		{
+			const auto data = ReadPayload<recorded::DrawIndexed>(header, payload);
+			target.DrawIndexedInstanced(data.IndexCount, data.InstanceCount, data.StartIndex, data.BaseVertex, data.StartInstance);
+			break;
+		}
+		default:
+			assert(false && "Unknown recorded command!");
+			break;
+		}
+	});
+}
+
+void framework::RecordingCommandRecorder::SetPipelineState(GpuPipelineHandle pso)
+{
+	Push(ERecordedCommand::SetPipelineState, recorded::Handle{ ToValue(pso) });
+}
+
+void framework::RecordingCommandRecorder::SetGraphicsRootSignature(GpuRootSignatureHandle rootSignature)
+{
+	Push(ERecordedCommand::SetGraphicsRootSignature, recorded::Handle{ ToValue(rootSignature) });
+}
+
+void framework::RecordingCommandRecorder::SetDescriptorHeap(GpuDescriptorHeapHandle heap)
+{
+	Push(ERecordedCommand::SetDescriptorHeap, recorded::Handle{ ToValue(heap) });
+}
+
+void framework::RecordingCommandRecorder::SetViewport(const GpuViewport& viewport)
+{
+	Push(ERecordedCommand::SetViewport, viewport);
+}
+
+void framework::RecordingCommandRecorder::SetScissorRect(const GpuScissorRect& rect)
+{
+	Push(ERecordedCommand::SetScissorRect, rect);
+}
+
+void framework::RecordingCommandRecorder::SetRenderTarget(CpuDescriptorHandle rtv, CpuDescriptorHandle dsv)
+{
+	Push(ERecordedCommand::SetRenderTarget, recorded::RenderTarget{ rtv.Ptr, dsv.Ptr });
+}
+
+void framework::RecordingCommandRecorder::SetVertexBuffer(std::uint32_t slot, const GpuVertexBufferView& view)
+{
+	Push(ERecordedCommand::SetVertexBuffer, recorded::VertexBuffer{ slot, 0u, view });
+}
+
+void framework::RecordingCommandRecorder::SetIndexBuffer(const GpuIndexBufferView& view)
+{
+	Push(ERecordedCommand::SetIndexBuffer, view);
+}
+
+void framework::RecordingCommandRecorder::SetPrimitiveTopology(EPrimitiveTopology topology)
+{
+	Push(ERecordedCommand::SetPrimitiveTopology, recorded::Topology{ topology });
+}
+
+void framework::RecordingCommandRecorder::SetGraphicsRootDescriptorTable(std::uint32_t rootParameter, GpuDescriptorHandle handle)
+{
+	Push(ERecordedCommand::SetGraphicsRootDescriptorTable, recorded::RootDescriptorTable{ rootParameter, 0u, handle.Ptr });
+}
+
+void framework::RecordingCommandRecorder::SetGraphicsRoot32BitConstant(std::uint32_t rootParameter, std::uint32_t value, std::uint32_t destOffset)
+{
+	Push(ERecordedCommand::SetGraphicsRoot32BitConstant, recorded::RootConstant{ rootParameter, value, destOffset });
+}
+
+void framework::RecordingCommandRecorder::SetGraphicsRootShaderResourceView(std::uint32_t rootParameter, GpuVirtualAddress address)
+{
+	Push(ERecordedCommand::SetGraphicsRootShaderResourceView, recorded::RootView{ rootParameter, 0u, address });
+}
+
+void framework::RecordingCommandRecorder::SetGraphicsRootConstantBufferView(std::uint32_t rootParameter, GpuVirtualAddress address)
+{
+	Push(ERecordedCommand::SetGraphicsRootConstantBufferView, recorded::RootView{ rootParameter, 0u, address });
+}
+
+void framework::RecordingCommandRecorder::SetGraphicsRoot32BitConstants(
+	std::uint32_t rootParameter,
+	std::uint32_t count,
+	const void* data,
+	std::uint32_t destOffset)
+{
+	Push(ERecordedCommand::SetGraphicsRoot32BitConstants, recorded::RootConstants{ rootParameter, count, destOffset },
+		 data, count * sizeof(std::uint32_t));
+}
+
+void framework::RecordingCommandRecorder::TransitionResource(
+	GpuResourceHandle resource,
+	EResourceState before,
+	EResourceState after,
+	std::uint32_t subresource)
+{
+	Push(ERecordedCommand::TransitionResource, recorded::Transition{ ToValue(resource), before, after, subresource, 0u });
+}
+
+void framework::RecordingCommandRecorder::ResourceBarriers(const GpuResourceBarrier* barriers, std::uint32_t count)
+{
+	//~ converted in place to the plain layout, the batch stays one command
+	std::vector<recorded::Barrier> data(count);
+	for (std::uint32_t i = 0u; i < count; ++i)
+	{
+		const auto& barrier = barriers[ i ];
+		data[ i ] = { ToValue(barrier.Resource), barrier.Type, barrier.Flags,
+					  barrier.Before, barrier.After, barrier.Subresource, 0u };
+	}
+	Push(ERecordedCommand::ResourceBarriers, recorded::Barriers{ count, 0u }, data.data(), count * sizeof(recorded::Barrier));
+}
+
+void framework::RecordingCommandRecorder::ClearRenderTarget(CpuDescriptorHandle rtv, const float color[ 4 ])
+{
+	recorded::ClearColor data{};
+	data.Rtv = rtv.Ptr;
+	std::memcpy(data.Color, color, sizeof(data.Color));
+	Push(ERecordedCommand::ClearRenderTarget, data);
+}
+
+void framework::RecordingCommandRecorder::ClearDepthStencil(CpuDescriptorHandle dsv, float depth, std::uint8_t stencil)
+{
+	Push(ERecordedCommand::ClearDepthStencil, recorded::ClearDepth{ dsv.Ptr, depth, stencil });
+}
+
+void framework::RecordingCommandRecorder::DrawIndexedInstanced(
+	std::uint32_t indexCount,
+	std::uint32_t instanceCount,
+	std::uint32_t startIndex,
+	std::int32_t  baseVertex,
+	std::uint32_t startInstance)
+{
+	Push(ERecordedCommand::DrawIndexedInstanced,
+		 recorded::DrawIndexed{ indexCount, instanceCount, startIndex, baseVertex, startInstance });
+}
+
+//~ RecordingRenderDevice
+
+void framework::RecordingRenderDevice::ExecuteCommandLists(ICommandRecorder* const* recorders, std::uint32_t count)
+{
+	for (std::uint32_t i = 0u; i < count; ++i)
+	{
+		assert(recorders[ i ] && recorders[ i ]->GetBackendType() == EBackendType::Recording
+			   && "Recording device can only execute recording command lists!");
+
+		const auto* recorder = static_cast<const RecordingCommandRecorder*>(recorders[ i ]);
+		m_nSubmittedCommands += recorder->GetCommandCount();
+		m_nSubmittedBytes	 += recorder->GetByteSize();
+		++m_nSubmittedLists;
+	}
+}
+
+void framework::RecordingRenderDevice::Present(std::uint32_t, std::uint32_t)
+{
+	++m_nPresentCount;
+}
+
+std::uint64_t framework::RecordingRenderDevice::Signal()
+{
+	return ++m_nFenceValue;
+}
+
+void framework::RecordingRenderDevice::WaitForFence(std::uint64_t value)
+{
+	//~ nothing runs asynchronously, every signaled value is already complete
+	assert(value <= m_nFenceValue && "Waiting on a fence value that was never signaled!");
+	(void)value;
+}
+
+namespace
+{
+	//~ fences complete on Signal, a wait never blocks
+	class RecordingFenceWaiter final : public IFenceWaiter
+	{
+	public:
+		explicit RecordingFenceWaiter(const RecordingRenderDevice* device) : m_pDevice(device) {}
+
+		std::uint64_t GetCompletedValue() const override { return m_pDevice->GetCompletedFenceValue(); }
+
+		bool Wait(std::uint64_t value) override
+		{
+			assert(value <= m_pDevice->GetCompletedFenceValue() && "Waiting on a fence value that was never signaled!");
+			(void)value;
+			return false;
+		}
+
+	private:
+		const RecordingRenderDevice* m_pDevice{ nullptr };
+	};
+} // namespace
+
+std::unique_ptr<IFenceWaiter> framework::RecordingRenderDevice::CreateFenceWaiter()
+{
+	return std::make_unique<RecordingFenceWaiter>(this);
+}
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "command_recorder.h"
+#include "render_device.h"
+
+namespace framework
+{
+	enum class ERecordedCommand : std::uint8_t
+	{
+		SetPipelineState = 0,
+		SetGraphicsRootSignature,
+		SetDescriptorHeap,
+		SetViewport,
+		SetScissorRect,
+		SetRenderTarget,
+		SetVertexBuffer,
+		SetIndexBuffer,
+		SetPrimitiveTopology,
+		SetGraphicsRootDescriptorTable,
+		SetGraphicsRoot32BitConstant,
+		SetGraphicsRootShaderResourceView,
+		SetGraphicsRootConstantBufferView,
+		SetGraphicsRoot32BitConstants,
+		TransitionResource,
+		ResourceBarriers,
+		ClearRenderTarget,
+		ClearDepthStencil,
+		DrawIndexedInstanced,
+		Count
+	};
+
+	//~ every command in the stream starts with this header, Size is the payload size
+	typedef struct _RECORDED_COMMAND_HEADER
+	{
+		ERecordedCommand Command{ ERecordedCommand::Count };
+		std::uint8_t	 Reserved{ 0u };
+		std::uint16_t	 Size	 { 0u };
+	} RECORDED_COMMAND_HEADER;
+
+	//~ payload layouts, plain data so the stream can be memcpy'd around
+	namespace recorded
+	{
+		struct Handle
+		{
+			std::uint64_t Value;
+		};
+
+		struct VertexBuffer
+		{
+			std::uint32_t		Slot;
+			std::uint32_t		Pad;
+			GpuVertexBufferView View;
+		};
+
+		struct RenderTarget
+		{
+			std::uint64_t Rtv;
+			std::uint64_t Dsv;
+		};
+
+		struct Topology
+		{
+			EPrimitiveTopology Value;
+		};
+
+		struct RootDescriptorTable
+		{
+			std::uint32_t RootParameter;
+			std::uint32_t Pad;
+			std::uint64_t Handle;
+		};
+
+		struct RootConstant
+		{
+			std::uint32_t RootParameter;
+			std::uint32_t Value;
+			std::uint32_t DestOffset;
+		};
+
+		struct RootView
+		{
+			std::uint32_t RootParameter;
+			std::uint32_t Pad;
+			std::uint64_t Address;
+		};
+
+		//~ followed by Count dwords, the payload size is sizeof(RootConstants) + Count * 4
+		struct RootConstants
+		{
+			std::uint32_t RootParameter;
+			std::uint32_t Count;
+			std::uint32_t DestOffset;
+		};
+
+		struct Transition
+		{
+			std::uint64_t  Resource;
+			EResourceState Before;
+			EResourceState After;
+			std::uint32_t  Subresource;
+			std::uint32_t  Pad;
+		};
+
+		//~ followed by Count Barrier, the payload size is sizeof(Barriers) + Count * sizeof(Barrier)
+		struct Barriers
+		{
+			std::uint32_t Count;
+			std::uint32_t Pad;
+		};
+
+		struct Barrier
+		{
+			std::uint64_t  Resource;
+			EBarrierType   Type;
+			EBarrierFlags  Flags;
+			EResourceState Before;
+			EResourceState After;
+			std::uint32_t  Subresource;
+			std::uint32_t  Pad;
+		};
+
+		struct ClearColor
+		{
+			std::uint64_t Rtv;
+			float		  Color[ 4 ];
+		};
+
+		struct ClearDepth
+		{
+			std::uint64_t Dsv;
+			float		  Depth;
+			std::uint32_t Stencil;
+		};
+
+		struct DrawIndexed
+		{
+			std::uint32_t IndexCount;
+			std::uint32_t InstanceCount;
+			std::uint32_t StartIndex;
+			std::int32_t  BaseVertex;
+			std::uint32_t StartInstance;
+		};
+	} // namespace recorded
+
+	/// <summary>
+	/// Headless backend: captures every call into a compact in-memory command stream.
+	/// Used to measure CPU side frame building and to replay into another recorder.
+	/// </summary>
+	class RecordingCommandRecorder final : public ICommandRecorder
+	{
+	public:
+		static constexpr std::size_t COMMAND_ALIGNMENT = 8u;
+
+		RecordingCommandRecorder() = default;
+		~RecordingCommandRecorder() override = default;
+
+		//~ stream control
+		void Reset() noexcept;
+		void Replay(ICommandRecorder& target) const;
+
+		//~ Getters
+		const std::vector<std::uint8_t>& GetStream	   () const noexcept { return m_stream; }
+		std::size_t						 GetByteSize   () const noexcept { return m_stream.size(); }
+		std::uint32_t					 GetCommandCount() const noexcept { return m_nCommandCount; }
+		std::uint32_t					 GetCommandCount(ERecordedCommand command) const noexcept
+		{
+			return m_commandCounts[ static_cast<std::size_t>(command) ];
+		}
+
+		//~ walks the stream, fn(const RECORDED_COMMAND_HEADER&, const void* payload)
+		template<typename Fn>
+		void ForEach(Fn&& fn) const
+		{
+			std::size_t offset = 0u;
+			while (offset < m_stream.size())
+			{
+				RECORDED_COMMAND_HEADER header{};
+				std::memcpy(&header, m_stream.data() + offset, sizeof(header));
+
+				fn(header, static_cast<const void*>(m_stream.data() + offset + sizeof(header)));
+				offset += AlignedSize(header.Size);
+			}
+		}
+
+		//~ ICommandRecorder Impl
+		EBackendType GetBackendType() const noexcept override { return EBackendType::Recording; }
+
+		void SetPipelineState		  (GpuPipelineHandle pso)				  override;
+		void SetGraphicsRootSignature (GpuRootSignatureHandle rootSignature)  override;
+		void SetDescriptorHeap		  (GpuDescriptorHeapHandle heap)		  override;
+		void SetViewport			  (const GpuViewport& viewport)			  override;
+		void SetScissorRect			  (const GpuScissorRect& rect)			  override;
+		void SetRenderTarget		  (CpuDescriptorHandle rtv,
+									   CpuDescriptorHandle dsv)				  override;
+
+		void SetVertexBuffer		  (std::uint32_t slot,
+									   const GpuVertexBufferView& view)		  override;
+		void SetIndexBuffer			  (const GpuIndexBufferView& view)		  override;
+		void SetPrimitiveTopology	  (EPrimitiveTopology topology)			  override;
+
+		void SetGraphicsRootDescriptorTable(std::uint32_t rootParameter,
+											GpuDescriptorHandle handle)		  override;
+		void SetGraphicsRoot32BitConstant  (std::uint32_t rootParameter,
+											std::uint32_t value,
+											std::uint32_t destOffset)		  override;
+		void SetGraphicsRootShaderResourceView(std::uint32_t rootParameter,
+											   GpuVirtualAddress address)	  override;
+		void SetGraphicsRootConstantBufferView(std::uint32_t rootParameter,
+											   GpuVirtualAddress address)	  override;
+		void SetGraphicsRoot32BitConstants (std::uint32_t rootParameter,
+											std::uint32_t count,
+											const void* data,
+											std::uint32_t destOffset)		  override;
+
+		void TransitionResource(GpuResourceHandle resource,
+								EResourceState before,
+								EResourceState after,
+								std::uint32_t subresource = ALL_SUBRESOURCES) override;
+		void ResourceBarriers  (const GpuResourceBarrier* barriers,
+								std::uint32_t count)						  override;
+
+		void ClearRenderTarget(CpuDescriptorHandle rtv, const float color[ 4 ])			  override;
+		void ClearDepthStencil(CpuDescriptorHandle dsv, float depth, std::uint8_t stencil) override;
+
+		void DrawIndexedInstanced(std::uint32_t indexCount,
+								  std::uint32_t instanceCount,
+								  std::uint32_t startIndex,
+								  std::int32_t  baseVertex,
+								  std::uint32_t startInstance)				  override;
+
+	private:
+		static constexpr std::size_t AlignedSize(std::size_t payload) noexcept
+		{
+			return (sizeof(RECORDED_COMMAND_HEADER) + payload + COMMAND_ALIGNMENT - 1u) & ~(COMMAND_ALIGNMENT - 1u);
+		}
+
+		template<typename T>
+		void Push(ERecordedCommand command, const T& payload)
+		{
+			static_assert(sizeof(T) <= 0xffffu, "Recorded payload too large");
+
+			RECORDED_COMMAND_HEADER header{};
+			header.Command = command;
+			header.Size	   = static_cast<std::uint16_t>(sizeof(T));
+
+			const std::size_t offset = m_stream.size();
+			m_stream.resize(offset + AlignedSize(sizeof(T)));
+
+			std::memcpy(m_stream.data() + offset, &header, sizeof(header));
+			std::memcpy(m_stream.data() + offset + sizeof(header), &payload, sizeof(T));
+
+			++m_nCommandCount;
+			++m_commandCounts[ static_cast<std::size_t>(command) ];
+		}
+
+		//~ fixed payload followed by size bytes of data
+		template<typename T>
+		void Push(ERecordedCommand command, const T& payload, const void* data, std::size_t size)
+		{
+			static_assert(sizeof(T) <= 0xffffu, "Recorded payload too large");
+			assert(sizeof(T) + size <= 0xffffu && "Recorded payload too large!");
+
+			RECORDED_COMMAND_HEADER header{};
+			header.Command = command;
+			header.Size	   = static_cast<std::uint16_t>(sizeof(T) + size);
+
+			const std::size_t offset = m_stream.size();
+			m_stream.resize(offset + AlignedSize(sizeof(T) + size));
+
+			std::memcpy(m_stream.data() + offset, &header, sizeof(header));
+			std::memcpy(m_stream.data() + offset + sizeof(header), &payload, sizeof(T));
+			std::memcpy(m_stream.data() + offset + sizeof(header) + sizeof(T), data, size);
+
+			++m_nCommandCount;
+			++m_commandCounts[ static_cast<std::size_t>(command) ];
+		}
+
+	private:
+		std::vector<std::uint8_t> m_stream{};
+		std::uint32_t			  m_nCommandCount{ 0u };
+		std::array<std::uint32_t, static_cast<std::size_t>(ERecordedCommand::Count)> m_commandCounts{};
+	};
+
+	/// <summary>
+	/// Headless device: counts submissions and completes every fence immediately.
+	/// </summary>
+	class RecordingRenderDevice final : public IRenderDevice
+	{
+	public:
+		RecordingRenderDevice() = default;
+		~RecordingRenderDevice() override = default;
+
+		//~ IRenderDevice Impl
+		EBackendType GetBackendType() const noexcept override { return EBackendType::Recording; }
+
+		void ExecuteCommandLists(ICommandRecorder* const* recorders, std::uint32_t count) override;
+		void Present(std::uint32_t syncInterval, std::uint32_t flags)					   override;
+
+		std::uint64_t Signal				() override;
+		std::uint64_t GetCompletedFenceValue() const override { return m_nFenceValue; }
+		void		  WaitForFence			(std::uint64_t value) override;
+
+		std::unique_ptr<IFenceWaiter> CreateFenceWaiter() override;
+
+		//~ Getters
+		std::uint64_t GetSubmittedListCount	  () const noexcept { return m_nSubmittedLists;	   }
+		std::uint64_t GetSubmittedCommandCount() const noexcept { return m_nSubmittedCommands; }
+		std::uint64_t GetSubmittedByteCount	  () const noexcept { return m_nSubmittedBytes;	   }
+		std::uint64_t GetPresentCount		  () const noexcept { return m_nPresentCount;	   }
+
+	private:
+		std::uint64_t m_nFenceValue		  { 0u };
+		std::uint64_t m_nSubmittedLists	  { 0u };
+		std::uint64_t m_nSubmittedCommands{ 0u };
+		std::uint64_t m_nSubmittedBytes	  { 0u };
+		std::uint64_t m_nPresentCount	  { 0u };
+	};
+} // namespace framework
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "command_recorder.h"
+
+namespace framework
+{
+	/// <summary>
+	/// Blocks the CPU on one fence with an OS event created once, so a wait costs no
+	/// event creation. One waiter per waiting owner: waits on a single waiter must not overlap.
+	/// </summary>
+	class IFenceWaiter
+	{
+	public:
+		virtual ~IFenceWaiter() = default;
+
+		virtual std::uint64_t GetCompletedValue() const = 0;
+
+		//~ returns false without blocking when the fence already reached value
+		virtual bool Wait(std::uint64_t value) = 0;
+	};
+
+	/// <summary>
+	/// Thin submission side of the backend: queue execution, fences and present.
+	/// Recorders handed to a device must come from the same backend.
+	/// </summary>
+	class IRenderDevice
+	{
+	public:
+		virtual ~IRenderDevice() = default;
+
+		virtual EBackendType GetBackendType() const noexcept = 0;
+
+		//~ submission, recorders are executed in array order
+		virtual void ExecuteCommandLists(ICommandRecorder* const* recorders, std::uint32_t count) = 0;
+		virtual void Present(std::uint32_t syncInterval, std::uint32_t flags)					   = 0;
+
+		//~ fences
+		virtual std::uint64_t Signal				() = 0; //~ returns the signaled value
+		virtual std::uint64_t GetCompletedFenceValue() const = 0;
+		virtual void		  WaitForFence			(std::uint64_t value) = 0;
+
+		//~ a waiter on the fence Signal advances, for owners that wait from their own thread
+		virtual std::unique_ptr<IFenceWaiter> CreateFenceWaiter() = 0;
+	};
+} // namespace framework
@@ -0,0 +1,100 @@
+#include "descriptor_allocator.h"
+
+#include <cassert>
+
+using namespace framework;
+
+framework::DescriptorAllocator::DescriptorAllocator(std::uint32_t persistentCount,
+													std::uint32_t transientPerFrame,
+													std::uint32_t frameCount)
+	: m_nPersistentCount(persistentCount),
+	  m_nTransientPerFrame(transientPerFrame),
+	  m_nFrameCount(frameCount),
+	  m_persistent(persistentCount, 1u),
+	  m_slices(std::make_unique<TRANSIENT_SLICE[]>(frameCount))
+{
+	assert(persistentCount > 0u && frameCount > 0u && "Descriptor allocator needs a persistent region and a frame!");
+
+	for (std::uint32_t i = 0u; i < frameCount; ++i)
+	{
+		m_slices[ i ].Begin = persistentCount + i * transientPerFrame;
+	}
+}
+
+DESCRIPTOR_RANGE framework::DescriptorAllocator::AllocatePersistent(std::uint32_t count)
+{
+	assert(count > 0u && "Empty descriptor range!");
+
+	std::lock_guard lock(m_mutex);
+	const auto allocation = m_persistent.Allocate(count);
+	if (!allocation.IsValid())
+	{
+		m_nFailed.fetch_add(1u, std::memory_order_relaxed);
+		return {};
+	}
+	return { static_cast<std::uint32_t>(allocation.Offset), count, allocation.Handle };
+}
+
+void framework::DescriptorAllocator::FreePersistent(DESCRIPTOR_RANGE& range)
+{
+	if (!range.IsValid()) return;
+	assert(range.Handle != INVALID_TLSF_HANDLE && "Transient descriptors are recycled by fence, not freed!");
+
+	std::lock_guard lock(m_mutex);
+	m_persistent.Free(range.Handle);
+	range = {};
+}
+
+bool framework::DescriptorAllocator::BeginFrame(std::uint32_t frame, std::uint64_t completedFence)
+{
+	assert(frame < m_nFrameCount && "Descriptor frame out of range!");
+
+	auto& slice = m_slices[ frame ];
+	if (slice.Fence > completedFence) return false; //~ the GPU may still read this slice
+
+	slice.Cursor.store(0u, std::memory_order_relaxed);
+	return true;
+}
+
+DESCRIPTOR_RANGE framework::DescriptorAllocator::AllocateTransient(std::uint32_t frame, std::uint32_t count) noexcept
+{
+	assert(frame < m_nFrameCount && count > 0u && "Bad transient descriptor request!");
+
+	auto& slice = m_slices[ frame ];
+	const std::uint32_t offset = slice.Cursor.fetch_add(count, std::memory_order_relaxed);
+	if (offset + count > m_nTransientPerFrame)
+	{
+		m_nFailed.fetch_add(1u, std::memory_order_relaxed);
+		return {};
+	}
+
+	//~ peak is only statistics, a lost race just reports a slightly lower number
+	const std::uint32_t used = offset + count;
+	if (used > m_nTransientPeak.load(std::memory_order_relaxed))
+	{
+		m_nTransientPeak.store(used, std::memory_order_relaxed);
+	}
+	return { slice.Begin + offset, count, INVALID_TLSF_HANDLE };
+}
+
+void framework::DescriptorAllocator::EndFrame(std::uint32_t frame, std::uint64_t fence) noexcept
+{
+	assert(frame < m_nFrameCount && "Descriptor frame out of range!");
+	m_slices[ frame ].Fence = fence;
+}
+
+DESCRIPTOR_ALLOCATOR_STATS framework::DescriptorAllocator::GetStats() const
+{
+	DESCRIPTOR_ALLOCATOR_STATS stats{};
+	{
+		std::lock_guard lock(m_mutex);
+		const auto persistent	 = m_persistent.GetStats();
+		stats.PersistentCapacity = static_cast<std::uint32_t>(persistent.TotalSize);
+		stats.PersistentUsed	 = static_cast<std::uint32_t>(persistent.UsedBytes);
+		stats.PersistentRanges	 = persistent.AllocationCount;
+	}
+	stats.TransientCapacity = m_nTransientPerFrame;
+	stats.TransientPeak		= m_nTransientPeak.load(std::memory_order_relaxed);
+	stats.FailedAllocations = m_nFailed.load(std::memory_order_relaxed);
+	return stats;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "tlsf_allocator.h"
+
+namespace framework
+{
+	inline constexpr std::uint32_t INVALID_DESCRIPTOR_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+	//~ contiguous descriptors inside the global heap
+	typedef struct _DESCRIPTOR_RANGE
+	{
+		std::uint32_t Index { INVALID_DESCRIPTOR_INDEX };
+		std::uint32_t Count { 0u };
+		TlsfHandle	  Handle{ INVALID_TLSF_HANDLE }; //~ persistent ranges only
+
+		bool IsValid() const noexcept { return Index != INVALID_DESCRIPTOR_INDEX; }
+	} DESCRIPTOR_RANGE;
+
+	typedef struct _DESCRIPTOR_ALLOCATOR_STATS
+	{
+		std::uint32_t PersistentCapacity  { 0u };
+		std::uint32_t PersistentUsed	  { 0u };
+		std::uint32_t PersistentRanges	  { 0u };
+		std::uint32_t TransientCapacity	  { 0u }; //~ per frame
+		std::uint32_t TransientPeak		  { 0u }; //~ most used by one frame
+		std::uint32_t FailedAllocations	  { 0u };
+	} DESCRIPTOR_ALLOCATOR_STATS;
+
+	/// <summary>
+	/// Index bookkeeping for one large shader visible descriptor heap, no device involved.
+	/// [0, persistent) holds long lived ranges handed out by a TLSF free list, O(1) allocate and free.
+	/// The rest is split into one linear transient slice per frame in flight: allocations bump an
+	/// atomic cursor, EndFrame tags the slice with the frame's fence and BeginFrame resets it once
+	/// that fence completed, so transient descriptors never need freeing.
+	/// </summary>
+	class DescriptorAllocator
+	{
+	public:
+		DescriptorAllocator(std::uint32_t persistentCount,
+							std::uint32_t transientPerFrame,
+							std::uint32_t frameCount);
+		~DescriptorAllocator() = default;
+
+		DescriptorAllocator(const DescriptorAllocator&) = delete;
+		DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+		//~ persistent region, thread safe
+		DESCRIPTOR_RANGE AllocatePersistent(std::uint32_t count);
+		void			 FreePersistent	   (DESCRIPTOR_RANGE& range);
+
+		//~ transient slices; a frame slot is used by one pipeline stage at a time but
+		//~ AllocateTransient may be called from many recording threads at once
+		bool			 BeginFrame		  (std::uint32_t frame, std::uint64_t completedFence);
+		DESCRIPTOR_RANGE AllocateTransient(std::uint32_t frame, std::uint32_t count) noexcept;
+		void			 EndFrame		  (std::uint32_t frame, std::uint64_t fence) noexcept;
+
+		//~ Getters
+		std::uint32_t			   GetDescriptorCount() const noexcept { return m_nPersistentCount + m_nTransientPerFrame * m_nFrameCount; }
+		std::uint32_t			   GetFrameCount	 () const noexcept { return m_nFrameCount; }
+		DESCRIPTOR_ALLOCATOR_STATS GetStats			 () const;
+
+	private:
+		typedef struct _TRANSIENT_SLICE
+		{
+			std::uint32_t			   Begin { 0u };
+			std::atomic<std::uint32_t> Cursor{ 0u };
+			std::uint64_t			   Fence { 0u }; //~ last submit that used the slice
+		} TRANSIENT_SLICE;
+
+	private:
+		std::uint32_t m_nPersistentCount  { 0u };
+		std::uint32_t m_nTransientPerFrame{ 0u };
+		std::uint32_t m_nFrameCount		  { 0u };
+
+		TlsfAllocator					   m_persistent;
+		std::unique_ptr<TRANSIENT_SLICE[]> m_slices{ nullptr };
+
+		std::atomic<std::uint32_t> m_nTransientPeak{ 0u };
+		std::atomic<std::uint32_t> m_nFailed	   { 0u };
+		mutable std::mutex		   m_mutex{};
+	};
+} // namespace framework
@@ -0,0 +1,132 @@
+#include "dynamic_geometry.h"
+
+#include "utility/graphics/stream_copy.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace framework;
+
+namespace
+{
+	constexpr std::uint32_t IndexSize(EIndexFormat format) noexcept
+	{
+		return format == EIndexFormat::Uint16 ? 2u : 4u;
+	}
+} // namespace
+
+//~ DynamicGeometryStream
+
+framework::DynamicGeometryStream::DynamicGeometryStream(LinearUploadAllocator* allocator)
+	: m_pAllocator(allocator)
+{
+	assert(m_pAllocator && "Dynamic geometry needs an upload allocator!");
+}
+
+DYNAMIC_GEOMETRY framework::DynamicGeometryStream::Allocate(
+	std::uint32_t vertexCount,
+	std::uint32_t vertexStride,
+	std::uint32_t indexCount,
+	EIndexFormat indexFormat)
+{
+	const std::uint64_t vertexBytes = static_cast<std::uint64_t>(vertexCount) * vertexStride;
+	const std::uint64_t indexBytes	= static_cast<std::uint64_t>(indexCount) * IndexSize(indexFormat);
+	assert(vertexBytes <= 0xffffffffull && indexBytes <= 0xffffffffull && "Dynamic geometry views are 32 bit sized!");
+
+	//~ both ranges stream aligned, so StreamCopy can always run on them
+	const auto vertices = m_pAllocator->Allocate(std::max<std::uint64_t>(vertexBytes, 1u), UPLOAD_ALIGN_BUFFER);
+	const auto indices	= indexCount ? m_pAllocator->Allocate(indexBytes, UPLOAD_ALIGN_BUFFER) : UPLOAD_ALLOCATION{};
+	if (!vertices.IsValid() || (indexCount && !indices.IsValid()))
+	{
+		++m_stats.FailedAllocations;
+		return {};
+	}
+
+	DYNAMIC_GEOMETRY geometry{};
+	geometry.Vertices	 = vertices.Cpu;
+	geometry.Indices	 = indices.Cpu;
+	geometry.VertexCount = vertexCount;
+	geometry.IndexCount	 = indexCount;
+	geometry.VertexView	 = { vertices.Gpu, static_cast<std::uint32_t>(vertexBytes), vertexStride };
+	geometry.IndexView	 = { indices.Gpu,  static_cast<std::uint32_t>(indexBytes),	indexFormat };
+
+	++m_stats.MeshCount;
+	m_stats.VertexBytes += vertexBytes;
+	m_stats.IndexBytes	+= indexBytes;
+	return geometry;
+}
+
+void framework::DynamicGeometryStream::CopyStreams(const DYNAMIC_GEOMETRY& geometry, const void* vertices, const void* indices) noexcept
+{
+	StreamCopy(geometry.Vertices, vertices, geometry.VertexView.SizeInBytes);
+	if (geometry.IndexCount) StreamCopy(geometry.Indices, indices, geometry.IndexView.SizeInBytes);
+	StreamFence();
+}
+
+//~ DynamicGeometryBatch
+
+bool framework::DynamicGeometryBatch::Begin(
+	DynamicGeometryStream& stream,
+	std::uint32_t maxVertices,
+	std::uint32_t vertexStride,
+	std::uint32_t maxIndices)
+{
+	assert(!m_bOpen && "Dynamic geometry batch is already open!");
+
+	m_geometry	   = stream.Allocate(maxVertices, vertexStride, maxIndices, EIndexFormat::Uint16);
+	m_nStride	   = vertexStride;
+	m_nVertexCount = 0u;
+	m_nIndexCount  = 0u;
+	m_nDropped	   = 0u;
+	m_bOpen		   = m_geometry.IsValid();
+	return m_bOpen;
+}
+
+std::uint32_t framework::DynamicGeometryBatch::AppendVertices(const void* vertices, std::uint32_t count) noexcept
+{
+	if (!m_bOpen || m_nVertexCount + count > m_geometry.VertexCount)
+	{
+		++m_nDropped;
+		return INVALID_BASE;
+	}
+
+	auto* dst = static_cast<std::uint8_t*>(m_geometry.Vertices) + static_cast<std::size_t>(m_nVertexCount) * m_nStride;
+	std::memcpy(dst, vertices, static_cast<std::size_t>(count) * m_nStride);
+
+	const std::uint32_t base = m_nVertexCount;
+	m_nVertexCount += count;
+	return base;
+}
+
+bool framework::DynamicGeometryBatch::AppendIndices(const std::uint16_t* indices, std::uint32_t count, std::uint32_t baseVertex) noexcept
+{
+	if (!m_bOpen || baseVertex == INVALID_BASE || m_nIndexCount + count > m_geometry.IndexCount)
+	{
+		++m_nDropped;
+		return false;
+	}
+
+	auto* dst = static_cast<std::uint16_t*>(m_geometry.Indices) + m_nIndexCount;
+	for (std::uint32_t i = 0u; i < count; ++i)
+	{
+		assert(baseVertex + indices[ i ] <= 0xffffu && "Batch vertex out of 16 bit index range!");
+		dst[ i ] = static_cast<std::uint16_t>(baseVertex + indices[ i ]);
+	}
+	m_nIndexCount += count;
+	return true;
+}
+
+DYNAMIC_GEOMETRY framework::DynamicGeometryBatch::End() noexcept
+{
+	if (!m_bOpen) return {};
+	m_bOpen = false;
+
+	//~ the reservation tail stays unused until the frame retires, only the views shrink
+	DYNAMIC_GEOMETRY geometry = m_geometry;
+	geometry.VertexCount			= m_nVertexCount;
+	geometry.IndexCount				= m_nIndexCount;
+	geometry.VertexView.SizeInBytes = m_nVertexCount * m_nStride;
+	geometry.IndexView.SizeInBytes	= m_nIndexCount * static_cast<std::uint32_t>(sizeof(std::uint16_t));
+	return geometry;
+}
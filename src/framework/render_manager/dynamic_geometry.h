@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "upload_ring.h"
+
+namespace framework
+{
+	//~ one vertex range and one index range in upload memory, valid until the frame retires
+	typedef struct _DYNAMIC_GEOMETRY
+	{
+		GpuVertexBufferView VertexView {};
+		GpuIndexBufferView	IndexView  {};
+		void*				Vertices   { nullptr };
+		void*				Indices	   { nullptr };
+		std::uint32_t		VertexCount{ 0u };
+		std::uint32_t		IndexCount { 0u };
+
+		bool IsValid() const noexcept { return Vertices != nullptr; }
+	} DYNAMIC_GEOMETRY;
+
+	typedef struct _DYNAMIC_GEOMETRY_STATS
+	{
+		std::uint32_t MeshCount		   { 0u };
+		std::uint64_t VertexBytes	   { 0u };
+		std::uint64_t IndexBytes	   { 0u };
+		std::uint32_t FailedAllocations{ 0u };
+	} DYNAMIC_GEOMETRY_STATS;
+
+	/// <summary>
+	/// Per frame vertex/index streams for geometry generated on the CPU every frame (debug
+	/// lines, particles, UI). Memory comes from the frame's LinearUploadAllocator, so every
+	/// frame in flight has its own copy and the ring recycles it once the frame fence passes.
+	/// </summary>
+	class DynamicGeometryStream
+	{
+	public:
+		explicit DynamicGeometryStream(LinearUploadAllocator* allocator);
+		~DynamicGeometryStream() = default;
+
+		DynamicGeometryStream(const DynamicGeometryStream&) = delete;
+		DynamicGeometryStream& operator=(const DynamicGeometryStream&) = delete;
+
+		//~ uninitialized ranges for the caller to fill, sequentially for write-combined memory
+		DYNAMIC_GEOMETRY Allocate(std::uint32_t vertexCount,
+								  std::uint32_t vertexStride,
+								  std::uint32_t indexCount,
+								  EIndexFormat	indexFormat = EIndexFormat::Uint16);
+
+		//~ allocate and stream copy in one go
+		template<typename TVertex, typename TIndex>
+		DYNAMIC_GEOMETRY Write(const TVertex* vertices, std::uint32_t vertexCount,
+							   const TIndex*  indices,	std::uint32_t indexCount)
+		{
+			static_assert(std::is_same_v<TIndex, std::uint16_t> || std::is_same_v<TIndex, std::uint32_t>,
+						  "Dynamic indices are 16 or 32 bit");
+
+			auto geometry = Allocate(vertexCount, sizeof(TVertex), indexCount,
+									 sizeof(TIndex) == 2u ? EIndexFormat::Uint16 : EIndexFormat::Uint32);
+			if (geometry.IsValid()) CopyStreams(geometry, vertices, indices);
+			return geometry;
+		}
+
+		//~ stats cover everything since the last call
+		void ResetStats() noexcept { m_stats = {}; }
+
+		//~ Getters
+		const DYNAMIC_GEOMETRY_STATS& GetStats() const noexcept { return m_stats; }
+
+	private:
+		void CopyStreams(const DYNAMIC_GEOMETRY& geometry, const void* vertices, const void* indices) noexcept;
+
+	private:
+		LinearUploadAllocator* m_pAllocator{ nullptr };
+		DYNAMIC_GEOMETRY_STATS m_stats	   {};
+	};
+
+	/// <summary>
+	/// Append style builder over one reserved DYNAMIC_GEOMETRY: callers push vertices and
+	/// 16 bit indices relative to what they pushed, End trims the views to what was written.
+	/// Appends past the reservation are dropped and reported by End.
+	/// </summary>
+	class DynamicGeometryBatch
+	{
+	public:
+		static constexpr std::uint32_t INVALID_BASE = 0xffffffffu;
+
+		DynamicGeometryBatch() = default;
+		~DynamicGeometryBatch() = default;
+
+		bool Begin(DynamicGeometryStream& stream,
+				   std::uint32_t maxVertices,
+				   std::uint32_t vertexStride,
+				   std::uint32_t maxIndices);
+
+		//~ returns the index of the first appended vertex, INVALID_BASE when full
+		std::uint32_t AppendVertices(const void* vertices, std::uint32_t count) noexcept;
+		bool		  AppendIndices	(const std::uint16_t* indices, std::uint32_t count, std::uint32_t baseVertex) noexcept;
+
+		DYNAMIC_GEOMETRY End() noexcept;
+
+		//~ Getters
+		bool		  IsOpen		() const noexcept { return m_bOpen; }
+		std::uint32_t GetVertexCount() const noexcept { return m_nVertexCount; }
+		std::uint32_t GetIndexCount () const noexcept { return m_nIndexCount; }
+		std::uint32_t GetDropped	() const noexcept { return m_nDropped; }
+
+	private:
+		DYNAMIC_GEOMETRY m_geometry	   {};
+		std::uint32_t	 m_nStride	   { 0u };
+		std::uint32_t	 m_nVertexCount{ 0u };
+		std::uint32_t	 m_nIndexCount { 0u };
+		std::uint32_t	 m_nDropped	   { 0u };
+		bool			 m_bOpen	   { false };
+	};
+} // namespace framework
@@ -0,0 +1,144 @@
+#include "dynamic_geometry_benchmark.h"
+#include "dynamic_geometry.h"
+
+#include "utility/logger/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+
+using namespace framework;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	typedef struct _BENCH_VERTEX
+	{
+		float Position[ 3 ];
+		float Color	  [ 4 ];
+		float Pad;
+	} BENCH_VERTEX;
+	static_assert(sizeof(BENCH_VERTEX) == 32u, "Benchmark vertex should be 32 bytes");
+
+	constexpr std::uint32_t nFramesInFlight = 3u;
+	constexpr std::uint16_t nQuadIndices[ 6 ]{ 0u, 1u, 2u, 0u, 2u, 3u };
+
+	double ToMBps(std::uint64_t bytes, double ms)
+	{
+		return ms > 0.0 ? (static_cast<double>(bytes) / (1024.0 * 1024.0)) / (ms / 1000.0) : 0.0;
+	}
+} // namespace
+
+std::vector<DYNAMIC_GEOMETRY_BENCHMARK_RESULT> framework::RunDynamicGeometryBenchmark(
+	const std::vector<std::uint32_t>& vertexCounts,
+	std::uint32_t frames)
+{
+	frames = frames ? frames : 1u;
+
+	std::vector<DYNAMIC_GEOMETRY_BENCHMARK_RESULT> results{};
+	results.reserve(vertexCounts.size());
+
+	for (auto count : vertexCounts)
+	{
+		//~ batches are 16 bit indexed, keep every batch addressable
+		const std::uint32_t vertices = std::max(4u, count / 4u * 4u);
+		const std::uint32_t quads	 = vertices / 4u;
+		const std::uint32_t indices	 = quads * 6u;
+		const std::uint32_t perBatch = 65536u;
+
+		std::vector<BENCH_VERTEX>  source(vertices);
+		std::vector<std::uint16_t> sourceIndices(indices);
+		for (std::uint32_t i = 0u; i < vertices; ++i)
+		{
+			const float f = static_cast<float>(i);
+			source[ i ] = { { f, f * 0.5f, -f }, { 1.f, 0.5f, 0.25f, 1.f }, 0.f };
+		}
+		for (std::uint32_t q = 0u; q < quads; ++q)
+		{
+			for (std::uint32_t k = 0u; k < 6u; ++k)
+			{
+				sourceIndices[ q * 6u + k ] = static_cast<std::uint16_t>((q * 4u + nQuadIndices[ k ]) & 0xffffu);
+			}
+		}
+
+		const std::uint64_t frameBytes = static_cast<std::uint64_t>(vertices) * sizeof(BENCH_VERTEX) + indices * 2ull;
+
+		//~ room for every frame in flight plus block slack
+		HostUploadMemory memory(2u * nFramesInFlight * (frameBytes + 2u * LinearUploadAllocator::DEFAULT_BLOCK_SIZE));
+		UploadRing		 ring(&memory);
+
+		std::vector<std::unique_ptr<LinearUploadAllocator>> allocators{};
+		std::vector<std::unique_ptr<DynamicGeometryStream>> streams{};
+		for (std::uint32_t i = 0u; i < nFramesInFlight; ++i)
+		{
+			allocators.push_back(std::make_unique<LinearUploadAllocator>(&ring));
+			streams	  .push_back(std::make_unique<DynamicGeometryStream>(allocators.back().get()));
+		}
+
+		DYNAMIC_GEOMETRY_BENCHMARK_RESULT result{};
+		result.VertexCount = vertices;
+
+		std::uint64_t fence = 0u;
+		double streamMs = 0.0, batchMs = 0.0, memcpyMs = 0.0;
+		for (std::uint32_t frame = 0u; frame < frames; ++frame)
+		{
+			const std::uint32_t slot = frame % nFramesInFlight;
+
+			//~ the frame that last used this slot has completed
+			ring.Reclaim(fence >= nFramesInFlight - 1u ? fence - (nFramesInFlight - 1u) : 0u);
+			auto& stream = *streams[ slot ];
+
+			auto start = Clock::now();
+			const auto mesh = stream.Write(source.data(), vertices, sourceIndices.data(), indices);
+			streamMs += ElapsedMs(start);
+
+			start = Clock::now();
+			if (mesh.IsValid())
+			{
+				std::memcpy(mesh.Vertices, source.data(), mesh.VertexView.SizeInBytes);
+				std::memcpy(mesh.Indices, sourceIndices.data(), mesh.IndexView.SizeInBytes);
+			}
+			memcpyMs += ElapsedMs(start);
+
+			start = Clock::now();
+			bool failed = !mesh.IsValid();
+			for (std::uint32_t first = 0u; first < vertices; first += perBatch)
+			{
+				const std::uint32_t batchVertices = std::min(perBatch, vertices - first);
+
+				DynamicGeometryBatch batch{};
+				if (!batch.Begin(stream, batchVertices, sizeof(BENCH_VERTEX), batchVertices / 4u * 6u))
+				{
+					failed = true;
+					break;
+				}
+				for (std::uint32_t v = first; v + 4u <= first + batchVertices; v += 4u)
+				{
+					batch.AppendIndices(nQuadIndices, 6u, batch.AppendVertices(&source[ v ], 4u));
+				}
+				batch.End();
+			}
+			batchMs += ElapsedMs(start);
+
+			allocators[ slot ]->Retire(++fence);
+			result.FailedFrames += failed ? 1u : 0u;
+		}
+
+		const std::uint64_t total = frameBytes * frames;
+		result.StreamMBps = ToMBps(total, streamMs);
+		result.BatchMBps  = ToMBps(total, batchMs);
+		result.MemcpyMBps = ToMBps(total, memcpyMs);
+
+		logger::info("Dynamic geometry benchmark {:>7} vertices/frame: stream {:.0f} MB/s, batch {:.0f} MB/s, memcpy {:.0f} MB/s, {} failed frames",
+					 result.VertexCount, result.StreamMBps, result.BatchMBps, result.MemcpyMBps, result.FailedFrames);
+		results.push_back(result);
+	}
+	return results;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace framework
+{
+	typedef struct _DYNAMIC_GEOMETRY_BENCHMARK_RESULT
+	{
+		std::uint32_t VertexCount  { 0u }; //~ per frame
+		double		  StreamMBps   { 0.0 }; //~ Write(): one allocation, non-temporal copy
+		double		  BatchMBps	   { 0.0 }; //~ DynamicGeometryBatch, one small append per quad
+		double		  MemcpyMBps   { 0.0 }; //~ plain memcpy into the same memory, the baseline
+		std::uint32_t FailedFrames { 0u };
+	} DYNAMIC_GEOMETRY_BENCHMARK_RESULT;
+
+	//~ simulates frames in flight over a host backed upload ring, the GPU lags two frames
+	//~ behind. Vertices are 32 bytes with 16 bit quad indices. Results are logged and
+	//~ returned. Blocks the calling thread.
+	std::vector<DYNAMIC_GEOMETRY_BENCHMARK_RESULT> RunDynamicGeometryBenchmark(
+		const std::vector<std::uint32_t>& vertexCounts = { 4'000u, 40'000u, 400'000u },
+		std::uint32_t frames = 32u);
+} // namespace framework
@@ -0,0 +1,56 @@
+#include "frame_arena.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace framework;
+
+namespace
+{
+	constexpr std::size_t AlignUp(std::size_t value, std::size_t alignment) noexcept
+	{
+		return (value + alignment - 1u) & ~(alignment - 1u);
+	}
+} // namespace
+
+framework::FrameArena::FrameArena(std::size_t capacity)
+{
+	m_stats.Capacity = AlignUp(capacity, alignof(std::max_align_t));
+	if (m_stats.Capacity != 0u) m_pBlock = std::make_unique<std::byte[]>(m_stats.Capacity);
+}
+
+void* framework::FrameArena::Allocate(std::size_t size, std::size_t alignment)
+{
+	assert(alignment != 0u && (alignment & (alignment - 1u)) == 0u && "Alignment must be a power of two!");
+	assert(alignment <= alignof(std::max_align_t) && "Arena blocks are only max_align_t aligned!");
+	if (size == 0u) return nullptr;
+
+	const auto offset = AlignUp(m_nOffset, alignment);
+	m_stats.Used += size + (offset - m_nOffset);
+	m_stats.Peak  = std::max(m_stats.Peak, m_stats.Used);
+
+	if (m_pBlock && offset + size <= m_stats.Capacity)
+	{
+		m_nOffset = offset + size;
+		return m_pBlock.get() + offset;
+	}
+
+	//~ keep serving from the main block afterwards, only this allocation goes to the heap
+	++m_stats.Overflows;
+	m_overflow.push_back(std::make_unique<std::byte[]>(size));
+	return m_overflow.back().get();
+}
+
+void framework::FrameArena::Reset()
+{
+	if (!m_overflow.empty())
+	{
+		m_overflow.clear();
+
+		//~ headroom so a slowly growing frame does not overflow every time
+		m_stats.Capacity = AlignUp(m_stats.Peak + m_stats.Peak / 4u, alignof(std::max_align_t));
+		m_pBlock		 = std::make_unique<std::byte[]>(m_stats.Capacity);
+	}
+	m_nOffset	 = 0u;
+	m_stats.Used = 0u;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace framework
+{
+	typedef struct _FRAME_ARENA_STATS
+	{
+		std::size_t	  Used		{ 0u }; //~ bytes handed out since the last Reset
+		std::size_t	  Capacity	{ 0u }; //~ main block
+		std::size_t	  Peak		{ 0u };
+		std::uint64_t Overflows { 0u }; //~ allocations that needed an extra block
+	} FRAME_ARENA_STATS;
+
+	/// <summary>
+	/// CPU scratch memory of one frame: bump allocation, everything freed at once by Reset.
+	/// When the main block runs out an extra block is taken from the heap, the next Reset
+	/// grows the main block to the peak so a steady workload stops allocating after one frame.
+	/// Not thread safe, one arena per frame context.
+	/// </summary>
+	class FrameArena
+	{
+	public:
+		explicit FrameArena(std::size_t capacity = 0u);
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+		//~ uninitialized storage for count elements, write them before reading
+		template<typename T>
+		T* AllocateArray(std::size_t count)
+		{
+			static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+						  "Arena memory is never destroyed, keep its elements trivial");
+			return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+		}
+
+		void Reset();
+
+		//~ Getters
+		const FRAME_ARENA_STATS& GetStats() const noexcept { return m_stats; }
+
+	private:
+		std::unique_ptr<std::byte[]>			  m_pBlock	{ nullptr };
+		std::vector<std::unique_ptr<std::byte[]>> m_overflow{}; //~ freed by the next Reset
+		std::size_t								  m_nOffset { 0u };
+		FRAME_ARENA_STATS						  m_stats	{};
+	};
+} // namespace framework
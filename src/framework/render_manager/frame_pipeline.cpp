@@ -0,0 +1,212 @@
+#include "frame_pipeline.h"
+
+#include <cassert>
+
+using namespace framework;
+
+framework::FramePipeline::FramePipeline(std::uint32_t ringDepth)
+	: m_nRingDepth(ringDepth)
+{
+	assert(ringDepth > 0u && "Frame pipeline needs at least one ring slot!");
+	m_pFreeSlots = std::make_unique<std::counting_semaphore<>>(static_cast<std::ptrdiff_t>(ringDepth));
+}
+
+framework::FramePipeline::~FramePipeline()
+{
+	if (m_bRunning)
+	{
+		Flush();
+		Stop ();
+	}
+}
+
+void framework::FramePipeline::AddStage(std::string name, StageFn&& fn)
+{
+	assert(!m_bRunning && "Stages must be added before the pipeline starts!");
+
+	auto stage			= std::make_unique<Stage>();
+	stage->Name			= std::move(name);
+	stage->Execute		= std::move(fn);
+	stage->Stats.Name	= stage->Name;
+	m_ppStages.push_back(std::move(stage));
+}
+
+void framework::FramePipeline::Start()
+{
+	assert(!m_ppStages.empty() && "Frame pipeline started without stages!");
+	if (m_bRunning) return;
+
+	m_bStopRequested = false;
+	m_bRunning		 = true;
+
+	//~ stage 0 is driven by Tick, everything after gets its own worker
+	for (std::uint32_t i = 1u; i < static_cast<std::uint32_t>(m_ppStages.size()); ++i)
+	{
+		m_ppStages[ i ]->Worker = std::thread([this, i]() { WorkerLoop(i); });
+	}
+}
+
+void framework::FramePipeline::Stop()
+{
+	if (!m_bRunning) return;
+
+	m_bStopRequested = true;
+	for (auto& stage : m_ppStages)
+	{
+		{
+			std::lock_guard lock(stage->QueueLock);
+		}
+		stage->QueueSignal.notify_all();
+	}
+
+	for (auto& stage : m_ppStages)
+	{
+		if (stage->Worker.joinable()) stage->Worker.join();
+	}
+	m_bRunning = false;
+}
+
+void framework::FramePipeline::Tick(float deltaTime)
+{
+	assert(m_bRunning && "Tick called on a pipeline that is not running!");
+	RethrowPendingError();
+
+	//~ blocks while every ring slot is owned by a stage
+	m_pFreeSlots->acquire();
+
+	FRAME_TICKET ticket{};
+	ticket.FrameNumber = m_nFramesPushed++;
+	ticket.FrameIndex  = static_cast<std::uint32_t>(ticket.FrameNumber % m_nRingDepth);
+	ticket.DeltaTime   = deltaTime;
+
+	try
+	{
+		RunStage(0u, ticket);
+	}
+	catch (...)
+	{
+		RetireFrame();
+		throw;
+	}
+
+	if (m_ppStages.size() == 1u) RetireFrame();
+	else HandOff(1u, ticket);
+}
+
+void framework::FramePipeline::Flush()
+{
+	if (!m_bRunning) return;
+
+	std::unique_lock lock(m_retireLock);
+	m_retireSignal.wait(lock, [this]() { return m_nFramesRetired == m_nFramesPushed; });
+	lock.unlock();
+
+	RethrowPendingError();
+}
+
+std::vector<FRAME_STAGE_STATS> framework::FramePipeline::GetStats() const
+{
+	std::vector<FRAME_STAGE_STATS> stats{};
+	stats.reserve(m_ppStages.size());
+
+	for (const auto& stage : m_ppStages)
+	{
+		std::lock_guard lock(stage->StatsLock);
+		stats.push_back(stage->Stats);
+	}
+	return stats;
+}
+
+void framework::FramePipeline::RunStage(std::uint32_t stageIndex, const FRAME_TICKET& ticket)
+{
+	auto& stage = *m_ppStages[ stageIndex ];
+
+	const auto start = std::chrono::steady_clock::now();
+	stage.Execute(ticket);
+	const auto end	 = std::chrono::steady_clock::now();
+
+	const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+	std::lock_guard lock(stage.StatsLock);
+	stage.Stats.LastMs	  = ms;
+	stage.Stats.AverageMs = stage.Stats.Executions == 0u
+		? ms
+		: stage.Stats.AverageMs * 0.9 + ms * 0.1;
+	++stage.Stats.Executions;
+}
+
+void framework::FramePipeline::WorkerLoop(std::uint32_t stageIndex)
+{
+	auto& stage = *m_ppStages[ stageIndex ];
+
+	while (true)
+	{
+		FRAME_TICKET ticket{};
+		{
+			std::unique_lock lock(stage.QueueLock);
+			stage.QueueSignal.wait(lock, [&]()
+			{
+				return !stage.Pending.empty() || m_bStopRequested.load();
+			});
+
+			if (stage.Pending.empty()) return; //~ stop requested and nothing left to drain
+
+			ticket = stage.Pending.front();
+			stage.Pending.pop_front();
+		}
+
+		try
+		{
+			RunStage(stageIndex, ticket);
+		}
+		catch (...)
+		{
+			{
+				std::lock_guard lock(m_errorLock);
+				if (!m_pendingError) m_pendingError = std::current_exception();
+			}
+			//~ skip the remaining stages for this frame, but keep the ring moving
+			RetireFrame();
+			continue;
+		}
+
+		if (stageIndex + 1u < static_cast<std::uint32_t>(m_ppStages.size()))
+		{
+			HandOff(stageIndex + 1u, ticket);
+		}
+		else
+		{
+			RetireFrame();
+		}
+	}
+}
+
+void framework::FramePipeline::HandOff(std::uint32_t stageIndex, const FRAME_TICKET& ticket)
+{
+	auto& stage = *m_ppStages[ stageIndex ];
+	{
+		std::lock_guard lock(stage.QueueLock);
+		stage.Pending.push_back(ticket);
+	}
+	stage.QueueSignal.notify_one();
+}
+
+void framework::FramePipeline::RetireFrame()
+{
+	{
+		std::lock_guard lock(m_retireLock);
+		++m_nFramesRetired;
+	}
+	m_retireSignal.notify_all();
+	m_pFreeSlots->release();
+}
+
+void framework::FramePipeline::RethrowPendingError()
+{
+	std::exception_ptr error{ nullptr };
+	{
+		std::lock_guard lock(m_errorLock);
+		std::swap(error, m_pendingError);
+	}
+	if (error) std::rethrow_exception(error);
+}
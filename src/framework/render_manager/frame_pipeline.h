@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace framework
+{
+	//~ a single frame travelling through the pipeline
+	typedef struct _FRAME_TICKET
+	{
+		std::uint64_t FrameNumber{ 0u };
+		std::uint32_t FrameIndex { 0u }; //~ slot inside the frame resource ring
+		float		  DeltaTime	 { 0.f };
+	} FRAME_TICKET;
+
+	typedef struct _FRAME_STAGE_STATS
+	{
+		std::string   Name{};
+		double		  LastMs	{ 0.0 };
+		double		  AverageMs { 0.0 }; //~ exponential moving average
+		std::uint64_t Executions{ 0u };
+	} FRAME_STAGE_STATS;
+
+	/// <summary>
+	/// Runs a frame through an ordered list of stages where every stage can work
+	/// on a different frame index at the same time. Stage 0 runs on the caller
+	/// thread inside Tick(), every following stage owns a worker thread.
+	/// The number of frames in flight is bounded by the ring depth, data is handed
+	/// from stage to stage through the ring slot given by FRAME_TICKET::FrameIndex.
+	/// </summary>
+	class FramePipeline
+	{
+	public:
+		using StageFn = std::function<void(const FRAME_TICKET&)>;
+
+		explicit FramePipeline(std::uint32_t ringDepth);
+		~FramePipeline();
+
+		FramePipeline(const FramePipeline&) = delete;
+		FramePipeline(FramePipeline&&)		= delete;
+
+		FramePipeline& operator=(const FramePipeline&) = delete;
+		FramePipeline& operator=(FramePipeline&&)	   = delete;
+
+		//~ setup (must be called before Start)
+		void AddStage(std::string name, StageFn&& fn);
+
+		//~ operations
+		void Start();
+		void Stop ();
+		void Tick (float deltaTime); //~ pushes a new frame in, blocks when the ring is full
+		void Flush();				 //~ waits until every pushed frame left the last stage
+
+		//~ Getters
+		std::uint32_t					GetRingDepth () const noexcept { return m_nRingDepth; }
+		std::uint64_t					GetFrameCount() const noexcept { return m_nFramesPushed; }
+		std::vector<FRAME_STAGE_STATS>	GetStats	 () const;
+		bool							IsRunning	 () const noexcept { return m_bRunning; }
+
+	private:
+		struct Stage
+		{
+			std::string	Name{};
+			StageFn		Execute{};
+
+			//~ input hand-off (unused for stage 0)
+			std::mutex				QueueLock{};
+			std::condition_variable QueueSignal{};
+			std::deque<FRAME_TICKET> Pending{};
+
+			std::thread Worker{};
+
+			//~ timing
+			mutable std::mutex StatsLock{};
+			FRAME_STAGE_STATS  Stats{};
+		};
+
+		void RunStage	(std::uint32_t stageIndex, const FRAME_TICKET& ticket);
+		void WorkerLoop (std::uint32_t stageIndex);
+		void HandOff	(std::uint32_t stageIndex, const FRAME_TICKET& ticket);
+		void RetireFrame();
+		void RethrowPendingError();
+
+	private:
+		std::uint32_t m_nRingDepth	 { 0u };
+		std::uint64_t m_nFramesPushed{ 0u };
+		bool		  m_bRunning	 { false };
+
+		std::vector<std::unique_ptr<Stage>> m_ppStages{};
+		std::atomic<bool>					m_bStopRequested{ false };
+
+		//~ free ring slots, acquired by Tick and released once the last stage is done
+		std::unique_ptr<std::counting_semaphore<>> m_pFreeSlots{ nullptr };
+
+		//~ flush tracking
+		std::mutex				m_retireLock{};
+		std::condition_variable m_retireSignal{};
+		std::uint64_t			m_nFramesRetired{ 0u };
+
+		//~ first exception thrown from a worker, rethrown on the caller thread
+		std::mutex		   m_errorLock{};
+		std::exception_ptr m_pendingError{ nullptr };
+	};
+} // namespace framework
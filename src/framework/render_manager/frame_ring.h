@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "backend/render_device.h"
+#include "frame_arena.h"
+
+namespace framework
+{
+	inline constexpr std::uint32_t MAX_FRAME_RING_DEPTH = 8u;
+
+	typedef struct _FRAME_RING_STATS
+	{
+		std::uint32_t Depth		   { 0u };
+		std::uint64_t Acquires	   { 0u };
+		std::uint64_t Stalls	   { 0u }; //~ acquires that blocked on the GPU
+		double		  LastWaitMs   { 0.0 };
+		double		  AverageWaitMs{ 0.0 }; //~ over the stalls only
+		double		  MaxWaitMs	   { 0.0 };
+		double		  TotalWaitMs  { 0.0 };
+
+		double GetStallRatio() const noexcept { return Acquires ? static_cast<double>(Stalls) / static_cast<double>(Acquires) : 0.0; }
+	} FRAME_RING_STATS;
+
+	/// <summary>
+	/// The frames in flight of a layer: depth contexts, each with the fence of the last
+	/// submit that used it and a CPU arena reset when the context comes round again.
+	/// Acquire blocks until the GPU is done with the context, through one fence waiter
+	/// owned by the ring, and records how often and how long the CPU waited.
+	/// A deeper ring stalls less but adds a frame of latency per slot.
+	/// Acquire and the getters belong to one thread; Retire may come from the submit thread.
+	/// </summary>
+	template<typename TContext>
+	class FrameRing
+	{
+	public:
+		//~ factory(index) builds the context of every slot
+		template<typename TFactory>
+		FrameRing(std::unique_ptr<IFenceWaiter> waiter, std::uint32_t depth, std::size_t arenaBytes, TFactory&& factory)
+			: m_pWaiter(std::move(waiter))
+			, m_slots(depth)
+		{
+			assert(m_pWaiter && "Frame ring needs a fence waiter!");
+			assert(depth > 0u && depth <= MAX_FRAME_RING_DEPTH && "Frame ring depth out of range!");
+
+			for (std::uint32_t i = 0u; i < depth; ++i)
+			{
+				m_slots[ i ].Context = factory(i);
+				m_slots[ i ].Arena	 = std::make_unique<FrameArena>(arenaBytes);
+			}
+			m_stats.Depth = depth;
+		}
+
+		FrameRing(const FrameRing&) = delete;
+		FrameRing& operator=(const FrameRing&) = delete;
+
+		//~ waits for the last submit of the slot and resets its arena
+		TContext& Acquire(std::uint32_t index)
+		{
+			auto& slot = m_slots.at(index);
+
+			const auto start   = std::chrono::steady_clock::now();
+			const bool stalled = m_pWaiter->Wait(slot.Fence.load(std::memory_order_acquire));
+			const double ms	   = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			++m_stats.Acquires;
+			m_stats.LastWaitMs = stalled ? ms : 0.0;
+			if (stalled)
+			{
+				++m_stats.Stalls;
+				m_stats.TotalWaitMs	 += ms;
+				m_stats.MaxWaitMs	  = std::max(m_stats.MaxWaitMs, ms);
+				m_stats.AverageWaitMs = m_stats.TotalWaitMs / static_cast<double>(m_stats.Stalls);
+			}
+
+			slot.Arena->Reset();
+			return *slot.Context;
+		}
+
+		//~ the fence of the submit that used the slot, fences only grow
+		void Retire(std::uint32_t index, std::uint64_t fence)
+		{
+			auto& slot = m_slots.at(index);
+			assert(fence >= slot.Fence.load(std::memory_order_relaxed) && "Frame fences must grow!");
+			slot.Fence.store(fence, std::memory_order_release);
+		}
+
+		void WaitIdle()
+		{
+			m_pWaiter->Wait(GetLastFence());
+		}
+
+		void ResetStats() noexcept
+		{
+			m_stats = FRAME_RING_STATS{};
+			m_stats.Depth = GetDepth();
+		}
+
+		//~ Getters
+		TContext&				GetContext	  (std::uint32_t index)		  { return *m_slots.at(index).Context; }
+		const TContext&			GetContext	  (std::uint32_t index) const { return *m_slots.at(index).Context; }
+		FrameArena&				GetArena	  (std::uint32_t index)		  { return *m_slots.at(index).Arena; }
+		std::uint64_t			GetFence	  (std::uint32_t index) const { return m_slots.at(index).Fence.load(std::memory_order_acquire); }
+		std::uint32_t			GetDepth	  () const noexcept { return static_cast<std::uint32_t>(m_slots.size()); }
+		const FRAME_RING_STATS& GetStats	  () const noexcept { return m_stats; }
+
+		std::uint64_t GetLastFence() const
+		{
+			std::uint64_t fence = 0u;
+			for (const auto& slot : m_slots) fence = std::max(fence, slot.Fence.load(std::memory_order_acquire));
+			return fence;
+		}
+
+		//~ the largest main block and peak among the arenas, for sizing arenaBytes
+		FRAME_ARENA_STATS GetArenaStats() const
+		{
+			FRAME_ARENA_STATS total{};
+			for (const auto& slot : m_slots)
+			{
+				const auto& stats = slot.Arena->GetStats();
+				total.Capacity	= std::max(total.Capacity, stats.Capacity);
+				total.Peak		= std::max(total.Peak, stats.Peak);
+				total.Overflows += stats.Overflows;
+			}
+			return total;
+		}
+
+	private:
+		typedef struct _SLOT
+		{
+			std::unique_ptr<TContext>	Context{ nullptr };
+			std::unique_ptr<FrameArena> Arena  { nullptr };
+			std::atomic<std::uint64_t>	Fence  { 0u };
+		} SLOT;
+
+		std::unique_ptr<IFenceWaiter> m_pWaiter{ nullptr };
+		std::vector<SLOT>			  m_slots  {};
+		FRAME_RING_STATS			  m_stats  {};
+	};
+} // namespace framework
@@ -0,0 +1,183 @@
+#include "hot_reload.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace framework;
+
+namespace
+{
+	//~ events may come relative or absolute, compare resolved paths
+	std::filesystem::path Resolve(const std::filesystem::path& path)
+	{
+		std::error_code error{};
+		auto resolved = std::filesystem::weakly_canonical(path, error);
+		return error ? path.lexically_normal() : resolved;
+	}
+
+	//~ true when path is changed itself or lies below it
+	bool IsWithin(const std::filesystem::path& path, const std::filesystem::path& changed)
+	{
+		auto changedEnd = changed.end();
+		if (!changed.empty() && changed.filename().empty()) --changedEnd; //~ trailing separator
+
+		const auto [it, pathIt] = std::mismatch(changed.begin(), changedEnd, path.begin(), path.end());
+		return it == changedEnd;
+	}
+} // namespace
+
+const char* framework::ToString(EReloadState state) noexcept
+{
+	switch (state)
+	{
+	case EReloadState::Idle:	  return "idle";
+	case EReloadState::Pending:	  return "pending";
+	case EReloadState::Compiling: return "compiling";
+	case EReloadState::Ready:	  return "ready";
+	default:					  return "unknown";
+	}
+}
+
+framework::HotReloadScheduler::HotReloadScheduler(std::chrono::milliseconds debounce)
+	: m_debounce(debounce)
+{}
+
+std::uint32_t framework::HotReloadScheduler::Register(
+	std::string name,
+	const std::vector<std::filesystem::path>& dependencies)
+{
+	WATCHED_PROGRAM program{};
+	program.Name = std::move(name);
+	for (const auto& dependency : dependencies) program.Dependencies.push_back(Resolve(dependency));
+
+	std::lock_guard lock(m_mutex);
+	m_programs.push_back(std::move(program));
+	return static_cast<std::uint32_t>(m_programs.size() - 1u);
+}
+
+void framework::HotReloadScheduler::SetDependencies(
+	std::uint32_t program,
+	const std::vector<std::filesystem::path>& dependencies)
+{
+	std::vector<std::filesystem::path> resolved{};
+	for (const auto& dependency : dependencies) resolved.push_back(Resolve(dependency));
+
+	std::lock_guard lock(m_mutex);
+	assert(program < m_programs.size() && "Unknown program");
+	m_programs[ program ].Dependencies = std::move(resolved);
+}
+
+std::uint32_t framework::HotReloadScheduler::OnFileChanged(const std::filesystem::path& file, Clock::time_point now)
+{
+	const auto changed = Resolve(file);
+
+	std::lock_guard lock(m_mutex);
+	std::uint32_t touched = 0u;
+	for (auto& program : m_programs)
+	{
+		const bool depends = std::any_of(program.Dependencies.begin(), program.Dependencies.end(),
+			[&changed](const std::filesystem::path& dependency) { return IsWithin(dependency, changed); });
+		if (!depends) continue;
+
+		++touched;
+		program.LastChange = now;
+		switch (program.State)
+		{
+		case EReloadState::Idle:
+		case EReloadState::Pending:
+			program.State = EReloadState::Pending;
+			break;
+		case EReloadState::Compiling:
+		case EReloadState::Ready:
+			program.Dirty = true;
+			break;
+		}
+	}
+	if (touched) ++m_stats.Changes;
+	return touched;
+}
+
+std::vector<std::uint32_t> framework::HotReloadScheduler::TakeDue(Clock::time_point now)
+{
+	std::lock_guard lock(m_mutex);
+
+	std::vector<std::uint32_t> due{};
+	for (std::uint32_t i = 0u; i < m_programs.size(); ++i)
+	{
+		auto& program = m_programs[ i ];
+		if (program.State != EReloadState::Pending || now - program.LastChange < m_debounce) continue;
+
+		program.State = EReloadState::Compiling;
+		due.push_back(i);
+		++m_stats.Compiles;
+	}
+	return due;
+}
+
+void framework::HotReloadScheduler::Complete(std::uint32_t program, bool success)
+{
+	std::lock_guard lock(m_mutex);
+	assert(program < m_programs.size() && "Unknown program");
+
+	auto& watched = m_programs[ program ];
+	assert(watched.State == EReloadState::Compiling && "Program was not compiling");
+
+	if (success)
+	{
+		watched.State = EReloadState::Ready;
+		return;
+	}
+
+	//~ the live program stays, the next edit tries again
+	++m_stats.Failures;
+	watched.State = watched.Dirty ? EReloadState::Pending : EReloadState::Idle;
+	watched.Dirty = false;
+}
+
+std::vector<std::uint32_t> framework::HotReloadScheduler::TakeReady()
+{
+	std::lock_guard lock(m_mutex);
+
+	std::vector<std::uint32_t> ready{};
+	for (std::uint32_t i = 0u; i < m_programs.size(); ++i)
+	{
+		auto& program = m_programs[ i ];
+		if (program.State != EReloadState::Ready) continue;
+
+		program.State = program.Dirty ? EReloadState::Pending : EReloadState::Idle;
+		program.Dirty = false;
+		ready.push_back(i);
+		++m_stats.Swaps;
+	}
+	return ready;
+}
+
+EReloadState framework::HotReloadScheduler::GetState(std::uint32_t program) const
+{
+	std::lock_guard lock(m_mutex);
+	assert(program < m_programs.size() && "Unknown program");
+	return m_programs[ program ].State;
+}
+
+std::string framework::HotReloadScheduler::GetName(std::uint32_t program) const
+{
+	std::lock_guard lock(m_mutex);
+	assert(program < m_programs.size() && "Unknown program");
+	return m_programs[ program ].Name;
+}
+
+std::uint32_t framework::HotReloadScheduler::Find(const std::string& name) const
+{
+	std::lock_guard lock(m_mutex);
+	for (std::uint32_t i = 0u; i < m_programs.size(); ++i)
+	{
+		if (m_programs[ i ].Name == name) return i;
+	}
+	return INVALID_PROGRAM;
+}
+
+HOT_RELOAD_STATS framework::HotReloadScheduler::GetStats() const
+{
+	std::lock_guard lock(m_mutex);
+	return m_stats;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace framework
+{
+	enum class EReloadState : std::uint8_t
+	{
+		Idle = 0,
+		Pending,   //~ changed, waiting for the debounce to run out
+		Compiling,
+		Ready	   //~ compiled, swapped in at the next frame boundary
+	};
+
+	const char* ToString(EReloadState state) noexcept;
+
+	typedef struct _HOT_RELOAD_STATS
+	{
+		std::uint32_t Changes  { 0u }; //~ file events that touched at least one program
+		std::uint32_t Compiles { 0u };
+		std::uint32_t Swaps	   { 0u };
+		std::uint32_t Failures { 0u };
+	} HOT_RELOAD_STATS;
+
+	/// <summary>
+	/// Decides when watched programs (a shader and its includes) recompile and when the result
+	/// may replace the live one. Every change restarts the debounce of the programs depending on
+	/// the file, a program changed while compiling goes back to pending once its result is taken.
+	/// A change to a directory touches everything below it (watchers report one on overflow).
+	/// Thread safe, compiles may complete from a worker.
+	/// </summary>
+	class HotReloadScheduler
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		static constexpr std::uint32_t INVALID_PROGRAM = ~0u;
+
+		explicit HotReloadScheduler(std::chrono::milliseconds debounce = std::chrono::milliseconds(200));
+
+		std::uint32_t Register		 (std::string name, const std::vector<std::filesystem::path>& dependencies);
+		void		  SetDependencies(std::uint32_t program, const std::vector<std::filesystem::path>& dependencies);
+
+		//~ returns how many programs depend on file
+		std::uint32_t OnFileChanged(const std::filesystem::path& file, Clock::time_point now);
+
+		//~ pending programs quiet for the debounce, they move to compiling
+		std::vector<std::uint32_t> TakeDue(Clock::time_point now);
+		void					   Complete(std::uint32_t program, bool success);
+
+		//~ at a frame boundary, compiled programs to swap in
+		std::vector<std::uint32_t> TakeReady();
+
+		//~ Getters
+		EReloadState	   GetState	(std::uint32_t program) const;
+		std::string		   GetName	(std::uint32_t program) const;
+		std::uint32_t	   Find		(const std::string& name) const;
+		HOT_RELOAD_STATS   GetStats () const;
+		std::chrono::milliseconds GetDebounce() const noexcept { return m_debounce; }
+
+	private:
+		typedef struct _WATCHED_PROGRAM
+		{
+			std::string						   Name		   {};
+			std::vector<std::filesystem::path> Dependencies{};
+			EReloadState					   State	   { EReloadState::Idle };
+			bool							   Dirty	   { false }; //~ changed again while compiling or ready
+			Clock::time_point				   LastChange  {};
+		} WATCHED_PROGRAM;
+
+	private:
+		std::chrono::milliseconds	 m_debounce;
+		std::vector<WATCHED_PROGRAM> m_programs{};
+		HOT_RELOAD_STATS			 m_stats   {};
+
+		mutable std::mutex m_mutex{};
+	};
+} // namespace framework
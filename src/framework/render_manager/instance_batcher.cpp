@@ -0,0 +1,44 @@
+#include "instance_batcher.h"
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+using namespace framework;
+
+namespace
+{
+	inline auto Tie(const INSTANCE_KEY& key) noexcept
+	{
+		return std::tie(key.Pipeline, key.Geometry, key.StartIndex, key.BaseVertex, key.IndexCount);
+	}
+} // namespace
+
+void framework::InstanceBatcher::Build(const std::vector<INSTANCE_KEY>& keys)
+{
+	const auto count = static_cast<std::uint32_t>(keys.size());
+
+	m_instanceOrder.resize(count);
+	std::iota(m_instanceOrder.begin(), m_instanceOrder.end(), 0u);
+
+	//~ stable so instances of one batch stay in submission order
+	std::stable_sort(m_instanceOrder.begin(), m_instanceOrder.end(),
+					 [&keys](std::uint32_t a, std::uint32_t b) { return Tie(keys[ a ]) < Tie(keys[ b ]); });
+
+	m_batches.clear();
+	m_instanceSlots.resize(count);
+	for (std::uint32_t slot = 0u; slot < count; ++slot)
+	{
+		const std::uint32_t item = m_instanceOrder[ slot ];
+		m_instanceSlots[ item ]	 = slot;
+
+		if (m_batches.empty() || Tie(keys[ m_instanceOrder[ m_batches.back().FirstInstance ] ]) != Tie(keys[ item ]))
+		{
+			m_batches.push_back({ slot, 0u });
+		}
+		++m_batches.back().InstanceCount;
+	}
+
+	m_stats.ItemCount = count;
+	m_stats.DrawCount = static_cast<std::uint32_t>(m_batches.size());
+}
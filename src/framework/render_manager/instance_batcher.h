@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace framework
+{
+	//~ everything that has to match for two items to share one instanced draw
+	typedef struct _INSTANCE_KEY
+	{
+		std::uint64_t Geometry	{ 0u }; //~ vertex/index buffer identity
+		std::uint64_t Pipeline	{ 0u }; //~ pso / topology identity
+		std::uint32_t StartIndex{ 0u };
+		std::uint32_t BaseVertex{ 0u };
+		std::uint32_t IndexCount{ 0u };
+	} INSTANCE_KEY;
+
+	//~ instances [FirstInstance, FirstInstance + InstanceCount) of GetInstanceOrder()
+	typedef struct _INSTANCE_BATCH
+	{
+		std::uint32_t FirstInstance{ 0u };
+		std::uint32_t InstanceCount{ 0u };
+	} INSTANCE_BATCH;
+
+	typedef struct _INSTANCE_BATCH_STATS
+	{
+		std::uint32_t ItemCount{ 0u };
+		std::uint32_t DrawCount{ 0u };
+	} INSTANCE_BATCH_STATS;
+
+	/// <summary>
+	/// Groups items with identical geometry and pipeline into instanced draws. Pure CPU,
+	/// the caller owns the per instance data and lays it out in GetInstanceOrder() order.
+	/// </summary>
+	class InstanceBatcher
+	{
+	public:
+		InstanceBatcher() = default;
+		~InstanceBatcher() = default;
+
+		//~ keys[i] describes item i. Items keep their relative order inside a batch,
+		//~ batches are ordered by key so equal state ends up adjacent.
+		void Build(const std::vector<INSTANCE_KEY>& keys);
+
+		//~ Getters
+		const std::vector<INSTANCE_BATCH>& GetBatches	   () const noexcept { return m_batches;		}
+		const std::vector<std::uint32_t>&  GetInstanceOrder() const noexcept { return m_instanceOrder; } //~ slot -> item
+		const std::vector<std::uint32_t>&  GetInstanceSlots() const noexcept { return m_instanceSlots; } //~ item -> slot
+		INSTANCE_BATCH_STATS			   GetStats		   () const noexcept { return m_stats;			}
+
+	private:
+		std::vector<INSTANCE_BATCH> m_batches		{};
+		std::vector<std::uint32_t>	m_instanceOrder{};
+		std::vector<std::uint32_t>	m_instanceSlots{};
+		INSTANCE_BATCH_STATS		m_stats		   {};
+	};
+} // namespace framework
@@ -0,0 +1,113 @@
+#include "instance_benchmark.h"
+#include "instance_batcher.h"
+
+#include "backend/recording_backend.h"
+#include "utility/logger/logger.h"
+
+#include <chrono>
+
+using namespace framework;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	constexpr std::uint32_t nIndicesPerMesh = 2'400u;
+	constexpr std::uint32_t nVerticesPerMesh = 441u;
+} // namespace
+
+std::vector<INSTANCE_BENCHMARK_RESULT> framework::RunInstanceBenchmark(
+	const std::vector<std::uint32_t>& itemCounts,
+	std::uint32_t meshCount,
+	std::uint32_t iterations)
+{
+	meshCount  = meshCount  ? meshCount  : 1u;
+	iterations = iterations ? iterations : 1u;
+
+	std::vector<INSTANCE_BENCHMARK_RESULT> results{};
+	results.reserve(itemCounts.size());
+
+	//~ one shared vertex/index buffer, submeshes are ranges in it like the shapes demo
+	const GpuVertexBufferView vertexView{ 0x10000u, nVerticesPerMesh * meshCount * 28u, 28u };
+	const GpuIndexBufferView  indexView { 0x20000u, nIndicesPerMesh * meshCount * 2u, EIndexFormat::Uint16 };
+
+	RecordingCommandRecorder recorder{};
+
+	for (auto count : itemCounts)
+	{
+		//~ interleaved meshes and pipelines, the worst case for the per item path
+		std::vector<INSTANCE_KEY> keys(count);
+		for (std::uint32_t i = 0u; i < count; ++i)
+		{
+			const std::uint32_t mesh = i % meshCount;
+			keys[ i ].Geometry	 = vertexView.Location;
+			keys[ i ].Pipeline	 = (i / meshCount) & 1u;
+			keys[ i ].StartIndex = mesh * nIndicesPerMesh;
+			keys[ i ].BaseVertex = mesh * nVerticesPerMesh;
+			keys[ i ].IndexCount = nIndicesPerMesh;
+		}
+
+		INSTANCE_BENCHMARK_RESULT result{};
+		result.ItemCount = count;
+
+		InstanceBatcher batcher{};
+		for (std::uint32_t it = 0u; it < iterations; ++it)
+		{
+			auto start = Clock::now();
+			batcher.Build(keys);
+			result.GroupMs += ElapsedMs(start);
+
+			//~ what DrawShapes does per item: full IA state, one table, one draw
+			recorder.Reset();
+			start = Clock::now();
+			for (std::uint32_t i = 0u; i < count; ++i)
+			{
+				const auto& key = keys[ i ];
+				recorder.SetVertexBuffer(0u, vertexView);
+				recorder.SetIndexBuffer(indexView);
+				recorder.SetPrimitiveTopology(EPrimitiveTopology::TriangleList);
+				recorder.SetGraphicsRootDescriptorTable(0u, { 0x1000u + i * 32u });
+				recorder.DrawIndexedInstanced(key.IndexCount, 1u, key.StartIndex,
+											  static_cast<std::int32_t>(key.BaseVertex), 0u);
+			}
+			result.PerItemRecordMs += ElapsedMs(start);
+			result.PerItemDraws	   = recorder.GetCommandCount(ERecordedCommand::DrawIndexedInstanced);
+			result.PerItemCommands = recorder.GetCommandCount();
+
+			//~ instanced: one root constant and one draw per batch
+			recorder.Reset();
+			start = Clock::now();
+			const auto& order = batcher.GetInstanceOrder();
+			for (const auto& batch : batcher.GetBatches())
+			{
+				const auto& key = keys[ order[ batch.FirstInstance ] ];
+				recorder.SetVertexBuffer(0u, vertexView);
+				recorder.SetIndexBuffer(indexView);
+				recorder.SetPrimitiveTopology(EPrimitiveTopology::TriangleList);
+				recorder.SetGraphicsRoot32BitConstant(3u, batch.FirstInstance, 0u);
+				recorder.DrawIndexedInstanced(key.IndexCount, batch.InstanceCount, key.StartIndex,
+											  static_cast<std::int32_t>(key.BaseVertex), 0u);
+			}
+			result.InstancedRecordMs += ElapsedMs(start);
+			result.InstancedDraws	 = recorder.GetCommandCount(ERecordedCommand::DrawIndexedInstanced);
+			result.InstancedCommands = recorder.GetCommandCount();
+		}
+
+		result.GroupMs			 /= iterations;
+		result.PerItemRecordMs	 /= iterations;
+		result.InstancedRecordMs /= iterations;
+
+		logger::info("Instance benchmark {:>7} items: draws {} -> {}, commands {} -> {}, "
+					 "group {:.3f} ms, record {:.3f} ms -> {:.3f} ms",
+					 result.ItemCount, result.PerItemDraws, result.InstancedDraws,
+					 result.PerItemCommands, result.InstancedCommands,
+					 result.GroupMs, result.PerItemRecordMs, result.InstancedRecordMs);
+		results.push_back(result);
+	}
+	return results;
+}
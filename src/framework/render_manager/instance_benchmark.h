@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace framework
+{
+	typedef struct _INSTANCE_BENCHMARK_RESULT
+	{
+		std::uint32_t ItemCount		   { 0u };
+		std::uint32_t PerItemDraws	   { 0u };
+		std::uint32_t InstancedDraws   { 0u };
+		std::uint32_t PerItemCommands  { 0u };
+		std::uint32_t InstancedCommands{ 0u };
+		double		  GroupMs		   { 0.0 }; //~ averages over the iterations
+		double		  PerItemRecordMs  { 0.0 };
+		double		  InstancedRecordMs{ 0.0 };
+	} INSTANCE_BENCHMARK_RESULT;
+
+	//~ spreads the items over meshCount submeshes and two pipelines, groups them with
+	//~ InstanceBatcher and records the per item and the instanced path into the recording
+	//~ backend. Results are logged and returned. Blocks the calling thread.
+	std::vector<INSTANCE_BENCHMARK_RESULT> RunInstanceBenchmark(
+		const std::vector<std::uint32_t>& itemCounts = { 22u, 1'000u, 10'000u, 100'000u },
+		std::uint32_t meshCount	 = 8u,
+		std::uint32_t iterations = 8u);
+} // namespace framework
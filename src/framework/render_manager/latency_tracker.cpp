@@ -0,0 +1,102 @@
+#include "latency_tracker.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace framework;
+
+namespace
+{
+	double ToMs(LatencyTracker::Clock::duration duration) noexcept
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	//~ nearest rank on a sorted copy: the smallest sample with at least percent of them at or below it
+	double Percentile(const std::vector<double>& sorted, std::size_t percent) noexcept
+	{
+		if (sorted.empty()) return 0.0;
+		const auto rank = (percent * sorted.size() + 99u) / 100u;
+		return sorted[ std::clamp<std::size_t>(rank, 1u, sorted.size()) - 1u ];
+	}
+} // namespace
+
+framework::LatencyTracker::LatencyTracker(std::size_t window)
+	: m_nWindow(std::max<std::size_t>(window, 1u))
+{
+	m_samples.reserve(m_nWindow);
+}
+
+void framework::LatencyTracker::BeginFrame(std::uint64_t frame, TimePoint inputSampled, double latencyWaitMs)
+{
+	std::lock_guard lock(m_mutex);
+	assert((m_pending.empty() || frame > m_pending.back().Frame) && "Frames must begin in order!");
+
+	m_pending.push_back({ frame, inputSampled, latencyWaitMs });
+	while (m_pending.size() > MAX_PENDING_FRAMES)
+	{
+		m_pending.pop_front();
+		++m_nDropped;
+	}
+}
+
+void framework::LatencyTracker::EndFrame(std::uint64_t frame, TimePoint presentBegin, TimePoint presentEnd)
+{
+	std::lock_guard lock(m_mutex);
+
+	//~ frames present in order, anything older than this one will never present
+	while (!m_pending.empty() && m_pending.front().Frame < frame)
+	{
+		m_pending.pop_front();
+		++m_nDropped;
+	}
+	if (m_pending.empty() || m_pending.front().Frame != frame) return;
+
+	const auto& pending = m_pending.front();
+	const LATENCY_SAMPLE sample{ ToMs(presentEnd - pending.Input), ToMs(presentEnd - presentBegin), pending.WaitMs };
+	m_pending.pop_front();
+
+	if (m_samples.size() < m_nWindow) m_samples.push_back(sample);
+	else							  m_samples[ m_nNext ] = sample;
+	m_nNext = (m_nNext + 1u) % m_nWindow;
+}
+
+void framework::LatencyTracker::Reset()
+{
+	std::lock_guard lock(m_mutex);
+	m_pending.clear();
+	m_samples.clear();
+	m_nNext	   = 0u;
+	m_nDropped = 0u;
+}
+
+LATENCY_STATS framework::LatencyTracker::GetStats() const
+{
+	std::lock_guard lock(m_mutex);
+
+	LATENCY_STATS stats{};
+	stats.Frames  = m_samples.size();
+	stats.Dropped = m_nDropped;
+	if (m_samples.empty()) return stats;
+
+	std::vector<double> latencies{};
+	latencies.reserve(m_samples.size());
+	for (const auto& sample : m_samples)
+	{
+		latencies.push_back(sample.LatencyMs);
+		stats.AverageMs		   += sample.LatencyMs;
+		stats.AveragePresentMs += sample.PresentMs;
+		stats.AverageWaitMs	   += sample.WaitMs;
+	}
+
+	const auto count = static_cast<double>(m_samples.size());
+	stats.AverageMs		   /= count;
+	stats.AveragePresentMs /= count;
+	stats.AverageWaitMs	   /= count;
+
+	std::sort(latencies.begin(), latencies.end());
+	stats.P50Ms = Percentile(latencies, 50u);
+	stats.P95Ms = Percentile(latencies, 95u);
+	stats.MaxMs = latencies.back();
+	return stats;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace framework
+{
+	typedef struct _LATENCY_STATS
+	{
+		std::uint64_t Frames		 { 0u }; //~ presented frames in the window
+		std::uint64_t Dropped		 { 0u }; //~ started but never presented, since the last Reset
+		double		  AverageMs		 { 0.0 }; //~ input sampled to Present returned
+		double		  P50Ms			 { 0.0 };
+		double		  P95Ms			 { 0.0 };
+		double		  MaxMs			 { 0.0 };
+		double		  AveragePresentMs{ 0.0 }; //~ time spent inside Present, back pressure of a full queue
+		double		  AverageWaitMs	 { 0.0 }; //~ time spent on the frame latency waitable before sampling input
+	} LATENCY_STATS;
+
+	/// <summary>
+	/// Input to present latency of the frames in flight: the frame is opened when its input
+	/// is sampled and closed when its Present returns, the stats cover the last window frames.
+	/// Timestamps are passed in, so the accounting runs headless with made up clocks.
+	/// Start and present may come from different threads.
+	/// </summary>
+	class LatencyTracker
+	{
+	public:
+		using Clock		= std::chrono::steady_clock;
+		using TimePoint = Clock::time_point;
+
+		static constexpr std::size_t MAX_PENDING_FRAMES = 16u; //~ older starts are counted as dropped
+
+		explicit LatencyTracker(std::size_t window = 240u);
+
+		void BeginFrame(std::uint64_t frame, TimePoint inputSampled, double latencyWaitMs = 0.0);
+		void EndFrame  (std::uint64_t frame, TimePoint presentBegin, TimePoint presentEnd);
+		void Reset	   ();
+
+		//~ Getters
+		LATENCY_STATS GetStats() const;
+
+	private:
+		typedef struct _PENDING_FRAME
+		{
+			std::uint64_t Frame	 { 0u };
+			TimePoint	  Input	 {};
+			double		  WaitMs { 0.0 };
+		} PENDING_FRAME;
+
+		typedef struct _LATENCY_SAMPLE
+		{
+			double LatencyMs{ 0.0 };
+			double PresentMs{ 0.0 };
+			double WaitMs	{ 0.0 };
+		} LATENCY_SAMPLE;
+
+		std::size_t					m_nWindow{ 240u };
+		std::deque<PENDING_FRAME>	m_pending{};
+		std::vector<LATENCY_SAMPLE> m_samples{}; //~ ring of the last m_nWindow frames
+		std::size_t					m_nNext	 { 0u };
+		std::uint64_t				m_nDropped{ 0u };
+		mutable std::mutex			m_mutex	 {};
+	};
+} // namespace framework
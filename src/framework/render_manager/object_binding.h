@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+
+#include "backend/command_recorder.h"
+
+namespace framework
+{
+	//~ how per object constants reach the shader, picks the root parameter layout
+	enum class EObjectBinding : std::uint8_t
+	{
+		DescriptorTable = 0, //~ one CBV descriptor per object and frame, a table per draw
+		RootCbv,			 //~ the object's constant buffer address in the root signature, no descriptors
+		RootConstants,		 //~ the data itself in the root signature, only for a few dwords
+		StructuredBuffer,	 //~ bindless: all objects tightly packed in one buffer per frame, the object id per draw
+		Count
+	};
+
+	//~ 64 dwords of root signature in total, leave room for the pass and instancing parameters
+	inline constexpr std::uint32_t MAX_OBJECT_ROOT_CONSTANTS = 16u;
+
+	inline const char* ToString(EObjectBinding binding) noexcept
+	{
+		switch (binding)
+		{
+		case EObjectBinding::DescriptorTable: return "descriptor table";
+		case EObjectBinding::RootCbv:		  return "root CBV";
+		case EObjectBinding::RootConstants:	  return "root constants";
+		case EObjectBinding::StructuredBuffer: return "structured buffer";
+		default:							  return "unknown";
+		}
+	}
+
+	//~ where object i's constants live for each binding, filled once per recorded range
+	typedef struct _OBJECT_BINDING_SOURCE
+	{
+		EObjectBinding		Binding		  { EObjectBinding::RootCbv };
+		std::uint32_t		RootParameter { 0u };
+		GpuDescriptorHandle TableStart	  {};		  //~ DescriptorTable: object 0's CBV
+		std::uint32_t		DescriptorSize{ 0u };
+		GpuVirtualAddress	BufferStart	  { 0u };	  //~ RootCbv: object 0's constants
+		std::uint64_t		ElementSize	  { 0u };	  //~ 256 byte aligned constant buffer stride
+		const std::uint8_t* Constants	  { nullptr }; //~ RootConstants: tightly packed CPU copy
+		std::uint32_t		ConstantCount { 0u };	  //~ dwords per object
+		//~ StructuredBuffer needs nothing per range, the buffer is bound once per frame
+	} OBJECT_BINDING_SOURCE;
+
+	//~ the only per draw binding work, shared by the renderer and the benchmark
+	inline void BindObject(ICommandRecorder& recorder, const OBJECT_BINDING_SOURCE& source, std::uint32_t object)
+	{
+		switch (source.Binding)
+		{
+		case EObjectBinding::DescriptorTable:
+			recorder.SetGraphicsRootDescriptorTable(
+				source.RootParameter,
+				{ source.TableStart.Ptr + static_cast<std::uint64_t>(object) * source.DescriptorSize });
+			break;
+		case EObjectBinding::RootCbv:
+			recorder.SetGraphicsRootConstantBufferView(source.RootParameter, source.BufferStart + object * source.ElementSize);
+			break;
+		case EObjectBinding::RootConstants:
+			recorder.SetGraphicsRoot32BitConstants(
+				source.RootParameter, source.ConstantCount,
+				source.Constants + static_cast<std::size_t>(object) * source.ConstantCount * sizeof(std::uint32_t), 0u);
+			break;
+		case EObjectBinding::StructuredBuffer:
+			recorder.SetGraphicsRoot32BitConstant(source.RootParameter, object, 0u);
+			break;
+		default:
+			break;
+		}
+	}
+} // namespace framework
@@ -0,0 +1,71 @@
+#include "parallel_recorder.h"
+
+#include "utility/thread/job_system.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace framework;
+
+std::vector<RECORD_RANGE> framework::PartitionRecordRanges(
+	std::uint32_t itemCount,
+	std::uint32_t maxChunks,
+	std::uint32_t minItemsPerChunk)
+{
+	std::vector<RECORD_RANGE> ranges{};
+	if (itemCount == 0u || maxChunks == 0u) return ranges;
+
+	minItemsPerChunk = std::max(minItemsPerChunk, 1u);
+
+	const std::uint32_t wanted = itemCount / minItemsPerChunk;
+	const std::uint32_t chunks = std::clamp(wanted, 1u, maxChunks);
+	const std::uint32_t base   = itemCount / chunks;
+	const std::uint32_t extra  = itemCount % chunks;
+
+	ranges.reserve(chunks);
+
+	std::uint32_t begin = 0u;
+	for (std::uint32_t i = 0u; i < chunks; ++i)
+	{
+		const std::uint32_t size = base + (i < extra ? 1u : 0u);
+		ranges.push_back({ begin, begin + size });
+		begin += size;
+	}
+
+	assert(begin == itemCount && "Partition lost items!");
+	return ranges;
+}
+
+std::uint32_t framework::ParallelRecorder::Record(
+	std::uint32_t itemCount,
+	const std::vector<ICommandRecorder*>& recorders,
+	std::uint32_t minItemsPerChunk,
+	const ChunkFn& fn) const
+{
+	const auto ranges = PartitionRecordRanges(
+		itemCount,
+		static_cast<std::uint32_t>(recorders.size()),
+		minItemsPerChunk);
+
+	const auto chunkCount = static_cast<std::uint32_t>(ranges.size());
+
+	auto recordChunks = [&](std::uint32_t begin, std::uint32_t end)
+	{
+		for (std::uint32_t chunk = begin; chunk < end; ++chunk)
+		{
+			assert(recorders[ chunk ] && "Null recorder handed to parallel recorder!");
+			fn(*recorders[ chunk ], chunk, ranges[ chunk ]);
+		}
+	};
+
+	if (!m_pJobSystem || chunkCount <= 1u)
+	{
+		recordChunks(0u, chunkCount);
+	}
+	else
+	{
+		m_pJobSystem->ParallelFor(chunkCount, 1u, recordChunks);
+	}
+
+	return chunkCount;
+}
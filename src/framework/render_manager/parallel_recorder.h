@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "backend/command_recorder.h"
+
+namespace framework
+{
+	class JobSystem;
+
+	//~ contiguous item range [Begin, End) recorded by one recorder
+	typedef struct _RECORD_RANGE
+	{
+		std::uint32_t Begin{ 0u };
+		std::uint32_t End  { 0u };
+	} RECORD_RANGE;
+
+	//~ splits itemCount items in at most maxChunks contiguous, balanced ranges of at
+	//~ least minItemsPerChunk items. The split only depends on the arguments so the
+	//~ concatenation of the chunks is always the serial order.
+	std::vector<RECORD_RANGE> PartitionRecordRanges(std::uint32_t itemCount,
+													std::uint32_t maxChunks,
+													std::uint32_t minItemsPerChunk);
+
+	/// <summary>
+	/// Records a list of items into several recorders at once. Chunk i is always
+	/// recorded into recorders[i], so submitting the recorders in index order gives
+	/// the same result as recording every item serially into one list.
+	/// </summary>
+	class ParallelRecorder
+	{
+	public:
+		using ChunkFn = std::function<void(ICommandRecorder& recorder,
+										   std::uint32_t chunkIndex,
+										   const RECORD_RANGE& range)>;
+
+		//~ jobs may be null, chunks are then recorded on the calling thread
+		explicit ParallelRecorder(JobSystem* jobs = nullptr)
+			: m_pJobSystem(jobs)
+		{}
+
+		//~ returns the number of recorders used, recorders past it were not touched
+		std::uint32_t Record(std::uint32_t itemCount,
+							 const std::vector<ICommandRecorder*>& recorders,
+							 std::uint32_t minItemsPerChunk,
+							 const ChunkFn& fn) const;
+
+	private:
+		JobSystem* m_pJobSystem{ nullptr };
+	};
+} // namespace framework
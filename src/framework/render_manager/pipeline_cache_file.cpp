@@ -0,0 +1,180 @@
+#include "pipeline_cache_file.h"
+#include "state_hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace framework;
+
+namespace
+{
+	template<typename T>
+	void Write(std::vector<std::uint8_t>& out, const T& value)
+	{
+		const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+		out.insert(out.end(), bytes, bytes + sizeof(T));
+	}
+
+	template<typename T>
+	bool Read(const std::uint8_t* data, std::size_t size, std::size_t& offset, T& value) noexcept
+	{
+		if (size - offset < sizeof(T)) return false;
+		std::memcpy(&value, data + offset, sizeof(T));
+		offset += sizeof(T);
+		return true;
+	}
+} // namespace
+
+framework::PipelineCacheFile::PipelineCacheFile(std::uint64_t deviceId)
+	: m_nDeviceId(deviceId)
+{}
+
+EPipelineCacheLoad framework::PipelineCacheFile::Load(const std::filesystem::path& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return EPipelineCacheLoad::Missing;
+
+	const std::vector<std::uint8_t> data{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+	return Deserialize(data.data(), data.size());
+}
+
+EPipelineCacheLoad framework::PipelineCacheFile::Deserialize(const std::uint8_t* data, std::size_t size)
+{
+	std::size_t offset = 0u;
+
+	PIPELINE_CACHE_FILE_HEADER header{};
+	if (!data || !Read(data, size, offset, header) || header.Magic != MAGIC) return EPipelineCacheLoad::Corrupt;
+	if (header.Version	!= VERSION)		return EPipelineCacheLoad::VersionMismatch;
+	if (header.DeviceId != m_nDeviceId) return EPipelineCacheLoad::DeviceMismatch;
+
+	//~ parse everything before touching the entries, a bad file adds nothing
+	std::vector<std::pair<std::uint64_t, std::vector<std::uint8_t>>> parsed{};
+	for (std::uint64_t i = 0u; i < header.EntryCount; ++i)
+	{
+		PIPELINE_CACHE_FILE_ENTRY entry{};
+		if (!Read(data, size, offset, entry) || size - offset < entry.Size) return EPipelineCacheLoad::Corrupt;
+
+		const std::uint8_t* blob = data + offset;
+		if (HashBytes(blob, static_cast<std::size_t>(entry.Size)) != entry.Checksum) return EPipelineCacheLoad::Corrupt;
+
+		parsed.emplace_back(entry.Key, std::vector<std::uint8_t>(blob, blob + entry.Size));
+		offset += static_cast<std::size_t>(entry.Size);
+	}
+	if (offset != size) return EPipelineCacheLoad::Corrupt;
+
+	std::lock_guard lock(m_mutex);
+	for (auto& [key, blob] : parsed)
+	{
+		m_entries.try_emplace(key, std::move(blob));
+	}
+	return EPipelineCacheLoad::Loaded;
+}
+
+bool framework::PipelineCacheFile::Save(const std::filesystem::path& path)
+{
+	const auto data = Serialize();
+
+	std::error_code error{};
+	if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), error);
+
+	auto temporary = path;
+	temporary += ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		if (!file) return false;
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		if (!file) return false;
+	}
+
+	std::filesystem::rename(temporary, path, error);
+	if (error) return false;
+
+	std::lock_guard lock(m_mutex);
+	m_bDirty = false;
+	return true;
+}
+
+std::vector<std::uint8_t> framework::PipelineCacheFile::Serialize() const
+{
+	std::lock_guard lock(m_mutex);
+
+	//~ sorted by key, the same entries always give the same file
+	std::vector<std::uint64_t> keys{};
+	keys.reserve(m_entries.size());
+	std::size_t bytes = sizeof(PIPELINE_CACHE_FILE_HEADER);
+	for (const auto& [key, blob] : m_entries)
+	{
+		keys.push_back(key);
+		bytes += sizeof(PIPELINE_CACHE_FILE_ENTRY) + blob.size();
+	}
+	std::sort(keys.begin(), keys.end());
+
+	std::vector<std::uint8_t> out{};
+	out.reserve(bytes);
+
+	PIPELINE_CACHE_FILE_HEADER header{};
+	header.DeviceId	  = m_nDeviceId;
+	header.EntryCount = keys.size();
+	Write(out, header);
+
+	for (auto key : keys)
+	{
+		const auto& blob = m_entries.at(key);
+
+		PIPELINE_CACHE_FILE_ENTRY entry{};
+		entry.Key	   = key;
+		entry.Size	   = blob.size();
+		entry.Checksum = HashBytes(blob.data(), blob.size());
+		Write(out, entry);
+		out.insert(out.end(), blob.begin(), blob.end());
+	}
+	return out;
+}
+
+bool framework::PipelineCacheFile::Find(std::uint64_t key, std::vector<std::uint8_t>& blob) const
+{
+	std::lock_guard lock(m_mutex);
+	const auto it = m_entries.find(key);
+	if (it == m_entries.end()) return false;
+
+	blob = it->second;
+	return true;
+}
+
+void framework::PipelineCacheFile::Store(std::uint64_t key, const void* data, std::size_t size)
+{
+	const auto* bytes = static_cast<const std::uint8_t*>(data);
+
+	std::lock_guard lock(m_mutex);
+	m_entries[ key ].assign(bytes, bytes + size);
+	m_bDirty = true;
+}
+
+void framework::PipelineCacheFile::Clear()
+{
+	std::lock_guard lock(m_mutex);
+	m_bDirty = !m_entries.empty();
+	m_entries.clear();
+}
+
+std::size_t framework::PipelineCacheFile::GetEntryCount() const
+{
+	std::lock_guard lock(m_mutex);
+	return m_entries.size();
+}
+
+std::uint64_t framework::PipelineCacheFile::GetByteSize() const
+{
+	std::lock_guard lock(m_mutex);
+	std::uint64_t bytes = 0u;
+	for (const auto& [key, blob] : m_entries) bytes += blob.size();
+	return bytes;
+}
+
+bool framework::PipelineCacheFile::IsDirty() const
+{
+	std::lock_guard lock(m_mutex);
+	return m_bDirty;
+}
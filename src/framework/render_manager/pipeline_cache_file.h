@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace framework
+{
+	enum class EPipelineCacheLoad : std::uint8_t
+	{
+		Loaded = 0,
+		Missing,		//~ no file yet, a cold start
+		VersionMismatch, //~ written by another build of the cache format
+		DeviceMismatch,	//~ another adapter or driver, its blobs would be rejected anyway
+		Corrupt
+	};
+
+	/// <summary>
+	/// Versioned key -> blob store persisted as one file. Blobs are opaque (driver compiled
+	/// pipelines for the D3D12 cache), every entry carries a checksum and a file is only
+	/// accepted for the device id it was written with. Thread safe, platform independent.
+	/// </summary>
+	class PipelineCacheFile
+	{
+	public:
+		static constexpr std::uint32_t MAGIC   = 0x43505346u; //~ "FSPC"
+		static constexpr std::uint32_t VERSION = 1u;
+
+		//~ deviceId identifies adapter and driver, a change throws every blob away
+		explicit PipelineCacheFile(std::uint64_t deviceId = 0u);
+		~PipelineCacheFile() = default;
+
+		PipelineCacheFile(const PipelineCacheFile&) = delete;
+		PipelineCacheFile& operator=(const PipelineCacheFile&) = delete;
+
+		//~ entries already stored are kept, the file only adds what is missing
+		EPipelineCacheLoad Load		 (const std::filesystem::path& path);
+		EPipelineCacheLoad Deserialize(const std::uint8_t* data, std::size_t size);
+
+		//~ writes a temporary file and renames it over path, a crash never leaves half a cache
+		bool					  Save		(const std::filesystem::path& path);
+		std::vector<std::uint8_t> Serialize () const;
+
+		//~ copies the blob, false when key is unknown
+		bool Find (std::uint64_t key, std::vector<std::uint8_t>& blob) const;
+		void Store(std::uint64_t key, const void* data, std::size_t size);
+		void Clear();
+
+		//~ Getters
+		std::uint64_t GetDeviceId	() const noexcept { return m_nDeviceId; }
+		std::size_t	  GetEntryCount () const;
+		std::uint64_t GetByteSize	() const;
+		bool		  IsDirty		() const;
+
+	private:
+		typedef struct _PIPELINE_CACHE_FILE_HEADER
+		{
+			std::uint32_t Magic	  { MAGIC };
+			std::uint32_t Version { VERSION };
+			std::uint64_t DeviceId{ 0u };
+			std::uint64_t EntryCount{ 0u };
+		} PIPELINE_CACHE_FILE_HEADER;
+
+		typedef struct _PIPELINE_CACHE_FILE_ENTRY
+		{
+			std::uint64_t Key	  { 0u };
+			std::uint64_t Size	  { 0u };
+			std::uint64_t Checksum{ 0u };
+		} PIPELINE_CACHE_FILE_ENTRY;
+
+	private:
+		std::uint64_t m_nDeviceId{ 0u };
+		std::unordered_map<std::uint64_t, std::vector<std::uint8_t>> m_entries{};
+		bool m_bDirty{ false };
+
+		mutable std::mutex m_mutex{};
+	};
+} // namespace framework
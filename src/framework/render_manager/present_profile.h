@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+namespace framework
+{
+	//~ how frames reach the screen, picks the swap chain flags, buffer count and present call
+	enum class EPresentProfile : std::uint8_t
+	{
+		LowLatency = 0, //~ vsync, waitable swap chain with one queued frame: input is sampled right before it is needed
+		HighThroughput, //~ vsync, three buffers so the GPU never waits for a free back buffer
+		Uncapped,		//~ no vsync, tearing allowed when the output supports it
+		Count
+	};
+
+	inline constexpr std::uint32_t MAX_SWAP_CHAIN_BUFFER_COUNT = 3u;
+
+	typedef struct _PRESENT_PROFILE_DESC
+	{
+		EPresentProfile Profile		   { EPresentProfile::LowLatency };
+		std::uint32_t	BufferCount	   { 2u };
+		std::uint32_t	MaxFrameLatency{ 0u }; //~ frames the present queue may hold, 0 keeps the DXGI default and no waitable object
+		std::uint32_t	SyncInterval   { 1u };
+		bool			AllowTearing   { false };
+	} PRESENT_PROFILE_DESC;
+
+	inline constexpr PRESENT_PROFILE_DESC GetPresentProfileDesc(EPresentProfile profile) noexcept
+	{
+		switch (profile)
+		{
+		case EPresentProfile::LowLatency:	  return { EPresentProfile::LowLatency,		2u, 1u, 1u, false };
+		case EPresentProfile::HighThroughput: return { EPresentProfile::HighThroughput, 3u, 0u, 1u, false };
+		case EPresentProfile::Uncapped:		  return { EPresentProfile::Uncapped,		3u, 0u, 0u, true  };
+		default:							  return {};
+		}
+	}
+
+	inline const char* ToString(EPresentProfile profile) noexcept
+	{
+		switch (profile)
+		{
+		case EPresentProfile::LowLatency:	  return "low latency";
+		case EPresentProfile::HighThroughput: return "high throughput";
+		case EPresentProfile::Uncapped:		  return "uncapped";
+		default:							  return "unknown";
+		}
+	}
+
+	static_assert(GetPresentProfileDesc(EPresentProfile::HighThroughput).BufferCount <= MAX_SWAP_CHAIN_BUFFER_COUNT
+				  && GetPresentProfileDesc(EPresentProfile::Uncapped).BufferCount <= MAX_SWAP_CHAIN_BUFFER_COUNT,
+				  "A present profile asks for more back buffers than the render manager keeps");
+} // namespace framework
@@ -0,0 +1,125 @@
+#include "recording_benchmark.h"
+#include "parallel_recorder.h"
+
+#include "backend/recording_backend.h"
+#include "utility/logger/logger.h"
+#include "utility/thread/job_system.h"
+
+#include <cassert>
+#include <chrono>
+#include <memory>
+
+using namespace framework;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	constexpr std::uint32_t nObjectDwords	  = 16u;
+	constexpr std::uint32_t nIndicesPerDraw	  = 2'400u;
+	constexpr std::uint32_t nDrawsPerGeometry = 16u;
+	constexpr std::uint32_t nDrawsPerPipeline = 256u;
+	constexpr std::uint32_t nMinDrawsPerChunk = 256u; //~ what DrawShapes hands a worker at least
+
+	//~ the per item part of DrawShapes::RecordStage once the queue sorted the packets
+	void RecordDraws(ICommandRecorder& recorder, const RECORD_RANGE& range, const std::uint32_t* constants)
+	{
+		const GpuVertexBufferView vertexView{ 0x10000u, 441u * 28u, 28u };
+		const GpuIndexBufferView  indexView { 0x20000u, nIndicesPerDraw * 2u, EIndexFormat::Uint16 };
+
+		recorder.SetGraphicsRootSignature(reinterpret_cast<GpuRootSignatureHandle>(std::uintptr_t(0x40u)));
+		recorder.SetPrimitiveTopology(EPrimitiveTopology::TriangleList);
+		for (std::uint32_t i = range.Begin; i < range.End; ++i)
+		{
+			//~ a chunk can start mid run, it has to bind what its first draw needs
+			if (i == range.Begin || i % nDrawsPerPipeline == 0u)
+			{
+				recorder.SetPipelineState(reinterpret_cast<GpuPipelineHandle>(std::uintptr_t(0x80u + i / nDrawsPerPipeline)));
+			}
+			if (i == range.Begin || i % nDrawsPerGeometry == 0u)
+			{
+				recorder.SetVertexBuffer(0u, vertexView);
+				recorder.SetIndexBuffer(indexView);
+			}
+			recorder.SetGraphicsRootConstantBufferView(2u, 0x100000ull + i * 256ull);
+			recorder.SetGraphicsRoot32BitConstants(0u, nObjectDwords, constants + std::size_t(i) * nObjectDwords, 0u);
+			recorder.DrawIndexedInstanced(nIndicesPerDraw, 1u, 0u, 0, 0u);
+		}
+	}
+} // namespace
+
+std::vector<RECORDING_BENCHMARK_RESULT> framework::RunRecordingBenchmark(
+	JobSystem* jobs,
+	const std::vector<std::uint32_t>& drawCounts,
+	std::uint32_t iterations)
+{
+	iterations = iterations ? iterations : 1u;
+
+	//~ one recorder per worker plus the caller, which runs the first chunk
+	const std::uint32_t recorderCount = jobs ? jobs->GetWorkerCount() + 1u : 1u;
+
+	std::vector<std::unique_ptr<RecordingCommandRecorder>> workers{};
+	std::vector<ICommandRecorder*> recorders{};
+	for (std::uint32_t i = 0u; i < recorderCount; ++i)
+	{
+		workers.push_back(std::make_unique<RecordingCommandRecorder>());
+		recorders.push_back(workers.back().get());
+	}
+
+	const ParallelRecorder parallel(jobs);
+	RecordingCommandRecorder recorder{};
+	RecordingCommandRecorder replay	 {};
+
+	std::vector<RECORDING_BENCHMARK_RESULT> results{};
+	results.reserve(drawCounts.size());
+
+	for (auto count : drawCounts)
+	{
+		const std::vector<std::uint32_t> constants(std::size_t(count) * nObjectDwords, 0x3f800000u);
+
+		RECORDING_BENCHMARK_RESULT result{};
+		result.DrawCount = count;
+
+		for (std::uint32_t it = 0u; it < iterations; ++it)
+		{
+			recorder.Reset();
+			auto start = Clock::now();
+			RecordDraws(recorder, { 0u, count }, constants.data());
+			result.RecordMs += ElapsedMs(start);
+
+			for (auto& worker : workers) worker->Reset();
+			start = Clock::now();
+			result.Recorders = parallel.Record(count, recorders, nMinDrawsPerChunk,
+				[&constants](ICommandRecorder& target, std::uint32_t, const RECORD_RANGE& range)
+				{
+					RecordDraws(target, range, constants.data());
+				});
+			result.ParallelRecordMs += ElapsedMs(start);
+
+			replay.Reset();
+			start = Clock::now();
+			recorder.Replay(replay);
+			result.ReplayMs += ElapsedMs(start);
+		}
+
+		assert(replay.GetStream() == recorder.GetStream() && "Replay changed the recorded stream!");
+
+		result.RecordMs			/= iterations;
+		result.ParallelRecordMs /= iterations;
+		result.ReplayMs			/= iterations;
+		result.NsPerDraw		 = count ? result.RecordMs * 1.0e6 / count : 0.0;
+		result.BytesPerDraw		 = count ? static_cast<double>(recorder.GetByteSize()) / count : 0.0;
+
+		logger::info("Recording benchmark {:>7} draws: record {:.3f} ms ({:.1f} ns/draw, {:.1f} bytes/draw), "
+					 "parallel {:.3f} ms over {} recorders, replay {:.3f} ms",
+					 result.DrawCount, result.RecordMs, result.NsPerDraw, result.BytesPerDraw,
+					 result.ParallelRecordMs, result.Recorders, result.ReplayMs);
+		results.push_back(result);
+	}
+	return results;
+}
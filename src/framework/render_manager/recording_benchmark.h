@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace framework
+{
+	class JobSystem;
+
+	typedef struct _RECORDING_BENCHMARK_RESULT
+	{
+		std::uint32_t DrawCount		  { 0u };
+		std::uint32_t Recorders		  { 0u };	//~ chunks the parallel pass used
+		double		  RecordMs		  { 0.0 }; //~ averages over the iterations
+		double		  ParallelRecordMs{ 0.0 }; //~ same draws through ParallelRecorder
+		double		  ReplayMs		  { 0.0 }; //~ walking the stream back into a recorder
+		double		  NsPerDraw		  { 0.0 }; //~ serial record
+		double		  BytesPerDraw	  { 0.0 };
+	} RECORDING_BENCHMARK_RESULT;
+
+	//~ records a DrawShapes like frame of drawCount draws into the recording backend, once on
+	//~ the calling thread and once split over jobs, then replays it. jobs may be null, the
+	//~ parallel pass then runs on the caller. Results are logged and returned.
+	std::vector<RECORDING_BENCHMARK_RESULT> RunRecordingBenchmark(
+		JobSystem* jobs,
+		const std::vector<std::uint32_t>& drawCounts = { 1'000u, 10'000u, 100'000u },
+		std::uint32_t iterations = 8u);
+} // namespace framework
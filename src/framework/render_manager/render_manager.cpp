@@ -1,11 +1,13 @@
 ﻿#include "render_manager.h"
 
+#include "backend/dx_render_device.h"
 #include "framework/exception/dx_exception.h"
 #include "framework/windows_manager/windows_manager.h"
 #include "utility/logger/logger.h"
 
-#include <vector>
 #include <cassert>
+#include <chrono>
+#include <vector>
 
 #include "utility/graphics/d3dx12.h"
 
@@ -21,10 +23,20 @@ framework::DxRenderManager::~DxRenderManager()
 	{
 		FlushCommandQueue();
 	}
+
+	m_pDepthStencilBuffer.Reset();
+	if (m_pGpuAllocator) m_pGpuAllocator->Free(m_depthStencilAllocation);
+	ReleaseSwapChain();
 }
 
 bool framework::DxRenderManager::Initialize()
 {
+	m_pJobSystem = std::make_unique<JobSystem>();
+	logger::info("Render job system started with {} workers", m_pJobSystem->GetWorkerCount());
+
+	m_pShaderCache = std::make_unique<ShaderCache>(std::make_unique<DxShaderCompiler>(),
+												   SHADER_CACHE_DIRECTORY, m_pJobSystem.get());
+
 	if (!InitDirectX()) return false;
 	OnResize();
 	return true;
@@ -53,16 +65,50 @@ EMsaaState framework::DxRenderManager::GetMsaaState() const noexcept
 	return EMsaaState::x1;
 }
 
+EPresentProfile framework::DxRenderManager::GetPresentProfile() const noexcept
+{
+	return m_presentProfile.Profile;
+}
+
+UINT framework::DxRenderManager::GetSwapChainBufferCount() const noexcept
+{
+	return m_nSwapChainBufferCount;
+}
+
+UINT framework::DxRenderManager::GetPresentSyncInterval() const noexcept
+{
+	return m_presentProfile.SyncInterval;
+}
+
+UINT framework::DxRenderManager::GetPresentFlags() const noexcept
+{
+	//~ tearing is only legal with a zero sync interval on a swap chain created for it
+	const bool tearing = (m_nSwapChainFlags & DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING) != 0u;
+	return tearing && m_presentProfile.SyncInterval == 0u ? DXGI_PRESENT_ALLOW_TEARING : 0u;
+}
+
 ID3D12Resource* framework::DxRenderManager::GetBackBuffer() const noexcept
 {
-	return m_pSwapChainBuffer[m_nCurrentBackBuffer].Get();
+	return GetBackBuffer(m_nCurrentBackBuffer);
+}
+
+ID3D12Resource* framework::DxRenderManager::GetBackBuffer(UINT index) const noexcept
+{
+	assert(index < m_nSwapChainBufferCount && "Back buffer index out of range!");
+	return m_pSwapChainBuffer[index].Get();
 }
 
 D3D12_CPU_DESCRIPTOR_HANDLE framework::DxRenderManager::GetBackBufferHandle() const noexcept
 {
+	return GetBackBufferHandle(m_nCurrentBackBuffer);
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE framework::DxRenderManager::GetBackBufferHandle(UINT index) const noexcept
+{
+	assert(index < m_nSwapChainBufferCount && "Back buffer index out of range!");
 	return CD3DX12_CPU_DESCRIPTOR_HANDLE(
 		m_pRtvHeap->GetCPUDescriptorHandleForHeapStart(),
-		m_nCurrentBackBuffer,
+		index,
 		m_nRtvDescriptorSize);
 }
 
@@ -77,6 +123,21 @@ void framework::DxRenderManager::SetMsaaState(const EMsaaState state)
 	OnResize();
 }
 
+void framework::DxRenderManager::SetPresentProfile(const EPresentProfile profile)
+{
+	assert(profile < EPresentProfile::Count && "Unknown present profile!");
+	if (profile == m_presentProfile.Profile) return;
+
+	//~ flags and buffer count can not change with ResizeBuffers, the swap chain is recreated
+	FlushCommandQueue();
+	ReleaseBackBuffers();
+	ReleaseSwapChain();
+
+	m_presentProfile = GetPresentProfileDesc(profile);
+	CreateSwapChain();
+	OnResize();
+}
+
 int framework::DxRenderManager::AddDrawCB(DrawCB&& cb)
 {
 	auto key = ++DRAW_KEY_GEN;
@@ -122,6 +183,15 @@ bool framework::DxRenderManager::InitDirectX()
 	THROW_DX_IF_FAILS(m_pDevice->CreateFence(
 		0u, D3D12_FENCE_FLAG_NONE,
 		IID_PPV_ARGS(m_pFence.GetAddressOf())));
+	m_pFlushWaiter = std::make_unique<DxFenceWaiter>(m_pFence.Get());
+
+	m_pGpuAllocator	  = std::make_unique<DxGpuAllocator>(m_pDevice.Get(), m_pAdapter.Get());
+	m_pDescriptorHeap = std::make_unique<DxDescriptorHeap>(m_pDevice.Get(),
+														   PERSISTENT_DESCRIPTOR_COUNT,
+														   TRANSIENT_DESCRIPTORS_PER_FRAME,
+														   DESCRIPTOR_FRAME_COUNT);
+	m_pPipelineCache  = std::make_unique<DxPipelineCache>(m_pDevice.Get(), m_pAdapter.Get(),
+														  PIPELINE_CACHE_PATH, m_pJobSystem.get());
 
 	m_nRtvDescriptorSize	   = m_pDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
 	m_nDsvDescriptorSize	   = m_pDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
@@ -170,13 +240,13 @@ bool framework::DxRenderManager::CreateCommandObjects()
 	qDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
 	THROW_DX_IF_FAILS(m_pDevice->CreateCommandQueue(
 		&qDesc,
-		IID_PPV_ARGS(m_pCommandQueue.GetAddressOf())));
+		IID_PPV_ARGS(m_pCopyQueue.GetAddressOf())));
 
 	//~ compute queue
 	qDesc.Type = D3D12_COMMAND_LIST_TYPE_COMPUTE;
 	THROW_DX_IF_FAILS(m_pDevice->CreateCommandQueue(
 		&qDesc,
-		IID_PPV_ARGS(m_pCommandQueue.GetAddressOf())));
+		IID_PPV_ARGS(m_pComputeQueue.GetAddressOf())));
 
 	//~ graphics queue
 	qDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
@@ -199,12 +269,30 @@ bool framework::DxRenderManager::CreateCommandObjects()
 
 	m_pCommandList->Close();
 
+	m_commandRecorder.Attach(m_pCommandList.Get());
+	m_pRenderDevice = std::make_unique<DxRenderDevice>(this);
+	m_pUploadManager = std::make_unique<DxUploadManager>(m_pDevice.Get(), m_pCopyQueue.Get(), m_pGpuAllocator.get());
+
 	return true;
 }
 
 bool framework::DxRenderManager::CreateSwapChain()
 {
 	assert(m_pWindowsManager && "Cant create swap chain windows manager is null");
+	ReleaseSwapChain(); //~ the waitable object of a previous swap chain is closed here
+
+	const bool waitable = m_presentProfile.MaxFrameLatency != 0u;
+	bool	   tearing	= m_presentProfile.AllowTearing;
+	if (tearing && !IsTearingSupported())
+	{
+		logger::warning("Present profile '{}' asks for tearing, not supported by the output: presenting without it",
+						ToString(m_presentProfile.Profile));
+		tearing = false;
+	}
+
+	m_nSwapChainBufferCount = m_presentProfile.BufferCount;
+	m_nSwapChainFlags		= (waitable ? DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT : 0u)
+							| (tearing	? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0u);
 
 	DXGI_SWAP_CHAIN_DESC1 sd{};
 	sd.Width				= m_pWindowsManager->GetWindowsWidth();
@@ -213,11 +301,11 @@ bool framework::DxRenderManager::CreateSwapChain()
 	sd.SampleDesc.Count		= 1u;
 	sd.SampleDesc.Quality	= 0u;
 	sd.BufferUsage			= DXGI_USAGE_RENDER_TARGET_OUTPUT;
-	sd.BufferCount			= 2u;
+	sd.BufferCount			= m_nSwapChainBufferCount;
 	sd.Scaling				= DXGI_SCALING_STRETCH;
 	sd.SwapEffect			= DXGI_SWAP_EFFECT_FLIP_DISCARD;
 	sd.AlphaMode			= DXGI_ALPHA_MODE_IGNORE;
-	sd.Flags				= 0u;
+	sd.Flags				= m_nSwapChainFlags;
 
 	Microsoft::WRL::ComPtr<IDXGISwapChain1> swapChain1;
 	THROW_DX_IF_FAILS(m_pDxgiFactory->CreateSwapChainForHwnd(
@@ -231,9 +319,49 @@ bool framework::DxRenderManager::CreateSwapChain()
 
 	THROW_DX_IF_FAILS(swapChain1.As(&m_pSwapChain));
 
+	if (waitable)
+	{
+		Microsoft::WRL::ComPtr<IDXGISwapChain2> swapChain2;
+		THROW_DX_IF_FAILS(swapChain1.As(&swapChain2));
+		THROW_DX_IF_FAILS(swapChain2->SetMaximumFrameLatency(m_presentProfile.MaxFrameLatency));
+		m_hFrameLatencyWaitable = swapChain2->GetFrameLatencyWaitableObject();
+	}
+
+	logger::info("Swap chain: profile '{}', {} buffers, sync interval {}, latency waitable {}, tearing {}",
+				 ToString(m_presentProfile.Profile), m_nSwapChainBufferCount, m_presentProfile.SyncInterval,
+				 waitable ? m_presentProfile.MaxFrameLatency : 0u, tearing);
 	return true;
 }
 
+void framework::DxRenderManager::ReleaseSwapChain()
+{
+	if (m_hFrameLatencyWaitable)
+	{
+		CloseHandle(m_hFrameLatencyWaitable);
+		m_hFrameLatencyWaitable = nullptr;
+	}
+	m_pSwapChain.Reset();
+}
+
+void framework::DxRenderManager::ReleaseBackBuffers()
+{
+	for (auto& buffer : m_pSwapChainBuffer)
+	{
+		if (buffer) m_resourceStates.Unregister(buffer.Get());
+		buffer.Reset();
+	}
+}
+
+bool framework::DxRenderManager::IsTearingSupported() const
+{
+	Microsoft::WRL::ComPtr<IDXGIFactory5> factory5;
+	if (FAILED(m_pDxgiFactory.As(&factory5))) return false;
+
+	BOOL allowed = FALSE;
+	const HRESULT hr = factory5->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING, &allowed, sizeof(allowed));
+	return SUCCEEDED(hr) && allowed;
+}
+
 bool framework::DxRenderManager::CreateRenderTargetDescriptorHeap()
 {
 	assert(m_pDevice && "Device is null cant create RTV!");
@@ -242,7 +370,7 @@ bool framework::DxRenderManager::CreateRenderTargetDescriptorHeap()
 	desc.Type			= D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
 	desc.Flags			= D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
 	desc.NodeMask		= 0u;
-	desc.NumDescriptors = SWAP_CHAIN_BUFFER_COUNT;
+	desc.NumDescriptors = MAX_SWAP_CHAIN_BUFFER_COUNT; //~ any profile fits without a new heap
 
 	THROW_DX_IF_FAILS(m_pDevice->CreateDescriptorHeap(
 		&desc,
@@ -258,9 +386,10 @@ bool framework::DxRenderManager::CreateRenderTargetViews()
 	assert(m_pSwapChain && "Swap chain is not created but called to allocate");
 	
 	auto handle = m_pRtvHeap->GetCPUDescriptorHandleForHeapStart();
-	for (UINT i = 0; i < SWAP_CHAIN_BUFFER_COUNT; i++)
+	for (UINT i = 0; i < m_nSwapChainBufferCount; i++)
 	{
 		THROW_DX_IF_FAILS(m_pSwapChain->GetBuffer(i, IID_PPV_ARGS(&m_pSwapChainBuffer[ i ])));
+		m_resourceStates.Register(m_pSwapChainBuffer[ i ].Get(), EResourceState::Present);
 		m_pDevice->CreateRenderTargetView(m_pSwapChainBuffer[ i ].Get(), nullptr, handle);
 		handle.ptr += static_cast<SIZE_T>(m_nRtvDescriptorSize);
 	}
@@ -307,21 +436,14 @@ bool framework::DxRenderManager::CreateDepthStencilViews()
 	clear.DepthStencil.Depth	= 1.0f;
 	clear.DepthStencil.Stencil	= 0;
 
-	D3D12_HEAP_PROPERTIES properties{};
-	properties.Type					= D3D12_HEAP_TYPE_DEFAULT;
-	properties.CPUPageProperty		= D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-	properties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-	properties.VisibleNodeMask		= 1u;
-	properties.CreationNodeMask		= 1u;
-
-	THROW_DX_IF_FAILS(m_pDevice->CreateCommittedResource(
-		&properties,
-		D3D12_HEAP_FLAG_NONE,
-		&desc,
+	//~ placed in the render target heaps, a resize gives the old range back first
+	m_depthStencilAllocation = m_pGpuAllocator->CreateResource(
+		desc,
+		D3D12_HEAP_TYPE_DEFAULT,
 		D3D12_RESOURCE_STATE_DEPTH_WRITE,
-		&clear,
-		IID_PPV_ARGS(m_pDepthStencilBuffer.GetAddressOf())
-	));
+		&clear);
+	m_pDepthStencilBuffer = m_depthStencilAllocation.Resource;
+	m_resourceStates.Register(m_pDepthStencilBuffer.Get(), EResourceState::DepthWrite);
 
 	D3D12_DEPTH_STENCIL_VIEW_DESC view{};
 	view.Flags				= D3D12_DSV_FLAG_NONE;
@@ -359,22 +481,19 @@ void framework::DxRenderManager::FlushCommandQueue()
 	m_nCurrentFence++;
 	THROW_DX_IF_FAILS(m_pCommandQueue->Signal(m_pFence.Get(), m_nCurrentFence));
 
-	if (m_pFence->GetCompletedValue() < m_nCurrentFence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, nullptr, 0u, EVENT_ALL_ACCESS);
-		THROW_DX_IF_FAILS(m_pFence->SetEventOnCompletion(m_nCurrentFence, eventHandle));
+	m_pFlushWaiter->Wait(m_nCurrentFence);
+}
 
-		DWORD waitResult = WaitForSingleObject(eventHandle, INFINITE);
-		DWORD winErr	 = GetLastError();
-		CloseHandle(eventHandle);
+double framework::DxRenderManager::WaitForFrameLatency()
+{
+	if (!m_hFrameLatencyWaitable) return 0.0;
 
-		if (waitResult != WAIT_OBJECT_0)
-		{
-			logger::error("Fence wait failed! WaitForSingleObject returned: {}", waitResult);
-			logger::error("Win32 error: {}", winErr);
-			THROW_DX_IF_FAILS(HRESULT_FROM_WIN32(winErr));
-		}
-	}
+	const auto begin  = std::chrono::steady_clock::now();
+	const DWORD result = WaitForSingleObjectEx(m_hFrameLatencyWaitable, FRAME_LATENCY_TIMEOUT_MS, TRUE);
+	const double waited = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+	if (result == WAIT_TIMEOUT) logger::warning("Frame latency wait timed out after {} ms", FRAME_LATENCY_TIMEOUT_MS);
+	return waited;
 }
 
 void framework::DxRenderManager::OnResize()
@@ -389,18 +508,17 @@ void framework::DxRenderManager::OnResize()
 	FlushCommandQueue();
 	THROW_DX_IF_FAILS(m_pCommandList->Reset(m_pCommandAlloc.Get(), nullptr));
 
-	for (size_t i = 0; i < SWAP_CHAIN_BUFFER_COUNT; i++)
-	{
-		m_pSwapChainBuffer[ i ].Reset();
-	}
+	ReleaseBackBuffers();
+	if (m_pDepthStencilBuffer) m_resourceStates.Unregister(m_pDepthStencilBuffer.Get());
 	m_pDepthStencilBuffer.Reset();
+	m_pGpuAllocator->Free(m_depthStencilAllocation);
 
 	THROW_DX_IF_FAILS(m_pSwapChain->ResizeBuffers(
-		SWAP_CHAIN_BUFFER_COUNT,
+		m_nSwapChainBufferCount,
 		m_pWindowsManager->GetWindowsWidth (), 
 		m_pWindowsManager->GetWindowsHeight(),
 		m_backBufferFormat,
-		DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH
+		DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH | m_nSwapChainFlags //~ waitable and tearing must be kept
 	));
 
 	m_nCurrentBackBuffer = 0u;
@@ -409,20 +527,15 @@ void framework::DxRenderManager::OnResize()
 	CreateRenderTargetViews();
 	CreateDepthStencilViews();
 
-	D3D12_RESOURCE_BARRIER barrier{};
-	barrier.Type				   = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-	barrier.Flags				   = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-	barrier.Transition.pResource   = m_pDepthStencilBuffer.Get();
-	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COMMON;
-	barrier.Transition.StateAfter  = D3D12_RESOURCE_STATE_DEPTH_WRITE;
-	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-
-	m_pCommandList->ResourceBarrier(1u, &barrier);
-	m_pCommandList->Close();
+	//~ placed in DEPTH_WRITE already, the tracker drops this unless a layer left it elsewhere
+	ResourceStateTracker barriers(m_resourceStates);
+	barriers.Transition(m_pDepthStencilBuffer.Get(), EResourceState::DepthWrite);
+	barriers.Flush(m_commandRecorder);
+	barriers.Commit();
+	THROW_DX_IF_FAILS(m_pCommandList->Close());
 
-	ID3D12CommandList* cmdLists[]{ m_pCommandList.Get() };
-	UINT cmdSize = ARRAYSIZE(cmdLists);
-	m_pCommandQueue->ExecuteCommandLists(cmdSize, cmdLists);
+	ICommandRecorder* recorders[]{ &m_commandRecorder };
+	m_pRenderDevice->ExecuteCommandLists(recorders, 1u);
 	FlushCommandQueue();
 }
 
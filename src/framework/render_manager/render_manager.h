@@ -8,11 +8,25 @@
 #include <d3d12.h>
 #include <dxgi.h>
 #include <dxgi1_4.h>
+#include <dxgi1_5.h>
 #include <d3dcompiler.h>
 #include <wrl/client.h>
 #include <functional>
+#include <memory>
 #include <unordered_map>
 
+#include "backend/dx_command_recorder.h"
+#include "backend/dx_descriptor_heap.h"
+#include "backend/dx_fence_waiter.h"
+#include "backend/dx_gpu_allocator.h"
+#include "backend/dx_pipeline_cache.h"
+#include "backend/dx_shader_compiler.h"
+#include "backend/dx_upload_manager.h"
+#include "backend/render_device.h"
+#include "present_profile.h"
+#include "resource_state_tracker.h"
+#include "utility/thread/job_system.h"
+
 namespace framework
 {
 	class DxWindowsManager;
@@ -47,18 +61,28 @@ namespace framework
 
 		//~ Getters
 		EMsaaState					GetMsaaState		 () const noexcept;
+		EPresentProfile				GetPresentProfile	 () const noexcept;
+		UINT						GetSwapChainBufferCount() const noexcept;
+		UINT						GetPresentSyncInterval() const noexcept;
+		UINT						GetPresentFlags		 () const noexcept;
 		ID3D12Resource*				GetBackBuffer		 () const noexcept;
+		ID3D12Resource*				GetBackBuffer		 (UINT index) const noexcept;
 		D3D12_CPU_DESCRIPTOR_HANDLE GetBackBufferHandle  () const noexcept;
+		D3D12_CPU_DESCRIPTOR_HANDLE GetBackBufferHandle  (UINT index) const noexcept;
 		D3D12_CPU_DESCRIPTOR_HANDLE GetDepthStencilHandle() const noexcept;
 
 		//~ Setters
 		void SetMsaaState(const EMsaaState state);
+		//~ recreates the swap chain, the caller must not have frames in flight on the back buffers
+		void SetPresentProfile(const EPresentProfile profile);
 		int  AddDrawCB(DrawCB&& cb);
 		void RemoveDrawCB(const int key);
 
 		//~ operations
 		void FlushCommandQueue();
 		void OnResize();
+		//~ blocks on the frame latency waitable object when the profile has one, returns the ms waited
+		double WaitForFrameLatency();
 
 		//~ helpers
 		void LogAdapters();
@@ -72,6 +96,9 @@ namespace framework
 		bool ConfigureMSAA						 ();
 		bool CreateCommandObjects				 ();
 		bool CreateSwapChain					 ();
+		void ReleaseSwapChain					 ();
+		void ReleaseBackBuffers					 ();
+		bool IsTearingSupported					 () const;
 		bool CreateRenderTargetDescriptorHeap	 ();
 		bool CreateRenderTargetViews			 ();
 		bool CreateDepthStencilDescriptorHeap	 ();
@@ -94,14 +121,33 @@ namespace framework
 		Microsoft::WRL::ComPtr<IDXGISwapChain>	m_pSwapChain  { nullptr };
 		Microsoft::WRL::ComPtr<ID3D12Device>	m_pDevice	  { nullptr };
 
-		static constexpr unsigned SWAP_CHAIN_BUFFER_COUNT{ 2u };
+		//~ placed resources in shared heaps, declared before anything it allocates
+		std::unique_ptr<DxGpuAllocator> m_pGpuAllocator{ nullptr };
+
+		//~ presentation, buffer count and flags follow the profile
+		inline static constexpr EPresentProfile DEFAULT_PRESENT_PROFILE{ EPresentProfile::LowLatency };
+		static constexpr DWORD FRAME_LATENCY_TIMEOUT_MS{ 1000u }; //~ a lost device must not hang the frame
+
+		PRESENT_PROFILE_DESC m_presentProfile	 { GetPresentProfileDesc(DEFAULT_PRESENT_PROFILE) };
+		UINT				 m_nSwapChainFlags	 { 0u };
+		HANDLE				 m_hFrameLatencyWaitable{ nullptr };
+
+		//~ global descriptor heap layout, layers keep at most this many frames in flight
+		static constexpr unsigned DESCRIPTOR_FRAME_COUNT		 { 3u };
+		static constexpr unsigned PERSISTENT_DESCRIPTOR_COUNT	 { 16384u };
+		static constexpr unsigned TRANSIENT_DESCRIPTORS_PER_FRAME{ 4096u };
 		
-		unsigned m_nCurrentBackBuffer{ 0u };
-		Microsoft::WRL::ComPtr<ID3D12Resource> m_pSwapChainBuffer[ SWAP_CHAIN_BUFFER_COUNT ];
+		unsigned m_nCurrentBackBuffer	{ 0u };
+		unsigned m_nSwapChainBufferCount{ 2u };
+		Microsoft::WRL::ComPtr<ID3D12Resource> m_pSwapChainBuffer[ MAX_SWAP_CHAIN_BUFFER_COUNT ];
+
+		//~ last known state of the back buffers and the depth buffer, layers transition through trackers over it
+		ResourceStateCache m_resourceStates{};
 
 		// sync resource
 		Microsoft::WRL::ComPtr<ID3D12Fence> m_pFence{ nullptr };
 		UINT m_nCurrentFence{ 0u };
+		std::unique_ptr<DxFenceWaiter> m_pFlushWaiter{ nullptr }; //~ FlushCommandQueue only
 
 		// cmd resource
 		Microsoft::WRL::ComPtr<ID3D12CommandQueue>		  m_pCopyQueue{ nullptr };
@@ -110,10 +156,19 @@ namespace framework
 		Microsoft::WRL::ComPtr<ID3D12CommandAllocator>    m_pCommandAlloc{ nullptr };
 		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_pCommandList { nullptr };
 
+		//~ backend neutral view over the queue and the setup list above
+		std::unique_ptr<IRenderDevice> m_pRenderDevice	 { nullptr };
+		DxCommandRecorder			   m_commandRecorder{};
+
+		//~ static buffer uploads, batched on the copy queue
+		std::unique_ptr<DxUploadManager> m_pUploadManager{ nullptr };
+
 		//~ Render Resource
+		std::unique_ptr<DxDescriptorHeap>			 m_pDescriptorHeap	   { nullptr }; //~ the only shader visible heap
 		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_pRtvHeap			   { nullptr };
 		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_pDsvHeap			   { nullptr };
 		Microsoft::WRL::ComPtr<ID3D12Resource>		 m_pDepthStencilBuffer{ nullptr };
+		GPU_ALLOCATION								 m_depthStencilAllocation{};
 
 		D3D12_VIEWPORT m_viewport{};
 		D3D12_RECT     m_scissorRect{};
@@ -122,6 +177,17 @@ namespace framework
 		UINT m_nDsvDescriptorSize	   { 0u };
 		UINT m_nCbvSrvUavDescriptorSize{ 0u };
 
+		//~ shared workers for parallel frame work (recording, culling...)
+		std::unique_ptr<JobSystem> m_pJobSystem{ nullptr };
+
+		//~ root signatures and PSOs of every layer, compiles on the job system so it is declared after it
+		std::unique_ptr<DxPipelineCache> m_pPipelineCache{ nullptr };
+		inline static const char* PIPELINE_CACHE_PATH{ "cache/pipelines.bin" };
+
+		//~ shader bytecode by content hash, misses compile on the job system
+		std::unique_ptr<ShaderCache> m_pShaderCache{ nullptr };
+		inline static const char* SHADER_CACHE_DIRECTORY{ "cache/shaders" };
+
 		//~ draw callbacks
 		std::unordered_map<int, DrawCB> m_drawCallbacks{};
 		inline static unsigned int DRAW_KEY_GEN{ 0 };
@@ -0,0 +1,171 @@
+#include "render_queue.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using namespace framework;
+
+namespace
+{
+	constexpr std::uint64_t FieldMask(std::uint32_t bits) noexcept
+	{
+		return (1ull << bits) - 1ull;
+	}
+
+	constexpr std::uint32_t nDepthShift		   = 0u;
+	constexpr std::uint32_t nMaterialShift	   = nDepthShift	+ SORT_KEY_DEPTH_BITS;
+	constexpr std::uint32_t nGeometryShift	   = nMaterialShift + SORT_KEY_MATERIAL_BITS;
+	constexpr std::uint32_t nPipelineShift	   = nGeometryShift + SORT_KEY_GEOMETRY_BITS;
+	constexpr std::uint32_t nRootSignatureShift = nPipelineShift + SORT_KEY_PIPELINE_BITS;
+
+	inline std::uint64_t Field(std::uint64_t key, std::uint32_t shift, std::uint32_t bits) noexcept
+	{
+		return (key >> shift) & FieldMask(bits);
+	}
+
+	//~ below this a comparison sort beats eight histogram passes
+	constexpr std::size_t nMinRadixCount = 256u;
+} // namespace
+
+std::uint64_t framework::EncodeSortKey(const SORT_KEY_DESC& desc) noexcept
+{
+	return ((desc.RootSignature & FieldMask(SORT_KEY_ROOT_SIGNATURE_BITS)) << nRootSignatureShift)
+		 | ((desc.Pipeline		& FieldMask(SORT_KEY_PIPELINE_BITS))	   << nPipelineShift)
+		 | ((desc.Geometry		& FieldMask(SORT_KEY_GEOMETRY_BITS))	   << nGeometryShift)
+		 | ((desc.Material		& FieldMask(SORT_KEY_MATERIAL_BITS))	   << nMaterialShift)
+		 | ((desc.Depth			& FieldMask(SORT_KEY_DEPTH_BITS))		   << nDepthShift);
+}
+
+SORT_KEY_DESC framework::DecodeSortKey(std::uint64_t key) noexcept
+{
+	SORT_KEY_DESC desc{};
+	desc.RootSignature = static_cast<std::uint32_t>(Field(key, nRootSignatureShift, SORT_KEY_ROOT_SIGNATURE_BITS));
+	desc.Pipeline	   = static_cast<std::uint32_t>(Field(key, nPipelineShift,		SORT_KEY_PIPELINE_BITS));
+	desc.Geometry	   = static_cast<std::uint32_t>(Field(key, nGeometryShift,		SORT_KEY_GEOMETRY_BITS));
+	desc.Material	   = static_cast<std::uint32_t>(Field(key, nMaterialShift,		SORT_KEY_MATERIAL_BITS));
+	desc.Depth		   = static_cast<std::uint32_t>(Field(key, nDepthShift,			SORT_KEY_DEPTH_BITS));
+	return desc;
+}
+
+std::uint32_t framework::QuantizeDepth(float viewDepth, float nearZ, float farZ) noexcept
+{
+	const float range = farZ - nearZ;
+	if (!(range > 0.f)) return 0u;
+
+	const float t	 = std::clamp((viewDepth - nearZ) / range, 0.f, 1.f);
+	const auto	maxV = static_cast<float>(FieldMask(SORT_KEY_DEPTH_BITS));
+	return static_cast<std::uint32_t>(t * maxV);
+}
+
+void framework::RadixSortEntries(std::vector<RENDER_QUEUE_ENTRY>& entries, std::vector<RENDER_QUEUE_ENTRY>& scratch)
+{
+	const std::size_t count = entries.size();
+	if (count < nMinRadixCount)
+	{
+		std::stable_sort(entries.begin(), entries.end(),
+						 [](const RENDER_QUEUE_ENTRY& a, const RENDER_QUEUE_ENTRY& b) { return a.Key < b.Key; });
+		return;
+	}
+
+	//~ all eight histograms in one read of the keys
+	std::array<std::array<std::uint32_t, 256>, 8> histograms{};
+	for (const auto& entry : entries)
+	{
+		std::uint64_t key = entry.Key;
+		for (std::size_t digit = 0; digit < 8u; ++digit, key >>= 8u)
+		{
+			++histograms[ digit ][ key & 0xffu ];
+		}
+	}
+
+	scratch.resize(count);
+	RENDER_QUEUE_ENTRY* src = entries.data();
+	RENDER_QUEUE_ENTRY* dst = scratch.data();
+
+	for (std::size_t digit = 0; digit < 8u; ++digit)
+	{
+		auto& histogram = histograms[ digit ];
+
+		//~ a digit every key shares does not reorder anything
+		const std::uint32_t shift = static_cast<std::uint32_t>(digit * 8u);
+		if (histogram[ (src[ 0 ].Key >> shift) & 0xffu ] == count) continue;
+
+		std::uint32_t offset = 0u;
+		for (auto& bucket : histogram)
+		{
+			const std::uint32_t size = bucket;
+			bucket = offset;
+			offset += size;
+		}
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			dst[ histogram[ (src[ i ].Key >> shift) & 0xffu ]++ ] = src[ i ];
+		}
+		std::swap(src, dst);
+	}
+
+	if (src != entries.data())
+	{
+		std::copy(src, src + count, entries.data());
+	}
+}
+
+//~ RenderQueue
+
+void framework::RenderQueue::Reserve(std::size_t count)
+{
+	m_entries.reserve(count);
+	m_scratch.reserve(count);
+}
+
+void framework::RenderQueue::Reset() noexcept
+{
+	m_entries.clear();
+	m_stats = {};
+}
+
+void framework::RenderQueue::Push(std::uint64_t key, std::uint32_t payload)
+{
+	m_entries.push_back({ key, payload, STATE_CHANGE_ALL });
+}
+
+void framework::RenderQueue::Sort()
+{
+	RadixSortEntries(m_entries, m_scratch);
+	TagStateChanges();
+}
+
+void framework::RenderQueue::TagStateChanges() noexcept
+{
+	m_stats = {};
+	m_stats.DrawCount = GetCount();
+
+	std::uint64_t previous = 0u;
+	for (std::size_t i = 0; i < m_entries.size(); ++i)
+	{
+		auto& entry = m_entries[ i ];
+		if (i == 0u)
+		{
+			entry.Changes = STATE_CHANGE_ALL;
+		}
+		else
+		{
+			const std::uint64_t diff = entry.Key ^ previous;
+
+			std::uint32_t changes = STATE_CHANGE_NONE;
+			if (Field(diff, nRootSignatureShift, SORT_KEY_ROOT_SIGNATURE_BITS)) changes |= STATE_CHANGE_ROOT_SIGNATURE;
+			if (Field(diff, nPipelineShift,		 SORT_KEY_PIPELINE_BITS))		changes |= STATE_CHANGE_PIPELINE;
+			if (Field(diff, nGeometryShift,		 SORT_KEY_GEOMETRY_BITS))		changes |= STATE_CHANGE_GEOMETRY;
+			if (Field(diff, nMaterialShift,		 SORT_KEY_MATERIAL_BITS))		changes |= STATE_CHANGE_MATERIAL;
+			entry.Changes = changes;
+		}
+		previous = entry.Key;
+
+		m_stats.RootSignatureChanges += (entry.Changes & STATE_CHANGE_ROOT_SIGNATURE) ? 1u : 0u;
+		m_stats.PipelineChanges		 += (entry.Changes & STATE_CHANGE_PIPELINE)		  ? 1u : 0u;
+		m_stats.GeometryChanges		 += (entry.Changes & STATE_CHANGE_GEOMETRY)		  ? 1u : 0u;
+		m_stats.MaterialChanges		 += (entry.Changes & STATE_CHANGE_MATERIAL)		  ? 1u : 0u;
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace framework
+{
+	//~ 64 bit sort key, most expensive state in the highest bits:
+	//~ [63..60] root signature | [59..50] pipeline | [49..38] geometry | [37..24] material | [23..0] depth
+	inline constexpr std::uint32_t SORT_KEY_ROOT_SIGNATURE_BITS = 4u;
+	inline constexpr std::uint32_t SORT_KEY_PIPELINE_BITS		= 10u;
+	inline constexpr std::uint32_t SORT_KEY_GEOMETRY_BITS		= 12u;
+	inline constexpr std::uint32_t SORT_KEY_MATERIAL_BITS		= 14u;
+	inline constexpr std::uint32_t SORT_KEY_DEPTH_BITS			= 24u;
+
+	static_assert(SORT_KEY_ROOT_SIGNATURE_BITS + SORT_KEY_PIPELINE_BITS + SORT_KEY_GEOMETRY_BITS +
+				  SORT_KEY_MATERIAL_BITS + SORT_KEY_DEPTH_BITS == 64u, "Sort key fields must fill 64 bits");
+
+	//~ small dense ids, not native pointers. Values wider than their field are masked
+	typedef struct _SORT_KEY_DESC
+	{
+		std::uint32_t RootSignature{ 0u };
+		std::uint32_t Pipeline	   { 0u };
+		std::uint32_t Geometry	   { 0u };
+		std::uint32_t Material	   { 0u };
+		std::uint32_t Depth		   { 0u }; //~ see QuantizeDepth
+	} SORT_KEY_DESC;
+
+	std::uint64_t EncodeSortKey(const SORT_KEY_DESC& desc) noexcept;
+	SORT_KEY_DESC DecodeSortKey(std::uint64_t key)		   noexcept;
+
+	//~ maps view depth in [nearZ, farZ] to the depth field, front to back.
+	//~ Pass ~QuantizeDepth(...) masked to the field for back to front
+	std::uint32_t QuantizeDepth(float viewDepth, float nearZ, float farZ) noexcept;
+
+	//~ which pieces of state differ from the previous entry in sorted order
+	enum ERenderStateChange : std::uint32_t
+	{
+		STATE_CHANGE_NONE			= 0u,
+		STATE_CHANGE_ROOT_SIGNATURE = 1u << 0u,
+		STATE_CHANGE_PIPELINE		= 1u << 1u,
+		STATE_CHANGE_GEOMETRY		= 1u << 2u,
+		STATE_CHANGE_MATERIAL		= 1u << 3u,
+		STATE_CHANGE_ALL			= 0xfu
+	};
+
+	typedef struct _RENDER_QUEUE_ENTRY
+	{
+		std::uint64_t Key	 { 0u };
+		std::uint32_t Payload{ 0u }; //~ caller index, usually into its packet array
+		std::uint32_t Changes{ STATE_CHANGE_ALL }; //~ filled by Sort
+	} RENDER_QUEUE_ENTRY;
+
+	typedef struct _RENDER_QUEUE_STATS
+	{
+		std::uint32_t DrawCount			  { 0u };
+		std::uint32_t RootSignatureChanges{ 0u };
+		std::uint32_t PipelineChanges	  { 0u };
+		std::uint32_t GeometryChanges	  { 0u };
+		std::uint32_t MaterialChanges	  { 0u };
+	} RENDER_QUEUE_STATS;
+
+	/// <summary>
+	/// Per frame list of draws ordered by 64 bit sort keys. Sort() radix sorts the
+	/// entries (stable, so equal keys keep push order) and tags every entry with the
+	/// state it has to bind, the recorder only emits what actually changed.
+	/// </summary>
+	class RenderQueue
+	{
+	public:
+		RenderQueue() = default;
+		~RenderQueue() = default;
+
+		//~ operations, steady state frames do not allocate
+		void Reserve(std::size_t count);
+		void Reset	() noexcept;
+		void Push	(std::uint64_t key, std::uint32_t payload);
+		void Sort	();
+
+		//~ the first entry of a recorded range starts on a fresh command list, every
+		//~ piece of state has to be bound regardless of what Sort found
+		static std::uint32_t GetRangeChanges(std::uint32_t changes, bool firstInRange) noexcept
+		{
+			return firstInRange ? static_cast<std::uint32_t>(STATE_CHANGE_ALL) : changes;
+		}
+
+		//~ Getters
+		const std::vector<RENDER_QUEUE_ENTRY>& GetEntries() const noexcept { return m_entries; }
+		std::uint32_t						   GetCount	 () const noexcept { return static_cast<std::uint32_t>(m_entries.size()); }
+		RENDER_QUEUE_STATS					   GetStats	 () const noexcept { return m_stats; }
+
+	private:
+		void TagStateChanges() noexcept;
+
+	private:
+		std::vector<RENDER_QUEUE_ENTRY> m_entries{};
+		std::vector<RENDER_QUEUE_ENTRY> m_scratch{}; //~ radix ping-pong buffer
+		RENDER_QUEUE_STATS				m_stats	 {};
+	};
+
+	//~ LSD radix sort on Key, 8 bit digits, stable. Digits every entry shares are skipped.
+	//~ scratch is resized to entries.size(). Exposed for the benchmark
+	void RadixSortEntries(std::vector<RENDER_QUEUE_ENTRY>& entries, std::vector<RENDER_QUEUE_ENTRY>& scratch);
+} // namespace framework
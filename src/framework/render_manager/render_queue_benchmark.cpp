@@ -0,0 +1,119 @@
+#include "render_queue_benchmark.h"
+#include "render_queue.h"
+
+#include "utility/logger/logger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+using namespace framework;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	//~ xorshift, deterministic across runs and platforms
+	std::uint32_t NextRandom(std::uint32_t& state) noexcept
+	{
+		state ^= state << 13u;
+		state ^= state >> 17u;
+		state ^= state << 5u;
+		return state;
+	}
+
+	std::uint32_t CountChanges(const std::vector<RENDER_QUEUE_ENTRY>& entries) noexcept
+	{
+		std::uint32_t changes = 0u;
+		for (std::size_t i = 0; i < entries.size(); ++i)
+		{
+			if (i == 0u) { changes += 3u; continue; }
+
+			const auto a = DecodeSortKey(entries[ i - 1u ].Key);
+			const auto b = DecodeSortKey(entries[ i ].Key);
+			changes += (a.Pipeline != b.Pipeline) + (a.Geometry != b.Geometry) + (a.Material != b.Material);
+		}
+		return changes;
+	}
+
+	//~ a busy scene: few pipelines, a few hundred meshes, more materials
+	constexpr std::uint32_t nPipelines	= 8u;
+	constexpr std::uint32_t nGeometries = 256u;
+	constexpr std::uint32_t nMaterials	= 1024u;
+} // namespace
+
+std::vector<RENDER_QUEUE_BENCHMARK_RESULT> framework::RunRenderQueueBenchmark(
+	const std::vector<std::uint32_t>& itemCounts,
+	std::uint32_t iterations)
+{
+	iterations = iterations ? iterations : 1u;
+
+	std::vector<RENDER_QUEUE_BENCHMARK_RESULT> results{};
+	results.reserve(itemCounts.size());
+
+	for (auto count : itemCounts)
+	{
+		std::uint32_t seed = 0x9e3779b9u;
+		std::vector<std::uint64_t> keys(count);
+		for (auto& key : keys)
+		{
+			SORT_KEY_DESC desc{};
+			desc.Pipeline = NextRandom(seed) % nPipelines;
+			desc.Geometry = NextRandom(seed) % nGeometries;
+			desc.Material = NextRandom(seed) % nMaterials;
+			desc.Depth	  = NextRandom(seed);
+			key = EncodeSortKey(desc);
+		}
+
+		RENDER_QUEUE_BENCHMARK_RESULT result{};
+		result.ItemCount = count;
+
+		RenderQueue queue{};
+		queue.Reserve(count);
+
+		std::vector<RENDER_QUEUE_ENTRY> reference{};
+		for (std::uint32_t it = 0u; it < iterations; ++it)
+		{
+			queue.Reset();
+			for (std::uint32_t i = 0u; i < count; ++i) queue.Push(keys[ i ], i);
+			if (it == 0u) result.UnsortedChanges = CountChanges(queue.GetEntries());
+
+			reference = queue.GetEntries();
+
+			auto start = Clock::now();
+			queue.Sort();
+			result.RadixSortMs += ElapsedMs(start);
+
+			start = Clock::now();
+			std::stable_sort(reference.begin(), reference.end(),
+							 [](const RENDER_QUEUE_ENTRY& a, const RENDER_QUEUE_ENTRY& b) { return a.Key < b.Key; });
+			result.StdSortMs += ElapsedMs(start);
+		}
+
+		//~ both sorts are stable, payloads must match one to one
+		const auto& sorted = queue.GetEntries();
+		for (std::size_t i = 0; i < sorted.size(); ++i)
+		{
+			assert(sorted[ i ].Key == reference[ i ].Key && sorted[ i ].Payload == reference[ i ].Payload
+				   && "Radix sort disagrees with std::stable_sort!");
+		}
+
+		const auto stats = queue.GetStats();
+		result.SortedChanges = stats.PipelineChanges + stats.GeometryChanges + stats.MaterialChanges;
+		result.RadixSortMs	/= iterations;
+		result.StdSortMs	/= iterations;
+		result.NsPerItem	 = count ? result.RadixSortMs * 1.0e6 / count : 0.0;
+
+		logger::info("Render queue benchmark {:>8} items: radix {:.3f} ms, std::stable_sort {:.3f} ms, "
+					 "{:.2f} ns/item, state changes {} -> {}",
+					 result.ItemCount, result.RadixSortMs, result.StdSortMs, result.NsPerItem,
+					 result.UnsortedChanges, result.SortedChanges);
+		results.push_back(result);
+	}
+	return results;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace framework
+{
+	typedef struct _RENDER_QUEUE_BENCHMARK_RESULT
+	{
+		std::uint32_t ItemCount		  { 0u };
+		double		  RadixSortMs	  { 0.0 }; //~ averages over the iterations
+		double		  StdSortMs		  { 0.0 }; //~ std::stable_sort on the same entries
+		double		  NsPerItem		  { 0.0 }; //~ radix sort + state tagging
+		std::uint32_t UnsortedChanges { 0u };  //~ pipeline + geometry + material binds in push order
+		std::uint32_t SortedChanges	  { 0u };  //~ same after sorting
+	} RENDER_QUEUE_BENCHMARK_RESULT;
+
+	//~ fills a RenderQueue with pseudo random keys over a fixed state budget, sorts it and
+	//~ compares against std::stable_sort. Platform independent, results are logged and returned.
+	std::vector<RENDER_QUEUE_BENCHMARK_RESULT> RunRenderQueueBenchmark(
+		const std::vector<std::uint32_t>& itemCounts = { 10'000u, 100'000u, 1'000'000u },
+		std::uint32_t iterations = 8u);
+} // namespace framework
@@ -0,0 +1,316 @@
+#include "resource_state_tracker.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace framework;
+
+namespace
+{
+	bool IsRedundant(EResourceState before, EResourceState after) noexcept
+	{
+		if (before == after) return true;
+
+		//~ a read state already holding every bit asked for, Common is never covered
+		const auto bits = static_cast<std::uint32_t>(after);
+		return IsReadOnlyState(before) && IsReadOnlyState(after)
+			&& (static_cast<std::uint32_t>(before) & bits) == bits;
+	}
+
+	bool Overlaps(std::uint32_t a, std::uint32_t b) noexcept
+	{
+		return a == ALL_SUBRESOURCES || b == ALL_SUBRESOURCES || a == b;
+	}
+
+	void Collapse(RESOURCE_STATE& state)
+	{
+		if (state.IsUniform()) return;
+
+		const auto first = state.Subresources.front();
+		if (std::all_of(state.Subresources.begin(), state.Subresources.end(),
+						[first](EResourceState s) { return s == first; }))
+		{
+			state.State = first;
+			state.Subresources.clear();
+		}
+	}
+} // namespace
+
+//~ ResourceStateCache
+
+void framework::ResourceStateCache::Register(GpuResourceHandle resource, EResourceState initial, std::uint32_t subresourceCount)
+{
+	assert(resource && "Registering a null resource!");
+	assert(subresourceCount > 0u && "A resource has at least one subresource!");
+
+	std::lock_guard lock(m_mutex);
+	m_states[ resource ] = RESOURCE_STATE{ initial, subresourceCount, {} };
+}
+
+void framework::ResourceStateCache::Unregister(GpuResourceHandle resource)
+{
+	std::lock_guard lock(m_mutex);
+	m_states.erase(resource);
+}
+
+bool framework::ResourceStateCache::IsRegistered(GpuResourceHandle resource) const
+{
+	std::lock_guard lock(m_mutex);
+	return m_states.contains(resource);
+}
+
+EResourceState framework::ResourceStateCache::GetState(GpuResourceHandle resource, std::uint32_t subresource) const
+{
+	std::lock_guard lock(m_mutex);
+	const auto it = m_states.find(resource);
+	assert(it != m_states.end() && "Resource state requested for an unregistered resource!");
+	return it != m_states.end() ? it->second.Get(subresource) : EResourceState::Common;
+}
+
+std::size_t framework::ResourceStateCache::GetResourceCount() const
+{
+	std::lock_guard lock(m_mutex);
+	return m_states.size();
+}
+
+RESOURCE_STATE framework::ResourceStateCache::Load(GpuResourceHandle resource) const
+{
+	std::lock_guard lock(m_mutex);
+	const auto it = m_states.find(resource);
+	assert(it != m_states.end() && "Transition on a resource the state cache does not know!");
+	return it != m_states.end() ? it->second : RESOURCE_STATE{};
+}
+
+void framework::ResourceStateCache::Store(GpuResourceHandle resource, const RESOURCE_STATE& state)
+{
+	std::lock_guard lock(m_mutex);
+
+	//~ released while the list was recorded, nothing left to track
+	const auto it = m_states.find(resource);
+	if (it != m_states.end()) it->second = state;
+}
+
+//~ ResourceStateTracker
+
+framework::ResourceStateTracker::ResourceStateTracker(ResourceStateCache& cache)
+	: m_pCache(&cache)
+{}
+
+void framework::ResourceStateTracker::Transition(GpuResourceHandle resource, EResourceState after, std::uint32_t subresource)
+{
+	EndSplits(resource, subresource);
+	Apply(resource, after, subresource, EBarrierFlags::None);
+}
+
+void framework::ResourceStateTracker::BeginTransition(GpuResourceHandle resource, EResourceState after, std::uint32_t subresource)
+{
+	EndSplits(resource, subresource);
+	Apply(resource, after, subresource, EBarrierFlags::BeginOnly);
+}
+
+void framework::ResourceStateTracker::EndTransition(GpuResourceHandle resource, std::uint32_t subresource)
+{
+	EndSplits(resource, subresource);
+}
+
+void framework::ResourceStateTracker::UavBarrier(GpuResourceHandle resource)
+{
+	++m_stats.Requested;
+
+	//~ back to back UAV barriers on the same resource, nothing ran in between
+	for (auto it = m_pending.rbegin(); it != m_pending.rend(); ++it)
+	{
+		if (it->Resource != resource) continue;
+		if (it->Type == EBarrierType::UnorderedAccess)
+		{
+			++m_stats.Redundant;
+			return;
+		}
+		break;
+	}
+
+	GpuResourceBarrier barrier{};
+	barrier.Type	 = EBarrierType::UnorderedAccess;
+	barrier.Resource = resource;
+	m_pending.push_back(barrier);
+}
+
+void framework::ResourceStateTracker::Flush(ICommandRecorder& recorder)
+{
+	if (m_pending.empty()) return;
+
+	recorder.ResourceBarriers(m_pending.data(), static_cast<std::uint32_t>(m_pending.size()));
+	m_stats.Emitted += m_pending.size();
+	++m_stats.Batches;
+	m_pending.clear();
+}
+
+void framework::ResourceStateTracker::Commit()
+{
+	assert(m_pending.empty() && "Commit with barriers that were never flushed!");
+	assert(m_splits.empty()	 && "Commit with a split barrier that was never ended!");
+
+	for (const auto& tracked : m_states)
+	{
+		m_pCache->Store(tracked.Resource, tracked.State);
+	}
+	m_states.clear();
+}
+
+void framework::ResourceStateTracker::Reset() noexcept
+{
+	m_states.clear();
+	m_splits.clear();
+	m_pending.clear();
+}
+
+EResourceState framework::ResourceStateTracker::GetState(GpuResourceHandle resource, std::uint32_t subresource) const
+{
+	const auto it = std::find_if(m_states.begin(), m_states.end(),
+								 [resource](const TRACKED_RESOURCE& tracked) { return tracked.Resource == resource; });
+	return it != m_states.end() ? it->State.Get(subresource) : m_pCache->GetState(resource, subresource);
+}
+
+RESOURCE_STATE& framework::ResourceStateTracker::Track(GpuResourceHandle resource)
+{
+	const auto it = std::find_if(m_states.begin(), m_states.end(),
+								 [resource](const TRACKED_RESOURCE& tracked) { return tracked.Resource == resource; });
+	if (it != m_states.end()) return it->State;
+
+	//~ first use in this list, starts where the last committed list left it
+	m_states.push_back({ resource, m_pCache->Load(resource) });
+	return m_states.back().State;
+}
+
+void framework::ResourceStateTracker::Apply(GpuResourceHandle resource, EResourceState after,
+											 std::uint32_t subresource, EBarrierFlags flags)
+{
+	auto& state = Track(resource);
+
+	if (subresource == ALL_SUBRESOURCES)
+	{
+		if (state.IsUniform())
+		{
+			state.State = TransitionOne(resource, ALL_SUBRESOURCES, state.State, after, flags);
+			return;
+		}
+
+		//~ diverged subresources each move on their own, they may end up uniform again
+		for (std::uint32_t i = 0u; i < state.SubresourceCount; ++i)
+		{
+			state.Subresources[ i ] = TransitionOne(resource, i, state.Subresources[ i ], after, flags);
+		}
+		Collapse(state);
+		CollapsePending(resource, state.SubresourceCount);
+		return;
+	}
+
+	assert(subresource < state.SubresourceCount && "Subresource out of range!");
+	if (state.IsUniform())
+	{
+		if (IsRedundant(state.State, after))
+		{
+			++m_stats.Requested;
+			++m_stats.Redundant;
+			return;
+		}
+		state.Subresources.assign(state.SubresourceCount, state.State);
+	}
+	state.Subresources[ subresource ] = TransitionOne(resource, subresource, state.Subresources[ subresource ], after, flags);
+	Collapse(state);
+	CollapsePending(resource, state.SubresourceCount);
+}
+
+EResourceState framework::ResourceStateTracker::TransitionOne(GpuResourceHandle resource, std::uint32_t subresource,
+															   EResourceState before, EResourceState after, EBarrierFlags flags)
+{
+	++m_stats.Requested;
+	if (IsRedundant(before, after))
+	{
+		++m_stats.Redundant;
+		return before;
+	}
+
+	const GpuResourceBarrier barrier{ EBarrierType::Transition, flags, resource, before, after, subresource };
+	if (flags == EBarrierFlags::BeginOnly)
+	{
+		//~ never merged, the end half has to find the same states
+		m_pending.push_back(barrier);
+		m_splits.push_back(barrier);
+		return after;
+	}
+
+	Push(barrier);
+	return after;
+}
+
+void framework::ResourceStateTracker::Push(const GpuResourceBarrier& barrier)
+{
+	//~ the latest pending barrier on this subresource, if it is a plain transition no command
+	//~ used the state in between and the two fold into one. Plain transitions of the other
+	//~ subresources are independent and skipped, anything else on the resource ends the search
+	for (auto it = m_pending.rbegin(); it != m_pending.rend(); ++it)
+	{
+		if (it->Resource != barrier.Resource) continue;
+		if (it->Type != EBarrierType::Transition || it->Flags != EBarrierFlags::None) break;
+		if (it->Subresource != barrier.Subresource)
+		{
+			if (Overlaps(it->Subresource, barrier.Subresource)) break;
+			continue;
+		}
+
+		assert(it->After == barrier.Before && "Pending barrier does not chain into the next one!");
+		++m_stats.Merged;
+		it->After = barrier.After;
+		if (it->Before == it->After) m_pending.erase(std::next(it).base());
+		return;
+	}
+	m_pending.push_back(barrier);
+}
+
+void framework::ResourceStateTracker::CollapsePending(GpuResourceHandle resource, std::uint32_t subresourceCount)
+{
+	if (subresourceCount < 2u) return;
+
+	//~ the plain per subresource transitions at the end of the resource's pending barriers
+	std::vector<std::size_t> found{};
+	for (std::size_t i = m_pending.size(); i-- > 0u;)
+	{
+		const auto& barrier = m_pending[ i ];
+		if (barrier.Resource != resource) continue;
+		if (barrier.Type != EBarrierType::Transition || barrier.Flags != EBarrierFlags::None
+			|| barrier.Subresource == ALL_SUBRESOURCES) break;
+		found.push_back(i);
+	}
+
+	//~ folding left at most one per subresource, all of them moving the same way is one ALL barrier
+	if (found.size() != subresourceCount) return;
+
+	auto merged = m_pending[ found.front() ];
+	for (const auto i : found)
+	{
+		if (m_pending[ i ].Before != merged.Before || m_pending[ i ].After != merged.After) return;
+	}
+
+	for (const auto i : found) m_pending.erase(m_pending.begin() + static_cast<std::ptrdiff_t>(i)); //~ back to front
+	merged.Subresource = ALL_SUBRESOURCES;
+	m_pending.push_back(merged);
+	m_stats.Merged += subresourceCount - 1u;
+}
+
+void framework::ResourceStateTracker::EndSplits(GpuResourceHandle resource, std::uint32_t subresource)
+{
+	for (auto it = m_splits.begin(); it != m_splits.end();)
+	{
+		if (it->Resource != resource || !Overlaps(it->Subresource, subresource))
+		{
+			++it;
+			continue;
+		}
+
+		GpuResourceBarrier end = *it;
+		end.Flags = EBarrierFlags::EndOnly;
+		m_pending.push_back(end);
+		it = m_splits.erase(it);
+	}
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "backend/command_recorder.h"
+
+namespace framework
+{
+	//~ read states can be combined, a resource in GenericRead already satisfies VertexAndConstant
+	inline constexpr bool IsReadOnlyState(EResourceState state) noexcept
+	{
+		constexpr auto READ_MASK = static_cast<std::uint32_t>(EResourceState::GenericRead)
+								 | static_cast<std::uint32_t>(EResourceState::DepthRead);
+		const auto bits = static_cast<std::uint32_t>(state);
+		return bits != 0u && (bits & ~READ_MASK) == 0u;
+	}
+
+	//~ state of one resource, one value until a single subresource moves on its own
+	typedef struct _RESOURCE_STATE
+	{
+		EResourceState				State			{ EResourceState::Common };
+		std::uint32_t				SubresourceCount{ 1u };
+		std::vector<EResourceState> Subresources	{}; //~ empty while every subresource is in State
+
+		bool		   IsUniform() const noexcept { return Subresources.empty(); }
+		EResourceState Get(std::uint32_t subresource) const noexcept
+		{
+			return IsUniform() || subresource == ALL_SUBRESOURCES ? State : Subresources[ subresource ];
+		}
+	} RESOURCE_STATE;
+
+	typedef struct _RESOURCE_BARRIER_STATS
+	{
+		std::uint64_t Requested{ 0u }; //~ transitions and UAV barriers asked for
+		std::uint64_t Emitted  { 0u }; //~ barriers that reached a recorder
+		std::uint64_t Batches  { 0u }; //~ ResourceBarriers calls
+		std::uint64_t Redundant{ 0u }; //~ already in the state, or in a read state that covers it
+		std::uint64_t Merged   { 0u }; //~ folded into a pending barrier of the same batch
+	} RESOURCE_BARRIER_STATS;
+
+	/// <summary>
+	/// States of the registered resources as of the last committed command list. Shared by
+	/// every tracker, lists must commit in the order they are submitted.
+	/// </summary>
+	class ResourceStateCache
+	{
+	public:
+		ResourceStateCache() = default;
+
+		ResourceStateCache(const ResourceStateCache&)			 = delete;
+		ResourceStateCache& operator=(const ResourceStateCache&) = delete;
+
+		void Register  (GpuResourceHandle resource, EResourceState initial, std::uint32_t subresourceCount = 1u);
+		void Unregister(GpuResourceHandle resource);
+
+		//~ Getters
+		bool		   IsRegistered	  (GpuResourceHandle resource) const;
+		EResourceState GetState		  (GpuResourceHandle resource, std::uint32_t subresource = ALL_SUBRESOURCES) const;
+		std::size_t	   GetResourceCount() const;
+
+	private:
+		friend class ResourceStateTracker;
+
+		RESOURCE_STATE Load (GpuResourceHandle resource) const;
+		void		   Store(GpuResourceHandle resource, const RESOURCE_STATE& state);
+
+	private:
+		std::unordered_map<GpuResourceHandle, RESOURCE_STATE> m_states{};
+		mutable std::mutex									  m_mutex {};
+	};
+
+	/// <summary>
+	/// Per command list barrier builder. Callers name the state they need, the tracker knows
+	/// the one the resource is in: redundant transitions are dropped, A->B->C within a batch
+	/// becomes A->C and A->B->A disappears, per subresource. Pending barriers moving every
+	/// subresource the same way become one ALL barrier. Flush emits the batch as one ResourceBarriers call
+	/// and must come before the commands that use the new states. Commit publishes the final
+	/// states once the list is recorded. One recording thread per tracker.
+	/// </summary>
+	class ResourceStateTracker
+	{
+	public:
+		explicit ResourceStateTracker(ResourceStateCache& cache);
+
+		ResourceStateTracker(const ResourceStateTracker&)			 = delete;
+		ResourceStateTracker& operator=(const ResourceStateTracker&) = delete;
+
+		//~ barriers, a transition on a resource with an open split ends the split first
+		void Transition		(GpuResourceHandle resource, EResourceState after, std::uint32_t subresource = ALL_SUBRESOURCES);
+		void BeginTransition(GpuResourceHandle resource, EResourceState after, std::uint32_t subresource = ALL_SUBRESOURCES);
+		void EndTransition	(GpuResourceHandle resource, std::uint32_t subresource = ALL_SUBRESOURCES);
+		void UavBarrier		(GpuResourceHandle resource);
+
+		void Flush (ICommandRecorder& recorder);
+		void Commit();
+		void Reset () noexcept; //~ drops everything not committed, for a list that is thrown away
+		void ResetStats() noexcept { m_stats = {}; }
+
+		//~ Getters
+		EResourceState							GetState		 (GpuResourceHandle resource, std::uint32_t subresource = ALL_SUBRESOURCES) const;
+		const std::vector<GpuResourceBarrier>&	GetPendingBarriers() const noexcept { return m_pending; }
+		std::size_t								GetOpenSplitCount () const noexcept { return m_splits.size(); }
+		const RESOURCE_BARRIER_STATS&			GetStats		 () const noexcept { return m_stats; }
+
+	private:
+		typedef struct _TRACKED_RESOURCE
+		{
+			GpuResourceHandle Resource{ nullptr };
+			RESOURCE_STATE	  State	  {};
+		} TRACKED_RESOURCE;
+
+		RESOURCE_STATE& Track(GpuResourceHandle resource);
+
+		//~ one subresource (or ALL on a uniform resource), returns the state it is in afterwards
+		EResourceState TransitionOne(GpuResourceHandle resource, std::uint32_t subresource,
+									 EResourceState before, EResourceState after, EBarrierFlags flags);
+		void		   Push		   (const GpuResourceBarrier& barrier);
+		void		   CollapsePending(GpuResourceHandle resource, std::uint32_t subresourceCount);
+		void		   EndSplits   (GpuResourceHandle resource, std::uint32_t subresource);
+		void		   Apply	   (GpuResourceHandle resource, EResourceState after, std::uint32_t subresource, EBarrierFlags flags);
+
+	private:
+		ResourceStateCache*				m_pCache{ nullptr };
+		std::vector<TRACKED_RESOURCE>	m_states{}; //~ a list touches a handful of resources, searched linearly
+		std::vector<GpuResourceBarrier> m_splits{}; //~ begun, not ended yet
+		std::vector<GpuResourceBarrier> m_pending{};
+		RESOURCE_BARRIER_STATS			m_stats	 {};
+	};
+} // namespace framework
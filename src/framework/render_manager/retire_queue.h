@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <utility>
+
+namespace framework
+{
+	/// <summary>
+	/// Keeps objects alive until the GPU is past the fence they were retired with.
+	/// Fences must be retired in increasing order. Not thread safe.
+	/// </summary>
+	template<typename T>
+	class RetireQueue
+	{
+	public:
+		void Retire(T value, std::uint64_t fence)
+		{
+			assert((m_entries.empty() || fence >= m_entries.back().Fence) && "Fences must be retired in order");
+			m_entries.push_back({ fence, std::move(value) });
+		}
+
+		//~ onRelease sees every value whose fence completed, right before it is destroyed
+		template<typename Fn>
+		std::size_t Reclaim(std::uint64_t completedFence, Fn&& onRelease)
+		{
+			std::size_t released = 0u;
+			while (!m_entries.empty() && m_entries.front().Fence <= completedFence)
+			{
+				onRelease(m_entries.front().Value);
+				m_entries.pop_front();
+				++released;
+			}
+			return released;
+		}
+
+		std::size_t Reclaim(std::uint64_t completedFence)
+		{
+			return Reclaim(completedFence, [](T&) {});
+		}
+
+		void Clear() { m_entries.clear(); }
+
+		//~ Getters
+		std::size_t GetSize() const noexcept { return m_entries.size(); }
+		bool		IsEmpty() const noexcept { return m_entries.empty(); }
+
+	private:
+		typedef struct _RETIRED
+		{
+			std::uint64_t Fence{ 0u };
+			T			  Value{};
+		} RETIRED;
+
+		std::deque<RETIRED> m_entries{};
+	};
+} // namespace framework
@@ -0,0 +1,104 @@
+#include "root_binding_benchmark.h"
+
+#include "backend/recording_backend.h"
+#include "utility/logger/logger.h"
+
+#include <chrono>
+
+using namespace framework;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	//~ a world matrix per object, what the shapes demo binds
+	constexpr std::uint32_t nObjectDwords	 = 16u;
+	constexpr std::uint64_t nObjectCBStride	 = 256u;
+	constexpr std::uint32_t nDescriptorSize	 = 32u;
+	constexpr std::uint32_t nIndicesPerDraw	 = 2'400u;
+	constexpr std::uint32_t nDrawsPerGeometry = 16u;
+} // namespace
+
+std::vector<ROOT_BINDING_BENCHMARK_RESULT> framework::RunRootBindingBenchmark(
+	const std::vector<std::uint32_t>& drawCounts,
+	std::uint32_t frameCount,
+	std::uint32_t iterations)
+{
+	frameCount = frameCount ? frameCount : 1u;
+	iterations = iterations ? iterations : 1u;
+
+	std::vector<ROOT_BINDING_BENCHMARK_RESULT> results{};
+	results.reserve(drawCounts.size() * static_cast<std::size_t>(EObjectBinding::Count));
+
+	const GpuVertexBufferView vertexView{ 0x10000u, 441u * 28u, 28u };
+	const GpuIndexBufferView  indexView { 0x20000u, nIndicesPerDraw * 2u, EIndexFormat::Uint16 };
+
+	RecordingCommandRecorder recorder{};
+
+	for (auto count : drawCounts)
+	{
+		std::vector<std::uint32_t> constants(static_cast<std::size_t>(count) * nObjectDwords, 0x3f800000u);
+
+		for (std::uint32_t b = 0u; b < static_cast<std::uint32_t>(EObjectBinding::Count); ++b)
+		{
+			OBJECT_BINDING_SOURCE source{};
+			source.Binding		  = static_cast<EObjectBinding>(b);
+			source.TableStart	  = { 0x100000u };
+			source.DescriptorSize = nDescriptorSize;
+			source.BufferStart	  = 0x1000000u;
+			source.ElementSize	  = nObjectCBStride;
+			source.Constants	  = reinterpret_cast<const std::uint8_t*>(constants.data());
+			source.ConstantCount  = nObjectDwords;
+
+			ROOT_BINDING_BENCHMARK_RESULT result{};
+			result.Binding	   = source.Binding;
+			result.DrawCount   = count;
+			result.Descriptors = source.Binding == EObjectBinding::DescriptorTable ? count * frameCount : 0u;
+
+			//~ CBVs take a 256 byte slot, the structured buffer only the data, root constants live in the list
+			switch (source.Binding)
+			{
+			case EObjectBinding::DescriptorTable:
+			case EObjectBinding::RootCbv:		   result.ObjectBytes = nObjectCBStride; break;
+			case EObjectBinding::StructuredBuffer: result.ObjectBytes = nObjectDwords * sizeof(std::uint32_t); break;
+			default:							   result.ObjectBytes = 0u; break;
+			}
+
+			for (std::uint32_t it = 0u; it < iterations; ++it)
+			{
+				//~ what DrawShapes records per item once the queue sorted it: geometry
+				//~ only when it changes, the object binding and the draw every time
+				recorder.Reset();
+				const auto start = Clock::now();
+				for (std::uint32_t i = 0u; i < count; ++i)
+				{
+					if (i % nDrawsPerGeometry == 0u)
+					{
+						recorder.SetVertexBuffer(0u, vertexView);
+						recorder.SetIndexBuffer(indexView);
+						recorder.SetPrimitiveTopology(EPrimitiveTopology::TriangleList);
+					}
+					BindObject(recorder, source, i);
+					recorder.DrawIndexedInstanced(nIndicesPerDraw, 1u, 0u, 0, 0u);
+				}
+				result.RecordMs += ElapsedMs(start);
+			}
+
+			result.RecordMs		/= iterations;
+			result.NsPerDraw	 = count ? result.RecordMs * 1.0e6 / count : 0.0;
+			result.BytesPerDraw	 = count ? static_cast<double>(recorder.GetByteSize()) / count : 0.0;
+
+			logger::info("Root binding benchmark {:>7} draws, {:<16}: record {:.3f} ms, {:.1f} ns/draw, "
+						 "{:.1f} bytes/draw, {} CBV descriptors, {} upload bytes/object",
+						 result.DrawCount, ToString(result.Binding), result.RecordMs, result.NsPerDraw,
+						 result.BytesPerDraw, result.Descriptors, result.ObjectBytes);
+			results.push_back(result);
+		}
+	}
+	return results;
+}
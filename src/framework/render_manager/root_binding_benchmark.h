@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "object_binding.h"
+
+namespace framework
+{
+	typedef struct _ROOT_BINDING_BENCHMARK_RESULT
+	{
+		EObjectBinding Binding	   { EObjectBinding::DescriptorTable };
+		std::uint32_t  DrawCount   { 0u };
+		double		   RecordMs	   { 0.0 }; //~ averages over the iterations
+		double		   NsPerDraw   { 0.0 };
+		double		   BytesPerDraw{ 0.0 }; //~ recorded stream, binding + draw
+		std::uint32_t  Descriptors { 0u };	//~ CBVs the layout needs for frameCount frames
+		std::uint64_t  ObjectBytes { 0u };	//~ upload memory per object and frame
+	} ROOT_BINDING_BENCHMARK_RESULT;
+
+	//~ records drawCount per object draws into the recording backend once per EObjectBinding
+	//~ through BindObject, the same call DrawShapes makes. Results are logged and returned.
+	std::vector<ROOT_BINDING_BENCHMARK_RESULT> RunRootBindingBenchmark(
+		const std::vector<std::uint32_t>& drawCounts = { 1'000u, 10'000u, 100'000u },
+		std::uint32_t frameCount = 3u,
+		std::uint32_t iterations = 8u);
+} // namespace framework
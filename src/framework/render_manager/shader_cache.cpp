@@ -0,0 +1,339 @@
+#include "shader_cache.h"
+#include "state_hash.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+
+using namespace framework;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double MsSince(Clock::time_point start) noexcept
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	bool ReadText(const std::filesystem::path& path, std::string& text)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file) return false;
+
+		text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	//~ every #include "x" or <x>, conditional ones too: a key that changes too often only costs a compile
+	std::vector<std::string> ParseIncludes(std::string_view text)
+	{
+		std::vector<std::string> includes{};
+
+		std::size_t lineStart = 0u;
+		while (lineStart < text.size())
+		{
+			std::size_t lineEnd = text.find('\n', lineStart);
+			if (lineEnd == std::string_view::npos) lineEnd = text.size();
+
+			auto line  = text.substr(lineStart, lineEnd - lineStart);
+			lineStart  = lineEnd + 1u;
+
+			const auto skipSpaces = [&line]()
+			{
+				const auto first = line.find_first_not_of(" \t");
+				line = first == std::string_view::npos ? std::string_view{} : line.substr(first);
+			};
+
+			skipSpaces();
+			if (line.empty() || line.front() != '#') continue;
+			line.remove_prefix(1u);
+			skipSpaces();
+			if (!line.starts_with("include")) continue;
+			line.remove_prefix(7u);
+			skipSpaces();
+			if (line.empty() || (line.front() != '"' && line.front() != '<')) continue;
+
+			const char close = line.front() == '"' ? '"' : '>';
+			const auto end	 = line.find(close, 1u);
+			if (end == std::string_view::npos || end == 1u) continue;
+
+			includes.emplace_back(line.substr(1u, end - 1u));
+		}
+		return includes;
+	}
+
+	//~ relative to the including file first, then to the directory of the root source
+	void HashSource(StateHasher& hasher,
+					const std::filesystem::path& file,
+					const std::filesystem::path& rootDirectory,
+					std::vector<std::filesystem::path>& visited)
+	{
+		const auto path = file.lexically_normal();
+		hasher.AddString(path.generic_string());
+
+		if (std::find(visited.begin(), visited.end(), path) != visited.end()) return;
+		visited.push_back(path);
+
+		std::string text{};
+		if (!ReadText(path, text))
+		{
+			hasher.Add(std::uint8_t{ 0u });
+			return;
+		}
+		hasher.Add(std::uint8_t{ 1u });
+		hasher.AddString(text);
+
+		for (const auto& include : ParseIncludes(text))
+		{
+			auto candidate = path.parent_path() / include;
+			if (!std::filesystem::exists(candidate))
+			{
+				const auto fromRoot = rootDirectory / include;
+				if (std::filesystem::exists(fromRoot)) candidate = fromRoot;
+			}
+			HashSource(hasher, candidate, rootDirectory, visited);
+		}
+	}
+} // namespace
+
+const char* framework::ToString(EShaderCacheSource source) noexcept
+{
+	switch (source)
+	{
+	case EShaderCacheSource::Memory:   return "memory";
+	case EShaderCacheSource::Disk:	   return "disk";
+	case EShaderCacheSource::Compiled: return "compiled";
+	case EShaderCacheSource::Failed:   return "failed";
+	default:						   return "unknown";
+	}
+}
+
+framework::ShaderCache::ShaderCache(std::unique_ptr<IShaderCompiler> compiler,
+									std::filesystem::path directory,
+									JobSystem* jobs)
+	: m_pCompiler(std::move(compiler))
+	, m_directory(std::move(directory))
+	, m_pJobs(jobs)
+{
+	assert(m_pCompiler && "Shader cache needs a compiler");
+}
+
+SHADER_BYTECODE framework::ShaderCache::Compile(const SHADER_COMPILE_DESC& desc)
+{
+	const auto hashStart = Clock::now();
+
+	SHADER_BYTECODE result{};
+	result.Key = ComputeKey(desc);
+
+	std::promise<Bytecode>	   promise{};
+	std::shared_future<Bytecode> pending{};
+	bool owner = false;
+	{
+		std::lock_guard lock(m_mutex);
+		++m_stats.Requests;
+		m_stats.HashMs += MsSince(hashStart);
+
+		if (const auto it = m_entries.find(result.Key); it != m_entries.end())
+		{
+			pending = it->second;
+		}
+		else
+		{
+			pending = promise.get_future().share();
+			m_entries.emplace(result.Key, pending);
+			owner = true;
+		}
+	}
+
+	//~ the owner compiles right away on its own thread, waiting on it never waits on a queued job
+	if (!owner)
+	{
+		result.Bytecode = pending.get();
+		result.Source	= result.IsValid() ? EShaderCacheSource::Memory : EShaderCacheSource::Failed;
+		if (!result.IsValid()) result.Errors = "identical request compiled at the same time failed";
+
+		std::lock_guard lock(m_mutex);
+		if (result.IsValid()) ++m_stats.MemoryHits;
+		else				  ++m_stats.Failed;
+		return result;
+	}
+
+	std::vector<std::uint8_t> bytecode{};
+	bool   ok		 = false;
+	double compileMs = 0.0;
+	try
+	{
+		if (Read(result.Key, bytecode))
+		{
+			result.Source = EShaderCacheSource::Disk;
+			ok			  = true;
+		}
+		else
+		{
+			const auto compileStart = Clock::now();
+			ok		  = m_pCompiler->Compile(desc, bytecode, result.Errors) && !bytecode.empty();
+			compileMs = MsSince(compileStart);
+
+			if (ok)
+			{
+				result.Source = EShaderCacheSource::Compiled;
+				Write(result.Key, bytecode);
+			}
+		}
+	}
+	catch (...)
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_entries.erase(result.Key);
+			++m_stats.Failed;
+		}
+		promise.set_exception(std::current_exception());
+		throw;
+	}
+
+	std::lock_guard lock(m_mutex);
+	m_stats.CompileMs += compileMs;
+
+	if (!ok)
+	{
+		//~ failures are not kept, the next request tries again
+		m_entries.erase(result.Key);
+		++m_stats.Failed;
+		promise.set_value(nullptr);
+		return result;
+	}
+
+	if (result.Source == EShaderCacheSource::Disk) ++m_stats.DiskHits;
+	else										  ++m_stats.Compiled;
+
+	result.Bytecode = std::make_shared<const std::vector<std::uint8_t>>(std::move(bytecode));
+	promise.set_value(result.Bytecode);
+	return result;
+}
+
+std::vector<SHADER_BYTECODE> framework::ShaderCache::CompileAll(const std::vector<SHADER_COMPILE_DESC>& descs)
+{
+	std::vector<SHADER_BYTECODE> results(descs.size());
+	const auto count = static_cast<std::uint32_t>(descs.size());
+
+	if (m_pJobs && count > 1u)
+	{
+		m_pJobs->ParallelFor(count, 1u, [&](std::uint32_t begin, std::uint32_t end)
+		{
+			for (auto i = begin; i < end; ++i) results[ i ] = Compile(descs[ i ]);
+		});
+	}
+	else
+	{
+		for (std::uint32_t i = 0u; i < count; ++i) results[ i ] = Compile(descs[ i ]);
+	}
+	return results;
+}
+
+std::uint64_t framework::ShaderCache::ComputeKey(
+	const SHADER_COMPILE_DESC& desc,
+	std::vector<std::filesystem::path>* dependencies) const
+{
+	StateHasher hasher{};
+	hasher.Add(VERSION).Add(m_pCompiler->GetCompilerId());
+	hasher.AddString(desc.Entry).AddString(desc.Target).Add(desc.Flags);
+
+	hasher.Add(static_cast<std::uint64_t>(desc.Defines.size()));
+	for (const auto& define : desc.Defines)
+	{
+		hasher.AddString(define.Name).AddString(define.Value);
+	}
+
+	std::vector<std::filesystem::path> visited{};
+	HashSource(hasher, desc.Path, desc.Path.parent_path(), visited);
+
+	if (dependencies) *dependencies = std::move(visited);
+	return hasher.Get();
+}
+
+void framework::ShaderCache::ClearMemory()
+{
+	std::lock_guard lock(m_mutex);
+
+	//~ pending compiles keep their entry, their owner is still going to fill it
+	std::erase_if(m_entries, [](const auto& entry)
+	{
+		return entry.second.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	});
+}
+
+std::filesystem::path framework::ShaderCache::GetFilePath(std::uint64_t key) const
+{
+	constexpr const char* digits = "0123456789abcdef";
+
+	std::string name(16u, '0');
+	for (auto it = name.rbegin(); it != name.rend(); ++it, key >>= 4u)
+	{
+		*it = digits[ key & 0xfu ];
+	}
+	return m_directory / (name + ".bin");
+}
+
+SHADER_CACHE_STATS framework::ShaderCache::GetStats() const
+{
+	std::lock_guard lock(m_mutex);
+	return m_stats;
+}
+
+bool framework::ShaderCache::Read(std::uint64_t key, std::vector<std::uint8_t>& bytecode)
+{
+	std::ifstream file(GetFilePath(key), std::ios::binary);
+	if (!file) return false;
+
+	SHADER_FILE_HEADER header{};
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+	bool valid = file && header.Magic == MAGIC && header.Version == VERSION && header.Key == key && header.Size > 0u;
+	if (valid)
+	{
+		bytecode.resize(static_cast<std::size_t>(header.Size));
+		file.read(reinterpret_cast<char*>(bytecode.data()), static_cast<std::streamsize>(bytecode.size()));
+
+		valid = file && file.peek() == std::char_traits<char>::eof()
+			&& HashBytes(bytecode.data(), bytecode.size()) == header.Checksum;
+	}
+
+	if (!valid)
+	{
+		bytecode.clear();
+		std::lock_guard lock(m_mutex);
+		++m_stats.BadFiles;
+	}
+	return valid;
+}
+
+bool framework::ShaderCache::Write(std::uint64_t key, const std::vector<std::uint8_t>& bytecode) const
+{
+	std::error_code error{};
+	std::filesystem::create_directories(m_directory, error);
+
+	SHADER_FILE_HEADER header{};
+	header.Key		= key;
+	header.Size		= bytecode.size();
+	header.Checksum = HashBytes(bytecode.data(), bytecode.size());
+
+	//~ one owner per key in this process, a reader never sees half a file
+	const auto path = GetFilePath(key);
+	auto temporary	= path;
+	temporary += ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		if (!file) return false;
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(bytecode.data()), static_cast<std::streamsize>(bytecode.size()));
+		if (!file) return false;
+	}
+
+	std::filesystem::rename(temporary, path, error);
+	return !error;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "utility/thread/job_system.h"
+
+namespace framework
+{
+	typedef struct _SHADER_DEFINE
+	{
+		std::string Name {};
+		std::string Value{ "1" };
+	} SHADER_DEFINE;
+
+	typedef struct _SHADER_COMPILE_DESC
+	{
+		std::filesystem::path	   Path	  {};
+		std::string				   Entry  { "main" };
+		std::string				   Target {};
+		std::vector<SHADER_DEFINE> Defines{};
+		std::uint32_t			   Flags  { 0u }; //~ compiler specific, opaque to the cache
+	} SHADER_COMPILE_DESC;
+
+	enum class EShaderCacheSource : std::uint8_t
+	{
+		Memory = 0, //~ already loaded or compiled this run
+		Disk,
+		Compiled,
+		Failed
+	};
+
+	const char* ToString(EShaderCacheSource source) noexcept;
+
+	typedef struct _SHADER_BYTECODE
+	{
+		std::uint64_t									 Key	 { 0u };
+		std::shared_ptr<const std::vector<std::uint8_t>> Bytecode{ nullptr };
+		std::string										 Errors	 {}; //~ compiler output, warnings included
+		EShaderCacheSource								 Source	 { EShaderCacheSource::Failed };
+
+		bool IsValid() const noexcept { return Bytecode && !Bytecode->empty(); }
+	} SHADER_BYTECODE;
+
+	typedef struct _SHADER_CACHE_STATS
+	{
+		std::uint32_t Requests	 { 0u };
+		std::uint32_t MemoryHits { 0u };
+		std::uint32_t DiskHits	 { 0u };
+		std::uint32_t Compiled	 { 0u };
+		std::uint32_t Failed	 { 0u };
+		std::uint32_t BadFiles	 { 0u }; //~ cache files with a wrong header or checksum, compiled again
+		double		  HashMs	 { 0.0 }; //~ reading sources and includes
+		double		  CompileMs	 { 0.0 }; //~ summed over compiles, workers overlap
+	} SHADER_CACHE_STATS;
+
+	/// <summary>
+	/// Compiler behind the cache. Compile is called from several workers at once.
+	/// </summary>
+	class IShaderCompiler
+	{
+	public:
+		virtual ~IShaderCompiler() = default;
+
+		//~ compiler name and version, part of every key
+		virtual std::uint64_t GetCompilerId() const noexcept = 0;
+
+		virtual bool Compile(const SHADER_COMPILE_DESC& desc,
+							 std::vector<std::uint8_t>& bytecode,
+							 std::string& errors) = 0;
+	};
+
+	/// <summary>
+	/// Content addressed shader bytecode. The key hashes the source, every file it includes
+	/// (resolved the way the standard file include handler does), defines, entry point, target,
+	/// flags and compiler id, so an unchanged shader is never compiled twice. Bytecode lives
+	/// in memory for the run and in one file per key under the cache directory, written to a
+	/// temporary file and renamed. Misses of CompileAll compile in parallel on the job system.
+	/// </summary>
+	class ShaderCache
+	{
+	public:
+		static constexpr std::uint32_t MAGIC   = 0x43535346u; //~ "FSSC"
+		static constexpr std::uint32_t VERSION = 1u;
+
+		ShaderCache(std::unique_ptr<IShaderCompiler> compiler,
+					std::filesystem::path directory,
+					JobSystem* jobs = nullptr);
+		~ShaderCache() = default;
+
+		ShaderCache(const ShaderCache&) = delete;
+		ShaderCache& operator=(const ShaderCache&) = delete;
+
+		SHADER_BYTECODE				 Compile   (const SHADER_COMPILE_DESC& desc);
+		std::vector<SHADER_BYTECODE> CompileAll(const std::vector<SHADER_COMPILE_DESC>& descs);
+
+		//~ dependencies receives the source followed by every include found, missing ones too
+		std::uint64_t ComputeKey(const SHADER_COMPILE_DESC& desc,
+								 std::vector<std::filesystem::path>* dependencies = nullptr) const;
+
+		//~ forgets the bytecode loaded this run, the files stay
+		void ClearMemory();
+
+		//~ Getters
+		std::filesystem::path GetFilePath(std::uint64_t key) const;
+		SHADER_CACHE_STATS	  GetStats	 () const;
+
+	private:
+		bool Read (std::uint64_t key, std::vector<std::uint8_t>& bytecode);
+		bool Write(std::uint64_t key, const std::vector<std::uint8_t>& bytecode) const;
+
+	private:
+		typedef struct _SHADER_FILE_HEADER
+		{
+			std::uint32_t Magic	  { MAGIC };
+			std::uint32_t Version { VERSION };
+			std::uint64_t Key	  { 0u };
+			std::uint64_t Size	  { 0u };
+			std::uint64_t Checksum{ 0u };
+		} SHADER_FILE_HEADER;
+
+		using Bytecode = std::shared_ptr<const std::vector<std::uint8_t>>;
+
+		std::unique_ptr<IShaderCompiler> m_pCompiler{ nullptr };
+		std::filesystem::path			 m_directory{};
+		JobSystem*						 m_pJobs	{ nullptr };
+
+		//~ a pending future is shared by identical requests compiling at the same time
+		std::unordered_map<std::uint64_t, std::shared_future<Bytecode>> m_entries{};
+		SHADER_CACHE_STATS m_stats{};
+
+		mutable std::mutex m_mutex{};
+	};
+} // namespace framework
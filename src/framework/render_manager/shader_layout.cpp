@@ -0,0 +1,148 @@
+#include "shader_layout.h"
+
+#include <cassert>
+
+using namespace framework;
+
+namespace
+{
+	constexpr std::uint32_t nRegisterSize	  = 16u;
+	constexpr std::uint32_t nConstantBufferAlign = 256u;
+
+	constexpr std::uint32_t AlignUp(std::uint32_t value, std::uint32_t alignment) noexcept
+	{
+		return (value + alignment - 1u) & ~(alignment - 1u);
+	}
+
+	std::string FieldName(const SHADER_FIELD& field)
+	{
+		return field.Name ? field.Name : "<unnamed>";
+	}
+} // namespace
+
+std::uint32_t framework::GetShaderFieldSize(EShaderFieldType type) noexcept
+{
+	switch (type)
+	{
+	case EShaderFieldType::Float:
+	case EShaderFieldType::Uint:
+	case EShaderFieldType::Int:		 return 4u;
+	case EShaderFieldType::Float2:
+	case EShaderFieldType::Uint2:
+	case EShaderFieldType::Int2:	 return 8u;
+	case EShaderFieldType::Float3:
+	case EShaderFieldType::Uint3:
+	case EShaderFieldType::Int3:	 return 12u;
+	case EShaderFieldType::Float4:
+	case EShaderFieldType::Uint4:
+	case EShaderFieldType::Int4:	 return 16u;
+	case EShaderFieldType::Float4x4: return 64u;
+	default:
+		assert(false && "Unknown shader field type!");
+		return 0u;
+	}
+}
+
+std::uint32_t framework::PackShaderField(
+	std::uint32_t offset,
+	EShaderFieldType type,
+	std::uint32_t arrayCount,
+	EShaderBufferLayout layout) noexcept
+{
+	if (layout != EShaderBufferLayout::ConstantBuffer) return offset;
+
+	//~ arrays and matrices start on a register, anything else only when it would straddle one
+	const std::uint32_t size	  = GetShaderFieldSize(type);
+	const bool			aggregate = arrayCount > 1u || type == EShaderFieldType::Float4x4;
+	if (aggregate || offset / nRegisterSize != (offset + size - 1u) / nRegisterSize)
+	{
+		return AlignUp(offset, nRegisterSize);
+	}
+	return offset;
+}
+
+std::uint32_t framework::GetShaderFieldExtent(
+	EShaderFieldType type,
+	std::uint32_t arrayCount,
+	EShaderBufferLayout layout) noexcept
+{
+	const std::uint32_t size  = GetShaderFieldSize(type);
+	const std::uint32_t count = arrayCount ? arrayCount : 1u;
+
+	//~ array elements after the first start on a new register in a cbuffer, structured buffers are tight
+	const std::uint32_t elementStride = layout == EShaderBufferLayout::ConstantBuffer && count > 1u
+		? AlignUp(size, nRegisterSize)
+		: size;
+	return elementStride * (count - 1u) + size;
+}
+
+SHADER_LAYOUT_REPORT framework::ValidateShaderLayout(
+	const char* name,
+	EShaderBufferLayout layout,
+	const std::vector<SHADER_FIELD>& fields,
+	std::uint32_t hostSize)
+{
+	SHADER_LAYOUT_REPORT report{};
+	report.Name		= name ? name : "<unnamed>";
+	report.HostSize = hostSize;
+
+	const bool cbuffer = layout == EShaderBufferLayout::ConstantBuffer;
+
+	std::uint32_t offset	= 0u;
+	std::uint32_t usedBytes = 0u;
+	for (const auto& field : fields)
+	{
+		const std::uint32_t size  = GetShaderFieldSize(field.Type);
+		const std::uint32_t count = field.ArrayCount ? field.ArrayCount : 1u;
+
+		offset = PackShaderField(offset, field.Type, count, layout);
+
+		if (field.HostOffset != offset)
+		{
+			report.Errors.push_back(FieldName(field) + " is at " + std::to_string(field.HostOffset)
+									+ " on the host, the shader reads it at " + std::to_string(offset));
+		}
+
+		offset	  += GetShaderFieldExtent(field.Type, count, layout);
+		usedBytes += size * count;
+	}
+	report.ShaderSize = offset;
+
+	if (hostSize % 4u != 0u)
+	{
+		report.Errors.push_back("host size " + std::to_string(hostSize) + " is not a multiple of 4");
+	}
+
+	if (cbuffer)
+	{
+		//~ the host struct may run past the last register, never short of it
+		if (hostSize < offset)
+		{
+			report.Errors.push_back("host size " + std::to_string(hostSize) + " is smaller than the "
+									+ std::to_string(offset) + " bytes the shader reads");
+		}
+		report.Stride = AlignUp(hostSize > offset ? hostSize : offset, nConstantBufferAlign);
+	}
+	else
+	{
+		//~ the element stride comes from the host, any difference shifts every element after the first
+		if (hostSize != offset)
+		{
+			report.Errors.push_back("host stride " + std::to_string(hostSize) + " differs from the "
+									+ std::to_string(offset) + " byte shader struct");
+		}
+		report.Stride = hostSize;
+		if (hostSize % nRegisterSize != 0u)
+		{
+			report.Warnings.push_back("stride " + std::to_string(hostSize) + " is not a multiple of 16, elements straddle cache lines");
+		}
+	}
+
+	report.PaddingBytes = report.Stride > usedBytes ? report.Stride - usedBytes : 0u;
+	if (cbuffer && report.PaddingBytes * 2u > report.Stride)
+	{
+		report.Warnings.push_back("more than half of every " + std::to_string(report.Stride)
+								  + " byte constant buffer element is padding");
+	}
+	return report;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace framework
+{
+	enum class EShaderFieldType : std::uint8_t
+	{
+		Float = 0,
+		Float2,
+		Float3,
+		Float4,
+		Uint,
+		Uint2,
+		Uint3,
+		Uint4,
+		Int,
+		Int2,
+		Int3,
+		Int4,
+		Float4x4, //~ row or column major, 64 bytes either way
+		Count
+	};
+
+	enum class EShaderBufferLayout : std::uint8_t
+	{
+		ConstantBuffer = 0, //~ 16 byte registers: no field straddles one, matrices and array elements start on one
+		StructuredBuffer	//~ tightly packed, 4 byte aligned, sizeof the host struct is the stride
+	};
+
+	//~ one HLSL member and where the host struct keeps it, in declaration order
+	typedef struct _SHADER_FIELD
+	{
+		const char*		 Name	   { nullptr };
+		EShaderFieldType Type	   { EShaderFieldType::Float };
+		std::uint32_t	 HostOffset{ 0u }; //~ offsetof in the C++ struct
+		std::uint32_t	 ArrayCount{ 1u };
+	} SHADER_FIELD;
+
+	typedef struct _SHADER_LAYOUT_REPORT
+	{
+		std::string	  Name		  {};
+		std::uint32_t ShaderSize  { 0u }; //~ end of the last field as HLSL packs it
+		std::uint32_t HostSize	  { 0u }; //~ sizeof the C++ struct
+		std::uint32_t Stride	  { 0u }; //~ bytes per element in the buffer, 256 aligned for CBVs
+		std::uint32_t PaddingBytes{ 0u }; //~ bytes of Stride no field uses
+		std::vector<std::string> Errors	 {}; //~ the host struct does not match what the shader reads
+		std::vector<std::string> Warnings{}; //~ matches, but wastes memory or bandwidth
+
+		bool IsValid() const noexcept { return Errors.empty(); }
+	} SHADER_LAYOUT_REPORT;
+
+	std::uint32_t GetShaderFieldSize(EShaderFieldType type) noexcept;
+
+	//~ offset HLSL gives a field declared right after offset (the end of the previous one)
+	std::uint32_t PackShaderField(std::uint32_t offset,
+								  EShaderFieldType type,
+								  std::uint32_t arrayCount,
+								  EShaderBufferLayout layout) noexcept;
+
+	//~ bytes from the first element of a field to the end of its last one
+	std::uint32_t GetShaderFieldExtent(EShaderFieldType type,
+									   std::uint32_t arrayCount,
+									   EShaderBufferLayout layout) noexcept;
+
+	//~ packs fields by the HLSL rules of layout and compares every offset and the element size
+	//~ with the host struct. Platform independent, needs no compiler or device.
+	SHADER_LAYOUT_REPORT ValidateShaderLayout(const char* name,
+											  EShaderBufferLayout layout,
+											  const std::vector<SHADER_FIELD>& fields,
+											  std::uint32_t hostSize);
+} // namespace framework
+
+//~ SHADER_FIELD_OF(PassConstants, gViewProj, Float4x4)
+#define SHADER_FIELD_OF(Struct, Member, Type) \
+	framework::SHADER_FIELD{ #Member, framework::EShaderFieldType::Type, static_cast<std::uint32_t>(offsetof(Struct, Member)), 1u }
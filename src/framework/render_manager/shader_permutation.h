@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "shader_cache.h"
+
+namespace framework
+{
+	/// <summary>
+	/// Compile time set of feature bits of one shader, TFeature is an enum of single bits.
+	/// Two permutations with the same bits are the same shader variant.
+	/// </summary>
+	template<typename TFeature>
+		requires std::is_enum_v<TFeature>
+	class ShaderPermutation
+	{
+	public:
+		using Bits = std::underlying_type_t<TFeature>;
+
+		constexpr ShaderPermutation() = default;
+		constexpr explicit ShaderPermutation(Bits bits) noexcept : m_bits(bits) {}
+
+		template<typename... TFeatures>
+		static constexpr ShaderPermutation Of(TFeatures... features) noexcept
+		{
+			return ShaderPermutation{ static_cast<Bits>((Bits{ 0 } | ... | static_cast<Bits>(features))) };
+		}
+
+		constexpr ShaderPermutation With(TFeature feature, bool enabled = true) const noexcept
+		{
+			const auto bit = static_cast<Bits>(feature);
+			return ShaderPermutation{ static_cast<Bits>(enabled ? (m_bits | bit) : (m_bits & ~bit)) };
+		}
+
+		constexpr bool Has(TFeature feature) const noexcept
+		{
+			return (m_bits & static_cast<Bits>(feature)) != Bits{ 0 };
+		}
+
+		constexpr Bits GetBits() const noexcept { return m_bits; }
+
+		constexpr bool operator==(const ShaderPermutation&) const noexcept = default;
+
+	private:
+		Bits m_bits{ 0 };
+	};
+
+	/// <summary>
+	/// Names the preprocessor define of every feature. Every feature is defined in every
+	/// permutation (0 or 1), so shaders test them with #if and a missing one is a compile error.
+	/// </summary>
+	template<typename TFeature, std::size_t N>
+		requires std::is_enum_v<TFeature>
+	class ShaderFeatureSet
+	{
+	public:
+		using Permutation = ShaderPermutation<TFeature>;
+		using Bits		  = typename Permutation::Bits;
+
+		constexpr explicit ShaderFeatureSet(const std::array<std::pair<TFeature, const char*>, N>& features)
+			: m_features(features)
+		{}
+
+		//~ one bit per feature, no bit twice, every define named: checked with static_assert
+		constexpr bool IsValid() const noexcept
+		{
+			Bits seen{ 0 };
+			for (const auto& [feature, define] : m_features)
+			{
+				const auto bit = static_cast<Bits>(feature);
+				if (bit == Bits{ 0 } || (bit & (bit - 1)) != Bits{ 0 } || (seen & bit) != Bits{ 0 }) return false;
+				if (!define || !*define) return false;
+				seen |= bit;
+			}
+			return true;
+		}
+
+		constexpr Bits GetMask() const noexcept
+		{
+			Bits mask{ 0 };
+			for (const auto& [feature, define] : m_features) mask |= static_cast<Bits>(feature);
+			return mask;
+		}
+
+		std::vector<SHADER_DEFINE> ToDefines(Permutation permutation) const
+		{
+			std::vector<SHADER_DEFINE> defines{};
+			defines.reserve(N);
+			for (const auto& [feature, define] : m_features)
+			{
+				defines.push_back({ define, permutation.Has(feature) ? "1" : "0" });
+			}
+			return defines;
+		}
+
+		//~ "OBJECT_BUFFER|INSTANCED", "base" when no feature is on
+		std::string ToString(Permutation permutation) const
+		{
+			std::string name{};
+			for (const auto& [feature, define] : m_features)
+			{
+				if (!permutation.Has(feature)) continue;
+				if (!name.empty()) name += '|';
+				name += define;
+			}
+			return name.empty() ? "base" : name;
+		}
+
+	private:
+		std::array<std::pair<TFeature, const char*>, N> m_features{};
+	};
+} // namespace framework
@@ -0,0 +1,736 @@
+#include "shader_reflection.h"
+#include "state_hash.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+
+using namespace framework;
+
+namespace
+{
+	using Macros = std::unordered_map<std::string, std::string>;
+
+	constexpr std::uint32_t nRegisterSize = 16u;
+
+	constexpr std::uint32_t AlignUp(std::uint32_t value, std::uint32_t alignment) noexcept
+	{
+		return (value + alignment - 1u) & ~(alignment - 1u);
+	}
+
+	bool IsIdentifierStart(char c) noexcept { return std::isalpha(static_cast<unsigned char>(c)) || c == '_'; }
+	bool IsIdentifierChar (char c) noexcept { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; }
+
+	std::string_view Trim(std::string_view text) noexcept
+	{
+		const auto first = text.find_first_not_of(" \t\r");
+		if (first == std::string_view::npos) return {};
+		const auto last = text.find_last_not_of(" \t\r");
+		return text.substr(first, last - first + 1u);
+	}
+
+	//~ comments become spaces, newlines stay so line based directives still work
+	std::string StripComments(std::string_view source)
+	{
+		std::string out{};
+		out.reserve(source.size());
+
+		for (std::size_t i = 0u; i < source.size(); ++i)
+		{
+			if (source[ i ] == '/' && i + 1u < source.size() && source[ i + 1u ] == '/')
+			{
+				while (i < source.size() && source[ i ] != '\n') ++i;
+				if (i < source.size()) out += '\n';
+			}
+			else if (source[ i ] == '/' && i + 1u < source.size() && source[ i + 1u ] == '*')
+			{
+				for (i += 2u; i < source.size() && !(source[ i ] == '*' && i + 1u < source.size() && source[ i + 1u ] == '/'); ++i)
+				{
+					if (source[ i ] == '\n') out += '\n';
+				}
+				++i;
+				out += ' ';
+			}
+			else
+			{
+				out += source[ i ];
+			}
+		}
+		return out;
+	}
+
+	std::vector<std::string> Tokenize(std::string_view text)
+	{
+		std::vector<std::string> tokens{};
+		for (std::size_t i = 0u; i < text.size();)
+		{
+			const char c = text[ i ];
+			if (std::isspace(static_cast<unsigned char>(c)))
+			{
+				++i;
+			}
+			else if (IsIdentifierStart(c) || std::isdigit(static_cast<unsigned char>(c)))
+			{
+				const auto start = i;
+				while (i < text.size() && IsIdentifierChar(text[ i ])) ++i;
+				tokens.emplace_back(text.substr(start, i - start));
+			}
+			else
+			{
+				//~ two character operators of #if expressions
+				static constexpr std::string_view pairs[]{ "&&", "||", "==", "!=", "<=", ">=" };
+				const auto two = text.substr(i, 2u);
+				const bool pair = std::find(std::begin(pairs), std::end(pairs), two) != std::end(pairs);
+				tokens.emplace_back(text.substr(i, pair ? 2u : 1u));
+				i += pair ? 2u : 1u;
+			}
+		}
+		return tokens;
+	}
+
+	bool ParseInteger(std::string_view token, long long& value) noexcept
+	{
+		while (!token.empty() && (token.back() == 'u' || token.back() == 'U' || token.back() == 'l' || token.back() == 'L'))
+		{
+			token.remove_suffix(1u);
+		}
+		if (token.empty() || !std::isdigit(static_cast<unsigned char>(token.front()))) return false;
+
+		try
+		{
+			std::size_t used = 0u;
+			value = std::stoll(std::string(token), &used, 0);
+			return used == token.size();
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+
+	/// <summary>
+	/// #if expressions: integers, defined(), identifiers (value of the macro, 0 when undefined),
+	/// ! - ( ) && || == != < > <= >=.
+	/// </summary>
+	class ExpressionParser
+	{
+	public:
+		ExpressionParser(std::string_view text, const Macros& macros, std::uint32_t depth = 0u)
+			: m_tokens(Tokenize(text)), m_macros(macros), m_nDepth(depth)
+		{}
+
+		bool Evaluate(long long& value)
+		{
+			value = Or();
+			return m_bOk && m_nNext == m_tokens.size();
+		}
+
+	private:
+		const std::string& Peek() const
+		{
+			static const std::string end{};
+			return m_nNext < m_tokens.size() ? m_tokens[ m_nNext ] : end;
+		}
+
+		bool Accept(std::string_view token)
+		{
+			if (Peek() != token) return false;
+			++m_nNext;
+			return true;
+		}
+
+		long long Or()
+		{
+			long long value = And();
+			while (Accept("||")) value = (And() != 0) || value != 0;
+			return value;
+		}
+
+		long long And()
+		{
+			long long value = Compare();
+			while (Accept("&&")) value = (Compare() != 0) && value != 0;
+			return value;
+		}
+
+		long long Compare()
+		{
+			long long value = Unary();
+			for (;;)
+			{
+				if		(Accept("==")) value = value == Unary();
+				else if (Accept("!=")) value = value != Unary();
+				else if (Accept("<=")) value = value <= Unary();
+				else if (Accept(">=")) value = value >= Unary();
+				else if (Accept("<"))  value = value <	Unary();
+				else if (Accept(">"))  value = value >	Unary();
+				else return value;
+			}
+		}
+
+		long long Unary()
+		{
+			if (Accept("!")) return Unary() == 0;
+			if (Accept("-")) return -Unary();
+			return Primary();
+		}
+
+		long long Primary()
+		{
+			if (Accept("("))
+			{
+				const long long value = Or();
+				if (!Accept(")")) m_bOk = false;
+				return value;
+			}
+			if (Accept("defined"))
+			{
+				const bool paren = Accept("(");
+				const bool found = m_macros.contains(Peek());
+				++m_nNext;
+				if (paren && !Accept(")")) m_bOk = false;
+				return found;
+			}
+
+			const auto token = Peek();
+			if (token.empty())
+			{
+				m_bOk = false;
+				return 0;
+			}
+			++m_nNext;
+
+			long long value = 0;
+			if (ParseInteger(token, value)) return value;
+			if (!IsIdentifierStart(token.front()))
+			{
+				m_bOk = false;
+				return 0;
+			}
+
+			//~ object like macros expand to their value, undefined identifiers are 0
+			const auto it = m_macros.find(token);
+			if (it == m_macros.end() || Trim(it->second).empty() || m_nDepth > 8u) return 0;
+
+			ExpressionParser nested(it->second, m_macros, m_nDepth + 1u);
+			if (!nested.Evaluate(value)) m_bOk = false;
+			return value;
+		}
+
+	private:
+		std::vector<std::string> m_tokens{};
+		const Macros&			 m_macros;
+		std::uint32_t			 m_nDepth{ 0u };
+		std::size_t				 m_nNext { 0u };
+		bool					 m_bOk	 { true };
+	};
+
+	//~ active lines of the source, directive lines and inactive branches are left empty
+	std::string Preprocess(std::string_view source, Macros& macros, std::vector<std::string>& errors)
+	{
+		typedef struct _BRANCH
+		{
+			bool ParentActive{ true };
+			bool Taken		 { false }; //~ an earlier branch of this #if was active
+			bool Active		 { true };
+		} BRANCH;
+
+		const auto evaluate = [&](std::string_view expression)
+		{
+			long long value = 0;
+			if (!ExpressionParser(expression, macros).Evaluate(value))
+			{
+				errors.push_back("cannot evaluate #if " + std::string(expression));
+			}
+			return value != 0;
+		};
+
+		std::vector<BRANCH> branches{};
+		const auto active = [&branches]() { return branches.empty() || branches.back().Active; };
+
+		std::string out{};
+		out.reserve(source.size());
+
+		std::size_t lineStart = 0u;
+		while (lineStart < source.size())
+		{
+			auto lineEnd = source.find('\n', lineStart);
+			if (lineEnd == std::string_view::npos) lineEnd = source.size();
+			const auto line = source.substr(lineStart, lineEnd - lineStart);
+			lineStart = lineEnd + 1u;
+
+			const auto trimmed = Trim(line);
+			if (trimmed.empty() || trimmed.front() != '#')
+			{
+				if (active()) out += line;
+				out += '\n';
+				continue;
+			}
+			out += '\n';
+
+			auto directive = Trim(trimmed.substr(1u));
+			std::size_t nameEnd = 0u;
+			while (nameEnd < directive.size() && IsIdentifierChar(directive[ nameEnd ])) ++nameEnd;
+			const auto name = directive.substr(0u, nameEnd);
+			const auto rest = Trim(directive.substr(nameEnd));
+
+			if (name == "if" || name == "ifdef" || name == "ifndef")
+			{
+				BRANCH branch{};
+				branch.ParentActive = active();
+
+				bool condition = false;
+				if		(name == "ifdef")  condition = macros.contains(std::string(rest));
+				else if (name == "ifndef") condition = !macros.contains(std::string(rest));
+				else if (branch.ParentActive) condition = evaluate(rest);
+
+				branch.Active = branch.ParentActive && condition;
+				branch.Taken  = branch.Active;
+				branches.push_back(branch);
+			}
+			else if (name == "elif" || name == "else" || name == "endif")
+			{
+				if (branches.empty())
+				{
+					errors.push_back("#" + std::string(name) + " without #if");
+					continue;
+				}
+
+				auto& branch = branches.back();
+				if (name == "endif")
+				{
+					branches.pop_back();
+				}
+				else if (branch.ParentActive && !branch.Taken && (name == "else" || evaluate(rest)))
+				{
+					branch.Active = true;
+					branch.Taken  = true;
+				}
+				else
+				{
+					branch.Active = false;
+				}
+			}
+			else if (name == "define" && active())
+			{
+				std::size_t macroEnd = 0u;
+				while (macroEnd < rest.size() && IsIdentifierChar(rest[ macroEnd ])) ++macroEnd;
+				macros[ std::string(rest.substr(0u, macroEnd)) ] = std::string(Trim(rest.substr(macroEnd)));
+			}
+			else if (name == "undef" && active())
+			{
+				macros.erase(std::string(rest));
+			}
+			//~ include, pragma, line, error: nothing that changes a layout
+		}
+
+		if (!branches.empty()) errors.push_back("#if without #endif");
+		return out;
+	}
+
+	//~ quoted includes inlined relative to the including file, each file once
+	bool ReadWithIncludes(const std::filesystem::path& file,
+						  std::string& out,
+						  std::vector<std::filesystem::path>& visited,
+						  std::vector<std::string>& errors)
+	{
+		const auto path = file.lexically_normal();
+		if (std::find(visited.begin(), visited.end(), path) != visited.end()) return true;
+		visited.push_back(path);
+
+		std::ifstream stream(path, std::ios::binary);
+		if (!stream)
+		{
+			errors.push_back("cannot read " + path.generic_string());
+			return false;
+		}
+		const std::string text{ std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+
+		std::size_t lineStart = 0u;
+		while (lineStart < text.size())
+		{
+			auto lineEnd = text.find('\n', lineStart);
+			if (lineEnd == std::string::npos) lineEnd = text.size();
+			const std::string_view line(text.data() + lineStart, lineEnd - lineStart);
+			lineStart = lineEnd + 1u;
+
+			const auto trimmed = Trim(line);
+			const auto quote   = trimmed.find('"');
+			if (trimmed.starts_with("#") && trimmed.find("include") != std::string_view::npos && quote != std::string_view::npos)
+			{
+				const auto close = trimmed.find('"', quote + 1u);
+				if (close != std::string_view::npos)
+				{
+					const auto include = trimmed.substr(quote + 1u, close - quote - 1u);
+					ReadWithIncludes(path.parent_path() / include, out, visited, errors);
+					out += '\n';
+					continue;
+				}
+			}
+			out += line;
+			out += '\n';
+		}
+		return true;
+	}
+
+	bool ParseFieldType(std::string_view name, EShaderFieldType& type) noexcept
+	{
+		typedef struct _TYPE_NAME
+		{
+			std::string_view Name;
+			EShaderFieldType Type;
+		} TYPE_NAME;
+
+		static constexpr TYPE_NAME types[]
+		{
+			{ "float",	  EShaderFieldType::Float	 }, { "float1", EShaderFieldType::Float },
+			{ "float2",	  EShaderFieldType::Float2	 }, { "float3", EShaderFieldType::Float3 },
+			{ "float4",	  EShaderFieldType::Float4	 },
+			{ "uint",	  EShaderFieldType::Uint	 }, { "uint1",	EShaderFieldType::Uint },
+			{ "dword",	  EShaderFieldType::Uint	 }, { "bool",	EShaderFieldType::Uint }, //~ 4 bytes in a cbuffer
+			{ "uint2",	  EShaderFieldType::Uint2	 }, { "uint3",	EShaderFieldType::Uint3 },
+			{ "uint4",	  EShaderFieldType::Uint4	 },
+			{ "int",	  EShaderFieldType::Int		 }, { "int1",	EShaderFieldType::Int },
+			{ "int2",	  EShaderFieldType::Int2	 }, { "int3",	EShaderFieldType::Int3 },
+			{ "int4",	  EShaderFieldType::Int4	 },
+			{ "float4x4", EShaderFieldType::Float4x4 }, { "matrix", EShaderFieldType::Float4x4 },
+		};
+
+		for (const auto& entry : types)
+		{
+			if (entry.Name != name) continue;
+			type = entry.Type;
+			return true;
+		}
+		return false;
+	}
+
+	bool IsQualifier(std::string_view token) noexcept
+	{
+		return token == "row_major" || token == "column_major" || token == "precise"
+			|| token == "uniform"	|| token == "const";
+	}
+
+	void PackConstantBuffer(SHADER_CBUFFER& buffer)
+	{
+		std::uint32_t offset = 0u;
+		std::uint32_t used	 = 0u;
+		for (auto& field : buffer.Fields)
+		{
+			field.Offset = PackShaderField(offset, field.Type, field.ArrayCount, EShaderBufferLayout::ConstantBuffer);
+			offset		 = field.Offset + GetShaderFieldExtent(field.Type, field.ArrayCount, EShaderBufferLayout::ConstantBuffer);
+			used		+= GetShaderFieldSize(field.Type) * field.ArrayCount;
+		}
+		buffer.Size			= offset;
+		buffer.PaddingBytes = AlignUp(offset, nRegisterSize) - used;
+	}
+
+	//~ cbuffer Name [: register(bN)] { [qualifiers] type name[[N]]; ... }
+	void ParseConstantBuffers(const std::vector<std::string>& tokens, const Macros& macros, SHADER_REFLECTION& reflection)
+	{
+		for (std::size_t i = 0u; i < tokens.size(); ++i)
+		{
+			if (tokens[ i ] != "cbuffer" || i + 1u >= tokens.size()) continue;
+
+			SHADER_CBUFFER buffer{};
+			buffer.Name = tokens[ ++i ];
+			++i;
+
+			if (i + 4u < tokens.size() && tokens[ i ] == ":" && tokens[ i + 1u ] == "register" && tokens[ i + 2u ] == "(")
+			{
+				const auto& slot = tokens[ i + 3u ];
+				long long index = 0;
+				if (slot.size() > 1u && (slot.front() == 'b' || slot.front() == 'B') && ParseInteger(slot.substr(1u), index))
+				{
+					buffer.Register = static_cast<std::uint32_t>(index);
+				}
+				while (i < tokens.size() && tokens[ i ] != ")") ++i;
+				++i;
+			}
+			if (i >= tokens.size() || tokens[ i ] != "{")
+			{
+				reflection.Errors.push_back(buffer.Name + ": expected {");
+				continue;
+			}
+			++i;
+
+			while (i < tokens.size() && tokens[ i ] != "}")
+			{
+				std::vector<std::string> member{};
+				while (i < tokens.size() && tokens[ i ] != ";" && tokens[ i ] != "}") member.push_back(tokens[ i++ ]);
+				if (i < tokens.size() && tokens[ i ] == ";") ++i;
+				if (member.empty()) continue;
+
+				std::size_t m = 0u;
+				while (m < member.size() && IsQualifier(member[ m ])) ++m;
+				if (m + 1u >= member.size())
+				{
+					reflection.Errors.push_back(buffer.Name + ": cannot read member " + member.front());
+					continue;
+				}
+
+				SHADER_CBUFFER_FIELD field{};
+				field.Name = member[ m + 1u ];
+				if (!ParseFieldType(member[ m ], field.Type))
+				{
+					reflection.Errors.push_back(buffer.Name + "." + field.Name + ": type " + member[ m ] + " is not supported");
+					continue;
+				}
+
+				for (std::size_t t = m + 2u; t < member.size(); ++t)
+				{
+					if (member[ t ] == "[" && t + 2u < member.size() && member[ t + 2u ] == "]")
+					{
+						long long count = 0;
+						ExpressionParser size(member[ t + 1u ], macros);
+						if (!size.Evaluate(count) || count <= 0)
+						{
+							reflection.Errors.push_back(buffer.Name + "." + field.Name + ": bad array size " + member[ t + 1u ]);
+						}
+						field.ArrayCount = count > 0 ? static_cast<std::uint32_t>(count) : 1u;
+						t += 2u;
+					}
+					else if (member[ t ] == ":" && t + 1u < member.size() && member[ t + 1u ] == "packoffset")
+					{
+						reflection.Errors.push_back(buffer.Name + "." + field.Name + ": packoffset is not supported");
+						break;
+					}
+				}
+				buffer.Fields.push_back(std::move(field));
+			}
+
+			PackConstantBuffer(buffer);
+			reflection.ConstantBuffers.push_back(std::move(buffer));
+		}
+	}
+
+	std::string FormatDefines(const std::vector<SHADER_DEFINE>& defines)
+	{
+		std::string text{};
+		for (const auto& define : defines) text += define.Name + "=" + define.Value + ";";
+		return text;
+	}
+
+	std::vector<SHADER_DEFINE> ParseDefines(std::string_view text)
+	{
+		std::vector<SHADER_DEFINE> defines{};
+		while (!text.empty())
+		{
+			const auto end	 = std::min(text.find(';'), text.size());
+			const auto entry = text.substr(0u, end);
+			const auto equal = entry.find('=');
+			if (!entry.empty())
+			{
+				defines.push_back({ std::string(entry.substr(0u, equal)),
+									equal == std::string_view::npos ? "1" : std::string(entry.substr(equal + 1u)) });
+			}
+			text.remove_prefix(std::min(end + 1u, text.size()));
+		}
+		return defines;
+	}
+
+	constexpr const char* IDENTITY{ "{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f }" };
+
+	//~ the host side type of one element, arrays of small types use full registers
+	const char* CppType(EShaderFieldType type, bool registerElement) noexcept
+	{
+		switch (type)
+		{
+		case EShaderFieldType::Float:	 return registerElement ? "DirectX::XMFLOAT4" : "float";
+		case EShaderFieldType::Float2:	 return registerElement ? "DirectX::XMFLOAT4" : "DirectX::XMFLOAT2";
+		case EShaderFieldType::Float3:	 return registerElement ? "DirectX::XMFLOAT4" : "DirectX::XMFLOAT3";
+		case EShaderFieldType::Float4:	 return "DirectX::XMFLOAT4";
+		case EShaderFieldType::Uint:	 return registerElement ? "DirectX::XMUINT4" : "std::uint32_t";
+		case EShaderFieldType::Uint2:	 return registerElement ? "DirectX::XMUINT4" : "DirectX::XMUINT2";
+		case EShaderFieldType::Uint3:	 return registerElement ? "DirectX::XMUINT4" : "DirectX::XMUINT3";
+		case EShaderFieldType::Uint4:	 return "DirectX::XMUINT4";
+		case EShaderFieldType::Int:		 return registerElement ? "DirectX::XMINT4" : "std::int32_t";
+		case EShaderFieldType::Int2:	 return registerElement ? "DirectX::XMINT4" : "DirectX::XMINT2";
+		case EShaderFieldType::Int3:	 return registerElement ? "DirectX::XMINT4" : "DirectX::XMINT3";
+		case EShaderFieldType::Int4:	 return "DirectX::XMINT4";
+		case EShaderFieldType::Float4x4: return "DirectX::XMFLOAT4X4";
+		default:						 return "float";
+		}
+	}
+} // namespace
+
+const SHADER_CBUFFER_FIELD* framework::SHADER_CBUFFER::Find(std::string_view name) const noexcept
+{
+	const auto it = std::find_if(Fields.begin(), Fields.end(), [name](const auto& field) { return field.Name == name; });
+	return it == Fields.end() ? nullptr : &*it;
+}
+
+const SHADER_CBUFFER* framework::SHADER_REFLECTION::Find(std::string_view name) const noexcept
+{
+	const auto it = std::find_if(ConstantBuffers.begin(), ConstantBuffers.end(),
+		[name](const auto& buffer) { return buffer.Name == name; });
+	return it == ConstantBuffers.end() ? nullptr : &*it;
+}
+
+SHADER_REFLECTION framework::ReflectShaderSource(std::string_view source, const std::vector<SHADER_DEFINE>& defines)
+{
+	SHADER_REFLECTION reflection{};
+
+	Macros macros{};
+	for (const auto& define : defines) macros[ define.Name ] = define.Value;
+
+	const auto stripped = StripComments(source);
+	const auto active	= Preprocess(stripped, macros, reflection.Errors);
+	ParseConstantBuffers(Tokenize(active), macros, reflection);
+	return reflection;
+}
+
+SHADER_REFLECTION framework::ReflectShaderFile(const std::filesystem::path& file, const std::vector<SHADER_DEFINE>& defines)
+{
+	std::string source{};
+	std::vector<std::filesystem::path> visited{};
+	std::vector<std::string> errors{};
+	if (!ReadWithIncludes(file, source, visited, errors) && visited.size() == 1u)
+	{
+		SHADER_REFLECTION reflection{};
+		reflection.Errors = std::move(errors);
+		return reflection;
+	}
+
+	auto reflection = ReflectShaderSource(source, defines);
+	reflection.Errors.insert(reflection.Errors.begin(), errors.begin(), errors.end());
+	return reflection;
+}
+
+std::uint64_t framework::GetLayoutFingerprint(const SHADER_CBUFFER& buffer) noexcept
+{
+	StateHasher hasher{};
+	hasher.Add(static_cast<std::uint64_t>(buffer.Fields.size()));
+	for (const auto& field : buffer.Fields)
+	{
+		hasher.AddString(field.Name);
+		hasher.Add(static_cast<std::uint8_t>(field.Type)).Add(field.ArrayCount).Add(field.Offset);
+	}
+	return hasher.Add(buffer.Size).Get();
+}
+
+std::string framework::GenerateLayoutStruct(
+	const SHADER_CBUFFER& buffer,
+	const SHADER_LAYOUT_JOB& job,
+	std::vector<std::string>& errors)
+{
+	const auto& name = job.StructName;
+	std::ostringstream members{};
+	std::ostringstream asserts{};
+
+	std::uint32_t cursor  = 0u;
+	std::uint32_t padding = 0u;
+	const auto pad = [&](std::uint32_t bytes)
+	{
+		members << "\tfloat _pad" << padding++ << "[ " << bytes / 4u << " ]{};\n";
+	};
+
+	for (const auto& field : buffer.Fields)
+	{
+		const std::uint32_t size		  = GetShaderFieldSize(field.Type);
+		const bool			registerArray = field.ArrayCount > 1u && size < nRegisterSize;
+		const std::uint32_t hostExtent	  = registerArray
+			? nRegisterSize * field.ArrayCount
+			: GetShaderFieldExtent(field.Type, field.ArrayCount, EShaderBufferLayout::ConstantBuffer);
+
+		if (field.Offset < cursor)
+		{
+			errors.push_back(buffer.Name + "." + field.Name + " packs into the last register of the array before it, "
+							 "give that array a 16 byte element type");
+			return {};
+		}
+		if (field.Offset > cursor) pad(field.Offset - cursor);
+
+		members << "\t" << CppType(field.Type, registerArray) << " " << field.Name;
+		if (field.ArrayCount > 1u) members << "[ " << field.ArrayCount << " ]";
+		//~ matrices start as identity like the hand written constants did
+		members << (field.Type == EShaderFieldType::Float4x4 && field.ArrayCount == 1u ? IDENTITY : "{}") << ";\n";
+
+		asserts << "static_assert(offsetof(" << name << ", " << field.Name << ") == " << field.Offset
+				<< "u, \"" << buffer.Name << "." << field.Name << " moved, regenerate the shader layouts\");\n";
+		cursor = field.Offset + hostExtent;
+	}
+
+	const std::uint32_t size = AlignUp(std::max(cursor, 1u), nRegisterSize);
+	if (size > cursor) pad(size - cursor);
+
+	std::ostringstream out{};
+	out << "//~ cbuffer " << buffer.Name;
+	if (buffer.Register != ~0u) out << " : register(b" << buffer.Register << ")";
+	out << " of " << job.Source.generic_string();
+	if (!job.Defines.empty())
+	{
+		auto defines = FormatDefines(job.Defines);
+		defines.pop_back();
+		out << " with " << defines;
+	}
+	out << ", " << buffer.Size << " bytes, " << buffer.PaddingBytes << " of them padding\n";
+
+	out << "struct alignas(16) " << name << "\n{\n" << members.str() << "};\n";
+	out << asserts.str();
+	out << "static_assert(sizeof(" << name << ") == " << size << "u, \"" << buffer.Name
+		<< " changed size, regenerate the shader layouts\");\n\n";
+
+	out << "inline constexpr framework::SHADER_GENERATED_LAYOUT " << name << "Layout\n{\n"
+		<< "\t\"" << job.Source.generic_string() << "\", \"" << buffer.Name << "\", \"" << FormatDefines(job.Defines) << "\",\n"
+		<< "\t" << buffer.Size << "u, 0x" << std::hex << GetLayoutFingerprint(buffer) << std::dec << "ull\n};\n";
+	return out.str();
+}
+
+std::string framework::GenerateLayoutHeader(
+	const std::vector<SHADER_LAYOUT_JOB>& jobs,
+	std::string_view generator,
+	std::vector<std::string>& errors)
+{
+	std::ostringstream out{};
+	out << "#pragma once\n\n"
+		<< "//~ generated by " << generator << " from the cbuffers of the shaders, do not edit.\n"
+		<< "//~ run it again after changing one, the layers check these against the sources at startup\n\n"
+		<< "#include <DirectXMath.h>\n\n"
+		<< "#include <cstddef>\n"
+		<< "#include <cstdint>\n\n"
+		<< "#include \"framework/render_manager/shader_reflection.h\"\n";
+
+	for (const auto& job : jobs)
+	{
+		const auto reflection = ReflectShaderFile(job.Source, job.Defines);
+		for (const auto& error : reflection.Errors) errors.push_back(job.Source.generic_string() + ": " + error);
+
+		const auto* buffer = reflection.Find(job.ConstantBuffer);
+		if (!buffer)
+		{
+			errors.push_back(job.Source.generic_string() + ": no cbuffer " + job.ConstantBuffer);
+			continue;
+		}
+		out << "\n" << GenerateLayoutStruct(*buffer, job, errors);
+	}
+	return out.str();
+}
+
+std::vector<std::string> framework::ValidateGeneratedLayout(const SHADER_GENERATED_LAYOUT& layout)
+{
+	std::vector<std::string> errors{};
+	const std::string source = layout.Source ? layout.Source : "";
+	const std::string name	 = layout.ConstantBuffer ? layout.ConstantBuffer : "";
+
+	const auto reflection = ReflectShaderFile(source, ParseDefines(layout.Defines ? layout.Defines : ""));
+	for (const auto& error : reflection.Errors) errors.push_back(source + ": " + error);
+
+	const auto* buffer = reflection.Find(name);
+	if (!buffer)
+	{
+		errors.push_back(source + ": no cbuffer " + name);
+		return errors;
+	}
+
+	if (GetLayoutFingerprint(*buffer) != layout.Fingerprint)
+	{
+		errors.push_back(name + " of " + source + " changed since its struct was generated ("
+						 + std::to_string(layout.Size) + " bytes then, " + std::to_string(buffer->Size)
+						 + " now), regenerate the shader layouts");
+	}
+	return errors;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "shader_cache.h"
+#include "shader_layout.h"
+
+namespace framework
+{
+	typedef struct _SHADER_CBUFFER_FIELD
+	{
+		std::string		 Name	   {};
+		EShaderFieldType Type	   { EShaderFieldType::Float };
+		std::uint32_t	 ArrayCount{ 1u };
+		std::uint32_t	 Offset	   { 0u }; //~ as HLSL packs it
+	} SHADER_CBUFFER_FIELD;
+
+	typedef struct _SHADER_CBUFFER
+	{
+		std::string						  Name		  {};
+		std::uint32_t					  Register	  { ~0u }; //~ bN, ~0u when the compiler assigns it
+		std::vector<SHADER_CBUFFER_FIELD> Fields	  {};
+		std::uint32_t					  Size		  { 0u }; //~ end of the last field
+		std::uint32_t					  PaddingBytes{ 0u }; //~ holes between fields and up to the last register
+
+		const SHADER_CBUFFER_FIELD* Find(std::string_view name) const noexcept;
+	} SHADER_CBUFFER;
+
+	typedef struct _SHADER_REFLECTION
+	{
+		std::vector<SHADER_CBUFFER> ConstantBuffers{};
+		std::vector<std::string>	Errors		   {}; //~ unsupported members or directives, the buffer is still listed
+
+		const SHADER_CBUFFER* Find(std::string_view name) const noexcept;
+		bool				  IsValid() const noexcept { return Errors.empty(); }
+	} SHADER_REFLECTION;
+
+	//~ written by the generator next to every struct, checked against the sources at startup
+	typedef struct _SHADER_GENERATED_LAYOUT
+	{
+		const char*	  Source	   { nullptr };
+		const char*	  ConstantBuffer{ nullptr };
+		const char*	  Defines	   { nullptr }; //~ "NAME=VALUE;..." of the permutation
+		std::uint32_t Size		   { 0u };
+		std::uint64_t Fingerprint  { 0u };
+	} SHADER_GENERATED_LAYOUT;
+
+	//~ one struct of a generated header
+	typedef struct _SHADER_LAYOUT_JOB
+	{
+		std::filesystem::path	   Source		 {};
+		std::string				   ConstantBuffer{};
+		std::string				   StructName	 {};
+		std::vector<SHADER_DEFINE> Defines		 {};
+	} SHADER_LAYOUT_JOB;
+
+	/// <summary>
+	/// Reads the cbuffer declarations of HLSL source without a compiler: comments are stripped,
+	/// #if/#ifdef/#ifndef/#elif/#else/#endif are evaluated against the defines (and #define),
+	/// quoted includes are followed by the file overload. Members are packed with the rules of
+	/// PackShaderField, packoffset and user types are reported as errors.
+	/// </summary>
+	SHADER_REFLECTION ReflectShaderSource(std::string_view source, const std::vector<SHADER_DEFINE>& defines);
+	SHADER_REFLECTION ReflectShaderFile	 (const std::filesystem::path& file, const std::vector<SHADER_DEFINE>& defines);
+
+	//~ names, types, array counts, offsets and size, anything that changes what the host must write
+	std::uint64_t GetLayoutFingerprint(const SHADER_CBUFFER& buffer) noexcept;
+
+	//~ C++ mirror of a cbuffer: every hole is an explicit _padN member, offsets and size are static_asserted
+	std::string GenerateLayoutStruct(const SHADER_CBUFFER& buffer,
+									 const SHADER_LAYOUT_JOB& job,
+									 std::vector<std::string>& errors);
+
+	//~ whole header for a set of jobs, errors names the jobs that could not be generated
+	std::string GenerateLayoutHeader(const std::vector<SHADER_LAYOUT_JOB>& jobs,
+									 std::string_view generator,
+									 std::vector<std::string>& errors);
+
+	//~ reflects the source again with the recorded defines, empty when the generated struct still matches
+	std::vector<std::string> ValidateGeneratedLayout(const SHADER_GENERATED_LAYOUT& layout);
+} // namespace framework
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace framework
+{
+	/// <summary>
+	/// 64 bit FNV-1a over whatever is fed to it, stable across runs and platforms so the
+	/// result can key data on disk. Hash fields one by one, never a struct with padding.
+	/// </summary>
+	class StateHasher
+	{
+	public:
+		static constexpr std::uint64_t OFFSET_BASIS = 0xcbf29ce484222325ull;
+		static constexpr std::uint64_t PRIME		= 0x100000001b3ull;
+
+		StateHasher() = default;
+		explicit StateHasher(std::uint64_t seed) noexcept : m_nHash(seed) {}
+
+		StateHasher& Add(const void* data, std::size_t size) noexcept
+		{
+			const auto* bytes = static_cast<const std::uint8_t*>(data);
+			for (std::size_t i = 0u; i < size; ++i)
+			{
+				m_nHash ^= bytes[ i ];
+				m_nHash *= PRIME;
+			}
+			return *this;
+		}
+
+		template<typename T>
+		StateHasher& Add(const T& value) noexcept
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be hashed by bytes");
+			return Add(&value, sizeof(T));
+		}
+
+		//~ length first, "ab" + "c" and "a" + "bc" must differ
+		StateHasher& AddString(std::string_view text) noexcept
+		{
+			Add(static_cast<std::uint64_t>(text.size()));
+			return Add(text.data(), text.size());
+		}
+
+		std::uint64_t Get() const noexcept { return m_nHash; }
+
+	private:
+		std::uint64_t m_nHash{ OFFSET_BASIS };
+	};
+
+	inline std::uint64_t HashBytes(const void* data, std::size_t size) noexcept
+	{
+		return StateHasher{}.Add(data, size).Get();
+	}
+} // namespace framework
@@ -0,0 +1,352 @@
+#include "tlsf_allocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+using namespace framework;
+
+namespace
+{
+	constexpr std::uint64_t AlignUp(std::uint64_t value, std::uint64_t alignment) noexcept
+	{
+		return (value + alignment - 1u) & ~(alignment - 1u);
+	}
+} // namespace
+
+framework::TlsfAllocator::TlsfAllocator(std::uint64_t size, std::uint64_t granularity)
+	: m_nSize(size & ~(granularity - 1u)), m_nGranularity(granularity)
+{
+	assert(std::has_single_bit(granularity) && "TLSF granularity must be a power of two!");
+	assert(m_nSize >= granularity && "TLSF range smaller than its granularity!");
+	Reset();
+}
+
+TLSF_ALLOCATION framework::TlsfAllocator::Allocate(std::uint64_t size, std::uint64_t alignment, std::uint64_t userData)
+{
+	alignment = (std::max)(alignment, m_nGranularity);
+	assert(std::has_single_bit(alignment) && "TLSF alignment must be a power of two!");
+
+	const std::uint64_t need   = AlignUp((std::max)(size, std::uint64_t{ 1u }), m_nGranularity);
+	const std::uint64_t search = need + (alignment - m_nGranularity); //~ worst case front padding
+	if (search > m_nSize) return {};
+
+	TlsfHandle found = FindFreeBlock(search);
+	if (found == INVALID_TLSF_HANDLE) found = FindInClass(search);
+	if (found == INVALID_TLSF_HANDLE) return {};
+
+	const TlsfHandle block = Place(found, need, alignment);
+	m_blocks[ block ].UserData = userData;
+	return { m_blocks[ block ].Offset, m_blocks[ block ].Size, block };
+}
+
+void framework::TlsfAllocator::Free(TlsfHandle handle)
+{
+	assert(handle < m_blocks.size() && m_blocks[ handle ].Live && !m_blocks[ handle ].Free && "TLSF double free or stale handle!");
+
+	m_nUsedBytes -= m_blocks[ handle ].Size;
+	--m_nAllocationCount;
+	m_blocks[ handle ].Free = true;
+
+	//~ merge with the previous neighbour, it absorbs this block
+	const TlsfHandle prev = m_blocks[ handle ].PrevPhysical;
+	if (prev != INVALID_TLSF_HANDLE && m_blocks[ prev ].Free)
+	{
+		RemoveFree(prev);
+		m_blocks[ prev ].Size		 += m_blocks[ handle ].Size;
+		m_blocks[ prev ].NextPhysical = m_blocks[ handle ].NextPhysical;
+		if (m_blocks[ prev ].NextPhysical != INVALID_TLSF_HANDLE) m_blocks[ m_blocks[ prev ].NextPhysical ].PrevPhysical = prev;
+
+		ReleaseRecord(handle);
+		handle = prev;
+	}
+
+	//~ and with the next one, this block absorbs it
+	const TlsfHandle next = m_blocks[ handle ].NextPhysical;
+	if (next != INVALID_TLSF_HANDLE && m_blocks[ next ].Free)
+	{
+		RemoveFree(next);
+		m_blocks[ handle ].Size		   += m_blocks[ next ].Size;
+		m_blocks[ handle ].NextPhysical = m_blocks[ next ].NextPhysical;
+		if (m_blocks[ handle ].NextPhysical != INVALID_TLSF_HANDLE) m_blocks[ m_blocks[ handle ].NextPhysical ].PrevPhysical = handle;
+
+		ReleaseRecord(next);
+	}
+
+	InsertFree(handle);
+}
+
+void framework::TlsfAllocator::Reset()
+{
+	m_blocks.clear();
+	m_unusedRecords.clear();
+	m_nUsedBytes	   = 0u;
+	m_nAllocationCount = 0u;
+	m_nFreeCount	   = 0u;
+	m_flBitmap		   = 0u;
+	std::fill(std::begin(m_slBitmap), std::end(m_slBitmap), 0u);
+	for (auto& row : m_freeHeads) std::fill(std::begin(row), std::end(row), INVALID_TLSF_HANDLE);
+
+	const TlsfHandle all = NewRecord();
+	m_blocks[ all ].Offset = 0u;
+	m_blocks[ all ].Size   = m_nSize;
+	m_blocks[ all ].Free   = true;
+	InsertFree(all);
+}
+
+std::uint32_t framework::TlsfAllocator::Defragment(const std::function<void(const TLSF_MOVE&)>& move, std::uint32_t maxMoves)
+{
+	std::vector<TlsfHandle> used{};
+	used.reserve(m_nAllocationCount);
+	for (TlsfHandle i = 0u; i < m_blocks.size(); ++i)
+	{
+		if (m_blocks[ i ].Live && !m_blocks[ i ].Free) used.push_back(i);
+	}
+
+	//~ highest allocations first, they are the ones splitting the free space
+	std::sort(used.begin(), used.end(), [this](TlsfHandle a, TlsfHandle b) { return m_blocks[ a ].Offset > m_blocks[ b ].Offset; });
+
+	std::uint32_t moves = 0u;
+	for (const TlsfHandle handle : used)
+	{
+		if (moves >= maxMoves) break;
+
+		const auto block  = m_blocks[ handle ];
+		const auto target = FindLowestFit(block.Size, block.Alignment, block.Offset);
+		if (target == INVALID_TLSF_HANDLE) continue;
+
+		const TlsfHandle moved = Place(target, block.Size, block.Alignment);
+		m_blocks[ moved ].UserData = block.UserData;
+
+		move({ handle, block.Offset, { m_blocks[ moved ].Offset, m_blocks[ moved ].Size, moved }, block.UserData });
+		Free(handle);
+		++moves;
+	}
+	return moves;
+}
+
+TLSF_STATS framework::TlsfAllocator::GetStats() const noexcept
+{
+	TLSF_STATS stats{};
+	stats.TotalSize		  = m_nSize;
+	stats.UsedBytes		  = m_nUsedBytes;
+	stats.FreeBytes		  = m_nSize - m_nUsedBytes;
+	stats.AllocationCount = m_nAllocationCount;
+	stats.FreeBlockCount  = m_nFreeCount;
+
+	//~ the largest block sits in the highest non empty class
+	if (m_flBitmap)
+	{
+		const std::uint32_t fl = 63u - static_cast<std::uint32_t>(std::countl_zero(m_flBitmap));
+		const std::uint32_t sl = 31u - static_cast<std::uint32_t>(std::countl_zero(m_slBitmap[ fl ]));
+		for (TlsfHandle it = m_freeHeads[ fl ][ sl ]; it != INVALID_TLSF_HANDLE; it = m_blocks[ it ].NextFree)
+		{
+			stats.LargestFreeBlock = (std::max)(stats.LargestFreeBlock, m_blocks[ it ].Size);
+		}
+	}
+	return stats;
+}
+
+void framework::TlsfAllocator::MappingInsert(std::uint64_t units, std::uint32_t& fl, std::uint32_t& sl) const noexcept
+{
+	if (units < SL_COUNT)
+	{
+		//~ small blocks get one exact list per unit count
+		fl = 0u;
+		sl = static_cast<std::uint32_t>(units);
+		return;
+	}
+
+	const std::uint32_t msb = static_cast<std::uint32_t>(std::bit_width(units)) - 1u;
+	sl = static_cast<std::uint32_t>(units >> (msb - SL_LOG2)) ^ SL_COUNT;
+	fl = msb - SL_LOG2 + 1u;
+}
+
+void framework::TlsfAllocator::MappingSearch(std::uint64_t units, std::uint32_t& fl, std::uint32_t& sl) const noexcept
+{
+	//~ round up to the next class so any block in the found list fits
+	if (units >= SL_COUNT)
+	{
+		const std::uint32_t msb = static_cast<std::uint32_t>(std::bit_width(units)) - 1u;
+		units += (std::uint64_t{ 1u } << (msb - SL_LOG2)) - 1u;
+	}
+	MappingInsert(units, fl, sl);
+}
+
+TlsfHandle framework::TlsfAllocator::FindFreeBlock(std::uint64_t size) const noexcept
+{
+	std::uint32_t fl = 0u, sl = 0u;
+	MappingSearch(size / m_nGranularity, fl, sl);
+	if (fl >= FL_COUNT) return INVALID_TLSF_HANDLE;
+
+	std::uint32_t slMap = m_slBitmap[ fl ] & (~0u << sl);
+	if (!slMap)
+	{
+		const std::uint64_t flMap = fl + 1u < 64u ? m_flBitmap & (~std::uint64_t{ 0u } << (fl + 1u)) : 0u;
+		if (!flMap) return INVALID_TLSF_HANDLE;
+
+		fl	  = static_cast<std::uint32_t>(std::countr_zero(flMap));
+		slMap = m_slBitmap[ fl ];
+	}
+	sl = static_cast<std::uint32_t>(std::countr_zero(slMap));
+	return m_freeHeads[ fl ][ sl ];
+}
+
+TlsfHandle framework::TlsfAllocator::FindInClass(std::uint64_t size) const noexcept
+{
+	//~ the rounded search skips blocks sharing the request's own class, e.g. a request for
+	//~ the whole range. Last resort before failing, walks that one list
+	std::uint32_t fl = 0u, sl = 0u;
+	MappingInsert(size / m_nGranularity, fl, sl);
+	if (fl >= FL_COUNT) return INVALID_TLSF_HANDLE;
+
+	for (TlsfHandle it = m_freeHeads[ fl ][ sl ]; it != INVALID_TLSF_HANDLE; it = m_blocks[ it ].NextFree)
+	{
+		if (m_blocks[ it ].Size >= size) return it;
+	}
+	return INVALID_TLSF_HANDLE;
+}
+
+TlsfHandle framework::TlsfAllocator::FindLowestFit(std::uint64_t size, std::uint64_t alignment, std::uint64_t below) const noexcept
+{
+	//~ address order walk, only used by Defragment
+	TlsfHandle it = INVALID_TLSF_HANDLE;
+	for (TlsfHandle i = 0u; i < m_blocks.size(); ++i)
+	{
+		if (m_blocks[ i ].Live && m_blocks[ i ].Offset == 0u)
+		{
+			it = i;
+			break;
+		}
+	}
+
+	for (; it != INVALID_TLSF_HANDLE && m_blocks[ it ].Offset < below; it = m_blocks[ it ].NextPhysical)
+	{
+		const auto& b = m_blocks[ it ];
+		if (!b.Free) continue;
+
+		const std::uint64_t aligned = AlignUp(b.Offset, alignment);
+		if (aligned + size <= b.Offset + b.Size && aligned < below) return it;
+	}
+	return INVALID_TLSF_HANDLE;
+}
+
+TlsfHandle framework::TlsfAllocator::Place(TlsfHandle block, std::uint64_t size, std::uint64_t alignment)
+{
+	RemoveFree(block);
+
+	const std::uint64_t aligned = AlignUp(m_blocks[ block ].Offset, alignment);
+	if (const std::uint64_t pad = aligned - m_blocks[ block ].Offset)
+	{
+		//~ padding stays behind as its own free block, the previous block is used so nothing merges
+		const TlsfHandle front = NewRecord();
+		auto& b = m_blocks[ block ];
+		auto& f = m_blocks[ front ];
+
+		f.Offset	   = b.Offset;
+		f.Size		   = pad;
+		f.PrevPhysical = b.PrevPhysical;
+		f.NextPhysical = block;
+		if (f.PrevPhysical != INVALID_TLSF_HANDLE) m_blocks[ f.PrevPhysical ].NextPhysical = front;
+
+		b.Offset	   = aligned;
+		b.Size		  -= pad;
+		b.PrevPhysical = front;
+		InsertFree(front);
+	}
+
+	if (m_blocks[ block ].Size > size)
+	{
+		SplitBack(block, size);
+	}
+
+	auto& b = m_blocks[ block ];
+	b.Free		= false;
+	b.Alignment = alignment;
+
+	m_nUsedBytes += b.Size;
+	++m_nAllocationCount;
+	return block;
+}
+
+void framework::TlsfAllocator::InsertFree(TlsfHandle block) noexcept
+{
+	std::uint32_t fl = 0u, sl = 0u;
+	MappingInsert(m_blocks[ block ].Size / m_nGranularity, fl, sl);
+
+	auto& b = m_blocks[ block ];
+	b.Free	   = true;
+	b.PrevFree = INVALID_TLSF_HANDLE;
+	b.NextFree = m_freeHeads[ fl ][ sl ];
+	if (b.NextFree != INVALID_TLSF_HANDLE) m_blocks[ b.NextFree ].PrevFree = block;
+
+	m_freeHeads[ fl ][ sl ] = block;
+	m_slBitmap[ fl ]	   |= 1u << sl;
+	m_flBitmap			   |= std::uint64_t{ 1u } << fl;
+	++m_nFreeCount;
+}
+
+void framework::TlsfAllocator::RemoveFree(TlsfHandle block) noexcept
+{
+	std::uint32_t fl = 0u, sl = 0u;
+	MappingInsert(m_blocks[ block ].Size / m_nGranularity, fl, sl);
+
+	auto& b = m_blocks[ block ];
+	if (b.PrevFree != INVALID_TLSF_HANDLE) m_blocks[ b.PrevFree ].NextFree = b.NextFree;
+	if (b.NextFree != INVALID_TLSF_HANDLE) m_blocks[ b.NextFree ].PrevFree = b.PrevFree;
+
+	if (m_freeHeads[ fl ][ sl ] == block)
+	{
+		m_freeHeads[ fl ][ sl ] = b.NextFree;
+		if (b.NextFree == INVALID_TLSF_HANDLE)
+		{
+			m_slBitmap[ fl ] &= ~(1u << sl);
+			if (!m_slBitmap[ fl ]) m_flBitmap &= ~(std::uint64_t{ 1u } << fl);
+		}
+	}
+	b.PrevFree = INVALID_TLSF_HANDLE;
+	b.NextFree = INVALID_TLSF_HANDLE;
+	--m_nFreeCount;
+}
+
+TlsfHandle framework::TlsfAllocator::NewRecord()
+{
+	TlsfHandle handle = INVALID_TLSF_HANDLE;
+	if (!m_unusedRecords.empty())
+	{
+		handle = m_unusedRecords.back();
+		m_unusedRecords.pop_back();
+	}
+	else
+	{
+		handle = static_cast<TlsfHandle>(m_blocks.size());
+		m_blocks.emplace_back();
+	}
+
+	m_blocks[ handle ]		= {};
+	m_blocks[ handle ].Live = true;
+	return handle;
+}
+
+void framework::TlsfAllocator::ReleaseRecord(TlsfHandle block) noexcept
+{
+	m_blocks[ block ].Live = false;
+	m_unusedRecords.push_back(block);
+}
+
+void framework::TlsfAllocator::SplitBack(TlsfHandle block, std::uint64_t size)
+{
+	const TlsfHandle back = NewRecord();
+	auto& b = m_blocks[ block ];
+	auto& r = m_blocks[ back ];
+
+	r.Offset	   = b.Offset + size;
+	r.Size		   = b.Size - size;
+	r.PrevPhysical = block;
+	r.NextPhysical = b.NextPhysical;
+	if (r.NextPhysical != INVALID_TLSF_HANDLE) m_blocks[ r.NextPhysical ].PrevPhysical = back;
+
+	b.Size		   = size;
+	b.NextPhysical = back;
+	InsertFree(back);
+}
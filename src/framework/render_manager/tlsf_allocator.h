@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace framework
+{
+	using TlsfHandle = std::uint32_t;
+	inline constexpr TlsfHandle INVALID_TLSF_HANDLE = std::numeric_limits<TlsfHandle>::max();
+
+	typedef struct _TLSF_ALLOCATION
+	{
+		std::uint64_t Offset{ 0u };
+		std::uint64_t Size	{ 0u }; //~ rounded up to the granularity
+		TlsfHandle	  Handle{ INVALID_TLSF_HANDLE };
+
+		bool IsValid() const noexcept { return Handle != INVALID_TLSF_HANDLE; }
+	} TLSF_ALLOCATION;
+
+	typedef struct _TLSF_STATS
+	{
+		std::uint64_t TotalSize		  { 0u };
+		std::uint64_t UsedBytes		  { 0u };
+		std::uint64_t FreeBytes		  { 0u };
+		std::uint64_t LargestFreeBlock{ 0u };
+		std::uint32_t AllocationCount { 0u };
+		std::uint32_t FreeBlockCount  { 0u };
+
+		//~ 0 when all free space is one block, close to 1 when it is scattered
+		double Fragmentation() const noexcept
+		{
+			return FreeBytes ? 1.0 - static_cast<double>(LargestFreeBlock) / static_cast<double>(FreeBytes) : 0.0;
+		}
+	} TLSF_STATS;
+
+	//~ one relocation proposed by Defragment, the old range stays valid until the hook returns
+	typedef struct _TLSF_MOVE
+	{
+		TlsfHandle		OldHandle{ INVALID_TLSF_HANDLE };
+		std::uint64_t	OldOffset{ 0u };
+		TLSF_ALLOCATION NewAllocation{};
+		std::uint64_t	UserData { 0u };
+	} TLSF_MOVE;
+
+	/// <summary>
+	/// Two level segregated fit allocator over an abstract range [0, size). It only hands out
+	/// offsets, so the same code places resources in an ID3D12Heap, sub-allocates a buffer or
+	/// runs on the host in the fragmentation benchmark.
+	/// Free blocks live in FL x SL size classes found with two bitmap scans, allocate and free are O(1);
+	/// physically adjacent free blocks are merged on free. Not thread safe, owners lock.
+	/// </summary>
+	class TlsfAllocator
+	{
+	public:
+		static constexpr std::uint32_t SL_LOG2	= 5u;
+		static constexpr std::uint32_t SL_COUNT = 1u << SL_LOG2;
+		static constexpr std::uint32_t FL_COUNT = 64u - SL_LOG2 + 1u;
+
+		//~ granularity is the smallest unit and alignment, a power of two
+		TlsfAllocator(std::uint64_t size, std::uint64_t granularity = 256u);
+		~TlsfAllocator() = default;
+
+		TlsfAllocator(const TlsfAllocator&) = delete;
+		TlsfAllocator& operator=(const TlsfAllocator&) = delete;
+
+		//~ alignment is a power of two, 0 means the granularity. Invalid allocation when full
+		TLSF_ALLOCATION Allocate(std::uint64_t size, std::uint64_t alignment = 0u, std::uint64_t userData = 0u);
+		void			Free	(TlsfHandle handle);
+		void			Reset	();
+
+		//~ defragmentation hook: walks allocations from the top of the range and moves each one
+		//~ into the lowest free block it fits, so free space gathers at the end. move() must copy the
+		//~ data (or re-create the resource) and take the new handle, the old one is freed right after it returns
+		std::uint32_t Defragment(const std::function<void(const TLSF_MOVE&)>& move, std::uint32_t maxMoves);
+
+		//~ Getters
+		TLSF_STATS	  GetStats		 () const noexcept;
+		std::uint64_t GetSize		 () const noexcept { return m_nSize; }
+		std::uint64_t GetGranularity () const noexcept { return m_nGranularity; }
+		std::uint64_t GetUsedBytes	 () const noexcept { return m_nUsedBytes; }
+		bool		  IsEmpty		 () const noexcept { return m_nAllocationCount == 0u; }
+		std::uint64_t GetUserData	 (TlsfHandle handle) const noexcept { return m_blocks[ handle ].UserData; }
+
+	private:
+		typedef struct _TLSF_BLOCK
+		{
+			std::uint64_t Offset   { 0u };
+			std::uint64_t Size	   { 0u };
+			std::uint64_t Alignment{ 0u };
+			std::uint64_t UserData { 0u };
+			TlsfHandle	  PrevPhysical{ INVALID_TLSF_HANDLE };
+			TlsfHandle	  NextPhysical{ INVALID_TLSF_HANDLE };
+			TlsfHandle	  PrevFree	  { INVALID_TLSF_HANDLE };
+			TlsfHandle	  NextFree	  { INVALID_TLSF_HANDLE };
+			bool		  Free		  { false };
+			bool		  Live		  { false }; //~ false while the record sits in the unused pool
+		} TLSF_BLOCK;
+
+		//~ size class of a block, rounding down (insert) or up (search)
+		void MappingInsert(std::uint64_t units, std::uint32_t& fl, std::uint32_t& sl) const noexcept;
+		void MappingSearch(std::uint64_t units, std::uint32_t& fl, std::uint32_t& sl) const noexcept;
+
+		TlsfHandle FindFreeBlock(std::uint64_t size) const noexcept;
+		TlsfHandle FindInClass	(std::uint64_t size) const noexcept;
+		TlsfHandle FindLowestFit(std::uint64_t size, std::uint64_t alignment, std::uint64_t below) const noexcept;
+		TlsfHandle Place		(TlsfHandle block, std::uint64_t size, std::uint64_t alignment);
+		void	   InsertFree	(TlsfHandle block) noexcept;
+		void	   RemoveFree	(TlsfHandle block) noexcept;
+		TlsfHandle NewRecord	();
+		void	   ReleaseRecord(TlsfHandle block) noexcept;
+
+		//~ cuts [Offset + size, end) of block into a new free block
+		void SplitBack(TlsfHandle block, std::uint64_t size);
+
+	private:
+		std::uint64_t m_nSize		 { 0u };
+		std::uint64_t m_nGranularity { 0u };
+		std::uint64_t m_nUsedBytes	 { 0u };
+		std::uint32_t m_nAllocationCount{ 0u };
+		std::uint32_t m_nFreeCount	 { 0u };
+
+		std::uint64_t m_flBitmap{ 0u };
+		std::uint32_t m_slBitmap[ FL_COUNT ]{};
+		TlsfHandle	  m_freeHeads[ FL_COUNT ][ SL_COUNT ]{};
+
+		std::vector<TLSF_BLOCK> m_blocks	   {};
+		std::vector<TlsfHandle> m_unusedRecords{};
+	};
+} // namespace framework
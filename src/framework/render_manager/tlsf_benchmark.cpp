@@ -0,0 +1,215 @@
+#include "tlsf_benchmark.h"
+#include "tlsf_allocator.h"
+
+#include "utility/logger/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <random>
+
+using namespace framework;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	constexpr std::uint64_t nGranularity = 64ull * 1024ull;
+	constexpr std::uint64_t nMsaaAlign	 = 4ull * 1024ull * 1024ull;
+	constexpr double		nTargetFill	 = 0.75;
+
+	typedef struct _BENCH_OP
+	{
+		bool		  Allocate { false };
+		std::uint64_t Size	   { 0u };
+		std::uint64_t Alignment{ 0u };
+		std::uint32_t Victim   { 0u }; //~ random pick among live allocations when freeing
+	} BENCH_OP;
+
+	//~ first fit over an offset ordered free list, merging on free
+	class FirstFitAllocator
+	{
+	public:
+		explicit FirstFitAllocator(std::uint64_t size) { m_free[ 0u ] = size; }
+
+		bool Allocate(std::uint64_t size, std::uint64_t alignment, std::uint64_t& offset)
+		{
+			for (auto it = m_free.begin(); it != m_free.end(); ++it)
+			{
+				const std::uint64_t aligned = (it->first + alignment - 1u) & ~(alignment - 1u);
+				const std::uint64_t end		= it->first + it->second;
+				if (aligned + size > end) continue;
+
+				const std::uint64_t begin = it->first;
+				m_free.erase(it);
+				if (aligned > begin)	   m_free[ begin ]			= aligned - begin;
+				if (aligned + size < end) m_free[ aligned + size ] = end - aligned - size;
+
+				offset = aligned;
+				return true;
+			}
+			return false;
+		}
+
+		void Free(std::uint64_t offset, std::uint64_t size)
+		{
+			auto it = m_free.emplace(offset, size).first;
+
+			auto next = std::next(it);
+			if (next != m_free.end() && it->first + it->second == next->first)
+			{
+				it->second += next->second;
+				m_free.erase(next);
+			}
+			if (it != m_free.begin())
+			{
+				auto prev = std::prev(it);
+				if (prev->first + prev->second == it->first)
+				{
+					prev->second += it->second;
+					m_free.erase(it);
+				}
+			}
+		}
+
+	private:
+		std::map<std::uint64_t, std::uint64_t> m_free{};
+	};
+
+	std::vector<BENCH_OP> BuildOps(std::uint32_t count, std::uint64_t heapSize)
+	{
+		std::mt19937_64 rng(0x7157u);
+		std::uniform_real_distribution<double> logSize(std::log2(64.0 * 1024.0), std::log2(8.0 * 1024.0 * 1024.0));
+		std::uniform_int_distribution<std::uint32_t> victim(0u, ~0u);
+		std::uniform_int_distribution<std::uint32_t> msaa(0u, 7u);
+
+		//~ the mean of the size distribution is ~1.8MB, pick the live count that fills the target
+		const double meanSize = 1.8 * 1024.0 * 1024.0;
+		const std::uint32_t targetLive = static_cast<std::uint32_t>(static_cast<double>(heapSize) * nTargetFill / meanSize);
+
+		std::vector<BENCH_OP> ops(count);
+		std::uint32_t live = 0u;
+		for (auto& op : ops)
+		{
+			op.Allocate = live < targetLive || (live == 0u) || (victim(rng) & 1u && live < targetLive * 5u / 4u);
+			if (op.Allocate)
+			{
+				op.Size		 = static_cast<std::uint64_t>(std::exp2(logSize(rng)));
+				op.Alignment = msaa(rng) == 0u ? nMsaaAlign : nGranularity;
+				++live;
+			}
+			else
+			{
+				op.Victim = victim(rng);
+				--live;
+			}
+		}
+		return ops;
+	}
+} // namespace
+
+std::vector<TLSF_BENCHMARK_RESULT> framework::RunTlsfBenchmark(
+	const std::vector<std::uint32_t>& operationCounts,
+	std::uint64_t heapSize)
+{
+	std::vector<TLSF_BENCHMARK_RESULT> results{};
+	results.reserve(operationCounts.size());
+
+	for (auto count : operationCounts)
+	{
+		const auto ops = BuildOps(count, heapSize);
+
+		TLSF_BENCHMARK_RESULT result{};
+		result.Operations = count;
+
+		//~ tlsf, failed allocations are skipped by the matching frees
+		TlsfAllocator tlsf(heapSize, nGranularity);
+		std::vector<TlsfHandle>	   live{};
+		std::vector<std::uint32_t> slotOf{}; //~ handle -> index in live
+		live.reserve(count);
+
+		auto start = Clock::now();
+		for (const auto& op : ops)
+		{
+			if (op.Allocate)
+			{
+				const auto allocation = tlsf.Allocate(op.Size, op.Alignment);
+				if (!allocation.IsValid())
+				{
+					++result.TlsfFailed;
+					continue;
+				}
+				if (allocation.Handle >= slotOf.size()) slotOf.resize(allocation.Handle + 1u);
+				slotOf[ allocation.Handle ] = static_cast<std::uint32_t>(live.size());
+				live.push_back(allocation.Handle);
+			}
+			else if (!live.empty())
+			{
+				const std::uint32_t slot = op.Victim % static_cast<std::uint32_t>(live.size());
+				tlsf.Free(live[ slot ]);
+				live[ slot ] = live.back();
+				slotOf[ live[ slot ] ] = slot;
+				live.pop_back();
+			}
+		}
+		result.TlsfNsPerOp = ElapsedMs(start) * 1e6 / static_cast<double>(count);
+
+		//~ first fit baseline on the same stream
+		FirstFitAllocator firstFit(heapSize);
+		std::vector<std::pair<std::uint64_t, std::uint64_t>> firstFitLive{};
+		firstFitLive.reserve(count);
+
+		start = Clock::now();
+		for (const auto& op : ops)
+		{
+			if (op.Allocate)
+			{
+				const std::uint64_t size = (op.Size + nGranularity - 1u) & ~(nGranularity - 1u);
+				std::uint64_t offset = 0u;
+				if (!firstFit.Allocate(size, op.Alignment, offset))
+				{
+					++result.FirstFitFailed;
+					continue;
+				}
+				firstFitLive.emplace_back(offset, size);
+			}
+			else if (!firstFitLive.empty())
+			{
+				const std::uint32_t slot = op.Victim % static_cast<std::uint32_t>(firstFitLive.size());
+				firstFit.Free(firstFitLive[ slot ].first, firstFitLive[ slot ].second);
+				firstFitLive[ slot ] = firstFitLive.back();
+				firstFitLive.pop_back();
+			}
+		}
+		result.FirstFitNsPerOp = ElapsedMs(start) * 1e6 / static_cast<double>(count);
+
+		const auto before = tlsf.GetStats();
+		result.Occupancy	 = static_cast<double>(before.UsedBytes) / static_cast<double>(before.TotalSize);
+		result.Fragmentation = before.Fragmentation();
+
+		//~ the hook only rewires handles here, a GPU owner would copy the resource
+		start = Clock::now();
+		result.DefragMoves = tlsf.Defragment([&](const TLSF_MOVE& move)
+		{
+			const std::uint32_t slot = slotOf[ move.OldHandle ];
+			if (move.NewAllocation.Handle >= slotOf.size()) slotOf.resize(move.NewAllocation.Handle + 1u);
+			slotOf[ move.NewAllocation.Handle ] = slot;
+			live[ slot ] = move.NewAllocation.Handle;
+		}, ~0u);
+		result.DefragMs			   = ElapsedMs(start);
+		result.DefragFragmentation = tlsf.GetStats().Fragmentation();
+
+		logger::info("TLSF benchmark {:>7} ops: tlsf {:.1f} ns/op ({} failed), first fit {:.1f} ns/op ({} failed), "
+					 "{:.0f}% full, fragmentation {:.2f} -> {:.2f} after {} moves in {:.3f} ms",
+					 result.Operations, result.TlsfNsPerOp, result.TlsfFailed, result.FirstFitNsPerOp, result.FirstFitFailed,
+					 result.Occupancy * 100.0, result.Fragmentation, result.DefragFragmentation, result.DefragMoves, result.DefragMs);
+		results.push_back(result);
+	}
+	return results;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace framework
+{
+	typedef struct _TLSF_BENCHMARK_RESULT
+	{
+		std::uint32_t Operations		  { 0u };
+		double		  TlsfNsPerOp		  { 0.0 };
+		double		  FirstFitNsPerOp	  { 0.0 }; //~ ordered free list, the baseline
+		std::uint32_t TlsfFailed		  { 0u };
+		std::uint32_t FirstFitFailed	  { 0u };
+		double		  Occupancy			  { 0.0 }; //~ used / heap after the run
+		double		  Fragmentation		  { 0.0 }; //~ 1 - largest free / free, before defragment
+		double		  DefragFragmentation { 0.0 };
+		std::uint32_t DefragMoves		  { 0u };
+		double		  DefragMs			  { 0.0 };
+	} TLSF_BENCHMARK_RESULT;
+
+	//~ random placed resource churn over one heap: 64KB granularity, log uniform sizes
+	//~ from 64KB to 8MB, one in eight allocations 4MB aligned like MSAA targets. The heap is
+	//~ kept around 75% full. Runs on the host only, results are logged and returned.
+	std::vector<TLSF_BENCHMARK_RESULT> RunTlsfBenchmark(
+		const std::vector<std::uint32_t>& operationCounts = { 10'000u, 100'000u, 1'000'000u },
+		std::uint64_t heapSize = 512ull * 1024ull * 1024ull);
+} // namespace framework
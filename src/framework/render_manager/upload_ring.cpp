@@ -0,0 +1,156 @@
+#include "upload_ring.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace framework;
+
+namespace
+{
+	constexpr std::uint64_t AlignUp(std::uint64_t value, std::uint64_t alignment) noexcept
+	{
+		return (value + alignment - 1u) & ~(alignment - 1u);
+	}
+} // namespace
+
+//~ UploadRing
+
+framework::UploadRing::UploadRing(IUploadMemory* memory)
+	: m_pMemory(memory)
+{
+	assert(m_pMemory && m_pMemory->GetSize() >= BLOCK_ALIGNMENT && "Upload ring needs backing memory!");
+
+	//~ a partial trailing block could never be handed out
+	m_nCapacity = m_pMemory->GetSize() & ~(BLOCK_ALIGNMENT - 1u);
+}
+
+std::uint64_t framework::UploadRing::AllocateBlock(std::uint64_t size)
+{
+	size = AlignUp(std::max<std::uint64_t>(size, 1u), BLOCK_ALIGNMENT);
+
+	std::lock_guard<std::mutex> guard(m_lock);
+
+	std::uint64_t offset = UPLOAD_INVALID_OFFSET;
+	if (m_blocks.empty())
+	{
+		//~ nothing in flight, start over at the front
+		if (size <= m_nCapacity) offset = 0u;
+	}
+	else
+	{
+		const std::uint64_t tail = m_blocks.front().Offset;
+		if (m_nHead > tail)
+		{
+			//~ free space is [head, capacity) plus [0, tail), a block never straddles the end
+			if (m_nHead + size <= m_nCapacity) offset = m_nHead;
+			else if (size <= tail)			   offset = 0u;
+		}
+		else if (m_nHead + size <= tail)
+		{
+			//~ wrapped, head == tail means full
+			offset = m_nHead;
+		}
+	}
+
+	if (offset == UPLOAD_INVALID_OFFSET)
+	{
+		++m_nFailed;
+		return UPLOAD_INVALID_OFFSET;
+	}
+
+	m_blocks.push_back({ offset, size, 0u, false });
+	m_nHead = offset + size;
+	m_nUsed += size;
+	m_nPeak = std::max(m_nPeak, m_nUsed);
+	return offset;
+}
+
+void framework::UploadRing::RetireBlock(std::uint64_t offset, std::uint64_t fence)
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+
+	//~ recent blocks sit at the back, search from there
+	auto it = std::find_if(m_blocks.rbegin(), m_blocks.rend(), [offset](const RING_BLOCK& block)
+	{
+		return block.Offset == offset && !block.Retired;
+	});
+	assert(it != m_blocks.rend() && "Retiring a block the ring did not hand out!");
+	if (it == m_blocks.rend()) return;
+
+	it->Fence	= fence;
+	it->Retired = true;
+}
+
+void framework::UploadRing::Reclaim(std::uint64_t completedFence)
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+
+	while (!m_blocks.empty() && m_blocks.front().Retired && m_blocks.front().Fence <= completedFence)
+	{
+		m_nUsed -= m_blocks.front().Size;
+		m_blocks.pop_front();
+	}
+	if (m_blocks.empty()) m_nHead = 0u;
+}
+
+UPLOAD_RING_STATS framework::UploadRing::GetStats() const
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+
+	UPLOAD_RING_STATS stats{};
+	stats.Capacity			= m_nCapacity;
+	stats.Used				= m_nUsed;
+	stats.PeakUsed			= m_nPeak;
+	stats.BlocksInFlight	= static_cast<std::uint32_t>(m_blocks.size());
+	stats.FailedAllocations = m_nFailed;
+	return stats;
+}
+
+//~ LinearUploadAllocator
+
+framework::LinearUploadAllocator::LinearUploadAllocator(UploadRing* ring, std::uint64_t blockSize)
+	: m_pRing(ring), m_nBlockSize(AlignUp(blockSize, UploadRing::BLOCK_ALIGNMENT))
+{
+	assert(m_pRing && "Linear upload allocator needs a ring!");
+}
+
+UPLOAD_ALLOCATION framework::LinearUploadAllocator::Allocate(std::uint64_t size, std::uint64_t alignment)
+{
+	assert(alignment && (alignment & (alignment - 1u)) == 0u && alignment <= UploadRing::BLOCK_ALIGNMENT
+		   && "Upload alignment must be a power of two no larger than a block!");
+
+	std::uint64_t offset = AlignUp(m_nCursor, alignment);
+	if (m_nBlockOffset == UPLOAD_INVALID_OFFSET || offset + size > m_nBlockEnd)
+	{
+		//~ the rest of the current block is wasted, large requests get a block of their own
+		const std::uint64_t block = m_pRing->AllocateBlock(std::max(m_nBlockSize, size));
+		if (block == UPLOAD_INVALID_OFFSET) return {};
+
+		m_blocks.push_back(block);
+		m_nBlockOffset = block;
+		m_nBlockEnd	   = block + AlignUp(std::max(m_nBlockSize, size), UploadRing::BLOCK_ALIGNMENT);
+		offset		   = block;
+	}
+	m_nCursor = offset + size;
+	m_nAllocatedBytes += size;
+
+	const auto* memory = m_pRing->GetMemory();
+
+	UPLOAD_ALLOCATION allocation{};
+	allocation.Cpu	  = memory->GetCpuBase() + offset;
+	allocation.Gpu	  = memory->GetGpuBase() + offset;
+	allocation.Offset = offset;
+	allocation.Size	  = size;
+	return allocation;
+}
+
+void framework::LinearUploadAllocator::Retire(std::uint64_t fence)
+{
+	for (auto block : m_blocks) m_pRing->RetireBlock(block, fence);
+
+	m_blocks.clear();
+	m_nBlockOffset	  = UPLOAD_INVALID_OFFSET;
+	m_nBlockEnd		  = 0u;
+	m_nCursor		  = 0u;
+	m_nAllocatedBytes = 0u;
+}
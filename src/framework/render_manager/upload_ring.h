@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "backend/command_recorder.h"
+
+namespace framework
+{
+	//~ placement rules of the upload heap, every block starts at the largest of them
+	inline constexpr std::uint64_t UPLOAD_ALIGN_BUFFER	 = 16u;	 //~ vertices, indices, structured
+	inline constexpr std::uint64_t UPLOAD_ALIGN_CONSTANT = 256u; //~ D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT
+	inline constexpr std::uint64_t UPLOAD_ALIGN_TEXTURE	 = 512u; //~ D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+	inline constexpr std::uint64_t UPLOAD_INVALID_OFFSET = ~0ull;
+
+	/// <summary>
+	/// Backing store of an upload ring: one persistently mapped range the CPU writes and
+	/// the GPU reads. The ring only deals in offsets, so it runs unchanged on host memory.
+	/// </summary>
+	class IUploadMemory
+	{
+	public:
+		virtual ~IUploadMemory() = default;
+
+		virtual std::uint8_t*	  GetCpuBase() const noexcept = 0;
+		virtual GpuVirtualAddress GetGpuBase() const noexcept = 0;
+		virtual std::uint64_t	  GetSize	() const noexcept = 0;
+	};
+
+	//~ plain heap memory with a made up GPU base, for headless runs and benchmarks
+	class HostUploadMemory final : public IUploadMemory
+	{
+	public:
+		static constexpr GpuVirtualAddress FAKE_GPU_BASE = 0x100000000ull;
+
+		explicit HostUploadMemory(std::uint64_t size) : m_bytes(static_cast<std::size_t>(size)) {}
+		~HostUploadMemory() override = default;
+
+		std::uint8_t*	  GetCpuBase() const noexcept override { return const_cast<std::uint8_t*>(m_bytes.data()); }
+		GpuVirtualAddress GetGpuBase() const noexcept override { return FAKE_GPU_BASE; }
+		std::uint64_t	  GetSize	() const noexcept override { return m_bytes.size(); }
+
+	private:
+		std::vector<std::uint8_t> m_bytes{};
+	};
+
+	typedef struct _UPLOAD_ALLOCATION
+	{
+		void*			  Cpu	{ nullptr };
+		GpuVirtualAddress Gpu	{ 0u };
+		std::uint64_t	  Offset{ UPLOAD_INVALID_OFFSET }; //~ from the start of the upload memory
+		std::uint64_t	  Size	{ 0u };
+
+		bool IsValid() const noexcept { return Offset != UPLOAD_INVALID_OFFSET; }
+	} UPLOAD_ALLOCATION;
+
+	typedef struct _UPLOAD_RING_STATS
+	{
+		std::uint64_t Capacity		   { 0u };
+		std::uint64_t Used			   { 0u }; //~ live blocks, wrap padding excluded
+		std::uint64_t PeakUsed		   { 0u };
+		std::uint32_t BlocksInFlight   { 0u };
+		std::uint32_t FailedAllocations{ 0u };
+	} UPLOAD_RING_STATS;
+
+	/// <summary>
+	/// Fence reclaimed ring over one upload memory. Blocks are handed out in FIFO order and
+	/// retired with the fence value of the frame that used them; the tail only moves past a
+	/// block once it is retired and its fence completed, so frames in flight may interleave
+	/// their blocks freely. Thread safe, the lock is only taken once per block.
+	/// </summary>
+	class UploadRing
+	{
+	public:
+		static constexpr std::uint64_t BLOCK_ALIGNMENT = UPLOAD_ALIGN_TEXTURE;
+
+		explicit UploadRing(IUploadMemory* memory);
+		~UploadRing() = default;
+
+		UploadRing(const UploadRing&) = delete;
+		UploadRing& operator=(const UploadRing&) = delete;
+
+		//~ UPLOAD_INVALID_OFFSET when the ring is full
+		std::uint64_t AllocateBlock(std::uint64_t size);
+		void		  RetireBlock  (std::uint64_t offset, std::uint64_t fence);
+		void		  Reclaim	   (std::uint64_t completedFence);
+
+		//~ Getters
+		IUploadMemory*	  GetMemory() const noexcept { return m_pMemory; }
+		UPLOAD_RING_STATS GetStats () const;
+
+	private:
+		typedef struct _RING_BLOCK
+		{
+			std::uint64_t Offset { 0u };
+			std::uint64_t Size	 { 0u };
+			std::uint64_t Fence	 { 0u };
+			bool		  Retired{ false };
+		} RING_BLOCK;
+
+	private:
+		IUploadMemory*		   m_pMemory  { nullptr };
+		std::uint64_t		   m_nCapacity{ 0u };
+		std::uint64_t		   m_nHead	  { 0u }; //~ next free byte
+		std::uint64_t		   m_nUsed	  { 0u };
+		std::uint64_t		   m_nPeak	  { 0u };
+		std::uint32_t		   m_nFailed  { 0u };
+		std::deque<RING_BLOCK> m_blocks	  {}; //~ allocation order, front is the tail
+		mutable std::mutex	   m_lock	  {};
+	};
+
+	/// <summary>
+	/// Per frame linear allocator on top of an UploadRing. Pulls blocks from the ring as it
+	/// fills and gives all of them back with the frame fence in Retire. Not thread safe,
+	/// a frame resource is only touched by one pipeline stage at a time.
+	/// </summary>
+	class LinearUploadAllocator
+	{
+	public:
+		static constexpr std::uint64_t DEFAULT_BLOCK_SIZE = 64u * 1024u;
+
+		explicit LinearUploadAllocator(UploadRing* ring, std::uint64_t blockSize = DEFAULT_BLOCK_SIZE);
+		~LinearUploadAllocator() = default;
+
+		LinearUploadAllocator(const LinearUploadAllocator&) = delete;
+		LinearUploadAllocator& operator=(const LinearUploadAllocator&) = delete;
+
+		//~ alignment is a power of two up to UploadRing::BLOCK_ALIGNMENT. Invalid when the ring is full
+		UPLOAD_ALLOCATION Allocate(std::uint64_t size, std::uint64_t alignment = UPLOAD_ALIGN_BUFFER);
+
+		//~ every block used since the last Retire is released once fence completes
+		void Retire(std::uint64_t fence);
+
+		//~ Getters
+		std::uint64_t GetAllocatedBytes() const noexcept { return m_nAllocatedBytes; }
+		std::uint32_t GetBlockCount	   () const noexcept { return static_cast<std::uint32_t>(m_blocks.size()); }
+
+	private:
+		UploadRing*				   m_pRing		   { nullptr };
+		std::uint64_t			   m_nBlockSize	   { 0u };
+		std::uint64_t			   m_nBlockOffset  { UPLOAD_INVALID_OFFSET }; //~ current block
+		std::uint64_t			   m_nBlockEnd	   { 0u };
+		std::uint64_t			   m_nCursor	   { 0u };
+		std::uint64_t			   m_nAllocatedBytes{ 0u };
+		std::vector<std::uint64_t> m_blocks		   {}; //~ offsets of the blocks held this frame
+	};
+} // namespace framework
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <algorithm>
+#include <cmath>
+
+namespace framework
+{
+	//~ axis aligned box stored as min/max, the layout the BVH works on
+	typedef struct _BOUNDING_BOX
+	{
+		DirectX::XMFLOAT3 Min{ 0.f, 0.f, 0.f };
+		DirectX::XMFLOAT3 Max{ 0.f, 0.f, 0.f };
+	} BOUNDING_BOX;
+
+	inline BOUNDING_BOX MakeBoundingBox(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extents) noexcept
+	{
+		return { { center.x - extents.x, center.y - extents.y, center.z - extents.z },
+				 { center.x + extents.x, center.y + extents.y, center.z + extents.z } };
+	}
+
+	//~ world box of a local center/extents box, center goes through the full matrix and
+	//~ extents through |upper 3x3| (Arvo). world uses row vectors
+	inline void TransformBounds(const DirectX::XMFLOAT3& localCenter,
+								const DirectX::XMFLOAT3& localExtents,
+								const DirectX::XMFLOAT4X4& world,
+								DirectX::XMFLOAT3& outCenter,
+								DirectX::XMFLOAT3& outExtents) noexcept
+	{
+		const auto& c = localCenter;
+		const auto& e = localExtents;
+		outCenter.x = c.x * world._11 + c.y * world._21 + c.z * world._31 + world._41;
+		outCenter.y = c.x * world._12 + c.y * world._22 + c.z * world._32 + world._42;
+		outCenter.z = c.x * world._13 + c.y * world._23 + c.z * world._33 + world._43;
+
+		outExtents.x = e.x * std::fabs(world._11) + e.y * std::fabs(world._21) + e.z * std::fabs(world._31);
+		outExtents.y = e.x * std::fabs(world._12) + e.y * std::fabs(world._22) + e.z * std::fabs(world._32);
+		outExtents.z = e.x * std::fabs(world._13) + e.y * std::fabs(world._23) + e.z * std::fabs(world._33);
+	}
+
+	inline BOUNDING_BOX Union(const BOUNDING_BOX& a, const BOUNDING_BOX& b) noexcept
+	{
+		return { { std::min(a.Min.x, b.Min.x), std::min(a.Min.y, b.Min.y), std::min(a.Min.z, b.Min.z) },
+				 { std::max(a.Max.x, b.Max.x), std::max(a.Max.y, b.Max.y), std::max(a.Max.z, b.Max.z) } };
+	}
+
+	inline bool Overlaps(const BOUNDING_BOX& a, const BOUNDING_BOX& b) noexcept
+	{
+		return a.Min.x <= b.Max.x && a.Max.x >= b.Min.x
+			&& a.Min.y <= b.Max.y && a.Max.y >= b.Min.y
+			&& a.Min.z <= b.Max.z && a.Max.z >= b.Min.z;
+	}
+
+	inline float SurfaceArea(const BOUNDING_BOX& box) noexcept
+	{
+		const float dx = box.Max.x - box.Min.x;
+		const float dy = box.Max.y - box.Min.y;
+		const float dz = box.Max.z - box.Min.z;
+		return (dx < 0.f || dy < 0.f || dz < 0.f) ? 0.f : 2.f * (dx * dy + dy * dz + dz * dx);
+	}
+
+	//~ inverted box, the identity for Union
+	inline BOUNDING_BOX EmptyBoundingBox() noexcept
+	{
+		constexpr float inf = 3.402823466e+38f;
+		return { { inf, inf, inf }, { -inf, -inf, -inf } };
+	}
+} // namespace framework
@@ -0,0 +1,629 @@
+#include "bvh.h"
+
+#include "utility/thread/job_system.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#if defined(_XM_SSE_INTRINSICS_)
+#include <xmmintrin.h>
+#endif
+
+using namespace framework;
+using namespace DirectX;
+
+namespace
+{
+	constexpr float nInfinity = std::numeric_limits<float>::infinity();
+
+	//~ deep enough for any tree the builder produces, every level pushes at most 3 extra nodes
+	constexpr std::size_t nStackSize = 256u;
+
+	inline float Axis(const XMFLOAT3& v, int axis) noexcept
+	{
+		return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+	}
+
+	inline bool BoxInFrustum(const FRUSTUM_PLANES& frustum, const BOUNDING_BOX& box) noexcept
+	{
+		const float cx = 0.5f * (box.Min.x + box.Max.x), ex = 0.5f * (box.Max.x - box.Min.x);
+		const float cy = 0.5f * (box.Min.y + box.Max.y), ey = 0.5f * (box.Max.y - box.Min.y);
+		const float cz = 0.5f * (box.Min.z + box.Max.z), ez = 0.5f * (box.Max.z - box.Min.z);
+		for (const auto& p : frustum.Planes)
+		{
+			const float d = p.x * cx + p.y * cy + p.z * cz + p.w;
+			const float r = std::fabs(p.x) * ex + std::fabs(p.y) * ey + std::fabs(p.z) * ez;
+			if (d + r < 0.f) return false;
+		}
+		return true;
+	}
+
+	inline bool RayBox(const XMFLOAT3& origin, const XMFLOAT3& invDir, float maxT, const BOUNDING_BOX& box, float& tNear) noexcept
+	{
+		const float tx1 = (box.Min.x - origin.x) * invDir.x, tx2 = (box.Max.x - origin.x) * invDir.x;
+		const float ty1 = (box.Min.y - origin.y) * invDir.y, ty2 = (box.Max.y - origin.y) * invDir.y;
+		const float tz1 = (box.Min.z - origin.z) * invDir.z, tz2 = (box.Max.z - origin.z) * invDir.z;
+
+		const float t0 = std::max({ std::min(tx1, tx2), std::min(ty1, ty2), std::min(tz1, tz2), 0.f });
+		const float t1 = std::min({ std::max(tx1, tx2), std::max(ty1, ty2), std::max(tz1, tz2), maxT });
+		tNear = t0;
+		return t0 <= t1;
+	}
+
+	//~ per node tests, bit i set when child i passes. Empty slots are filtered by the caller
+#if defined(_XM_SSE_INTRINSICS_)
+	inline int NodeFrustumMask(const Bvh4Node& node, const FRUSTUM_PLANES& frustum) noexcept
+	{
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 minX = _mm_load_ps(node.MinX), maxX = _mm_load_ps(node.MaxX);
+		const __m128 minY = _mm_load_ps(node.MinY), maxY = _mm_load_ps(node.MaxY);
+		const __m128 minZ = _mm_load_ps(node.MinZ), maxZ = _mm_load_ps(node.MaxZ);
+
+		const __m128 cx = _mm_mul_ps(_mm_add_ps(minX, maxX), half), ex = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+		const __m128 cy = _mm_mul_ps(_mm_add_ps(minY, maxY), half), ey = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+		const __m128 cz = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half), ez = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+		__m128 outside = _mm_setzero_ps();
+		for (const auto& p : frustum.Planes)
+		{
+			const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.x), cx), _mm_mul_ps(_mm_set1_ps(p.y), cy)),
+										_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.z), cz), _mm_set1_ps(p.w)));
+			const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::fabs(p.x)), ex),
+												   _mm_mul_ps(_mm_set1_ps(std::fabs(p.y)), ey)),
+										_mm_mul_ps(_mm_set1_ps(std::fabs(p.z)), ez));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(d, r), _mm_setzero_ps()));
+		}
+		return ~_mm_movemask_ps(outside) & 0xf;
+	}
+
+	inline int NodeBoxMask(const Bvh4Node& node, const BOUNDING_BOX& box) noexcept
+	{
+		__m128 hit = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(node.MinX), _mm_set1_ps(box.Max.x)),
+								_mm_cmpge_ps(_mm_load_ps(node.MaxX), _mm_set1_ps(box.Min.x)));
+		hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmple_ps(_mm_load_ps(node.MinY), _mm_set1_ps(box.Max.y)),
+										 _mm_cmpge_ps(_mm_load_ps(node.MaxY), _mm_set1_ps(box.Min.y))));
+		hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmple_ps(_mm_load_ps(node.MinZ), _mm_set1_ps(box.Max.z)),
+										 _mm_cmpge_ps(_mm_load_ps(node.MaxZ), _mm_set1_ps(box.Min.z))));
+		return _mm_movemask_ps(hit);
+	}
+
+	inline int NodeRayMask(const Bvh4Node& node, const XMFLOAT3& origin, const XMFLOAT3& invDir, float maxT, float (&tNear)[ 4 ]) noexcept
+	{
+		const __m128 ox = _mm_set1_ps(origin.x), ix = _mm_set1_ps(invDir.x);
+		const __m128 oy = _mm_set1_ps(origin.y), iy = _mm_set1_ps(invDir.y);
+		const __m128 oz = _mm_set1_ps(origin.z), iz = _mm_set1_ps(invDir.z);
+
+		const __m128 tx1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MinX), ox), ix);
+		const __m128 tx2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MaxX), ox), ix);
+		const __m128 ty1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MinY), oy), iy);
+		const __m128 ty2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MaxY), oy), iy);
+		const __m128 tz1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MinZ), oz), iz);
+		const __m128 tz2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MaxZ), oz), iz);
+
+		__m128 t0 = _mm_max_ps(_mm_min_ps(tx1, tx2), _mm_setzero_ps());
+		t0 = _mm_max_ps(t0, _mm_min_ps(ty1, ty2));
+		t0 = _mm_max_ps(t0, _mm_min_ps(tz1, tz2));
+
+		__m128 t1 = _mm_min_ps(_mm_max_ps(tx1, tx2), _mm_set1_ps(maxT));
+		t1 = _mm_min_ps(t1, _mm_max_ps(ty1, ty2));
+		t1 = _mm_min_ps(t1, _mm_max_ps(tz1, tz2));
+
+		_mm_storeu_ps(tNear, t0);
+		return _mm_movemask_ps(_mm_cmple_ps(t0, t1));
+	}
+#else
+	inline BOUNDING_BOX ChildBox(const Bvh4Node& node, int i) noexcept
+	{
+		return { { node.MinX[ i ], node.MinY[ i ], node.MinZ[ i ] }, { node.MaxX[ i ], node.MaxY[ i ], node.MaxZ[ i ] } };
+	}
+
+	inline int NodeFrustumMask(const Bvh4Node& node, const FRUSTUM_PLANES& frustum) noexcept
+	{
+		int mask = 0;
+		for (int i = 0; i < 4; ++i) mask |= BoxInFrustum(frustum, ChildBox(node, i)) ? (1 << i) : 0;
+		return mask;
+	}
+
+	inline int NodeBoxMask(const Bvh4Node& node, const BOUNDING_BOX& box) noexcept
+	{
+		int mask = 0;
+		for (int i = 0; i < 4; ++i) mask |= Overlaps(ChildBox(node, i), box) ? (1 << i) : 0;
+		return mask;
+	}
+
+	inline int NodeRayMask(const Bvh4Node& node, const XMFLOAT3& origin, const XMFLOAT3& invDir, float maxT, float (&tNear)[ 4 ]) noexcept
+	{
+		int mask = 0;
+		for (int i = 0; i < 4; ++i) mask |= RayBox(origin, invDir, maxT, ChildBox(node, i), tNear[ i ]) ? (1 << i) : 0;
+		return mask;
+	}
+#endif
+} // namespace
+
+//~ Build
+
+void framework::Bvh4::Build(const std::vector<BOUNDING_BOX>& bounds, JobSystem* jobs, std::uint32_t minParallelCount)
+{
+	const auto count = static_cast<std::uint32_t>(bounds.size());
+
+	m_bounds = bounds;
+	m_centroids.resize(count);
+	m_primitives.resize(count);
+	for (std::uint32_t i = 0u; i < count; ++i)
+	{
+		const auto& box = bounds[ i ];
+		m_centroids[ i ]  = { 0.5f * (box.Min.x + box.Max.x), 0.5f * (box.Min.y + box.Max.y), 0.5f * (box.Min.z + box.Max.z) };
+		m_primitives[ i ] = i;
+	}
+
+	m_nodes.clear();
+	m_bAnyDirty = false;
+	if (count == 0u)
+	{
+		m_dirty.clear();
+		m_objectNode.clear();
+		return;
+	}
+
+	if (!jobs || count < minParallelCount)
+	{
+		BuildSubtree(m_nodes, { 0u, count }, BVH_INVALID);
+	}
+	else
+	{
+		//~ top two levels on this thread, every range below them is an independent task.
+		//~ Tasks only reorder their own slice of m_primitives
+		typedef struct _SUBTREE_TASK
+		{
+			BUILD_RANGE			  Range{};
+			std::uint32_t		  Parent{ BVH_INVALID };
+			std::uint32_t		  Slot	{ 0u };
+			std::vector<Bvh4Node> Nodes {};
+		} SUBTREE_TASK;
+		std::vector<SUBTREE_TASK> tasks{};
+
+		std::vector<std::pair<BUILD_RANGE, std::uint32_t>> level{ { { 0u, count }, BVH_INVALID } };
+		for (int depth = 0; depth < 2; ++depth)
+		{
+			std::vector<std::pair<BUILD_RANGE, std::uint32_t>> next{};
+			for (const auto& [ range, parentSlot ] : level)
+			{
+				const auto nodeIndex = static_cast<std::uint32_t>(m_nodes.size());
+				m_nodes.emplace_back();
+				InitNode(m_nodes.back(), parentSlot == BVH_INVALID ? BVH_INVALID : (parentSlot >> 2u));
+				if (parentSlot != BVH_INVALID) m_nodes[ parentSlot >> 2u ].Child[ parentSlot & 3u ] = nodeIndex;
+
+				BUILD_RANGE children[ 4 ]{};
+				const std::uint32_t childCount = PartitionNode(range, children);
+				for (std::uint32_t slot = 0u; slot < childCount; ++slot)
+				{
+					const auto& child = children[ slot ];
+					SetChildBox(m_nodes[ nodeIndex ], slot, RangeBounds(child));
+
+					const std::uint32_t size = child.End - child.Begin;
+					if (size <= MAX_LEAF_SIZE)
+					{
+						m_nodes[ nodeIndex ].Child[ slot ] = child.Begin;
+						m_nodes[ nodeIndex ].Count[ slot ] = static_cast<std::uint8_t>(size);
+					}
+					else if (depth + 1 < 2)
+					{
+						next.push_back({ child, (nodeIndex << 2u) | slot });
+					}
+					else
+					{
+						tasks.push_back({ child, nodeIndex, slot, {} });
+					}
+				}
+			}
+			level = std::move(next);
+		}
+
+		jobs->ParallelFor(static_cast<std::uint32_t>(tasks.size()), 1u, [&](std::uint32_t b, std::uint32_t e)
+		{
+			for (std::uint32_t t = b; t < e; ++t)
+			{
+				tasks[ t ].Nodes.reserve((tasks[ t ].Range.End - tasks[ t ].Range.Begin) / 2u);
+				BuildSubtree(tasks[ t ].Nodes, tasks[ t ].Range, BVH_INVALID);
+			}
+		});
+
+		//~ stitch, subtrees are appended after the top levels so parents still precede children
+		for (auto& task : tasks)
+		{
+			const auto offset = static_cast<std::uint32_t>(m_nodes.size());
+			for (auto& node : task.Nodes)
+			{
+				node.Parent = node.Parent == BVH_INVALID ? task.Parent : node.Parent + offset;
+				for (int i = 0; i < 4; ++i)
+				{
+					if (node.Child[ i ] != BVH_INVALID && node.Count[ i ] == 0u) node.Child[ i ] += offset;
+				}
+			}
+			m_nodes[ task.Parent ].Child[ task.Slot ] = offset;
+			m_nodes.insert(m_nodes.end(), task.Nodes.begin(), task.Nodes.end());
+		}
+	}
+
+	m_dirty.assign(m_nodes.size(), 0u);
+	LinkObjects();
+}
+
+std::uint32_t framework::Bvh4::BuildSubtree(std::vector<Bvh4Node>& nodes, BUILD_RANGE range, std::uint32_t parent)
+{
+	const auto nodeIndex = static_cast<std::uint32_t>(nodes.size());
+	nodes.emplace_back();
+	InitNode(nodes.back(), parent);
+
+	BUILD_RANGE children[ 4 ]{};
+	const std::uint32_t childCount = PartitionNode(range, children);
+
+	for (std::uint32_t slot = 0u; slot < childCount; ++slot)
+	{
+		const auto& child = children[ slot ];
+		SetChildBox(nodes[ nodeIndex ], slot, RangeBounds(child));
+
+		const std::uint32_t size = child.End - child.Begin;
+		if (size <= MAX_LEAF_SIZE)
+		{
+			nodes[ nodeIndex ].Child[ slot ] = child.Begin;
+			nodes[ nodeIndex ].Count[ slot ] = static_cast<std::uint8_t>(size);
+		}
+		else
+		{
+			//~ recursion may grow nodes, index again afterwards
+			const std::uint32_t childIndex = BuildSubtree(nodes, child, nodeIndex);
+			nodes[ nodeIndex ].Child[ slot ] = childIndex;
+		}
+	}
+	return nodeIndex;
+}
+
+std::uint32_t framework::Bvh4::PartitionNode(BUILD_RANGE range, BUILD_RANGE (&children)[ 4 ])
+{
+	//~ split the largest splittable range until four children, a binary SAH tree
+	//~ collapsed two levels at a time
+	std::uint32_t count = 1u;
+	children[ 0 ] = range;
+
+	while (count < 4u)
+	{
+		std::uint32_t best = BVH_INVALID;
+		std::uint32_t bestSize = MAX_LEAF_SIZE;
+		for (std::uint32_t i = 0u; i < count; ++i)
+		{
+			const std::uint32_t size = children[ i ].End - children[ i ].Begin;
+			if (size > bestSize)
+			{
+				best	 = i;
+				bestSize = size;
+			}
+		}
+		if (best == BVH_INVALID) break;
+
+		const BUILD_RANGE split = children[ best ];
+		const std::uint32_t mid = SplitRange(split);
+		children[ best ]	= { split.Begin, mid };
+		children[ count++ ] = { mid, split.End };
+	}
+	return count;
+}
+
+std::uint32_t framework::Bvh4::SplitRange(BUILD_RANGE range)
+{
+	const std::uint32_t size = range.End - range.Begin;
+
+	XMFLOAT3 cMin{ nInfinity, nInfinity, nInfinity };
+	XMFLOAT3 cMax{ -nInfinity, -nInfinity, -nInfinity };
+	for (std::uint32_t i = range.Begin; i < range.End; ++i)
+	{
+		const auto& c = m_centroids[ m_primitives[ i ] ];
+		cMin = { std::min(cMin.x, c.x), std::min(cMin.y, c.y), std::min(cMin.z, c.z) };
+		cMax = { std::max(cMax.x, c.x), std::max(cMax.y, c.y), std::max(cMax.z, c.z) };
+	}
+
+	const float extents[ 3 ]{ cMax.x - cMin.x, cMax.y - cMin.y, cMax.z - cMin.z };
+	const int axis = extents[ 0 ] > extents[ 1 ] ? (extents[ 0 ] > extents[ 2 ] ? 0 : 2) : (extents[ 1 ] > extents[ 2 ] ? 1 : 2);
+
+	auto* first = m_primitives.data() + range.Begin;
+	auto* last	= m_primitives.data() + range.End;
+	auto median = [&]()
+	{
+		auto* nth = first + size / 2u;
+		std::nth_element(first, nth, last, [&](std::uint32_t a, std::uint32_t b)
+		{
+			return Axis(m_centroids[ a ], axis) < Axis(m_centroids[ b ], axis);
+		});
+		return range.Begin + size / 2u;
+	};
+
+	//~ every centroid in one spot, SAH cannot separate them
+	if (!(extents[ axis ] > 0.f)) return median();
+
+	const float origin = Axis(cMin, axis);
+	const float scale  = static_cast<float>(BIN_COUNT) / extents[ axis ];
+	auto binOf = [&](std::uint32_t object)
+	{
+		const auto bin = static_cast<std::uint32_t>((Axis(m_centroids[ object ], axis) - origin) * scale);
+		return std::min(bin, BIN_COUNT - 1u);
+	};
+
+	std::array<BOUNDING_BOX, BIN_COUNT>	 binBounds{};
+	std::array<std::uint32_t, BIN_COUNT> binCounts{};
+	binBounds.fill(EmptyBoundingBox());
+	for (std::uint32_t i = range.Begin; i < range.End; ++i)
+	{
+		const auto object = m_primitives[ i ];
+		const auto bin	  = binOf(object);
+		binBounds[ bin ] = Union(binBounds[ bin ], m_bounds[ object ]);
+		++binCounts[ bin ];
+	}
+
+	//~ sweep from the right, then evaluate every plane from the left
+	std::array<float, BIN_COUNT> rightCost{};
+	BOUNDING_BOX  accumulated = EmptyBoundingBox();
+	std::uint32_t rightCount  = 0u;
+	for (std::uint32_t bin = BIN_COUNT - 1u; bin > 0u; --bin)
+	{
+		accumulated = Union(accumulated, binBounds[ bin ]);
+		rightCount += binCounts[ bin ];
+		rightCost[ bin ] = SurfaceArea(accumulated) * static_cast<float>(rightCount);
+	}
+
+	float		  bestCost  = nInfinity;
+	std::uint32_t bestPlane = 0u;
+	std::uint32_t leftCount = 0u;
+	accumulated = EmptyBoundingBox();
+	for (std::uint32_t plane = 1u; plane < BIN_COUNT; ++plane)
+	{
+		accumulated = Union(accumulated, binBounds[ plane - 1u ]);
+		leftCount  += binCounts[ plane - 1u ];
+		if (leftCount == 0u || leftCount == size) continue;
+
+		const float cost = SurfaceArea(accumulated) * static_cast<float>(leftCount) + rightCost[ plane ];
+		if (cost < bestCost)
+		{
+			bestCost  = cost;
+			bestPlane = plane;
+		}
+	}
+	if (bestPlane == 0u) return median();
+
+	auto* mid = std::partition(first, last, [&](std::uint32_t object) { return binOf(object) < bestPlane; });
+	return range.Begin + static_cast<std::uint32_t>(mid - first);
+}
+
+BOUNDING_BOX framework::Bvh4::RangeBounds(BUILD_RANGE range) const noexcept
+{
+	BOUNDING_BOX box = EmptyBoundingBox();
+	for (std::uint32_t i = range.Begin; i < range.End; ++i)
+	{
+		box = Union(box, m_bounds[ m_primitives[ i ] ]);
+	}
+	return box;
+}
+
+BOUNDING_BOX framework::Bvh4::NodeBounds(const Bvh4Node& node) const noexcept
+{
+	BOUNDING_BOX box = EmptyBoundingBox();
+	for (int i = 0; i < 4; ++i)
+	{
+		if (node.Child[ i ] == BVH_INVALID) continue;
+		box = Union(box, { { node.MinX[ i ], node.MinY[ i ], node.MinZ[ i ] }, { node.MaxX[ i ], node.MaxY[ i ], node.MaxZ[ i ] } });
+	}
+	return box;
+}
+
+BOUNDING_BOX framework::Bvh4::GetRootBounds() const noexcept
+{
+	return m_nodes.empty() ? BOUNDING_BOX{} : NodeBounds(m_nodes[ 0 ]);
+}
+
+void framework::Bvh4::LinkObjects() noexcept
+{
+	m_objectNode.assign(m_bounds.size(), BVH_INVALID);
+	for (std::uint32_t n = 0u; n < GetNodeCount(); ++n)
+	{
+		const auto& node = m_nodes[ n ];
+		for (int i = 0; i < 4; ++i)
+		{
+			if (node.Child[ i ] == BVH_INVALID || node.Count[ i ] == 0u) continue;
+			for (std::uint32_t p = node.Child[ i ]; p < node.Child[ i ] + node.Count[ i ]; ++p)
+			{
+				m_objectNode[ m_primitives[ p ] ] = n;
+			}
+		}
+	}
+}
+
+void framework::Bvh4::InitNode(Bvh4Node& node, std::uint32_t parent) noexcept
+{
+	for (std::uint32_t i = 0u; i < 4u; ++i)
+	{
+		SetChildBox(node, i, EmptyBoundingBox());
+		node.Child[ i ] = BVH_INVALID;
+		node.Count[ i ] = 0u;
+	}
+	node.Parent = parent;
+}
+
+void framework::Bvh4::SetChildBox(Bvh4Node& node, std::uint32_t slot, const BOUNDING_BOX& box) noexcept
+{
+	node.MinX[ slot ] = box.Min.x;
+	node.MinY[ slot ] = box.Min.y;
+	node.MinZ[ slot ] = box.Min.z;
+	node.MaxX[ slot ] = box.Max.x;
+	node.MaxY[ slot ] = box.Max.y;
+	node.MaxZ[ slot ] = box.Max.z;
+}
+
+//~ Refit
+
+void framework::Bvh4::UpdateBounds(std::uint32_t object, const BOUNDING_BOX& box) noexcept
+{
+	assert(object < m_bounds.size() && "BVH object out of range!");
+	m_bounds[ object ] = box;
+
+	//~ an already dirty node means its whole path to the root is dirty too
+	for (std::uint32_t node = m_objectNode[ object ]; node != BVH_INVALID && !m_dirty[ node ]; node = m_nodes[ node ].Parent)
+	{
+		m_dirty[ node ] = 1u;
+	}
+	m_bAnyDirty = true;
+}
+
+void framework::Bvh4::Refit() noexcept
+{
+	if (!m_bAnyDirty) return;
+
+	//~ children always live after their parent, so walking backwards refits bottom up
+	for (std::uint32_t n = GetNodeCount(); n-- > 0u;)
+	{
+		if (!m_dirty[ n ]) continue;
+
+		auto& node = m_nodes[ n ];
+		for (std::uint32_t i = 0u; i < 4u; ++i)
+		{
+			if (node.Child[ i ] == BVH_INVALID) continue;
+
+			const BOUNDING_BOX box = node.Count[ i ]
+				? RangeBounds({ node.Child[ i ], node.Child[ i ] + node.Count[ i ] })
+				: NodeBounds(m_nodes[ node.Child[ i ] ]);
+			SetChildBox(node, i, box);
+		}
+		m_dirty[ n ] = 0u;
+	}
+	m_bAnyDirty = false;
+}
+
+//~ Queries
+
+void framework::Bvh4::QueryFrustum(const FRUSTUM_PLANES& frustum, std::vector<std::uint32_t>& out) const
+{
+	if (m_nodes.empty()) return;
+
+	std::uint32_t stack[ nStackSize ];
+	std::size_t	  top = 0u;
+	stack[ top++ ] = 0u;
+
+	while (top)
+	{
+		const auto& node = m_nodes[ stack[ --top ] ];
+		const int	mask = NodeFrustumMask(node, frustum);
+
+		for (int i = 0; i < 4; ++i)
+		{
+			if (!(mask & (1 << i)) || node.Child[ i ] == BVH_INVALID) continue;
+
+			if (node.Count[ i ] == 0u)
+			{
+				assert(top < nStackSize && "BVH traversal stack overflow!");
+				stack[ top++ ] = node.Child[ i ];
+				continue;
+			}
+			for (std::uint32_t p = node.Child[ i ]; p < node.Child[ i ] + node.Count[ i ]; ++p)
+			{
+				const auto object = m_primitives[ p ];
+				if (BoxInFrustum(frustum, m_bounds[ object ])) out.push_back(object);
+			}
+		}
+	}
+}
+
+void framework::Bvh4::QueryBox(const BOUNDING_BOX& box, std::vector<std::uint32_t>& out) const
+{
+	if (m_nodes.empty()) return;
+
+	std::uint32_t stack[ nStackSize ];
+	std::size_t	  top = 0u;
+	stack[ top++ ] = 0u;
+
+	while (top)
+	{
+		const auto& node = m_nodes[ stack[ --top ] ];
+		const int	mask = NodeBoxMask(node, box);
+
+		for (int i = 0; i < 4; ++i)
+		{
+			if (!(mask & (1 << i)) || node.Child[ i ] == BVH_INVALID) continue;
+
+			if (node.Count[ i ] == 0u)
+			{
+				assert(top < nStackSize && "BVH traversal stack overflow!");
+				stack[ top++ ] = node.Child[ i ];
+				continue;
+			}
+			for (std::uint32_t p = node.Child[ i ]; p < node.Child[ i ] + node.Count[ i ]; ++p)
+			{
+				const auto object = m_primitives[ p ];
+				if (Overlaps(m_bounds[ object ], box)) out.push_back(object);
+			}
+		}
+	}
+}
+
+bool framework::Bvh4::Raycast(const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance, BVH_RAY_HIT& hit) const
+{
+	hit = {};
+	if (m_nodes.empty()) return false;
+
+	//~ 1/0 gives +-inf which the slab test handles, keep the sign of zero components
+	const XMFLOAT3 invDir{ 1.f / direction.x, 1.f / direction.y, 1.f / direction.z };
+
+	float best = maxDistance;
+
+	typedef struct _STACK_ENTRY
+	{
+		std::uint32_t Node;
+		float		  Near;
+	} STACK_ENTRY;
+	STACK_ENTRY stack[ nStackSize ];
+	std::size_t top = 0u;
+	stack[ top++ ] = { 0u, 0.f };
+
+	while (top)
+	{
+		const auto entry = stack[ --top ];
+		if (entry.Near > best) continue; //~ a closer hit was found after this was pushed
+
+		const auto& node = m_nodes[ entry.Node ];
+		float tNear[ 4 ];
+		const int mask = NodeRayMask(node, origin, invDir, best, tNear);
+		for (int i = 0; i < 4; ++i)
+		{
+			if (!(mask & (1 << i))) tNear[ i ] = -nInfinity; //~ misses may hold NaN, keep the sort well ordered
+		}
+
+		//~ push far children first so the nearest one is traversed next
+		int order[ 4 ]{ 0, 1, 2, 3 };
+		std::sort(order, order + 4, [&](int a, int b) { return tNear[ a ] > tNear[ b ]; });
+
+		for (int k = 0; k < 4; ++k)
+		{
+			const int i = order[ k ];
+			if (!(mask & (1 << i)) || node.Child[ i ] == BVH_INVALID) continue;
+
+			if (node.Count[ i ] == 0u)
+			{
+				assert(top < nStackSize && "BVH traversal stack overflow!");
+				stack[ top++ ] = { node.Child[ i ], tNear[ i ] };
+				continue;
+			}
+			for (std::uint32_t p = node.Child[ i ]; p < node.Child[ i ] + node.Count[ i ]; ++p)
+			{
+				const auto object = m_primitives[ p ];
+				float t = 0.f;
+				if (RayBox(origin, invDir, best, m_bounds[ object ], t) && t < best)
+				{
+					best		 = t;
+					hit.Object	 = object;
+					hit.Distance = t;
+				}
+			}
+		}
+	}
+	return hit.Object != BVH_INVALID;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "bounds.h"
+#include "frustum_culler.h"
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+namespace framework
+{
+	class JobSystem;
+
+	inline constexpr std::uint32_t BVH_INVALID = 0xffffffffu;
+
+	//~ four children per node, the child boxes are stored as SoA so a node tests all
+	//~ four against a ray/plane/box at once. Two cache lines per node
+	struct alignas(64) Bvh4Node
+	{
+		float MinX[ 4 ];
+		float MinY[ 4 ];
+		float MinZ[ 4 ];
+		float MaxX[ 4 ];
+		float MaxY[ 4 ];
+		float MaxZ[ 4 ];
+
+		std::uint32_t Child[ 4 ];		   //~ node index, first primitive of a leaf or BVH_INVALID
+		std::uint8_t  Count[ 4 ];		   //~ primitives of a leaf child, 0 for inner children
+		std::uint32_t Parent{ BVH_INVALID };
+	};
+	static_assert(sizeof(Bvh4Node) == 128u, "Bvh4Node should stay two cache lines");
+
+	typedef struct _BVH_RAY_HIT
+	{
+		std::uint32_t Object  { BVH_INVALID };
+		float		  Distance{ 0.f };
+	} BVH_RAY_HIT;
+
+	/// <summary>
+	/// 4-wide bounding volume hierarchy over object boxes. Built top down with binned SAH,
+	/// optionally with the subtrees below the top two levels built in parallel. Moving
+	/// objects only refit the nodes on their path to the root, a rebuild is needed when
+	/// the tree quality degrades (objects travelling far from where they were built).
+	/// </summary>
+	class Bvh4
+	{
+	public:
+		static constexpr std::uint32_t MAX_LEAF_SIZE = 4u;
+		static constexpr std::uint32_t BIN_COUNT	 = 16u;
+
+		Bvh4() = default;
+		~Bvh4() = default;
+
+		Bvh4(const Bvh4&) = delete;
+		Bvh4& operator=(const Bvh4&) = delete;
+
+		//~ bounds[i] is object i. jobs may be null to build on the calling thread
+		void Build(const std::vector<BOUNDING_BOX>& bounds,
+				   JobSystem* jobs = nullptr,
+				   std::uint32_t minParallelCount = 16384u);
+
+		//~ incremental refit: update any number of objects, then Refit once
+		void UpdateBounds(std::uint32_t object, const BOUNDING_BOX& box) noexcept;
+		void Refit		 () noexcept;
+
+		//~ queries append object ids to out
+		void QueryFrustum(const FRUSTUM_PLANES& frustum, std::vector<std::uint32_t>& out) const;
+		void QueryBox	 (const BOUNDING_BOX& box,		 std::vector<std::uint32_t>& out) const;
+
+		//~ nearest object box hit along the ray, direction does not need to be normalized
+		//~ (Distance is then in units of its length)
+		bool Raycast(const DirectX::XMFLOAT3& origin,
+					 const DirectX::XMFLOAT3& direction,
+					 float maxDistance,
+					 BVH_RAY_HIT& hit) const;
+
+		//~ Getters
+		bool						  IsEmpty		() const noexcept { return m_nodes.empty(); }
+		std::uint32_t				  GetNodeCount	() const noexcept { return static_cast<std::uint32_t>(m_nodes.size()); }
+		std::uint32_t				  GetObjectCount() const noexcept { return static_cast<std::uint32_t>(m_bounds.size()); }
+		const std::vector<Bvh4Node>&  GetNodes		() const noexcept { return m_nodes; }
+		const BOUNDING_BOX&			  GetBounds		(std::uint32_t object) const noexcept { return m_bounds[ object ]; }
+		BOUNDING_BOX				  GetRootBounds () const noexcept;
+
+	private:
+		typedef struct _BUILD_RANGE
+		{
+			std::uint32_t Begin{ 0u };
+			std::uint32_t End  { 0u };
+		} BUILD_RANGE;
+
+		std::uint32_t BuildSubtree	(std::vector<Bvh4Node>& nodes, BUILD_RANGE range, std::uint32_t parent);
+		std::uint32_t PartitionNode (BUILD_RANGE range, BUILD_RANGE (&children)[ 4 ]);
+		std::uint32_t SplitRange	(BUILD_RANGE range);
+		BOUNDING_BOX  RangeBounds	(BUILD_RANGE range) const noexcept;
+		BOUNDING_BOX  NodeBounds	(const Bvh4Node& node) const noexcept;
+		void		  LinkObjects	() noexcept;
+
+		static void InitNode	 (Bvh4Node& node, std::uint32_t parent) noexcept;
+		static void SetChildBox	 (Bvh4Node& node, std::uint32_t slot, const BOUNDING_BOX& box) noexcept;
+
+	private:
+		std::vector<BOUNDING_BOX>	   m_bounds	   {}; //~ per object
+		std::vector<DirectX::XMFLOAT3> m_centroids {}; //~ per object, build only
+		std::vector<std::uint32_t>	   m_primitives{}; //~ leaf order -> object
+		std::vector<std::uint32_t>	   m_objectNode{}; //~ object -> node holding its leaf
+		std::vector<Bvh4Node>		   m_nodes	   {}; //~ a parent always precedes its children
+		std::vector<std::uint8_t>	   m_dirty	   {}; //~ per node, pending refit
+		bool						   m_bAnyDirty { false };
+	};
+} // namespace framework
@@ -0,0 +1,173 @@
+#include "bvh_benchmark.h"
+#include "bvh.h"
+
+#include "utility/logger/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace framework;
+using namespace DirectX;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	constexpr std::uint32_t nQueryCount = 256u;
+
+	BOUNDING_BOX RandomBox(std::mt19937& rng, float halfWorld)
+	{
+		std::uniform_real_distribution<float> position(-halfWorld, halfWorld);
+		std::uniform_real_distribution<float> size(0.25f, 2.0f);
+		return MakeBoundingBox({ position(rng), position(rng), position(rng) }, { size(rng), size(rng), size(rng) });
+	}
+
+	//~ axis aligned view volume around center, the planes face inwards like ExtractFrustumPlanes
+	FRUSTUM_PLANES BoxFrustum(const XMFLOAT3& center, float halfSize)
+	{
+		FRUSTUM_PLANES frustum{};
+		frustum.Planes[ 0 ] = {  1.f,  0.f,  0.f, halfSize - center.x };
+		frustum.Planes[ 1 ] = { -1.f,  0.f,  0.f, halfSize + center.x };
+		frustum.Planes[ 2 ] = {  0.f,  1.f,  0.f, halfSize - center.y };
+		frustum.Planes[ 3 ] = {  0.f, -1.f,  0.f, halfSize + center.y };
+		frustum.Planes[ 4 ] = {  0.f,  0.f,  1.f, halfSize - center.z };
+		frustum.Planes[ 5 ] = {  0.f,  0.f, -1.f, halfSize + center.z };
+		return frustum;
+	}
+
+	float LinearRaycast(const std::vector<BOUNDING_BOX>& bounds, const XMFLOAT3& origin, const XMFLOAT3& direction)
+	{
+		const XMFLOAT3 inv{ 1.f / direction.x, 1.f / direction.y, 1.f / direction.z };
+		float best = std::numeric_limits<float>::infinity();
+		for (const auto& box : bounds)
+		{
+			const float tx1 = (box.Min.x - origin.x) * inv.x, tx2 = (box.Max.x - origin.x) * inv.x;
+			const float ty1 = (box.Min.y - origin.y) * inv.y, ty2 = (box.Max.y - origin.y) * inv.y;
+			const float tz1 = (box.Min.z - origin.z) * inv.z, tz2 = (box.Max.z - origin.z) * inv.z;
+
+			const float t0 = std::max({ std::min(tx1, tx2), std::min(ty1, ty2), std::min(tz1, tz2), 0.f });
+			const float t1 = std::min({ std::max(tx1, tx2), std::max(ty1, ty2), std::max(tz1, tz2) });
+			if (t0 <= t1 && t0 < best) best = t0;
+		}
+		return best;
+	}
+} // namespace
+
+std::vector<BVH_BENCHMARK_RESULT> framework::RunBvhBenchmark(
+	JobSystem* jobs,
+	const std::vector<std::uint32_t>& objectCounts,
+	std::uint32_t iterations)
+{
+	iterations = iterations ? iterations : 1u;
+
+	std::vector<BVH_BENCHMARK_RESULT> results{};
+	results.reserve(objectCounts.size());
+
+	for (auto count : objectCounts)
+	{
+		std::mt19937 rng{ 1234u };
+		const float halfWorld = 4.f * std::cbrt(static_cast<float>(count));
+
+		std::vector<BOUNDING_BOX> bounds(count);
+		for (auto& box : bounds) box = RandomBox(rng, halfWorld);
+
+		BVH_BENCHMARK_RESULT result{};
+		result.ObjectCount = count;
+
+		Bvh4 bvh{};
+		for (std::uint32_t it = 0u; it < iterations; ++it)
+		{
+			auto start = Clock::now();
+			bvh.Build(bounds);
+			result.BuildMs += ElapsedMs(start);
+
+			start = Clock::now();
+			bvh.Build(bounds, jobs, 0u);
+			result.ParallelBuildMs += ElapsedMs(start);
+		}
+		result.NodeCount = bvh.GetNodeCount();
+
+		//~ small moves, the case refit is meant for
+		std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+		for (std::uint32_t it = 0u; it < iterations; ++it)
+		{
+			for (std::uint32_t i = it % 10u; i < count; i += 10u)
+			{
+				const XMFLOAT3 offset{ jitter(rng), jitter(rng), jitter(rng) };
+				auto& box = bounds[ i ];
+				box.Min = { box.Min.x + offset.x, box.Min.y + offset.y, box.Min.z + offset.z };
+				box.Max = { box.Max.x + offset.x, box.Max.y + offset.y, box.Max.z + offset.z };
+				bvh.UpdateBounds(i, box);
+			}
+
+			const auto start = Clock::now();
+			bvh.Refit();
+			result.RefitMs += ElapsedMs(start);
+		}
+
+		result.BuildMs		   /= iterations;
+		result.ParallelBuildMs /= iterations;
+		result.RefitMs		   /= iterations;
+
+		std::uniform_real_distribution<float> position(-halfWorld, halfWorld);
+		std::uniform_real_distribution<float> direction(-1.f, 1.f);
+		std::vector<std::uint32_t> hits{};
+		hits.reserve(count);
+
+		double linearMs = 0.0;
+		for (std::uint32_t q = 0u; q < nQueryCount; ++q)
+		{
+			const XMFLOAT3 center{ position(rng), position(rng), position(rng) };
+
+			hits.clear();
+			auto start = Clock::now();
+			bvh.QueryFrustum(BoxFrustum(center, 16.f), hits);
+			result.FrustumQueryUs += ElapsedMs(start) * 1000.0;
+
+			hits.clear();
+			const BOUNDING_BOX query = MakeBoundingBox(center, { 8.f, 8.f, 8.f });
+			start = Clock::now();
+			bvh.QueryBox(query, hits);
+			result.BoxQueryUs += ElapsedMs(start) * 1000.0;
+
+			const auto expected = std::count_if(bounds.begin(), bounds.end(), [&](const BOUNDING_BOX& box) { return Overlaps(box, query); });
+			result.Matched &= static_cast<std::size_t>(expected) == hits.size();
+
+			const XMFLOAT3 dir{ direction(rng), direction(rng), direction(rng) };
+			BVH_RAY_HIT hit{};
+			start = Clock::now();
+			const bool anyHit = bvh.Raycast(center, dir, std::numeric_limits<float>::infinity(), hit);
+			result.RayQueryUs += ElapsedMs(start) * 1000.0;
+
+			//~ the scan is slow at 1M, a few samples are enough for the baseline and the check
+			if (q < 16u)
+			{
+				start = Clock::now();
+				const float nearest = LinearRaycast(bounds, center, dir);
+				linearMs += ElapsedMs(start);
+				result.Matched &= anyHit == std::isfinite(nearest) && (!anyHit || std::fabs(hit.Distance - nearest) < 1.0e-3f);
+			}
+		}
+
+		result.FrustumQueryUs  /= nQueryCount;
+		result.BoxQueryUs	   /= nQueryCount;
+		result.RayQueryUs	   /= nQueryCount;
+		result.LinearRayQueryUs = linearMs * 1000.0 / 16.0;
+
+		logger::info("BVH benchmark {:>8} objects, {} nodes: build {:.2f} ms (parallel {:.2f} ms), refit {:.3f} ms",
+					 result.ObjectCount, result.NodeCount, result.BuildMs, result.ParallelBuildMs, result.RefitMs);
+		logger::info("BVH benchmark {:>8} objects: frustum {:.2f} us, box {:.2f} us, ray {:.2f} us (linear {:.2f} us){}",
+					 result.ObjectCount, result.FrustumQueryUs, result.BoxQueryUs, result.RayQueryUs, result.LinearRayQueryUs,
+					 result.Matched ? "" : " MISMATCH");
+		results.push_back(result);
+	}
+	return results;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace framework
+{
+	class JobSystem;
+
+	typedef struct _BVH_BENCHMARK_RESULT
+	{
+		std::uint32_t ObjectCount	   { 0u };
+		std::uint32_t NodeCount		   { 0u };
+		double		  BuildMs		   { 0.0 }; //~ averages over the iterations
+		double		  ParallelBuildMs  { 0.0 };
+		double		  RefitMs		   { 0.0 }; //~ a tenth of the objects moved
+		double		  FrustumQueryUs   { 0.0 };
+		double		  RayQueryUs	   { 0.0 };
+		double		  BoxQueryUs	   { 0.0 };
+		double		  LinearRayQueryUs { 0.0 }; //~ brute force scan, the baseline
+		bool		  Matched		   { true }; //~ queries agreed with the brute force scan
+	} BVH_BENCHMARK_RESULT;
+
+	//~ random boxes in a cube scaled with the count, so density stays constant. Times build,
+	//~ refit and queries, checks query results against a linear scan. Results are logged
+	//~ and returned. Blocks the calling thread.
+	std::vector<BVH_BENCHMARK_RESULT> RunBvhBenchmark(
+		JobSystem* jobs,
+		const std::vector<std::uint32_t>& objectCounts = { 10'000u, 100'000u, 1'000'000u },
+		std::uint32_t iterations = 4u);
+} // namespace framework
@@ -0,0 +1,189 @@
+#include "frustum_culler.h"
+#include "bounds.h"
+
+#include "utility/thread/job_system.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+
+#if defined(_XM_SSE_INTRINSICS_)
+#include <xmmintrin.h>
+#endif
+
+using namespace framework;
+using namespace DirectX;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	inline XMFLOAT4 NormalizePlane(float a, float b, float c, float d) noexcept
+	{
+		const float length = std::sqrt(a * a + b * b + c * c);
+		const float inv	   = length > 0.f ? 1.f / length : 0.f;
+		return { a * inv, b * inv, c * inv, d * inv };
+	}
+
+	constexpr std::uint32_t nMinGroupsPerChunk = 256u;
+} // namespace
+
+FRUSTUM_PLANES framework::ExtractFrustumPlanes(const XMFLOAT4X4& m) noexcept
+{
+	//~ clip = v * M, so every plane is a combination of the columns of M
+	FRUSTUM_PLANES frustum{};
+	frustum.Planes[ 0 ] = NormalizePlane(m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41); //~ left
+	frustum.Planes[ 1 ] = NormalizePlane(m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41); //~ right
+	frustum.Planes[ 2 ] = NormalizePlane(m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42); //~ bottom
+	frustum.Planes[ 3 ] = NormalizePlane(m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42); //~ top
+	frustum.Planes[ 4 ] = NormalizePlane(m._13,			m._23,			m._33,			m._43);			  //~ near
+	frustum.Planes[ 5 ] = NormalizePlane(m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43); //~ far
+	return frustum;
+}
+
+void framework::FrustumCuller::Resize(std::uint32_t count)
+{
+	m_nCount = count;
+
+	const std::size_t padded = (static_cast<std::size_t>(count) + LANES - 1u) / LANES * LANES;
+	m_centerX.resize(padded, 0.f);
+	m_centerY.resize(padded, 0.f);
+	m_centerZ.resize(padded, 0.f);
+	m_extentX.resize(padded, 0.f);
+	m_extentY.resize(padded, 0.f);
+	m_extentZ.resize(padded, 0.f);
+	m_visible.resize(padded, 0u);
+}
+
+void framework::FrustumCuller::SetLocalBounds(
+	std::uint32_t index,
+	const XMFLOAT3& localCenter,
+	const XMFLOAT3& localExtents,
+	const XMFLOAT4X4& world) noexcept
+{
+	XMFLOAT3 center{};
+	XMFLOAT3 extents{};
+	TransformBounds(localCenter, localExtents, world, center, extents);
+
+	SetWorldBounds(index, center, extents);
+}
+
+void framework::FrustumCuller::SetWorldBounds(std::uint32_t index, const XMFLOAT3& center, const XMFLOAT3& extents) noexcept
+{
+	assert(index < m_nCount && "Cull bounds index out of range!");
+	m_centerX[ index ] = center.x;
+	m_centerY[ index ] = center.y;
+	m_centerZ[ index ] = center.z;
+	m_extentX[ index ] = extents.x;
+	m_extentY[ index ] = extents.y;
+	m_extentZ[ index ] = extents.z;
+}
+
+CULL_STATS framework::FrustumCuller::Cull(const FRUSTUM_PLANES& frustum, JobSystem* jobs, std::uint32_t minParallelCount)
+{
+	const auto start = Clock::now();
+
+	const std::uint32_t groups = (m_nCount + LANES - 1u) / LANES;
+	std::uint32_t visible = 0u;
+
+	if (jobs && m_nCount >= minParallelCount)
+	{
+		//~ chunks write disjoint byte ranges of m_visible, only the count is shared
+		std::atomic<std::uint32_t> total{ 0u };
+		jobs->ParallelFor(groups, nMinGroupsPerChunk, [&](std::uint32_t b, std::uint32_t e)
+		{
+			total.fetch_add(CullGroups(frustum, b, e), std::memory_order_relaxed);
+		});
+		visible = total.load(std::memory_order_relaxed);
+	}
+	else
+	{
+		visible = CullGroups(frustum, 0u, groups);
+	}
+
+	//~ padding lanes hold empty boxes at the origin, never report them
+	for (std::uint32_t i = m_nCount; i < groups * LANES; ++i)
+	{
+		visible -= m_visible[ i ];
+		m_visible[ i ] = 0u;
+	}
+
+	m_lastStats.Tested	= m_nCount;
+	m_lastStats.Visible = visible;
+	m_lastStats.Culled	= m_nCount - visible;
+	m_lastStats.CullMs	= std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	return m_lastStats;
+}
+
+std::uint32_t framework::FrustumCuller::CullGroups(const FRUSTUM_PLANES& frustum, std::uint32_t begin, std::uint32_t end) noexcept
+{
+	std::uint32_t visible = 0u;
+
+#if defined(_XM_SSE_INTRINSICS_)
+	//~ planes splatted once per chunk, |n| precomputed for the extent projection
+	__m128 nx[ 6 ], ny[ 6 ], nz[ 6 ], nw[ 6 ], ax[ 6 ], ay[ 6 ], az[ 6 ];
+	for (int p = 0; p < 6; ++p)
+	{
+		const auto& plane = frustum.Planes[ p ];
+		nx[ p ] = _mm_set1_ps(plane.x);
+		ny[ p ] = _mm_set1_ps(plane.y);
+		nz[ p ] = _mm_set1_ps(plane.z);
+		nw[ p ] = _mm_set1_ps(plane.w);
+		ax[ p ] = _mm_set1_ps(std::fabs(plane.x));
+		ay[ p ] = _mm_set1_ps(std::fabs(plane.y));
+		az[ p ] = _mm_set1_ps(std::fabs(plane.z));
+	}
+	const __m128 zero = _mm_setzero_ps();
+
+	for (std::uint32_t group = begin; group < end; ++group)
+	{
+		const std::size_t i = static_cast<std::size_t>(group) * LANES;
+		const __m128 cx = _mm_loadu_ps(&m_centerX[ i ]);
+		const __m128 cy = _mm_loadu_ps(&m_centerY[ i ]);
+		const __m128 cz = _mm_loadu_ps(&m_centerZ[ i ]);
+		const __m128 ex = _mm_loadu_ps(&m_extentX[ i ]);
+		const __m128 ey = _mm_loadu_ps(&m_extentY[ i ]);
+		const __m128 ez = _mm_loadu_ps(&m_extentZ[ i ]);
+
+		//~ a box is outside when distance + projected radius < 0 for any plane
+		__m128 outside = _mm_setzero_ps();
+		for (int p = 0; p < 6; ++p)
+		{
+			const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[ p ], cx), _mm_mul_ps(ny[ p ], cy)),
+										_mm_add_ps(_mm_mul_ps(nz[ p ], cz), nw[ p ]));
+			const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[ p ], ex), _mm_mul_ps(ay[ p ], ey)),
+										_mm_mul_ps(az[ p ], ez));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(d, r), zero));
+		}
+
+		const int mask = ~_mm_movemask_ps(outside) & 0xf;
+		for (std::uint32_t lane = 0u; lane < LANES; ++lane)
+		{
+			const std::uint8_t in = static_cast<std::uint8_t>((mask >> lane) & 1);
+			m_visible[ i + lane ] = in;
+			visible += in;
+		}
+	}
+#else
+	for (std::uint32_t group = begin; group < end; ++group)
+	{
+		for (std::uint32_t lane = 0u; lane < LANES; ++lane)
+		{
+			const std::size_t i = static_cast<std::size_t>(group) * LANES + lane;
+
+			bool inside = true;
+			for (const auto& plane : frustum.Planes)
+			{
+				const float d = plane.x * m_centerX[ i ] + plane.y * m_centerY[ i ] + plane.z * m_centerZ[ i ] + plane.w;
+				const float r = std::fabs(plane.x) * m_extentX[ i ] + std::fabs(plane.y) * m_extentY[ i ]
+							  + std::fabs(plane.z) * m_extentZ[ i ];
+				inside = inside && (d + r >= 0.f);
+			}
+			m_visible[ i ] = inside ? 1u : 0u;
+			visible += inside ? 1u : 0u;
+		}
+	}
+#endif
+	return visible;
+}
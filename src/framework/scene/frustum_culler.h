@@ -0,0 +1,86 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace framework
+{
+	class JobSystem;
+
+	//~ inward facing, normalized planes: left, right, bottom, top, near, far.
+	//~ A point p is inside a plane when dot(plane.xyz, p) + plane.w >= 0
+	typedef struct _FRUSTUM_PLANES
+	{
+		DirectX::XMFLOAT4 Planes[ 6 ];
+	} FRUSTUM_PLANES;
+
+	//~ viewProj uses the row vector convention (v * view * proj) and D3D clip depth [0, 1]
+	FRUSTUM_PLANES ExtractFrustumPlanes(const DirectX::XMFLOAT4X4& viewProj) noexcept;
+
+	typedef struct _CULL_STATS
+	{
+		std::uint32_t Tested { 0u };
+		std::uint32_t Visible{ 0u };
+		std::uint32_t Culled { 0u };
+		double		  CullMs { 0.0 };
+	} CULL_STATS;
+
+	/// <summary>
+	/// Frustum culling of world space AABBs. Bounds are kept as structure of arrays
+	/// padded to a multiple of four so Cull() tests four boxes per plane per instruction
+	/// and splits the work across the job system in independent chunks.
+	/// </summary>
+	class FrustumCuller
+	{
+	public:
+		static constexpr std::uint32_t LANES = 4u;
+
+		FrustumCuller() = default;
+		~FrustumCuller() = default;
+
+		FrustumCuller(const FrustumCuller&) = delete;
+		FrustumCuller& operator=(const FrustumCuller&) = delete;
+
+		//~ setup, new boxes start empty at the origin
+		void Resize(std::uint32_t count);
+
+		//~ world space box from a local box and a world matrix (row vectors)
+		void SetLocalBounds(std::uint32_t index,
+							const DirectX::XMFLOAT3& localCenter,
+							const DirectX::XMFLOAT3& localExtents,
+							const DirectX::XMFLOAT4X4& world) noexcept;
+		void SetWorldBounds(std::uint32_t index,
+							const DirectX::XMFLOAT3& center,
+							const DirectX::XMFLOAT3& extents) noexcept;
+
+		//~ tests every box, jobs may be null to run on the calling thread
+		CULL_STATS Cull(const FRUSTUM_PLANES& frustum,
+						JobSystem* jobs = nullptr,
+						std::uint32_t minParallelCount = 4096u);
+
+		//~ Getters
+		std::uint32_t					 GetCount	   ()					 const noexcept { return m_nCount; }
+		bool							 IsVisible	   (std::uint32_t index) const noexcept { return m_visible[ index ] != 0u; }
+		const std::vector<std::uint8_t>& GetVisibility () const noexcept { return m_visible; } //~ one byte per box, padded
+		const CULL_STATS&				 GetLastStats  () const noexcept { return m_lastStats; }
+
+	private:
+		//~ groups are LANES boxes wide, [begin, end) in groups
+		std::uint32_t CullGroups(const FRUSTUM_PLANES& frustum, std::uint32_t begin, std::uint32_t end) noexcept;
+
+	private:
+		std::uint32_t m_nCount{ 0u };
+
+		std::vector<float> m_centerX{};
+		std::vector<float> m_centerY{};
+		std::vector<float> m_centerZ{};
+		std::vector<float> m_extentX{};
+		std::vector<float> m_extentY{};
+		std::vector<float> m_extentZ{};
+
+		std::vector<std::uint8_t> m_visible{};
+		CULL_STATS				  m_lastStats{};
+	};
+} // namespace framework
@@ -0,0 +1,135 @@
+#include "occlusion_benchmark.h"
+#include "occlusion_culler.h"
+
+#include "utility/graphics/geometry_generator.h"
+#include "utility/logger/logger.h"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+
+using namespace framework;
+using namespace DirectX;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	XMFLOAT4X4 MakeViewProj()
+	{
+		const XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.f, 0.f, 0.f, 1.f), XMVectorSet(0.f, 0.f, 1.f, 1.f), XMVectorSet(0.f, 1.f, 0.f, 0.f));
+		const XMMATRIX proj = XMMatrixPerspectiveFovLH(0.25f * XM_PI, 2.f, 0.1f, 1000.f);
+
+		XMFLOAT4X4 viewProj{};
+		XMStoreFloat4x4(&viewProj, XMMatrixMultiply(view, proj));
+		return viewProj;
+	}
+
+	XMFLOAT4X4 MakeWorld(const XMFLOAT3& position, const XMFLOAT3& scale)
+	{
+		XMFLOAT4X4 world{};
+		XMStoreFloat4x4(&world, XMMatrixMultiply(XMMatrixScaling(scale.x, scale.y, scale.z),
+												 XMMatrixTranslation(position.x, position.y, position.z)));
+		return world;
+	}
+
+	//~ unit box positions, the occluder mesh is shared by every wall piece
+	typedef struct _OCCLUDER_MESH
+	{
+		std::vector<XMFLOAT3>	   Positions{};
+		std::vector<std::uint32_t> Indices	{};
+	} OCCLUDER_MESH;
+
+	OCCLUDER_MESH MakeUnitBox()
+	{
+		GeometryGenerator generator{};
+		const auto box = generator.CreateBox(1.f, 1.f, 1.f, 0u);
+
+		OCCLUDER_MESH mesh{};
+		mesh.Positions.reserve(box.Vertices.size());
+		for (const auto& v : box.Vertices) mesh.Positions.push_back(v.Position);
+		mesh.Indices = box.Indices32;
+		return mesh;
+	}
+} // namespace
+
+std::vector<OCCLUSION_BENCHMARK_RESULT> framework::RunOcclusionBenchmark(
+	const std::vector<std::uint32_t>& occluderCounts,
+	std::uint32_t occludeeCount,
+	std::uint32_t iterations)
+{
+	iterations = iterations ? iterations : 1u;
+
+	const auto mesh		= MakeUnitBox();
+	const auto viewProj = MakeViewProj();
+
+	OcclusionCuller culler{};
+
+	std::mt19937 rng{ 42u };
+	std::uniform_real_distribution<float> spread(-1.f, 1.f);
+	std::uniform_real_distribution<float> depth(30.f, 200.f);
+
+	//~ occludees fill the view volume behind the wall
+	std::vector<BOUNDING_BOX> occludees(occludeeCount);
+	for (auto& box : occludees)
+	{
+		const float z = depth(rng);
+		box = MakeBoundingBox({ spread(rng) * z * 0.8f, spread(rng) * z * 0.4f, z }, { 0.5f, 0.5f, 0.5f });
+	}
+
+	std::vector<OCCLUSION_BENCHMARK_RESULT> results{};
+	results.reserve(occluderCounts.size());
+
+	for (auto count : occluderCounts)
+	{
+		//~ a square grid of wall pieces at z = 15, covering the left two thirds of the view
+		const auto side = static_cast<std::uint32_t>(std::ceil(std::sqrt(static_cast<float>(count))));
+		const float piece = 16.f / static_cast<float>(side);
+
+		std::vector<XMFLOAT4X4> worlds{};
+		worlds.reserve(count);
+		for (std::uint32_t i = 0u; i < count; ++i)
+		{
+			const float x = -12.f + (static_cast<float>(i % side) + 0.5f) * piece;
+			const float y = -6.f  + (static_cast<float>(i / side) + 0.5f) * piece * 0.75f;
+			worlds.push_back(MakeWorld({ x, y, 15.f }, { piece, piece * 0.75f, 1.f }));
+		}
+
+		OCCLUSION_BENCHMARK_RESULT result{};
+		result.OccluderCount = count;
+		result.OccludeeCount = occludeeCount;
+
+		for (std::uint32_t it = 0u; it < iterations; ++it)
+		{
+			culler.Begin(viewProj);
+			for (const auto& world : worlds)
+			{
+				culler.RasterizeOccluder(mesh.Positions.data(), static_cast<std::uint32_t>(mesh.Positions.size()),
+										 mesh.Indices.data(), static_cast<std::uint32_t>(mesh.Indices.size()), world);
+			}
+			culler.Finalize();
+			result.RasterMs += culler.GetLastStats().RasterMs;
+
+			const auto start = Clock::now();
+			std::uint32_t occluded = 0u;
+			for (const auto& box : occludees) occluded += culler.TestOccludee(box) ? 1u : 0u;
+			result.TestMs  += ElapsedMs(start);
+			result.Occluded = occluded;
+		}
+
+		result.RasterMs		/= iterations;
+		result.TestMs		/= iterations;
+		result.NsPerOccludee = occludeeCount ? result.TestMs * 1.0e6 / occludeeCount : 0.0;
+
+		logger::info("Occlusion benchmark {:>4} occluders, {} occludees: raster {:.3f} ms, test {:.3f} ms ({:.1f} ns/box), {} occluded",
+					 result.OccluderCount, result.OccludeeCount, result.RasterMs, result.TestMs, result.NsPerOccludee,
+					 result.Occluded);
+		results.push_back(result);
+	}
+	return results;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace framework
+{
+	typedef struct _OCCLUSION_BENCHMARK_RESULT
+	{
+		std::uint32_t OccluderCount{ 0u };
+		std::uint32_t OccludeeCount{ 0u };
+		std::uint32_t Occluded	   { 0u };
+		double		  RasterMs	   { 0.0 }; //~ averages over the iterations, includes the HiZ build
+		double		  TestMs	   { 0.0 };
+		double		  NsPerOccludee{ 0.0 };
+	} OCCLUSION_BENCHMARK_RESULT;
+
+	//~ a wall of box occluders in front of a field of small occludee boxes, looking down +z.
+	//~ Results are logged and returned. Blocks the calling thread.
+	std::vector<OCCLUSION_BENCHMARK_RESULT> RunOcclusionBenchmark(
+		const std::vector<std::uint32_t>& occluderCounts = { 16u, 64u, 256u },
+		std::uint32_t occludeeCount = 100'000u,
+		std::uint32_t iterations = 8u);
+} // namespace framework
@@ -0,0 +1,278 @@
+#include "occlusion_culler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+
+#if defined(_XM_SSE_INTRINSICS_)
+#include <xmmintrin.h>
+#endif
+
+using namespace framework;
+using namespace DirectX;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	//~ clip w below this is treated as touching the near plane
+	constexpr float nMinClipW = 1.0e-4f;
+
+	//~ an occludee rectangle spans at most this many texels per axis at the tested mip
+	constexpr std::uint32_t nMaxTestTexels = 4u;
+} // namespace
+
+void framework::OcclusionCuller::Resize(std::uint32_t width, std::uint32_t height)
+{
+	assert(width > 0u && height > 0u && "Occlusion buffer must not be empty!");
+
+	m_nWidth  = (width + 3u) & ~3u;
+	m_nHeight = height;
+	m_depth.assign(static_cast<std::size_t>(m_nWidth) * m_nHeight, 1.f);
+
+	m_mips.clear();
+	std::uint32_t w = m_nWidth, h = m_nHeight;
+	while (w > 1u || h > 1u)
+	{
+		w = (w + 1u) / 2u;
+		h = (h + 1u) / 2u;
+		m_mips.push_back({ w, h, std::vector<float>(static_cast<std::size_t>(w) * h, 1.f) });
+	}
+}
+
+void framework::OcclusionCuller::Begin(const XMFLOAT4X4& viewProj)
+{
+	m_viewProj = viewProj;
+	m_stats	   = {};
+	std::fill(m_depth.begin(), m_depth.end(), 1.f);
+}
+
+void framework::OcclusionCuller::RasterizeOccluder(
+	const XMFLOAT3* positions,
+	std::uint32_t vertexCount,
+	const std::uint32_t* indices,
+	std::uint32_t indexCount,
+	const XMFLOAT4X4& world)
+{
+	assert(positions && indices && (indexCount % 3u) == 0u && "Occluder must be an indexed triangle list!");
+	const auto start = Clock::now();
+
+	const XMMATRIX worldViewProj = XMMatrixMultiply(XMLoadFloat4x4(&world), XMLoadFloat4x4(&m_viewProj));
+	m_clip.resize(vertexCount);
+	for (std::uint32_t i = 0u; i < vertexCount; ++i)
+	{
+		const XMVECTOR p = XMVectorSetW(XMLoadFloat3(&positions[ i ]), 1.f);
+		XMStoreFloat4(&m_clip[ i ], XMVector4Transform(p, worldViewProj));
+	}
+
+	const float halfW = 0.5f * static_cast<float>(m_nWidth);
+	const float halfH = 0.5f * static_cast<float>(m_nHeight);
+
+	for (std::uint32_t i = 0u; i < indexCount; i += 3u)
+	{
+		const XMFLOAT4& c0 = m_clip[ indices[ i + 0u ] ];
+		const XMFLOAT4& c1 = m_clip[ indices[ i + 1u ] ];
+		const XMFLOAT4& c2 = m_clip[ indices[ i + 2u ] ];
+		++m_stats.Triangles;
+
+		//~ no clipping, a triangle through the near plane only costs some occlusion
+		if (c0.w < nMinClipW || c1.w < nMinClipW || c2.w < nMinClipW) continue;
+		if (c0.z < 0.f || c1.z < 0.f || c2.z < 0.f) continue;
+
+		//~ trivially outside one side of the view volume
+		if ((c0.x >  c0.w && c1.x >  c1.w && c2.x >  c2.w) || (c0.x < -c0.w && c1.x < -c1.w && c2.x < -c2.w)) continue;
+		if ((c0.y >  c0.w && c1.y >  c1.w && c2.y >  c2.w) || (c0.y < -c0.w && c1.y < -c1.w && c2.y < -c2.w)) continue;
+		if (c0.z >  c0.w && c1.z >  c1.w && c2.z >  c2.w) continue;
+
+		auto toScreen = [halfW, halfH](const XMFLOAT4& c) -> SCREEN_VERTEX
+		{
+			const float invW = 1.f / c.w;
+			return { (c.x * invW + 1.f) * halfW, (1.f - c.y * invW) * halfH, c.z * invW };
+		};
+		RasterizeTriangle(toScreen(c0), toScreen(c1), toScreen(c2));
+	}
+
+	++m_stats.Occluders;
+	m_stats.RasterMs += ElapsedMs(start);
+}
+
+void framework::OcclusionCuller::RasterizeTriangle(const SCREEN_VERTEX& v0, const SCREEN_VERTEX& v1, const SCREEN_VERTEX& v2) noexcept
+{
+	//~ twice the signed area, both windings are drawn so occluders do not depend on the cull mode
+	float area = (v1.X - v0.X) * (v2.Y - v0.Y) - (v1.Y - v0.Y) * (v2.X - v0.X);
+	if (std::fabs(area) < 1.0e-8f) return;
+
+	const SCREEN_VERTEX& a = v0;
+	const SCREEN_VERTEX& b = area > 0.f ? v1 : v2;
+	const SCREEN_VERTEX& c = area > 0.f ? v2 : v1;
+	area = std::fabs(area);
+
+	const int minX = std::max(0,							static_cast<int>(std::floor(std::min({ a.X, b.X, c.X }))));
+	const int maxX = std::min(static_cast<int>(m_nWidth)  - 1, static_cast<int>(std::floor(std::max({ a.X, b.X, c.X }))));
+	const int minY = std::max(0,							static_cast<int>(std::floor(std::min({ a.Y, b.Y, c.Y }))));
+	const int maxY = std::min(static_cast<int>(m_nHeight) - 1, static_cast<int>(std::floor(std::max({ a.Y, b.Y, c.Y }))));
+	if (minX > maxX || minY > maxY) return;
+
+	++m_stats.TrianglesRasterized;
+
+	//~ edge functions E(x, y) = A x + B y + C, positive inside for this winding
+	const float a0 = b.Y - c.Y, b0 = c.X - b.X, k0 = b.X * c.Y - b.Y * c.X; //~ opposite a
+	const float a1 = c.Y - a.Y, b1 = a.X - c.X, k1 = c.X * a.Y - c.Y * a.X; //~ opposite b
+	const float a2 = a.Y - b.Y, b2 = b.X - a.X, k2 = a.X * b.Y - a.Y * b.X; //~ opposite c
+
+	//~ depth is affine in screen space: z = a.Z + (E1 (b.Z - a.Z) + E2 (c.Z - a.Z)) / area
+	const float invArea = 1.f / area;
+	const float dz1 = (b.Z - a.Z) * invArea;
+	const float dz2 = (c.Z - a.Z) * invArea;
+	const float zA	= a1 * dz1 + a2 * dz2;
+	const float zB	= b1 * dz1 + b2 * dz2;
+	const float zC	= k1 * dz1 + k2 * dz2 + a.Z;
+
+	const int startX = minX & ~3;
+
+#if defined(_XM_SSE_INTRINSICS_)
+	const __m128 laneX = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 stepE0 = _mm_set1_ps(4.f * a0), stepE1 = _mm_set1_ps(4.f * a1), stepE2 = _mm_set1_ps(4.f * a2);
+	const __m128 stepZ	= _mm_set1_ps(4.f * zA);
+	const __m128 zero	= _mm_setzero_ps();
+
+	for (int y = minY; y <= maxY; ++y)
+	{
+		const float py = static_cast<float>(y) + 0.5f;
+		const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(startX)), laneX);
+
+		__m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a0), px), _mm_set1_ps(b0 * py + k0));
+		__m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a1), px), _mm_set1_ps(b1 * py + k1));
+		__m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a2), px), _mm_set1_ps(b2 * py + k2));
+		__m128 z  = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(zA), px), _mm_set1_ps(zB * py + zC));
+
+		float* row = m_depth.data() + static_cast<std::size_t>(y) * m_nWidth;
+		for (int x = startX; x <= maxX; x += 4)
+		{
+			const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+			if (_mm_movemask_ps(inside))
+			{
+				//~ width is a multiple of four, the last block never runs past the row
+				const __m128 current = _mm_loadu_ps(row + x);
+				const __m128 nearest = _mm_min_ps(current, z);
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+			}
+			e0 = _mm_add_ps(e0, stepE0);
+			e1 = _mm_add_ps(e1, stepE1);
+			e2 = _mm_add_ps(e2, stepE2);
+			z  = _mm_add_ps(z,	stepZ);
+		}
+	}
+#else
+	for (int y = minY; y <= maxY; ++y)
+	{
+		const float py = static_cast<float>(y) + 0.5f;
+		float* row = m_depth.data() + static_cast<std::size_t>(y) * m_nWidth;
+		for (int x = startX; x <= maxX; ++x)
+		{
+			const float px = static_cast<float>(x) + 0.5f;
+			if (a0 * px + b0 * py + k0 < 0.f || a1 * px + b1 * py + k1 < 0.f || a2 * px + b2 * py + k2 < 0.f) continue;
+			row[ x ] = std::min(row[ x ], zA * px + zB * py + zC);
+		}
+	}
+#endif
+}
+
+void framework::OcclusionCuller::Finalize()
+{
+	const auto start = Clock::now();
+
+	//~ each texel keeps the farthest depth below it, odd edges only read the texels that exist
+	const float*  src		= m_depth.data();
+	std::uint32_t srcWidth	= m_nWidth;
+	std::uint32_t srcHeight = m_nHeight;
+	for (auto& mip : m_mips)
+	{
+		for (std::uint32_t y = 0u; y < mip.Height; ++y)
+		{
+			const std::uint32_t y0 = 2u * y;
+			const std::uint32_t y1 = std::min(y0 + 1u, srcHeight - 1u);
+			for (std::uint32_t x = 0u; x < mip.Width; ++x)
+			{
+				const std::uint32_t x0 = 2u * x;
+				const std::uint32_t x1 = std::min(x0 + 1u, srcWidth - 1u);
+				mip.Depth[ static_cast<std::size_t>(y) * mip.Width + x ] = std::max(
+					std::max(src[ y0 * srcWidth + x0 ], src[ y0 * srcWidth + x1 ]),
+					std::max(src[ y1 * srcWidth + x0 ], src[ y1 * srcWidth + x1 ]));
+			}
+		}
+		src		  = mip.Depth.data();
+		srcWidth  = mip.Width;
+		srcHeight = mip.Height;
+	}
+
+	m_stats.RasterMs += ElapsedMs(start);
+}
+
+bool framework::OcclusionCuller::IsOccluded(const BOUNDING_BOX& box) const noexcept
+{
+	const XMMATRIX viewProj = XMLoadFloat4x4(&m_viewProj);
+
+	float minX = 1.0e30f, minY = 1.0e30f, maxX = -1.0e30f, maxY = -1.0e30f;
+	float minZ = 1.f;
+	for (std::uint32_t corner = 0u; corner < 8u; ++corner)
+	{
+		const XMVECTOR p = XMVectorSet(corner & 1u ? box.Max.x : box.Min.x,
+									   corner & 2u ? box.Max.y : box.Min.y,
+									   corner & 4u ? box.Max.z : box.Min.z, 1.f);
+		XMFLOAT4 clip{};
+		XMStoreFloat4(&clip, XMVector4Transform(p, viewProj));
+
+		//~ the box reaches the camera, nothing can be in front of it
+		if (clip.w < nMinClipW || clip.z < 0.f) return false;
+
+		const float invW = 1.f / clip.w;
+		const float x	 = (clip.x * invW + 1.f) * 0.5f * static_cast<float>(m_nWidth);
+		const float y	 = (1.f - clip.y * invW) * 0.5f * static_cast<float>(m_nHeight);
+		minX = std::min(minX, x);
+		maxX = std::max(maxX, x);
+		minY = std::min(minY, y);
+		maxY = std::max(maxY, y);
+		minZ = std::min(minZ, clip.z * invW);
+	}
+
+	//~ off screen boxes belong to the frustum culler
+	if (maxX < 0.f || maxY < 0.f || minX >= static_cast<float>(m_nWidth) || minY >= static_cast<float>(m_nHeight)) return false;
+
+	const auto x0 = static_cast<std::uint32_t>(std::max(0.f, std::floor(minX)));
+	const auto y0 = static_cast<std::uint32_t>(std::max(0.f, std::floor(minY)));
+	const auto x1 = std::min(m_nWidth  - 1u, static_cast<std::uint32_t>(std::floor(maxX)));
+	const auto y1 = std::min(m_nHeight - 1u, static_cast<std::uint32_t>(std::floor(maxY)));
+
+	//~ coarsest level where the rectangle still spans only a few texels
+	std::uint32_t level = 0u;
+	while (level < m_mips.size() && (((x1 >> level) - (x0 >> level)) >= nMaxTestTexels || ((y1 >> level) - (y0 >> level)) >= nMaxTestTexels))
+	{
+		++level;
+	}
+
+	const float*  depth = level == 0u ? m_depth.data() : m_mips[ level - 1u ].Depth.data();
+	const std::uint32_t pitch = level == 0u ? m_nWidth : m_mips[ level - 1u ].Width;
+	for (std::uint32_t y = y0 >> level; y <= (y1 >> level); ++y)
+	{
+		for (std::uint32_t x = x0 >> level; x <= (x1 >> level); ++x)
+		{
+			if (depth[ static_cast<std::size_t>(y) * pitch + x ] >= minZ) return false;
+		}
+	}
+	return true;
+}
+
+bool framework::OcclusionCuller::TestOccludee(const BOUNDING_BOX& box) noexcept
+{
+	const bool occluded = IsOccluded(box);
+	++m_stats.Tested;
+	m_stats.Occluded += occluded ? 1u : 0u;
+	return occluded;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "bounds.h"
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+namespace framework
+{
+	typedef struct _OCCLUSION_STATS
+	{
+		std::uint32_t Occluders			 { 0u };
+		std::uint32_t Triangles			 { 0u }; //~ submitted by the occluders
+		std::uint32_t TrianglesRasterized{ 0u }; //~ survived near plane and screen rejection
+		std::uint32_t Tested			 { 0u };
+		std::uint32_t Occluded			 { 0u };
+		double		  RasterMs			 { 0.0 }; //~ occluders plus the HiZ build
+	} OCCLUSION_STATS;
+
+	/// <summary>
+	/// CPU software occlusion culling. Occluder triangles are rasterized into a small depth
+	/// buffer (four pixels per SSE instruction, scalar elsewhere), then a max depth pyramid is
+	/// built on top of it. An occludee box is hidden when its nearest depth lies behind the
+	/// farthest occluder depth of every HiZ texel its screen rectangle touches.
+	/// Depth is D3D clip depth [0, 1] with 1 cleared as far.
+	/// </summary>
+	/// <remarks>
+	/// Occluder depth is sampled at pixel centers and triangles crossing the near plane are
+	/// dropped rather than clipped. Occludees crossing the near plane are always visible.
+	/// </remarks>
+	class OcclusionCuller
+	{
+	public:
+		static constexpr std::uint32_t DEFAULT_WIDTH  = 256u;
+		static constexpr std::uint32_t DEFAULT_HEIGHT = 128u;
+
+		OcclusionCuller() { Resize(DEFAULT_WIDTH, DEFAULT_HEIGHT); }
+		~OcclusionCuller() = default;
+
+		OcclusionCuller(const OcclusionCuller&) = delete;
+		OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+		//~ width is rounded up to a multiple of four
+		void Resize(std::uint32_t width, std::uint32_t height);
+
+		//~ per frame: Begin, any number of occluders, Finalize, then test occludees.
+		//~ viewProj uses the row vector convention (v * view * proj)
+		void Begin			  (const DirectX::XMFLOAT4X4& viewProj);
+		void RasterizeOccluder(const DirectX::XMFLOAT3* positions,
+							   std::uint32_t vertexCount,
+							   const std::uint32_t* indices,
+							   std::uint32_t indexCount,
+							   const DirectX::XMFLOAT4X4& world);
+		void Finalize		  ();
+
+		bool IsOccluded	  (const BOUNDING_BOX& worldBox) const noexcept;
+		bool TestOccludee (const BOUNDING_BOX& worldBox) noexcept; //~ IsOccluded, counted in the stats
+
+		//~ Getters
+		std::uint32_t				GetWidth	() const noexcept { return m_nWidth; }
+		std::uint32_t				GetHeight	() const noexcept { return m_nHeight; }
+		const std::vector<float>&	GetDepth	() const noexcept { return m_depth; }
+		std::uint32_t				GetMipCount () const noexcept { return static_cast<std::uint32_t>(m_mips.size()); }
+		const OCCLUSION_STATS&		GetLastStats() const noexcept { return m_stats; }
+
+	private:
+		typedef struct _SCREEN_VERTEX
+		{
+			float X, Y, Z;
+		} SCREEN_VERTEX;
+
+		typedef struct _HIZ_MIP
+		{
+			std::uint32_t	   Width { 0u };
+			std::uint32_t	   Height{ 0u };
+			std::vector<float> Depth {};
+		} HIZ_MIP;
+
+		void RasterizeTriangle(const SCREEN_VERTEX& v0, const SCREEN_VERTEX& v1, const SCREEN_VERTEX& v2) noexcept;
+
+	private:
+		std::uint32_t m_nWidth { 0u };
+		std::uint32_t m_nHeight{ 0u };
+
+		DirectX::XMFLOAT4X4			   m_viewProj{};
+		std::vector<float>			   m_depth	 {}; //~ full resolution, row major
+		std::vector<HIZ_MIP>		   m_mips	 {}; //~ [0] is the max of 2x2 depth pixels
+		std::vector<DirectX::XMFLOAT4> m_clip	 {}; //~ scratch, occluder vertices in clip space
+		OCCLUSION_STATS				   m_stats	 {};
+	};
+} // namespace framework
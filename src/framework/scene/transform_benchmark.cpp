@@ -0,0 +1,80 @@
+#include "transform_benchmark.h"
+#include "transform_system.h"
+
+#include "utility/logger/logger.h"
+
+#include <chrono>
+
+using namespace framework;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+} // namespace
+
+std::vector<TRANSFORM_BENCHMARK_RESULT> framework::RunTransformBenchmark(
+	JobSystem* jobs,
+	const std::vector<std::uint32_t>& objectCounts,
+	std::uint32_t iterations)
+{
+	constexpr std::size_t nStride = sizeof(DirectX::XMFLOAT4X4);
+	iterations = iterations ? iterations : 1u;
+
+	std::vector<TRANSFORM_BENCHMARK_RESULT> results{};
+	results.reserve(objectCounts.size());
+
+	for (auto count : objectCounts)
+	{
+		TransformSystem transforms{};
+		transforms.Reserve(count);
+
+		//~ every fourth object hangs off the previous root, two levels like a typical scene
+		TransformId root = INVALID_TRANSFORM;
+		for (std::uint32_t i = 0u; i < count; ++i)
+		{
+			const float x = static_cast<float>(i % 1024u);
+			const float z = static_cast<float>(i / 1024u);
+			const bool child = (i % 4u) != 0u && root != INVALID_TRANSFORM;
+
+			auto id = transforms.Create({ x, 0.f, z }, { 0.f, 0.f, 0.f, 1.f }, { 1.f, 1.f, 1.f },
+										child ? root : INVALID_TRANSFORM);
+			if (!child) root = id;
+		}
+
+		std::vector<std::uint8_t> destination(static_cast<std::size_t>(count) * nStride);
+
+		TRANSFORM_BENCHMARK_RESULT result{};
+		result.ObjectCount = count;
+
+		for (std::uint32_t it = 0u; it < iterations; ++it)
+		{
+			const float y = static_cast<float>(it + 1u);
+			for (std::uint32_t i = 0u; i < count; ++i)
+			{
+				transforms.SetPosition(i, { static_cast<float>(i % 1024u), y, static_cast<float>(i / 1024u) });
+			}
+
+			auto start = Clock::now();
+			transforms.Update(jobs);
+			result.UpdateMs += ElapsedMs(start);
+
+			start = Clock::now();
+			transforms.WriteWorldsTransposed(destination.data(), nStride, 0u, count, jobs);
+			result.WriteMs += ElapsedMs(start);
+		}
+
+		result.UpdateMs	  /= iterations;
+		result.WriteMs	  /= iterations;
+		result.NsPerObject = count ? (result.UpdateMs + result.WriteMs) * 1.0e6 / count : 0.0;
+
+		logger::info("Transform benchmark {:>8} objects: update {:.3f} ms, write {:.3f} ms, {:.2f} ns/object",
+					 result.ObjectCount, result.UpdateMs, result.WriteMs, result.NsPerObject);
+		results.push_back(result);
+	}
+	return results;
+}
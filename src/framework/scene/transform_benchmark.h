@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace framework
+{
+	class JobSystem;
+
+	typedef struct _TRANSFORM_BENCHMARK_RESULT
+	{
+		std::uint32_t ObjectCount{ 0u };
+		double		  UpdateMs	 { 0.0 }; //~ average over the iterations
+		double		  WriteMs	 { 0.0 };
+		double		  NsPerObject{ 0.0 }; //~ update + write
+	} TRANSFORM_BENCHMARK_RESULT;
+
+	//~ animates every object, rebuilds worlds and writes them out at a 64 byte stride
+	//~ for each count. Results are logged and returned. Blocks the calling thread.
+	std::vector<TRANSFORM_BENCHMARK_RESULT> RunTransformBenchmark(
+		JobSystem* jobs,
+		const std::vector<std::uint32_t>& objectCounts = { 20u, 1'000u, 10'000u, 100'000u, 1'000'000u },
+		std::uint32_t iterations = 8u);
+} // namespace framework
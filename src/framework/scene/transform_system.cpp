@@ -0,0 +1,226 @@
+#include "transform_system.h"
+
+#include "utility/graphics/stream_copy.h"
+#include "utility/thread/job_system.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace framework;
+using namespace DirectX;
+
+namespace
+{
+	//~ S * R * T without the two full matrix multiplies: scale the rotation rows
+	//~ and drop the translation in the last row
+	inline XMMATRIX ComposeLocal(const XMFLOAT3& position, const XMFLOAT4& rotation, const XMFLOAT3& scale) noexcept
+	{
+		const XMVECTOR s = XMLoadFloat3(&scale);
+		XMMATRIX m		 = XMMatrixRotationQuaternion(XMLoadFloat4(&rotation));
+
+		m.r[ 0 ] = XMVectorMultiply(m.r[ 0 ], XMVectorSplatX(s));
+		m.r[ 1 ] = XMVectorMultiply(m.r[ 1 ], XMVectorSplatY(s));
+		m.r[ 2 ] = XMVectorMultiply(m.r[ 2 ], XMVectorSplatZ(s));
+		m.r[ 3 ] = XMVectorSetW(XMLoadFloat3(&position), 1.0f);
+		return m;
+	}
+
+	constexpr std::uint32_t nMinChunkSize = 1024u;
+} // namespace
+
+void framework::TransformSystem::Reserve(std::size_t count)
+{
+	m_positions	  .reserve(count);
+	m_rotations	  .reserve(count);
+	m_scales	  .reserve(count);
+	m_parents	  .reserve(count);
+	m_depths	  .reserve(count);
+	m_localDirty  .reserve(count);
+	m_worldChanged.reserve(count);
+	m_worlds	  .reserve(count);
+}
+
+TransformId framework::TransformSystem::Create(
+	const XMFLOAT3& position,
+	const XMFLOAT4& rotation,
+	const XMFLOAT3& scale,
+	TransformId parent)
+{
+	const auto id = static_cast<TransformId>(m_positions.size());
+	assert((parent == INVALID_TRANSFORM || parent < id) && "Transform parent must be created before its children!");
+
+	m_positions	  .push_back(position);
+	m_rotations	  .push_back(rotation);
+	m_scales	  .push_back(scale);
+	m_parents	  .push_back(parent);
+	m_depths	  .push_back(parent == INVALID_TRANSFORM ? 0u : m_depths[ parent ] + 1u);
+	m_localDirty  .push_back(1u);
+	m_worldChanged.push_back(0u);
+
+	WorldMatrix world{};
+	XMStoreFloat4x4(&world.Value, XMMatrixIdentity());
+	m_worlds.push_back(world);
+
+	m_bLevelsDirty = true;
+	return id;
+}
+
+void framework::TransformSystem::SetPosition(TransformId id, const XMFLOAT3& position) noexcept
+{
+	m_positions [ id ] = position;
+	m_localDirty[ id ] = 1u;
+}
+
+void framework::TransformSystem::SetRotation(TransformId id, const XMFLOAT4& rotation) noexcept
+{
+	m_rotations [ id ] = rotation;
+	m_localDirty[ id ] = 1u;
+}
+
+void framework::TransformSystem::SetScale(TransformId id, const XMFLOAT3& scale) noexcept
+{
+	m_scales	[ id ] = scale;
+	m_localDirty[ id ] = 1u;
+}
+
+void framework::TransformSystem::Update(JobSystem* jobs, std::uint32_t minParallelCount)
+{
+	if (m_bLevelsDirty) RebuildLevels();
+
+	//~ a single level means no hierarchy, walk the arrays directly
+	const bool		 flat = m_levelOffsets.size() <= 2u;
+	const TransformId* ids = flat ? nullptr : m_order.data();
+
+	for (std::size_t level = 0; level + 1u < m_levelOffsets.size(); ++level)
+	{
+		const std::uint32_t begin = m_levelOffsets[ level ];
+		const std::uint32_t count = m_levelOffsets[ level + 1u ] - begin;
+
+		//~ parents live in earlier levels, so a level only reads finished worlds
+		if (jobs && count >= minParallelCount)
+		{
+			jobs->ParallelFor(count, nMinChunkSize, [&](std::uint32_t b, std::uint32_t e)
+			{
+				UpdateRange(ids, begin + b, begin + e);
+			});
+		}
+		else
+		{
+			UpdateRange(ids, begin, begin + count);
+		}
+	}
+
+	m_nChangedCount = 0u;
+	for (auto flag : m_worldChanged) m_nChangedCount += flag;
+}
+
+void framework::TransformSystem::UpdateRange(const TransformId* ids, std::uint32_t begin, std::uint32_t end) noexcept
+{
+	for (std::uint32_t i = begin; i < end; ++i)
+	{
+		const TransformId id	 = ids ? ids[ i ] : i;
+		const TransformId parent = m_parents[ id ];
+
+		const bool dirty = m_localDirty[ id ] || (parent != INVALID_TRANSFORM && m_worldChanged[ parent ]);
+		m_worldChanged[ id ] = dirty ? 1u : 0u;
+		if (!dirty) continue;
+
+		XMMATRIX world = ComposeLocal(m_positions[ id ], m_rotations[ id ], m_scales[ id ]);
+		if (parent != INVALID_TRANSFORM)
+		{
+			world = XMMatrixMultiply(world, XMLoadFloat4x4(&m_worlds[ parent ].Value));
+		}
+
+		XMStoreFloat4x4(&m_worlds[ id ].Value, world);
+		m_localDirty[ id ] = 0u;
+	}
+}
+
+void framework::TransformSystem::WriteWorldsTransposed(
+	std::uint8_t* dst,
+	std::size_t stride,
+	std::uint32_t begin,
+	std::uint32_t end,
+	JobSystem* jobs) const
+{
+	assert(dst && "Transform write destination is null!");
+	assert(end <= GetCount() && begin <= end && "Transform write range out of bounds!");
+
+	const bool stream = IsStreamAligned(dst) && (stride % STREAM_ALIGNMENT) == 0u;
+
+	auto write = [this, dst, stride, stream](std::uint32_t b, std::uint32_t e)
+	{
+		if (stream)
+		{
+			for (std::uint32_t i = b; i < e; ++i)
+			{
+				StreamWorldTransposed(i, dst + static_cast<std::size_t>(i) * stride);
+			}
+			StreamFence(); //~ per chunk, fences only cover the issuing core
+		}
+		else
+		{
+			for (std::uint32_t i = b; i < e; ++i)
+			{
+				WriteWorldTransposed(i, dst + static_cast<std::size_t>(i) * stride);
+			}
+		}
+	};
+
+	const std::uint32_t count = end - begin;
+	if (jobs && count >= 4u * nMinChunkSize)
+	{
+		jobs->ParallelFor(count, nMinChunkSize, [&](std::uint32_t b, std::uint32_t e)
+		{
+			write(begin + b, begin + e);
+		});
+	}
+	else
+	{
+		write(begin, end);
+	}
+}
+
+void framework::TransformSystem::WriteWorldTransposed(TransformId id, void* dst) const noexcept
+{
+	const XMMATRIX world = XMLoadFloat4x4(&m_worlds[ id ].Value);
+	XMStoreFloat4x4(static_cast<XMFLOAT4X4*>(dst), XMMatrixTranspose(world));
+}
+
+void framework::TransformSystem::StreamWorldTransposed(TransformId id, void* dst) const noexcept
+{
+#if FRAMEWORK_STREAM_STORES && defined(_XM_SSE_INTRINSICS_)
+	assert(IsStreamAligned(dst) && "Streamed world destination must be 16 byte aligned!");
+
+	const XMMATRIX world = XMMatrixTranspose(XMLoadFloat4x4(&m_worlds[ id ].Value));
+	auto* out = static_cast<float*>(dst);
+	_mm_stream_ps(out + 0,  world.r[ 0 ]);
+	_mm_stream_ps(out + 4,  world.r[ 1 ]);
+	_mm_stream_ps(out + 8,  world.r[ 2 ]);
+	_mm_stream_ps(out + 12, world.r[ 3 ]);
+#else
+	WriteWorldTransposed(id, dst);
+#endif
+}
+
+void framework::TransformSystem::RebuildLevels()
+{
+	const std::uint32_t count = GetCount();
+
+	std::uint32_t maxDepth = 0u;
+	for (auto depth : m_depths) maxDepth = std::max(maxDepth, depth);
+
+	//~ counting sort by depth, stable so roots keep creation order
+	m_levelOffsets.assign(maxDepth + 2u, 0u);
+	for (auto depth : m_depths) ++m_levelOffsets[ depth + 1u ];
+	for (std::size_t i = 1; i < m_levelOffsets.size(); ++i) m_levelOffsets[ i ] += m_levelOffsets[ i - 1u ];
+
+	std::vector<std::uint32_t> cursor(m_levelOffsets.begin(), m_levelOffsets.end() - 1);
+	m_order.resize(count);
+	for (TransformId id = 0u; id < count; ++id)
+	{
+		m_order[ cursor[ m_depths[ id ] ]++ ] = id;
+	}
+
+	m_bLevelsDirty = false;
+}
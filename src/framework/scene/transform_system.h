@@ -0,0 +1,97 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace framework
+{
+	class JobSystem;
+
+	using TransformId = std::uint32_t;
+	inline constexpr TransformId INVALID_TRANSFORM = 0xffffffffu;
+
+	//~ one world matrix per cache line so parallel chunks never share a line
+	struct alignas(64) WorldMatrix
+	{
+		DirectX::XMFLOAT4X4 Value;
+	};
+	static_assert(sizeof(WorldMatrix) == 64u, "WorldMatrix must fill exactly one cache line");
+
+	/// <summary>
+	/// Structure of arrays transform storage. Locals are position, rotation (quaternion)
+	/// and scale; worlds are rebuilt only for changed nodes and their descendants,
+	/// level by level so every level can run in parallel on the job system.
+	/// </summary>
+	class TransformSystem
+	{
+	public:
+		TransformSystem() = default;
+		~TransformSystem() = default;
+
+		TransformSystem(const TransformSystem&) = delete;
+		TransformSystem& operator=(const TransformSystem&) = delete;
+
+		//~ creation, a parent must be created before its children
+		void		Reserve(std::size_t count);
+		TransformId Create (const DirectX::XMFLOAT3& position,
+							const DirectX::XMFLOAT4& rotation = { 0.f, 0.f, 0.f, 1.f },
+							const DirectX::XMFLOAT3& scale	  = { 1.f, 1.f, 1.f },
+							TransformId parent				  = INVALID_TRANSFORM);
+
+		//~ local setters mark the node dirty for the next Update
+		void SetPosition(TransformId id, const DirectX::XMFLOAT3& position) noexcept;
+		void SetRotation(TransformId id, const DirectX::XMFLOAT4& rotation) noexcept;
+		void SetScale	(TransformId id, const DirectX::XMFLOAT3& scale)	noexcept;
+
+		//~ rebuilds dirty worlds, jobs may be null to run on the calling thread
+		void Update(JobSystem* jobs = nullptr, std::uint32_t minParallelCount = 4096u);
+
+		//~ writes transposed (shader ready) worlds for [begin, end) to dst + i * stride,
+		//~ dst is usually a persistently mapped upload buffer. Streams when dst and stride
+		//~ allow it and fences before returning
+		void WriteWorldsTransposed(std::uint8_t* dst,
+								   std::size_t stride,
+								   std::uint32_t begin,
+								   std::uint32_t end,
+								   JobSystem* jobs = nullptr) const;
+		void WriteWorldTransposed (TransformId id, void* dst) const noexcept;
+
+		//~ same as above with non-temporal stores, dst must be 16 byte aligned and
+		//~ the caller issues StreamFence() once the batch is written
+		void StreamWorldTransposed(TransformId id, void* dst) const noexcept;
+
+		//~ Getters
+		std::uint32_t			   GetCount		  ()				const noexcept { return static_cast<std::uint32_t>(m_positions.size()); }
+		TransformId				   GetParent	  (TransformId id) const noexcept { return m_parents[ id ]; }
+		const DirectX::XMFLOAT4X4& GetWorld		  (TransformId id) const noexcept { return m_worlds[ id ].Value; }
+		bool					   HasWorldChanged(TransformId id) const noexcept { return m_worldChanged[ id ] != 0u; }
+		std::uint32_t			   GetChangedCount()				const noexcept { return m_nChangedCount; }
+
+	private:
+		void RebuildLevels();
+		void UpdateRange  (const TransformId* ids, std::uint32_t begin, std::uint32_t end) noexcept;
+
+	private:
+		//~ locals, hot in Update
+		std::vector<DirectX::XMFLOAT3> m_positions{};
+		std::vector<DirectX::XMFLOAT4> m_rotations{};
+		std::vector<DirectX::XMFLOAT3> m_scales	  {};
+		std::vector<TransformId>	   m_parents  {};
+		std::vector<std::uint32_t>	   m_depths	  {};
+
+		//~ byte flags rather than bits so parallel chunks never write the same word
+		std::vector<std::uint8_t> m_localDirty	{};
+		std::vector<std::uint8_t> m_worldChanged{};
+
+		std::vector<WorldMatrix> m_worlds{};
+
+		//~ ids ordered by depth, level i is m_order[m_levelOffsets[i], m_levelOffsets[i + 1])
+		std::vector<TransformId>   m_order		 {};
+		std::vector<std::uint32_t> m_levelOffsets{};
+		bool					   m_bLevelsDirty{ true };
+
+		std::uint32_t m_nChangedCount{ 0u };
+	};
+} // namespace framework
@@ -0,0 +1,210 @@
+#include "file_watcher.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace framework;
+
+namespace
+{
+	void AddUnique(std::vector<std::filesystem::path>& paths, std::filesystem::path path)
+	{
+		if (std::find(paths.begin(), paths.end(), path) == paths.end()) paths.push_back(std::move(path));
+	}
+} // namespace
+
+#if defined(_WIN32)
+
+struct framework::FileWatcher::Impl
+{
+	HANDLE		 Directory{ INVALID_HANDLE_VALUE };
+	HANDLE		 Event	  { nullptr };
+	OVERLAPPED	 Overlapped{};
+	bool		 Recursive{ true };
+	bool		 Reading  { false };
+	alignas(DWORD) std::uint8_t Buffer[ 16u * 1024u ]{};
+
+	static constexpr DWORD FILTER = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME
+		| FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE;
+
+	bool Read()
+	{
+		ResetEvent(Event);
+		Overlapped		 = {};
+		Overlapped.hEvent = Event;
+		Reading = ReadDirectoryChangesW(Directory, Buffer, sizeof(Buffer), Recursive,
+										FILTER, nullptr, &Overlapped, nullptr) != FALSE;
+		return Reading;
+	}
+
+	~Impl()
+	{
+		if (Directory != INVALID_HANDLE_VALUE)
+		{
+			if (Reading)
+			{
+				CancelIoEx(Directory, &Overlapped);
+				DWORD bytes = 0u;
+				GetOverlappedResult(Directory, &Overlapped, &bytes, TRUE);
+			}
+			CloseHandle(Directory);
+		}
+		if (Event) CloseHandle(Event);
+	}
+};
+
+framework::FileWatcher::FileWatcher(std::filesystem::path directory, bool recursive)
+	: m_directory(std::move(directory))
+	, m_pImpl(std::make_unique<Impl>())
+{
+	m_pImpl->Recursive = recursive;
+	m_pImpl->Event	   = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+	m_pImpl->Directory = CreateFileW(m_directory.c_str(), FILE_LIST_DIRECTORY,
+									 FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+									 OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+
+	if (m_pImpl->Event && m_pImpl->Directory != INVALID_HANDLE_VALUE) m_pImpl->Read();
+}
+
+framework::FileWatcher::~FileWatcher() = default;
+
+bool framework::FileWatcher::IsValid() const noexcept
+{
+	return m_pImpl && m_pImpl->Reading;
+}
+
+std::vector<std::filesystem::path> framework::FileWatcher::Poll()
+{
+	std::vector<std::filesystem::path> changed{};
+	if (!IsValid()) return changed;
+
+	DWORD bytes = 0u;
+	if (!GetOverlappedResult(m_pImpl->Directory, &m_pImpl->Overlapped, &bytes, FALSE))
+	{
+		if (GetLastError() == ERROR_IO_INCOMPLETE) return changed;
+
+		m_pImpl->Reading = false;
+		AddUnique(changed, m_directory);
+		m_pImpl->Read();
+		return changed;
+	}
+
+	//~ 0 bytes: the buffer overflowed and the events are lost
+	if (bytes == 0u) AddUnique(changed, m_directory);
+
+	std::size_t offset = 0u;
+	while (bytes != 0u)
+	{
+		const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(m_pImpl->Buffer + offset);
+		const std::wstring name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+		AddUnique(changed, m_directory / name);
+
+		if (info->NextEntryOffset == 0u) break;
+		offset += info->NextEntryOffset;
+	}
+
+	m_pImpl->Read();
+	return changed;
+}
+
+#elif defined(__linux__)
+
+struct framework::FileWatcher::Impl
+{
+	int Descriptor{ -1 };
+	std::unordered_map<int, std::filesystem::path> Watches{}; //~ watch descriptor -> directory
+
+	static constexpr std::uint32_t MASK = IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_DELETE
+		| IN_MOVED_FROM | IN_MOVED_TO;
+
+	void Watch(const std::filesystem::path& directory)
+	{
+		const int watch = inotify_add_watch(Descriptor, directory.c_str(), MASK);
+		if (watch >= 0) Watches[ watch ] = directory;
+	}
+
+	~Impl()
+	{
+		if (Descriptor >= 0) close(Descriptor);
+	}
+};
+
+framework::FileWatcher::FileWatcher(std::filesystem::path directory, bool recursive)
+	: m_directory(std::move(directory))
+	, m_pImpl(std::make_unique<Impl>())
+{
+	m_pImpl->Descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_pImpl->Descriptor < 0) return;
+
+	m_pImpl->Watch(m_directory);
+	if (!recursive) return;
+
+	//~ inotify is not recursive, directories created later are not watched
+	std::error_code error{};
+	for (std::filesystem::recursive_directory_iterator it(m_directory, error), end; !error && it != end; it.increment(error))
+	{
+		if (it->is_directory(error)) m_pImpl->Watch(it->path());
+	}
+}
+
+framework::FileWatcher::~FileWatcher() = default;
+
+bool framework::FileWatcher::IsValid() const noexcept
+{
+	return m_pImpl && m_pImpl->Descriptor >= 0 && !m_pImpl->Watches.empty();
+}
+
+std::vector<std::filesystem::path> framework::FileWatcher::Poll()
+{
+	std::vector<std::filesystem::path> changed{};
+	if (!IsValid()) return changed;
+
+	alignas(inotify_event) char buffer[ 16u * 1024u ];
+	for (;;)
+	{
+		const ssize_t bytes = read(m_pImpl->Descriptor, buffer, sizeof(buffer));
+		if (bytes <= 0) break; //~ EAGAIN once drained
+
+		for (ssize_t offset = 0; offset < bytes;)
+		{
+			const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+			offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				AddUnique(changed, m_directory);
+				continue;
+			}
+
+			const auto it = m_pImpl->Watches.find(event->wd);
+			if (it == m_pImpl->Watches.end() || event->len == 0u) continue;
+			AddUnique(changed, it->second / event->name);
+		}
+	}
+	return changed;
+}
+
+#else
+
+struct framework::FileWatcher::Impl {};
+
+framework::FileWatcher::FileWatcher(std::filesystem::path directory, bool)
+	: m_directory(std::move(directory))
+{}
+
+framework::FileWatcher::~FileWatcher() = default;
+
+bool framework::FileWatcher::IsValid() const noexcept { return false; }
+
+std::vector<std::filesystem::path> framework::FileWatcher::Poll() { return {}; }
+
+#endif
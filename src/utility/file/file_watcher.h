@@ -0,0 +1,35 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace framework
+{
+	/// <summary>
+	/// Non blocking directory watcher, ReadDirectoryChangesW on Windows and inotify on Linux.
+	/// Poll returns the files written, created, renamed or removed since the last call, each
+	/// one once. When the OS dropped events the watched directory itself is returned.
+	/// </summary>
+	class FileWatcher
+	{
+	public:
+		explicit FileWatcher(std::filesystem::path directory, bool recursive = true);
+		~FileWatcher();
+
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+
+		std::vector<std::filesystem::path> Poll();
+
+		//~ Getters
+		const std::filesystem::path& GetDirectory() const noexcept { return m_directory; }
+		bool						 IsValid	 () const noexcept;
+
+	private:
+		struct Impl;
+
+		std::filesystem::path m_directory{};
+		std::unique_ptr<Impl> m_pImpl	 { nullptr };
+	};
+} // namespace framework
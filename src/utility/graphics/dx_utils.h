@@ -4,6 +4,7 @@
 #include <string>
 #include <d3d12.h>
 #include <d3dcompiler.h>
+#include <DirectXMath.h>
 #include <wrl/client.h>
 #include <unordered_map>
 
@@ -45,6 +46,11 @@ namespace framework
 		UINT IndexCount{ 0u };
 		UINT StartIndex{ 0u };
 		UINT BaseVertex{ 0u };
+
+		//~ local space bounds, copied from GeometryGenerator::MeshData
+		DirectX::XMFLOAT3 BoundsCenter { 0.0f, 0.0f, 0.0f };
+		DirectX::XMFLOAT3 BoundsExtents{ 0.0f, 0.0f, 0.0f };
+		float			  BoundsRadius { 0.0f };
 	} SubmeshGeometry;
 
 	struct MeshGeometry
@@ -128,7 +134,7 @@ namespace framework
                 &defaultHeap,
                 D3D12_HEAP_FLAG_NONE,
                 &bufferDesc,
-                D3D12_RESOURCE_STATE_COMMON,
+                D3D12_RESOURCE_STATE_COMMON, //~ buffers are created Common, the copy promotes it to CopyDest implicitly
                 nullptr,
                 IID_PPV_ARGS(defaultBuffer.GetAddressOf()))
         );
@@ -155,16 +161,6 @@ namespace framework
         subResourceData.RowPitch    = byteSize;
         subResourceData.SlicePitch  = byteSize;
 
-        D3D12_RESOURCE_BARRIER toCopyDest{};
-        toCopyDest.Type                     = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-        toCopyDest.Flags                    = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-        toCopyDest.Transition.pResource     = defaultBuffer.Get();
-        toCopyDest.Transition.Subresource   = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-        toCopyDest.Transition.StateBefore   = D3D12_RESOURCE_STATE_COMMON;
-        toCopyDest.Transition.StateAfter    = D3D12_RESOURCE_STATE_COPY_DEST;
-
-        cmdList->ResourceBarrier(1, &toCopyDest);
-
         UpdateSubresources<1>(
             cmdList,
             defaultBuffer.Get(),
@@ -1,8 +1,42 @@
 #include "geometry_generator.h"
 #include <algorithm>
+#include <cmath>
 
 using namespace DirectX;
 
+void GeometryGenerator::MeshData::ComputeBounds()
+{
+	if (Vertices.empty())
+	{
+		BoundsCenter  = { 0.0f, 0.0f, 0.0f };
+		BoundsExtents = { 0.0f, 0.0f, 0.0f };
+		BoundsRadius  = 0.0f;
+		return;
+	}
+
+	XMVECTOR vMin = XMLoadFloat3(&Vertices[ 0 ].Position);
+	XMVECTOR vMax = vMin;
+	for (const auto& vertex : Vertices)
+	{
+		const XMVECTOR p = XMLoadFloat3(&vertex.Position);
+		vMin = XMVectorMin(vMin, p);
+		vMax = XMVectorMax(vMax, p);
+	}
+
+	const XMVECTOR center = XMVectorMultiply(XMVectorAdd(vMin, vMax), XMVectorReplicate(0.5f));
+	XMStoreFloat3(&BoundsCenter,  center);
+	XMStoreFloat3(&BoundsExtents, XMVectorMultiply(XMVectorSubtract(vMax, vMin), XMVectorReplicate(0.5f)));
+
+	//~ sphere around the box center, tighter than the box corner distance for round meshes
+	float radiusSq = 0.0f;
+	for (const auto& vertex : Vertices)
+	{
+		const XMVECTOR d = XMVectorSubtract(XMLoadFloat3(&vertex.Position), center);
+		radiusSq = std::max(radiusSq, XMVectorGetX(XMVector3Dot(d, d)));
+	}
+	BoundsRadius = std::sqrt(radiusSq);
+}
+
 GeometryGenerator::MeshData GeometryGenerator::CreateBox(float width, float height, float depth, uint32 numSubdivisions)
 {
 	MeshData meshData;
@@ -85,6 +119,7 @@ GeometryGenerator::MeshData GeometryGenerator::CreateBox(float width, float heig
 	for (uint32 i = 0; i < numSubdivisions; ++i)
 		Subdivide(meshData);
 
+	meshData.ComputeBounds();
 	return meshData;
 }
 
@@ -170,6 +205,7 @@ GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32
 		meshData.Indices32.push_back(baseIndex + i + 1);
 	}
 
+	meshData.ComputeBounds();
 	return meshData;
 }
 
@@ -315,6 +351,7 @@ GeometryGenerator::MeshData GeometryGenerator::CreateGeosphere(float radius, uin
 		XMStoreFloat3(&meshData.Vertices[ i ].TangentU, XMVector3Normalize(T));
 	}
 
+	meshData.ComputeBounds();
 	return meshData;
 }
 
@@ -381,6 +418,7 @@ GeometryGenerator::MeshData GeometryGenerator::CreateCylinder(float bottomRadius
 	BuildCylinderTopCap(bottomRadius, topRadius, height, sliceCount, stackCount, meshData);
 	BuildCylinderBottomCap(bottomRadius, topRadius, height, sliceCount, stackCount, meshData);
 
+	meshData.ComputeBounds();
 	return meshData;
 }
 
@@ -505,6 +543,7 @@ GeometryGenerator::MeshData GeometryGenerator::CreateGrid(float width, float dep
 		}
 	}
 
+	meshData.ComputeBounds();
 	return meshData;
 }
 
@@ -548,5 +587,6 @@ GeometryGenerator::MeshData GeometryGenerator::CreateQuad(float x, float y, floa
 	meshData.Indices32[ 4 ] = 2;
 	meshData.Indices32[ 5 ] = 3;
 
+	meshData.ComputeBounds();
 	return meshData;
 }
\ No newline at end of file
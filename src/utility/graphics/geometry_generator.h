@@ -48,6 +48,13 @@ public:
 		std::vector<Vertex> Vertices;
 		std::vector<uint32> Indices32;
 
+		//~ local space bounds, filled by every Create* call
+		DirectX::XMFLOAT3 BoundsCenter { 0.0f, 0.0f, 0.0f };
+		DirectX::XMFLOAT3 BoundsExtents{ 0.0f, 0.0f, 0.0f };
+		float			  BoundsRadius { 0.0f };
+
+		void ComputeBounds();
+
 		std::vector<uint16>& GetIndices16()
 		{
 			if (mIndices16.empty())
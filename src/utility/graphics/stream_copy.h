@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define FRAMEWORK_STREAM_STORES 1
+#else
+#define FRAMEWORK_STREAM_STORES 0
+#endif
+
+//~ Non-temporal copies for upload heaps. Upload memory is write-combined, streaming
+//~ stores fill whole WC lines without pulling the destination into the cache.
+namespace framework
+{
+	inline constexpr std::size_t STREAM_ALIGNMENT = 16u;
+
+	inline bool IsStreamAligned(const void* ptr) noexcept
+	{
+		return (reinterpret_cast<std::uintptr_t>(ptr) & (STREAM_ALIGNMENT - 1u)) == 0u;
+	}
+
+	//~ dst must be 16 byte aligned, any tail that is not a multiple of 16 is copied normally
+	inline void StreamCopy(void* dst, const void* src, std::size_t bytes) noexcept
+	{
+#if FRAMEWORK_STREAM_STORES
+		assert(IsStreamAligned(dst) && "Streaming copy destination must be 16 byte aligned!");
+
+		auto*		out = static_cast<__m128i*>(dst);
+		const auto* in	= static_cast<const __m128i*>(src);
+
+		const std::size_t blocks = bytes / STREAM_ALIGNMENT;
+		for (std::size_t i = 0; i < blocks; ++i)
+		{
+			_mm_stream_si128(out + i, _mm_loadu_si128(in + i));
+		}
+
+		const std::size_t tail = bytes - blocks * STREAM_ALIGNMENT;
+		if (tail)
+		{
+			std::memcpy(out + blocks, in + blocks, tail);
+		}
+#else
+		std::memcpy(dst, src, bytes);
+#endif
+	}
+
+	//~ orders streamed writes before anything that follows (e.g. the submit reading them),
+	//~ every thread that streamed has to fence its own writes
+	inline void StreamFence() noexcept
+	{
+#if FRAMEWORK_STREAM_STORES
+		_mm_sfence();
+#endif
+	}
+} // namespace framework
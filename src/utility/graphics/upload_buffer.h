@@ -5,6 +5,8 @@
 #include <wrl/client.h>
 
 #include "framework/exception/dx_exception.h"
+#include "framework/render_manager/backend/dx_gpu_allocator.h"
+#include "stream_copy.h"
 
 
 namespace framework
@@ -19,11 +21,12 @@ namespace framework
 	class UploadBuffer
 	{
 	public:
-		UploadBuffer(ID3D12Device* device, UINT64 elementCounts, UploadBufferType type)
-			: m_nElementCount(elementCounts), m_eBufferType(type)
+		//~ placed in the allocator's upload heaps, the allocator must outlive the buffer
+		UploadBuffer(DxGpuAllocator* allocator, UINT64 elementCounts, UploadBufferType type)
+			: m_pAllocator(allocator), m_nElementCount(elementCounts), m_eBufferType(type)
 		{
-			assert(device && "Called to create upload buffer but D3D12::Device is nullptr!");
-			assert(device && "Called to create upload buffer but element count is == 0!");
+			assert(allocator && "Called to create upload buffer but the GPU allocator is nullptr!");
+			assert(elementCounts && "Called to create upload buffer but element count is == 0!");
 
 			m_nElementByteSize = static_cast<UINT64>(sizeof(T));
 
@@ -35,13 +38,6 @@ namespace framework
 
 			const UINT64 bufferSize = m_nElementCount * m_nElementByteSize;
 
-			D3D12_HEAP_PROPERTIES properties{};
-			properties.Type					= D3D12_HEAP_TYPE_UPLOAD;
-			properties.CPUPageProperty		= D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-			properties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-			properties.CreationNodeMask		= 1u;
-			properties.VisibleNodeMask		= 1u;
-
 			D3D12_RESOURCE_DESC resource{};
 			resource.Dimension			= D3D12_RESOURCE_DIMENSION_BUFFER;
 			resource.Alignment			= 0u;
@@ -55,17 +51,13 @@ namespace framework
 			resource.Layout				= D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
 			resource.Flags				= D3D12_RESOURCE_FLAG_NONE;
 
-			THROW_DX_IF_FAILS(device->CreateCommittedResource(
-				&properties,
-				D3D12_HEAP_FLAG_NONE,
-				&resource,
-				D3D12_RESOURCE_STATE_GENERIC_READ,
-				nullptr,
-				IID_PPV_ARGS(&m_pUploadResource)
-			));
+			m_allocation = m_pAllocator->CreateResource(resource,
+														D3D12_HEAP_TYPE_UPLOAD,
+														D3D12_RESOURCE_STATE_GENERIC_READ);
+			assert(m_allocation.IsValid() && "Upload buffer allocation failed!");
 
 			//~ map the data
-			THROW_DX_IF_FAILS(m_pUploadResource->Map(
+			THROW_DX_IF_FAILS(m_allocation.Resource->Map(
 				0u,
 				nullptr,
 				reinterpret_cast<void**>(&m_pMappedData)
@@ -74,9 +66,10 @@ namespace framework
 
 		~UploadBuffer()
 		{
-			if (m_pUploadResource)
+			if (m_allocation.IsValid())
 			{
-				m_pUploadResource->Unmap(0u, nullptr);
+				m_allocation.Resource->Unmap(0u, nullptr);
+				m_pAllocator->Free(m_allocation);
 			}
 			m_pMappedData = nullptr;
 		}
@@ -90,13 +83,28 @@ namespace framework
 			memcpy(&m_pMappedData[ elementIndex * m_nElementByteSize ], &data, sizeof(T));
 		}
 
+		//~ non-temporal copy, skips the cache on the write-combined upload heap.
+		//~ Call StreamFence() after the last streamed element of the frame.
+		void StreamData(UINT64 elementIndex, const T& data)
+		{
+			StreamCopy(GetMappedElement(elementIndex), &data, sizeof(T));
+		}
+
+		//~ direct write access for producers that fill elements in place
+		void* GetMappedElement(UINT64 elementIndex) const
+		{
+			assert(elementIndex < m_nElementCount && "Upload buffer element out of range!");
+			return &m_pMappedData[ elementIndex * m_nElementByteSize ];
+		}
+
 		UINT64 GetElementByteSize() const { return m_nElementByteSize; }
 
 		//~ Getters
-		ID3D12Resource* GetResource() const { return m_pUploadResource.Get(); }
+		ID3D12Resource* GetResource() const { return m_allocation.Resource.Get(); }
 
 	private:
-		Microsoft::WRL::ComPtr<ID3D12Resource> m_pUploadResource { nullptr };
+		DxGpuAllocator*						   m_pAllocator		 { nullptr };
+		GPU_ALLOCATION						   m_allocation		 {};
 		BYTE*								   m_pMappedData	 { nullptr };
 		UINT64								   m_nElementByteSize{ 0u };
 		UINT64								   m_nElementCount	 { 0u };
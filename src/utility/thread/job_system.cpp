@@ -0,0 +1,113 @@
+#include "job_system.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace framework;
+
+framework::JobSystem::JobSystem(std::uint32_t workerCount)
+{
+	if (workerCount == 0u)
+	{
+		const std::uint32_t hardware = std::thread::hardware_concurrency();
+		workerCount = hardware > 1u ? hardware - 1u : 1u;
+	}
+
+	m_workers.reserve(workerCount);
+	for (std::uint32_t i = 0u; i < workerCount; ++i)
+	{
+		m_workers.emplace_back([this]() { WorkerLoop(); });
+	}
+}
+
+framework::JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard lock(m_lock);
+		m_bStop = true;
+	}
+	m_signal.notify_all();
+
+	for (auto& worker : m_workers)
+	{
+		if (worker.joinable()) worker.join();
+	}
+}
+
+std::future<void> framework::JobSystem::Submit(Job&& job)
+{
+	std::packaged_task<void()> task(std::move(job));
+	auto future = task.get_future();
+	{
+		std::lock_guard lock(m_lock);
+		assert(!m_bStop && "Job submitted to a stopped job system!");
+		m_jobs.push_back(std::move(task));
+	}
+	m_signal.notify_one();
+	return future;
+}
+
+void framework::JobSystem::ParallelFor(std::uint32_t count, std::uint32_t minChunkSize, const RangeFn& fn)
+{
+	if (count == 0u) return;
+
+	minChunkSize = std::max(minChunkSize, 1u);
+
+	//~ workers plus the calling thread
+	const std::uint32_t lanes	   = GetWorkerCount() + 1u;
+	const std::uint32_t maxChunks  = (count + minChunkSize - 1u) / minChunkSize;
+	const std::uint32_t chunkCount = std::min(lanes, maxChunks);
+	const std::uint32_t chunkSize  = (count + chunkCount - 1u) / chunkCount;
+
+	std::vector<std::future<void>> pending{};
+	pending.reserve(chunkCount);
+
+	for (std::uint32_t begin = chunkSize; begin < count; begin += chunkSize)
+	{
+		const std::uint32_t end = std::min(begin + chunkSize, count);
+		pending.push_back(Submit([&fn, begin, end]() { fn(begin, end); }));
+	}
+
+	std::exception_ptr error{ nullptr };
+	try
+	{
+		fn(0u, std::min(chunkSize, count));
+	}
+	catch (...)
+	{
+		error = std::current_exception();
+	}
+
+	//~ always drain, the jobs reference fn
+	for (auto& job : pending)
+	{
+		try
+		{
+			job.get();
+		}
+		catch (...)
+		{
+			if (!error) error = std::current_exception();
+		}
+	}
+
+	if (error) std::rethrow_exception(error);
+}
+
+void framework::JobSystem::WorkerLoop()
+{
+	while (true)
+	{
+		std::packaged_task<void()> task{};
+		{
+			std::unique_lock lock(m_lock);
+			m_signal.wait(lock, [this]() { return m_bStop || !m_jobs.empty(); });
+
+			if (m_bStop && m_jobs.empty()) return;
+
+			task = std::move(m_jobs.front());
+			m_jobs.pop_front();
+		}
+		task();
+	}
+}
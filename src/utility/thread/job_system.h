@@ -0,0 +1,54 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace framework
+{
+	/// <summary>
+	/// Fixed size worker pool used for data parallel frame work (recording, culling,
+	/// transform updates...). Jobs must not block on other jobs of the same pool.
+	/// </summary>
+	class JobSystem
+	{
+	public:
+		using Job	  = std::function<void()>;
+		using RangeFn = std::function<void(std::uint32_t begin, std::uint32_t end)>;
+
+		//~ 0 picks hardware_concurrency - 1 (at least one worker)
+		explicit JobSystem(std::uint32_t workerCount = 0u);
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem(JobSystem&&)		= delete;
+
+		JobSystem& operator=(const JobSystem&) = delete;
+		JobSystem& operator=(JobSystem&&)	   = delete;
+
+		//~ operations
+		std::future<void> Submit(Job&& job);
+
+		//~ splits [0, count) in chunks of at least minChunkSize, the caller runs the first chunk
+		//~ and blocks until every chunk is done. Exceptions from chunks are rethrown here.
+		void ParallelFor(std::uint32_t count, std::uint32_t minChunkSize, const RangeFn& fn);
+
+		//~ Getters
+		std::uint32_t GetWorkerCount() const noexcept { return static_cast<std::uint32_t>(m_workers.size()); }
+
+	private:
+		void WorkerLoop();
+
+	private:
+		std::vector<std::thread>			  m_workers{};
+		std::deque<std::packaged_task<void()>> m_jobs	{};
+		std::mutex							  m_lock   {};
+		std::condition_variable				  m_signal {};
+		bool								  m_bStop  { false };
+	};
+} // namespace framework
@@ -0,0 +1,108 @@
+#include "host_test.h"
+
+#include "framework/render_manager/descriptor_allocator.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace framework;
+
+HOST_TEST(PersistentRangesAreReusedAfterFree)
+{
+	DescriptorAllocator allocator(64u, 16u, 3u);
+	CHECK(allocator.GetDescriptorCount() == 64u + 16u * 3u);
+
+	auto first	= allocator.AllocatePersistent(8u);
+	auto second = allocator.AllocatePersistent(8u);
+	CHECK(first.IsValid() && second.IsValid());
+	CHECK(first.Count == 8u);
+	CHECK(first.Index + first.Count <= second.Index || second.Index + second.Count <= first.Index);
+	CHECK(second.Index + second.Count <= 64u);
+	CHECK(allocator.GetStats().PersistentUsed	== 16u);
+	CHECK(allocator.GetStats().PersistentRanges == 2u);
+
+	const auto freedIndex = first.Index;
+	allocator.FreePersistent(first);
+	CHECK(!first.IsValid());
+	CHECK(allocator.GetStats().PersistentRanges == 1u);
+
+	//~ the freed range is the only hole that fits, the TLSF lists hand it back
+	auto rest  = allocator.AllocatePersistent(64u - 16u);
+	auto reuse = allocator.AllocatePersistent(8u);
+	CHECK(rest.IsValid());
+	CHECK(reuse.IsValid());
+	CHECK(reuse.Index == freedIndex);
+
+	CHECK(!allocator.AllocatePersistent(1u).IsValid());
+	CHECK(allocator.GetStats().FailedAllocations == 1u);
+}
+
+HOST_TEST(TransientSliceOverflowFails)
+{
+	DescriptorAllocator allocator(16u, 8u, 2u);
+	CHECK(allocator.BeginFrame(1u, 0u));
+
+	const auto first = allocator.AllocateTransient(1u, 5u);
+	CHECK(first.IsValid());
+	CHECK(first.Index == 16u + 8u); //~ second slice, after the persistent region
+	CHECK(first.Handle == INVALID_TLSF_HANDLE);
+
+	CHECK(!allocator.AllocateTransient(1u, 4u).IsValid());
+	CHECK(allocator.GetStats().FailedAllocations == 1u);
+	CHECK(allocator.GetStats().TransientPeak == 5u);
+
+	//~ the other slice is untouched
+	CHECK(allocator.AllocateTransient(0u, 8u).Index == 16u);
+}
+
+HOST_TEST(BeginFrameWaitsForTheSliceFence)
+{
+	DescriptorAllocator allocator(16u, 8u, 2u);
+	CHECK(allocator.BeginFrame(0u, 0u));
+	CHECK(allocator.AllocateTransient(0u, 6u).IsValid());
+	allocator.EndFrame(0u, 5u);
+
+	//~ the GPU is still on fence 4, the slice keeps its cursor
+	CHECK(!allocator.BeginFrame(0u, 4u));
+	CHECK(!allocator.AllocateTransient(0u, 4u).IsValid());
+
+	CHECK(allocator.BeginFrame(0u, 5u));
+	const auto range = allocator.AllocateTransient(0u, 8u);
+	CHECK(range.IsValid());
+	CHECK(range.Index == 16u);
+}
+
+HOST_TEST(ConcurrentTransientRangesAreDisjoint)
+{
+	constexpr std::uint32_t threadCount = 4u;
+	constexpr std::uint32_t perThread	= 500u;
+
+	DescriptorAllocator allocator(16u, threadCount * perThread * 2u, 1u);
+	CHECK(allocator.BeginFrame(0u, 0u));
+
+	std::vector<std::vector<DESCRIPTOR_RANGE>> ranges(threadCount);
+	std::vector<std::thread> threads{};
+	for (std::uint32_t t = 0u; t < threadCount; ++t)
+	{
+		threads.emplace_back([&, t]()
+		{
+			for (std::uint32_t i = 0u; i < perThread; ++i) ranges[ t ].push_back(allocator.AllocateTransient(0u, 1u + i % 3u));
+		});
+	}
+	for (auto& thread : threads) thread.join();
+
+	std::vector<DESCRIPTOR_RANGE> all{};
+	for (const auto& list : ranges) all.insert(all.end(), list.begin(), list.end());
+	std::sort(all.begin(), all.end(), [](const auto& a, const auto& b) { return a.Index < b.Index; });
+
+	bool valid = true, disjoint = true;
+	for (std::size_t i = 0; i < all.size(); ++i)
+	{
+		valid &= all[ i ].IsValid();
+		if (i > 0u) disjoint &= all[ i - 1u ].Index + all[ i - 1u ].Count <= all[ i ].Index;
+	}
+	CHECK(valid);
+	CHECK(disjoint);
+	CHECK(allocator.GetStats().FailedAllocations == 0u);
+}
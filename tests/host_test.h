@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+//~ Minimal registry for the host_tests target. A test is a function declared with HOST_TEST,
+//~ CHECK records a failure and keeps going, so one run reports every broken expectation.
+namespace host_test
+{
+	using TestFn = void(*)();
+
+	typedef struct _TEST_CASE
+	{
+		const char* Name{ nullptr };
+		TestFn		Run { nullptr };
+	} TEST_CASE;
+
+	std::vector<TEST_CASE>& GetTests();
+
+	//~ failures of the running test, workers of a test may report too
+	std::atomic<int>& GetFailureCount();
+
+	void ReportFailure(const char* file, int line, const char* expression);
+
+	struct Registrar
+	{
+		Registrar(const char* name, TestFn fn) { GetTests().push_back({ name, fn }); }
+	};
+} // namespace host_test
+
+#define HOST_TEST(name)														\
+	static void name();														\
+	static const host_test::Registrar name##_registrar{ #name, &name };		\
+	static void name()
+
+#define CHECK(expression)																	\
+	do																						\
+	{																						\
+		if (!(expression)) host_test::ReportFailure(__FILE__, __LINE__, #expression);		\
+	} while (false)
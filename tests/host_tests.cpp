@@ -0,0 +1,47 @@
+//~ Runs every HOST_TEST linked into the executable.
+//~ usage: host_tests [name filter], only tests whose name contains the filter run.
+
+#include "host_test.h"
+
+#include <cstdio>
+#include <cstring>
+
+std::vector<host_test::TEST_CASE>& host_test::GetTests()
+{
+	static std::vector<TEST_CASE> tests{};
+	return tests;
+}
+
+std::atomic<int>& host_test::GetFailureCount()
+{
+	static std::atomic<int> failures{ 0 };
+	return failures;
+}
+
+void host_test::ReportFailure(const char* file, int line, const char* expression)
+{
+	std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+	++GetFailureCount();
+}
+
+int main(int argc, char** argv)
+{
+	const char* filter = argc > 1 ? argv[ 1 ] : nullptr;
+
+	int run = 0, failed = 0;
+	for (const auto& test : host_test::GetTests())
+	{
+		if (filter && !std::strstr(test.Name, filter)) continue;
+
+		host_test::GetFailureCount() = 0;
+		test.Run();
+		++run;
+
+		const bool passed = host_test::GetFailureCount() == 0;
+		failed += passed ? 0 : 1;
+		std::printf("[%s] %s\n", passed ? " ok " : "FAIL", test.Name);
+	}
+
+	std::printf("%d of %d tests passed\n", run - failed, run);
+	return failed == 0 && run > 0 ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+#include "host_test.h"
+
+#include "framework/render_manager/hot_reload.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+using namespace framework;
+using namespace std::chrono_literals;
+
+namespace
+{
+	using Clock = HotReloadScheduler::Clock;
+
+	//~ a shader tree on disk, events are resolved against real paths
+	std::filesystem::path MakeShaderTree(const char* name)
+	{
+		const auto root = std::filesystem::temp_directory_path() / "framework_host_tests" / name;
+		std::filesystem::remove_all(root);
+		std::filesystem::create_directories(root / "common");
+		for (const char* file : { "color.hlsl", "lit.hlsl", "common/light.hlsli" })
+		{
+			std::ofstream(root / file) << "\n";
+		}
+		return root;
+	}
+} // namespace
+
+HOST_TEST(HotReloadWaitsForTheDebounce)
+{
+	const auto root = MakeShaderTree("hot_reload_debounce");
+	HotReloadScheduler scheduler(200ms);
+	const auto color = scheduler.Register("color", { root / "color.hlsl" });
+	CHECK(scheduler.Find("color") == color);
+	CHECK(scheduler.GetName(color) == "color");
+
+	const auto start = Clock::time_point{} + 1s;
+	CHECK(scheduler.OnFileChanged(root / "color.hlsl", start) == 1u);
+	CHECK(scheduler.GetState(color) == EReloadState::Pending);
+	CHECK(scheduler.TakeDue(start + 199ms).empty());
+
+	//~ an editor saving twice restarts the window
+	scheduler.OnFileChanged(root / "color.hlsl", start + 150ms);
+	CHECK(scheduler.TakeDue(start + 300ms).empty());
+
+	const auto due = scheduler.TakeDue(start + 350ms);
+	CHECK(due.size() == 1u && due[ 0 ] == color);
+	CHECK(scheduler.GetState(color) == EReloadState::Compiling);
+	CHECK(scheduler.TakeDue(start + 1s).empty());
+
+	scheduler.Complete(color, true);
+	CHECK(scheduler.GetState(color) == EReloadState::Ready);
+	CHECK(scheduler.TakeReady().size() == 1u);
+	CHECK(scheduler.GetState(color) == EReloadState::Idle);
+
+	const auto stats = scheduler.GetStats();
+	CHECK(stats.Changes	 == 2u);
+	CHECK(stats.Compiles == 1u);
+	CHECK(stats.Swaps	 == 1u);
+
+	//~ files nobody depends on are ignored
+	CHECK(scheduler.OnFileChanged(root / "lit.hlsl", start + 2s) == 0u);
+	CHECK(scheduler.GetStats().Changes == 2u);
+}
+
+HOST_TEST(HotReloadChangesWhileBusyGoBackToPending)
+{
+	const auto root = MakeShaderTree("hot_reload_dirty");
+	HotReloadScheduler scheduler(100ms);
+	const auto compiling = scheduler.Register("compiling", { root / "color.hlsl" });
+	const auto ready	 = scheduler.Register("ready", { root / "lit.hlsl" });
+
+	const auto start = Clock::time_point{} + 1s;
+	scheduler.OnFileChanged(root / "color.hlsl", start);
+	scheduler.OnFileChanged(root / "lit.hlsl", start);
+	CHECK(scheduler.TakeDue(start + 100ms).size() == 2u);
+	scheduler.Complete(ready, true);
+
+	//~ edits land while one compiles and the other waits for the frame boundary
+	scheduler.OnFileChanged(root / "color.hlsl", start + 150ms);
+	scheduler.OnFileChanged(root / "lit.hlsl", start + 150ms);
+	CHECK(scheduler.GetState(compiling) == EReloadState::Compiling);
+	CHECK(scheduler.GetState(ready)		== EReloadState::Ready);
+
+	//~ the stale result is still swapped in, the edit compiles after it
+	const auto swapped = scheduler.TakeReady();
+	CHECK(swapped.size() == 1u && swapped[ 0 ] == ready);
+	CHECK(scheduler.GetState(ready) == EReloadState::Pending);
+
+	scheduler.Complete(compiling, true);
+	CHECK(scheduler.TakeReady().size() == 1u);
+	CHECK(scheduler.GetState(compiling) == EReloadState::Pending);
+
+	CHECK(scheduler.TakeDue(start + 200ms).empty());
+	CHECK(scheduler.TakeDue(start + 250ms).size() == 2u);
+}
+
+HOST_TEST(HotReloadFailedCompilesKeepTheLiveProgram)
+{
+	const auto root = MakeShaderTree("hot_reload_failure");
+	HotReloadScheduler scheduler(0ms);
+	const auto clean = scheduler.Register("clean", { root / "color.hlsl" });
+	const auto dirty = scheduler.Register("dirty", { root / "lit.hlsl" });
+
+	const auto start = Clock::time_point{} + 1s;
+	scheduler.OnFileChanged(root / "color.hlsl", start);
+	scheduler.OnFileChanged(root / "lit.hlsl", start);
+	CHECK(scheduler.TakeDue(start).size() == 2u);
+
+	scheduler.OnFileChanged(root / "lit.hlsl", start + 1ms);
+	scheduler.Complete(clean, false);
+	scheduler.Complete(dirty, false);
+
+	CHECK(scheduler.GetState(clean) == EReloadState::Idle);
+	CHECK(scheduler.GetState(dirty) == EReloadState::Pending);
+	CHECK(scheduler.TakeReady().empty());
+	CHECK(scheduler.GetStats().Failures == 2u);
+
+	//~ the dirty flag was consumed, a success afterwards ends idle
+	CHECK(scheduler.TakeDue(start + 1ms).size() == 1u);
+	scheduler.Complete(dirty, true);
+	CHECK(scheduler.TakeReady().size() == 1u);
+	CHECK(scheduler.GetState(dirty) == EReloadState::Idle);
+}
+
+HOST_TEST(HotReloadDirectoryEventsTouchEverythingBelow)
+{
+	const auto root = MakeShaderTree("hot_reload_directory");
+	HotReloadScheduler scheduler(0ms);
+	const auto color = scheduler.Register("color", { root / "color.hlsl" });
+	const auto lit	 = scheduler.Register("lit", { root / "lit.hlsl", root / "common" / "light.hlsli" });
+
+	const auto start = Clock::time_point{} + 1s;
+	CHECK(scheduler.OnFileChanged(root / "common", start) == 1u);
+	CHECK(scheduler.GetState(color) == EReloadState::Idle);
+	CHECK(scheduler.GetState(lit)	== EReloadState::Pending);
+
+	//~ a trailing separator names the same directory
+	CHECK(scheduler.OnFileChanged(root / "common" / "", start) == 1u);
+	CHECK(scheduler.OnFileChanged(root, start) == 2u);
+	CHECK(scheduler.GetState(color) == EReloadState::Pending);
+
+	//~ a shared name prefix is not a parent directory
+	CHECK(scheduler.OnFileChanged(root / "col", start) == 0u);
+	CHECK(scheduler.OnFileChanged(root / "common" / "light", start) == 0u);
+
+	//~ dependencies can change with the includes of the last compile
+	scheduler.SetDependencies(color, { root / "color.hlsl", root / "common" / "light.hlsli" });
+	CHECK(scheduler.OnFileChanged(root / "common" / "light.hlsli", start) == 2u);
+}
+
+HOST_TEST(HotReloadResolvesRelativeAndAbsolutePaths)
+{
+	const auto root = MakeShaderTree("hot_reload_paths");
+	const auto previous = std::filesystem::current_path();
+	std::filesystem::current_path(root);
+
+	HotReloadScheduler scheduler(0ms);
+	const auto lit = scheduler.Register("lit", { "lit.hlsl", "./common/../common/light.hlsli" });
+
+	const auto start = Clock::time_point{} + 1s;
+	CHECK(scheduler.OnFileChanged(root / "lit.hlsl", start) == 1u);
+	CHECK(scheduler.OnFileChanged(root / "common" / "light.hlsli", start) == 1u);
+	CHECK(scheduler.OnFileChanged(root / "common" / ".." / "lit.hlsl", start) == 1u);
+
+	//~ and the other way round, absolute registration and relative events
+	const auto color = scheduler.Register("color", { root / "color.hlsl" });
+	CHECK(scheduler.OnFileChanged("color.hlsl", start) == 1u);
+	CHECK(scheduler.OnFileChanged("common/light.hlsli", start) == 1u);
+	CHECK(scheduler.GetState(color) == EReloadState::Pending);
+	CHECK(scheduler.GetState(lit)	== EReloadState::Pending);
+
+	std::filesystem::current_path(previous);
+}
@@ -0,0 +1,145 @@
+#include "host_test.h"
+
+#include "framework/render_manager/latency_tracker.h"
+
+#include <chrono>
+
+using namespace framework;
+using namespace std::chrono_literals;
+
+namespace
+{
+	using TimePoint = LatencyTracker::TimePoint;
+
+	const TimePoint START = TimePoint{} + 1s;
+
+	//~ input at frame * 10ms, present takes presentMs and returns latencyMs after the input
+	void RunFrame(LatencyTracker& tracker, std::uint64_t frame, std::chrono::milliseconds latency,
+				  std::chrono::milliseconds present = 1ms)
+	{
+		const auto input = START + frame * 10ms;
+		tracker.BeginFrame(frame, input);
+		tracker.EndFrame(frame, input + latency - present, input + latency);
+	}
+
+	bool Near(double value, double expected) noexcept
+	{
+		return value > expected - 1e-6 && value < expected + 1e-6;
+	}
+} // namespace
+
+HOST_TEST(LatencyFramesPairInOrder)
+{
+	LatencyTracker tracker(8u);
+	CHECK(tracker.GetStats().Frames == 0u);
+	CHECK(tracker.GetStats().P95Ms	== 0.0);
+
+	//~ three frames in flight, each closed by its own present
+	tracker.BeginFrame(1u, START, 0.5);
+	tracker.BeginFrame(2u, START + 10ms, 1.5);
+	tracker.BeginFrame(3u, START + 20ms);
+	tracker.EndFrame(1u, START + 28ms, START + 30ms);
+	tracker.EndFrame(2u, START + 36ms, START + 40ms);
+	tracker.EndFrame(3u, START + 44ms, START + 50ms);
+
+	const auto stats = tracker.GetStats();
+	CHECK(stats.Frames	== 3u);
+	CHECK(stats.Dropped == 0u);
+	CHECK(Near(stats.AverageMs, 30.0));
+	CHECK(Near(stats.MaxMs, 30.0));
+	CHECK(Near(stats.AveragePresentMs, 4.0));
+	CHECK(Near(stats.AverageWaitMs, 2.0 / 3.0));
+
+	//~ a present for a frame that never began is ignored
+	tracker.EndFrame(9u, START + 90ms, START + 95ms);
+	CHECK(tracker.GetStats().Frames == 3u);
+}
+
+HOST_TEST(LatencySkippedFramesAreDropped)
+{
+	LatencyTracker tracker(8u);
+	tracker.BeginFrame(1u, START);
+	tracker.BeginFrame(2u, START + 10ms);
+	tracker.BeginFrame(3u, START + 20ms);
+
+	//~ frames 1 and 2 were thrown away, 3 is the one presented
+	tracker.EndFrame(3u, START + 40ms, START + 45ms);
+
+	auto stats = tracker.GetStats();
+	CHECK(stats.Frames	== 1u);
+	CHECK(stats.Dropped == 2u);
+	CHECK(Near(stats.AverageMs, 25.0));
+
+	//~ the late present of a dropped frame changes nothing
+	tracker.EndFrame(2u, START + 50ms, START + 55ms);
+	stats = tracker.GetStats();
+	CHECK(stats.Frames	== 1u);
+	CHECK(stats.Dropped == 2u);
+
+	tracker.Reset();
+	CHECK(tracker.GetStats().Frames	 == 0u);
+	CHECK(tracker.GetStats().Dropped == 0u);
+}
+
+HOST_TEST(LatencyPendingFramesAreBounded)
+{
+	LatencyTracker tracker(8u);
+	const auto count = LatencyTracker::MAX_PENDING_FRAMES + 4u;
+	for (std::uint64_t frame = 0u; frame < count; ++frame) tracker.BeginFrame(frame, START + frame * 10ms);
+
+	//~ the oldest starts fell off the queue
+	CHECK(tracker.GetStats().Dropped == 4u);
+	tracker.EndFrame(3u, START + 100ms, START + 101ms);
+	CHECK(tracker.GetStats().Frames == 0u);
+
+	//~ the first frame still queued presents normally
+	tracker.EndFrame(4u, START + 100ms, START + 101ms);
+	const auto stats = tracker.GetStats();
+	CHECK(stats.Frames	== 1u);
+	CHECK(stats.Dropped == 4u);
+	CHECK(Near(stats.AverageMs, 61.0));
+}
+
+HOST_TEST(LatencyWindowKeepsTheLastFrames)
+{
+	LatencyTracker tracker(4u);
+	for (std::uint64_t frame = 0u; frame < 4u; ++frame) RunFrame(tracker, frame, 100ms);
+	CHECK(Near(tracker.GetStats().AverageMs, 100.0));
+
+	//~ six newer frames wrap the ring, only the last four remain
+	for (std::uint64_t frame = 4u; frame < 10u; ++frame) RunFrame(tracker, frame, std::chrono::milliseconds(frame));
+
+	const auto stats = tracker.GetStats();
+	CHECK(stats.Frames == 4u);
+	CHECK(Near(stats.AverageMs, (6.0 + 7.0 + 8.0 + 9.0) / 4.0));
+	CHECK(Near(stats.MaxMs, 9.0));
+}
+
+HOST_TEST(LatencyPercentilesUseNearestRank)
+{
+	LatencyTracker tracker(64u);
+
+	//~ latencies 1..20 ms fed out of order
+	for (std::uint64_t frame = 0u; frame < 20u; ++frame)
+	{
+		RunFrame(tracker, frame, std::chrono::milliseconds((frame * 7u) % 20u + 1u));
+	}
+
+	auto stats = tracker.GetStats();
+	CHECK(stats.Frames == 20u);
+	CHECK(Near(stats.P50Ms, 10.0));
+	CHECK(Near(stats.P95Ms, 19.0));
+	CHECK(Near(stats.MaxMs, 20.0));
+	CHECK(Near(stats.AverageMs, 10.5));
+
+	//~ one more sample moves both ranks up
+	RunFrame(tracker, 20u, 21ms);
+	stats = tracker.GetStats();
+	CHECK(Near(stats.P50Ms, 11.0));
+	CHECK(Near(stats.P95Ms, 20.0));
+
+	LatencyTracker single(4u);
+	RunFrame(single, 0u, 7ms);
+	CHECK(Near(single.GetStats().P50Ms, 7.0));
+	CHECK(Near(single.GetStats().P95Ms, 7.0));
+}
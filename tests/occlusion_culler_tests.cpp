@@ -0,0 +1,115 @@
+#include "host_test.h"
+
+#include "framework/scene/occlusion_culler.h"
+#include "utility/graphics/geometry_generator.h"
+
+#include <vector>
+
+using namespace DirectX;
+using namespace framework;
+
+namespace
+{
+	//~ camera at the origin looking down +z, what the benchmark uses
+	XMFLOAT4X4 MakeViewProj()
+	{
+		const XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.f, 0.f, 0.f, 1.f), XMVectorSet(0.f, 0.f, 1.f, 1.f), XMVectorSet(0.f, 1.f, 0.f, 0.f));
+		const XMMATRIX proj = XMMatrixPerspectiveFovLH(0.25f * XM_PI, 2.f, 0.1f, 1000.f);
+
+		XMFLOAT4X4 viewProj{};
+		XMStoreFloat4x4(&viewProj, XMMatrixMultiply(view, proj));
+		return viewProj;
+	}
+
+	/// <summary>
+	/// An 8x8 wall half a unit thick, centered on the view axis 10 units away.
+	/// </summary>
+	class WallScene
+	{
+	public:
+		WallScene()
+		{
+			GeometryGenerator generator{};
+			const auto box = generator.CreateBox(1.f, 1.f, 1.f, 0u);
+			for (const auto& v : box.Vertices) m_positions.push_back(v.Position);
+			m_indices = box.Indices32;
+
+			XMStoreFloat4x4(&m_wall, XMMatrixMultiply(XMMatrixScaling(8.f, 8.f, 0.5f), XMMatrixTranslation(0.f, 0.f, 10.f)));
+		}
+
+		OcclusionCuller& Render(bool withWall = true)
+		{
+			m_culler.Begin(MakeViewProj());
+			if (withWall)
+			{
+				m_culler.RasterizeOccluder(m_positions.data(), static_cast<std::uint32_t>(m_positions.size()),
+										   m_indices.data(), static_cast<std::uint32_t>(m_indices.size()), m_wall);
+			}
+			m_culler.Finalize();
+			return m_culler;
+		}
+
+	private:
+		OcclusionCuller			   m_culler	  {};
+		std::vector<XMFLOAT3>	   m_positions{};
+		std::vector<std::uint32_t> m_indices  {};
+		XMFLOAT4X4				   m_wall	  {};
+	};
+} // namespace
+
+HOST_TEST(WallHidesOnlyWhatIsBehindIt)
+{
+	WallScene scene{};
+	const auto& culler = scene.Render();
+
+	CHECK( culler.IsOccluded(MakeBoundingBox({ 0.f,	 0.f, 20.f }, { 1.f, 1.f, 1.f })));
+	CHECK( culler.IsOccluded(MakeBoundingBox({ 2.f, -2.f, 60.f }, { 3.f, 3.f, 3.f })));
+	CHECK(!culler.IsOccluded(MakeBoundingBox({ 0.f,	 0.f, 5.f  }, { 1.f, 1.f, 1.f })));
+	CHECK(!culler.IsOccluded(MakeBoundingBox({ 30.f, 0.f, 20.f }, { 1.f, 1.f, 1.f })));
+	CHECK(!culler.IsOccluded(MakeBoundingBox({ 0.f,	 0.f, 10.f }, { 1.f, 1.f, 2.f })));
+}
+
+HOST_TEST(BoxPeekingPastTheWallEdgeIsVisible)
+{
+	WallScene scene{};
+	const auto& culler = scene.Render();
+
+	//~ the wall edge projects to x/z ~ 0.41: the first box spans 0.38 to 0.53, the second 0.14 to 0.26
+	CHECK(!culler.IsOccluded(MakeBoundingBox({ 9.f, 0.f, 20.f }, { 1.f, 1.f, 1.f })));
+	CHECK( culler.IsOccluded(MakeBoundingBox({ 4.f, 0.f, 20.f }, { 1.f, 1.f, 1.f })));
+}
+
+HOST_TEST(EmptyDepthHidesNothing)
+{
+	WallScene scene{};
+	const auto& culler = scene.Render(false);
+
+	CHECK(!culler.IsOccluded(MakeBoundingBox({ 0.f, 0.f, 20.f  }, { 1.f, 1.f, 1.f })));
+	CHECK(!culler.IsOccluded(MakeBoundingBox({ 0.f, 0.f, 900.f }, { 1.f, 1.f, 1.f })));
+	CHECK(culler.GetLastStats().Occluders == 0u);
+}
+
+HOST_TEST(NearPlaneAndOffscreenOccludeesStayVisible)
+{
+	WallScene scene{};
+	const auto& culler = scene.Render();
+
+	CHECK(!culler.IsOccluded(MakeBoundingBox({ 0.f,	  0.f, 0.f  }, { 1.f, 1.f, 1.f })));
+	CHECK(!culler.IsOccluded(MakeBoundingBox({ 0.f,	  0.f, -20.f }, { 1.f, 1.f, 1.f })));
+	CHECK(!culler.IsOccluded(MakeBoundingBox({ 500.f, 0.f, 20.f }, { 1.f, 1.f, 1.f })));
+}
+
+HOST_TEST(OccludeeTestsAreCounted)
+{
+	WallScene scene{};
+	auto& culler = scene.Render();
+
+	CHECK( culler.TestOccludee(MakeBoundingBox({ 0.f,  0.f, 20.f }, { 1.f, 1.f, 1.f })));
+	CHECK(!culler.TestOccludee(MakeBoundingBox({ 30.f, 0.f, 20.f }, { 1.f, 1.f, 1.f })));
+
+	const auto& stats = culler.GetLastStats();
+	CHECK(stats.Occluders == 1u);
+	CHECK(stats.Triangles == 12u);
+	CHECK(stats.Tested	  == 2u);
+	CHECK(stats.Occluded  == 1u);
+}
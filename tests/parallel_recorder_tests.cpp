@@ -0,0 +1,136 @@
+#include "host_test.h"
+
+#include "framework/render_manager/backend/recording_backend.h"
+#include "framework/render_manager/parallel_recorder.h"
+#include "utility/thread/job_system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+using namespace framework;
+
+namespace
+{
+	//~ one draw per item with item dependent arguments so any reordering changes the stream
+	void RecordItems(ICommandRecorder& recorder, const RECORD_RANGE& range)
+	{
+		for (std::uint32_t i = range.Begin; i < range.End; ++i)
+		{
+			recorder.SetGraphicsRootConstantBufferView(1u, 0x10000ull + i * 256ull);
+			recorder.DrawIndexedInstanced(36u + i, 1u, i * 3u, static_cast<std::int32_t>(i), 0u);
+		}
+	}
+
+	std::vector<std::uint8_t> RecordSerial(std::uint32_t itemCount)
+	{
+		RecordingCommandRecorder recorder{};
+		RecordItems(recorder, { 0u, itemCount });
+		return recorder.GetStream();
+	}
+
+	//~ records through ParallelRecorder and replays the chunks in submit order into one stream
+	std::vector<std::uint8_t> RecordParallel(std::uint32_t itemCount, std::uint32_t recorderCount,
+											 std::uint32_t minItemsPerChunk, JobSystem* jobs,
+											 std::uint32_t* usedCount = nullptr)
+	{
+		std::vector<std::unique_ptr<RecordingCommandRecorder>> owned{};
+		std::vector<ICommandRecorder*> recorders{};
+		for (std::uint32_t i = 0u; i < recorderCount; ++i)
+		{
+			owned.push_back(std::make_unique<RecordingCommandRecorder>());
+			recorders.push_back(owned.back().get());
+		}
+
+		const auto used = ParallelRecorder(jobs).Record(itemCount, recorders, minItemsPerChunk,
+			[](ICommandRecorder& recorder, std::uint32_t, const RECORD_RANGE& range) { RecordItems(recorder, range); });
+		if (usedCount) *usedCount = used;
+
+		for (std::uint32_t i = used; i < recorderCount; ++i)
+		{
+			CHECK(owned[ i ]->GetCommandCount() == 0u);
+		}
+
+		RecordingCommandRecorder merged{};
+		for (std::uint32_t i = 0u; i < used; ++i) owned[ i ]->Replay(merged);
+		return merged.GetStream();
+	}
+} // namespace
+
+HOST_TEST(PartitionCoversEveryItemInOrder)
+{
+	for (std::uint32_t items : { 1u, 7u, 64u, 1000u, 1023u })
+	{
+		for (std::uint32_t chunks : { 1u, 3u, 8u, 16u })
+		{
+			const auto ranges = PartitionRecordRanges(items, chunks, 16u);
+			CHECK(!ranges.empty());
+			CHECK(ranges.size() <= chunks);
+			CHECK(ranges.front().Begin == 0u);
+			CHECK(ranges.back().End == items);
+
+			std::uint32_t smallest = items, largest = 0u;
+			for (std::size_t i = 0; i < ranges.size(); ++i)
+			{
+				if (i > 0u) CHECK(ranges[ i ].Begin == ranges[ i - 1u ].End);
+				smallest = std::min(smallest, ranges[ i ].End - ranges[ i ].Begin);
+				largest	 = std::max(largest, ranges[ i ].End - ranges[ i ].Begin);
+			}
+			CHECK(largest - smallest <= 1u);
+			if (ranges.size() > 1u) CHECK(smallest >= 16u);
+		}
+	}
+}
+
+HOST_TEST(PartitionHonoursTheMinimumChunkSize)
+{
+	CHECK(PartitionRecordRanges(0u, 4u, 16u).empty());
+	CHECK(PartitionRecordRanges(100u, 0u, 16u).empty());
+	CHECK(PartitionRecordRanges(15u, 4u, 16u).size() == 1u);
+	CHECK(PartitionRecordRanges(64u, 8u, 16u).size() == 4u);
+	CHECK(PartitionRecordRanges(64u, 8u, 0u).size() == 8u);
+}
+
+HOST_TEST(ParallelRecordingMatchesSerialOrder)
+{
+	JobSystem jobs(4u);
+	for (std::uint32_t items : { 1u, 33u, 500u, 4096u })
+	{
+		const auto serial = RecordSerial(items);
+		CHECK(RecordParallel(items, 4u, 8u, &jobs)	  == serial);
+		CHECK(RecordParallel(items, 8u, 8u, &jobs)	  == serial);
+		CHECK(RecordParallel(items, 3u, 1u, nullptr) == serial);
+	}
+}
+
+HOST_TEST(ParallelRecordingLeavesUnusedRecordersUntouched)
+{
+	JobSystem jobs(2u);
+
+	std::uint32_t used = 0u;
+	RecordParallel(40u, 8u, 16u, &jobs, &used);
+	CHECK(used == 2u);
+
+	RecordParallel(0u, 4u, 16u, &jobs, &used);
+	CHECK(used == 0u);
+}
+
+HOST_TEST(ParallelRecordingHandsEachChunkItsOwnRecorder)
+{
+	JobSystem jobs(4u);
+
+	RecordingCommandRecorder recorders[ 4 ]{};
+	std::vector<ICommandRecorder*> list{ &recorders[ 0 ], &recorders[ 1 ], &recorders[ 2 ], &recorders[ 3 ] };
+
+	std::atomic<std::uint32_t> calls{ 0u };
+	const auto used = ParallelRecorder(&jobs).Record(400u, list, 1u,
+		[&](ICommandRecorder& recorder, std::uint32_t chunk, const RECORD_RANGE& range)
+		{
+			CHECK(&recorder == list[ chunk ]);
+			CHECK(range.End - range.Begin == 100u);
+			++calls;
+		});
+
+	CHECK(used == 4u);
+	CHECK(calls == 4u);
+}
@@ -0,0 +1,141 @@
+#include "host_test.h"
+
+#include "framework/render_manager/pipeline_cache_file.h"
+#include "framework/render_manager/state_hash.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace framework;
+
+namespace
+{
+	constexpr std::uint64_t DEVICE_ID = 0x10de2204ull;
+
+	//~ header layout: magic, version, device id, entry count
+	constexpr std::size_t VERSION_OFFSET = sizeof(std::uint32_t);
+	constexpr std::size_t DEVICE_OFFSET	 = 2u * sizeof(std::uint32_t);
+
+	std::vector<std::uint8_t> MakeFile()
+	{
+		PipelineCacheFile cache(DEVICE_ID);
+		const std::string first = "first pipeline blob";
+		const std::string second = "second";
+		cache.Store(1u, first.data(), first.size());
+		cache.Store(7u, second.data(), second.size());
+		return cache.Serialize();
+	}
+
+	template<typename T>
+	void Patch(std::vector<std::uint8_t>& data, std::size_t offset, T value)
+	{
+		std::memcpy(data.data() + offset, &value, sizeof(T));
+	}
+} // namespace
+
+HOST_TEST(PipelineCacheFileRoundTrips)
+{
+	const auto path = std::filesystem::temp_directory_path() / "framework_host_tests" / "pipelines.bin";
+	std::filesystem::remove(path);
+
+	PipelineCacheFile cache(DEVICE_ID);
+	CHECK(cache.Load(path) == EPipelineCacheLoad::Missing);
+
+	const std::uint8_t blob[]{ 1u, 2u, 3u, 4u, 5u };
+	cache.Store(42u, blob, sizeof(blob));
+	cache.Store(43u, blob, 2u);
+	CHECK(cache.IsDirty());
+	CHECK(cache.Save(path));
+	CHECK(!cache.IsDirty());
+
+	PipelineCacheFile loaded(DEVICE_ID);
+	CHECK(loaded.Load(path) == EPipelineCacheLoad::Loaded);
+	CHECK(loaded.GetEntryCount() == 2u);
+	CHECK(loaded.GetByteSize()	 == sizeof(blob) + 2u);
+
+	std::vector<std::uint8_t> found{};
+	CHECK(loaded.Find(42u, found));
+	CHECK(found == std::vector<std::uint8_t>(blob, blob + sizeof(blob)));
+	CHECK(!loaded.Find(44u, found));
+
+	//~ the same entries give the same bytes, whatever order they were stored in
+	CHECK(loaded.Serialize() == cache.Serialize());
+
+	std::filesystem::remove(path);
+}
+
+HOST_TEST(PipelineCacheFileRejectsOtherVersionsAndDevices)
+{
+	auto version = MakeFile();
+	Patch(version, VERSION_OFFSET, PipelineCacheFile::VERSION + 1u);
+
+	PipelineCacheFile cache(DEVICE_ID);
+	CHECK(cache.Deserialize(version.data(), version.size()) == EPipelineCacheLoad::VersionMismatch);
+
+	auto device = MakeFile();
+	Patch(device, DEVICE_OFFSET, DEVICE_ID + 1u);
+	CHECK(cache.Deserialize(device.data(), device.size()) == EPipelineCacheLoad::DeviceMismatch);
+
+	const auto valid = MakeFile();
+	PipelineCacheFile other(DEVICE_ID + 1u);
+	CHECK(other.Deserialize(valid.data(), valid.size()) == EPipelineCacheLoad::DeviceMismatch);
+	CHECK(cache.GetEntryCount() == 0u);
+	CHECK(other.GetEntryCount() == 0u);
+}
+
+HOST_TEST(PipelineCacheFileRejectsDamagedFiles)
+{
+	const auto valid = MakeFile();
+	PipelineCacheFile cache(DEVICE_ID);
+
+	CHECK(cache.Deserialize(valid.data(), 3u)				 == EPipelineCacheLoad::Corrupt);
+	CHECK(cache.Deserialize(valid.data(), valid.size() - 1u) == EPipelineCacheLoad::Corrupt);
+
+	auto flipped = valid;
+	flipped.back() ^= 0x10u;
+	CHECK(cache.Deserialize(flipped.data(), flipped.size()) == EPipelineCacheLoad::Corrupt);
+
+	auto trailing = valid;
+	trailing.push_back(0u);
+	CHECK(cache.Deserialize(trailing.data(), trailing.size()) == EPipelineCacheLoad::Corrupt);
+
+	auto magic = valid;
+	magic[ 0 ] ^= 0xffu;
+	CHECK(cache.Deserialize(magic.data(), magic.size()) == EPipelineCacheLoad::Corrupt);
+
+	//~ a bad file adds nothing, not even the entries before the damage
+	CHECK(cache.GetEntryCount() == 0u);
+
+	//~ same for a file on disk cut short
+	const auto path = std::filesystem::temp_directory_path() / "framework_host_tests" / "truncated.bin";
+	std::filesystem::create_directories(path.parent_path());
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(valid.data()), static_cast<std::streamsize>(valid.size() / 2u));
+	}
+	CHECK(cache.Load(path) == EPipelineCacheLoad::Corrupt);
+	std::filesystem::remove(path);
+
+	CHECK(cache.Deserialize(valid.data(), valid.size()) == EPipelineCacheLoad::Loaded);
+	CHECK(cache.GetEntryCount() == 2u);
+}
+
+HOST_TEST(StateHasherIsStable)
+{
+	//~ FNV-1a reference values, the hash keys files on disk and must never drift
+	CHECK(StateHasher{}.Get() == StateHasher::OFFSET_BASIS);
+	CHECK(HashBytes("a", 1u)	 == 0xaf63dc4c8601ec8cull);
+	CHECK(HashBytes("foobar", 6u) == 0x85944171f73967e8ull);
+
+	const std::uint32_t value = 0x01020304u;
+	CHECK(StateHasher{}.Add(value).Get() == StateHasher{}.Add(&value, sizeof(value)).Get());
+	CHECK(StateHasher{}.Add(1u).Add(2u).Get() == StateHasher{}.Add(1u).Add(2u).Get());
+	CHECK(StateHasher{}.Add(1u).Add(2u).Get() != StateHasher{}.Add(2u).Add(1u).Get());
+
+	//~ strings are length prefixed, the split point changes the hash
+	CHECK(StateHasher{}.AddString("ab").AddString("c").Get() != StateHasher{}.AddString("a").AddString("bc").Get());
+	CHECK(StateHasher{ 5u }.AddString("x").Get() != StateHasher{}.AddString("x").Get());
+}
@@ -0,0 +1,286 @@
+#include "host_test.h"
+
+#include "framework/render_manager/backend/recording_backend.h"
+#include "framework/render_manager/resource_state_tracker.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace framework;
+
+namespace
+{
+	//~ the tracker never dereferences its handles
+	GpuResourceHandle MakeHandle(std::uintptr_t id) noexcept
+	{
+		return reinterpret_cast<GpuResourceHandle>(id * 0x1000u);
+	}
+
+	typedef struct _FLUSHED_BARRIERS
+	{
+		std::uint32_t					Batches { 0u };
+		std::vector<GpuResourceBarrier> Barriers{};
+	} FLUSHED_BARRIERS;
+
+	//~ flushes into a fresh recorder and reads the batch back out of its stream
+	FLUSHED_BARRIERS Flush(ResourceStateTracker& tracker)
+	{
+		RecordingCommandRecorder recorder{};
+		tracker.Flush(recorder);
+
+		FLUSHED_BARRIERS flushed{};
+		flushed.Batches = recorder.GetCommandCount(ERecordedCommand::ResourceBarriers);
+		recorder.ForEach([&](const RECORDED_COMMAND_HEADER& header, const void* payload)
+		{
+			if (header.Command != ERecordedCommand::ResourceBarriers) return;
+
+			recorded::Barriers batch{};
+			std::memcpy(&batch, payload, sizeof(batch));
+
+			const auto* source = static_cast<const std::uint8_t*>(payload) + sizeof(batch);
+			for (std::uint32_t i = 0u; i < batch.Count; ++i)
+			{
+				recorded::Barrier barrier{};
+				std::memcpy(&barrier, source + i * sizeof(barrier), sizeof(barrier));
+				flushed.Barriers.push_back({ barrier.Type, barrier.Flags,
+											 reinterpret_cast<GpuResourceHandle>(static_cast<std::uintptr_t>(barrier.Resource)),
+											 barrier.Before, barrier.After, barrier.Subresource });
+			}
+		});
+		return flushed;
+	}
+
+	bool IsTransition(const GpuResourceBarrier& barrier, GpuResourceHandle resource,
+					  EResourceState before, EResourceState after,
+					  std::uint32_t subresource = ALL_SUBRESOURCES,
+					  EBarrierFlags flags = EBarrierFlags::None) noexcept
+	{
+		return barrier.Type == EBarrierType::Transition && barrier.Flags == flags && barrier.Resource == resource
+			&& barrier.Before == before && barrier.After == after && barrier.Subresource == subresource;
+	}
+
+	bool IsUav(const GpuResourceBarrier& barrier, GpuResourceHandle resource) noexcept
+	{
+		return barrier.Type == EBarrierType::UnorderedAccess && barrier.Resource == resource;
+	}
+} // namespace
+
+HOST_TEST(RedundantTransitionsEmitNothing)
+{
+	const auto texture = MakeHandle(1u);
+	ResourceStateCache cache{};
+	cache.Register(texture, EResourceState::GenericRead);
+
+	ResourceStateTracker tracker(cache);
+	tracker.Transition(texture, EResourceState::GenericRead);
+	tracker.Transition(texture, EResourceState::PixelShaderResource); //~ covered by GenericRead
+
+	const auto flushed = Flush(tracker);
+	CHECK(flushed.Batches == 0u);
+	CHECK(flushed.Barriers.empty());
+	CHECK(tracker.GetStats().Requested == 2u);
+	CHECK(tracker.GetStats().Redundant == 2u);
+	CHECK(tracker.GetStats().Emitted   == 0u);
+}
+
+HOST_TEST(ChainFoldsIntoOneBarrier)
+{
+	const auto buffer = MakeHandle(1u);
+	ResourceStateCache cache{};
+	cache.Register(buffer, EResourceState::Common);
+
+	ResourceStateTracker tracker(cache);
+	tracker.Transition(buffer, EResourceState::CopyDest);
+	tracker.Transition(buffer, EResourceState::PixelShaderResource);
+
+	const auto flushed = Flush(tracker);
+	CHECK(flushed.Barriers.size() == 1u);
+	CHECK(IsTransition(flushed.Barriers[ 0 ], buffer, EResourceState::Common, EResourceState::PixelShaderResource));
+	CHECK(tracker.GetStats().Merged == 1u);
+	CHECK(tracker.GetState(buffer) == EResourceState::PixelShaderResource);
+}
+
+HOST_TEST(RoundTripDisappears)
+{
+	const auto target = MakeHandle(1u);
+	ResourceStateCache cache{};
+	cache.Register(target, EResourceState::RenderTarget);
+
+	ResourceStateTracker tracker(cache);
+	tracker.Transition(target, EResourceState::PixelShaderResource);
+	tracker.Transition(target, EResourceState::RenderTarget);
+
+	CHECK(tracker.GetPendingBarriers().empty());
+	CHECK(Flush(tracker).Batches == 0u);
+	CHECK(tracker.GetState(target) == EResourceState::RenderTarget);
+}
+
+HOST_TEST(BarriersOfABatchGoOutInOneCall)
+{
+	const auto color = MakeHandle(1u);
+	const auto depth = MakeHandle(2u);
+	ResourceStateCache cache{};
+	cache.Register(color, EResourceState::Present);
+	cache.Register(depth, EResourceState::DepthWrite);
+
+	ResourceStateTracker tracker(cache);
+	tracker.Transition(color, EResourceState::RenderTarget);
+	tracker.Transition(depth, EResourceState::DepthRead);
+
+	const auto flushed = Flush(tracker);
+	CHECK(flushed.Batches == 1u);
+	CHECK(flushed.Barriers.size() == 2u);
+	CHECK(IsTransition(flushed.Barriers[ 0 ], color, EResourceState::Present, EResourceState::RenderTarget));
+	CHECK(IsTransition(flushed.Barriers[ 1 ], depth, EResourceState::DepthWrite, EResourceState::DepthRead));
+	CHECK(tracker.GetStats().Batches == 1u);
+	CHECK(tracker.GetStats().Emitted == 2u);
+}
+
+HOST_TEST(SubresourcesMoveOnTheirOwn)
+{
+	const auto texture = MakeHandle(1u);
+	ResourceStateCache cache{};
+	cache.Register(texture, EResourceState::Common, 4u);
+
+	ResourceStateTracker tracker(cache);
+	tracker.Transition(texture, EResourceState::RenderTarget, 1u);
+
+	auto flushed = Flush(tracker);
+	CHECK(flushed.Barriers.size() == 1u);
+	CHECK(IsTransition(flushed.Barriers[ 0 ], texture, EResourceState::Common, EResourceState::RenderTarget, 1u));
+
+	//~ the cache keeps the old states until the list commits
+	CHECK(cache.GetState(texture, 1u) == EResourceState::Common);
+	tracker.Commit();
+	CHECK(cache.GetState(texture, 0u) == EResourceState::Common);
+	CHECK(cache.GetState(texture, 1u) == EResourceState::RenderTarget);
+
+	//~ a later list brings the one diverged subresource back, the others are already there
+	ResourceStateTracker next(cache);
+	next.Transition(texture, EResourceState::Common);
+
+	flushed = Flush(next);
+	CHECK(flushed.Barriers.size() == 1u);
+	CHECK(IsTransition(flushed.Barriers[ 0 ], texture, EResourceState::RenderTarget, EResourceState::Common, 1u));
+	next.Commit();
+	CHECK(cache.GetState(texture, 1u) == EResourceState::Common);
+}
+
+HOST_TEST(SplitBarrierBeginsAndEnds)
+{
+	const auto target = MakeHandle(1u);
+	ResourceStateCache cache{};
+	cache.Register(target, EResourceState::RenderTarget);
+
+	ResourceStateTracker tracker(cache);
+	tracker.BeginTransition(target, EResourceState::PixelShaderResource);
+	CHECK(tracker.GetOpenSplitCount() == 1u);
+
+	auto flushed = Flush(tracker);
+	CHECK(flushed.Barriers.size() == 1u);
+	CHECK(IsTransition(flushed.Barriers[ 0 ], target, EResourceState::RenderTarget, EResourceState::PixelShaderResource,
+					   ALL_SUBRESOURCES, EBarrierFlags::BeginOnly));
+
+	tracker.EndTransition(target);
+	CHECK(tracker.GetOpenSplitCount() == 0u);
+
+	flushed = Flush(tracker);
+	CHECK(flushed.Barriers.size() == 1u);
+	CHECK(IsTransition(flushed.Barriers[ 0 ], target, EResourceState::RenderTarget, EResourceState::PixelShaderResource,
+					   ALL_SUBRESOURCES, EBarrierFlags::EndOnly));
+}
+
+HOST_TEST(TransitionEndsAnOpenSplitFirst)
+{
+	const auto target = MakeHandle(1u);
+	ResourceStateCache cache{};
+	cache.Register(target, EResourceState::RenderTarget);
+
+	ResourceStateTracker tracker(cache);
+	tracker.BeginTransition(target, EResourceState::PixelShaderResource);
+	Flush(tracker);
+
+	//~ the end half is not folded into the next transition
+	tracker.Transition(target, EResourceState::CopySource);
+	const auto flushed = Flush(tracker);
+	CHECK(tracker.GetOpenSplitCount() == 0u);
+	CHECK(flushed.Barriers.size() == 2u);
+	CHECK(IsTransition(flushed.Barriers[ 0 ], target, EResourceState::RenderTarget, EResourceState::PixelShaderResource,
+					   ALL_SUBRESOURCES, EBarrierFlags::EndOnly));
+	CHECK(IsTransition(flushed.Barriers[ 1 ], target, EResourceState::PixelShaderResource, EResourceState::CopySource));
+}
+
+HOST_TEST(BackToBackUavBarriersCollapse)
+{
+	const auto first  = MakeHandle(1u);
+	const auto second = MakeHandle(2u);
+	ResourceStateCache cache{};
+	cache.Register(first, EResourceState::UnorderedAccess);
+	cache.Register(second, EResourceState::UnorderedAccess);
+
+	ResourceStateTracker tracker(cache);
+	tracker.UavBarrier(first);
+	tracker.UavBarrier(second);
+	tracker.UavBarrier(first);
+
+	auto flushed = Flush(tracker);
+	CHECK(flushed.Barriers.size() == 2u);
+	CHECK(IsUav(flushed.Barriers[ 0 ], first));
+	CHECK(IsUav(flushed.Barriers[ 1 ], second));
+	CHECK(tracker.GetStats().Redundant == 1u);
+
+	//~ a transition in between keeps both
+	tracker.UavBarrier(first);
+	tracker.Transition(first, EResourceState::NonPixelShaderResource);
+	tracker.UavBarrier(first);
+
+	flushed = Flush(tracker);
+	CHECK(flushed.Barriers.size() == 3u);
+	CHECK(IsUav(flushed.Barriers[ 0 ], first));
+	CHECK(IsTransition(flushed.Barriers[ 1 ], first, EResourceState::UnorderedAccess, EResourceState::NonPixelShaderResource));
+	CHECK(IsUav(flushed.Barriers[ 2 ], first));
+}
+
+HOST_TEST(UniformTransitionAfterASubresourceIsOneBarrier)
+{
+	const auto texture = MakeHandle(1u);
+	ResourceStateCache cache{};
+	cache.Register(texture, EResourceState::Common, 4u);
+
+	//~ subresource 2 folds Common->CopyDest->PixelShaderResource, the others match it
+	ResourceStateTracker tracker(cache);
+	tracker.Transition(texture, EResourceState::CopyDest, 2u);
+	tracker.Transition(texture, EResourceState::PixelShaderResource);
+
+	const auto flushed = Flush(tracker);
+	CHECK(flushed.Barriers.size() == 1u);
+	CHECK(IsTransition(flushed.Barriers[ 0 ], texture, EResourceState::Common, EResourceState::PixelShaderResource));
+	CHECK(tracker.GetState(texture, 2u) == EResourceState::PixelShaderResource);
+}
+
+HOST_TEST(PendingSubresourceBarriersFoldPastEachOther)
+{
+	const auto texture = MakeHandle(1u);
+	ResourceStateCache cache{};
+	cache.Register(texture, EResourceState::Common, 4u);
+
+	ResourceStateTracker tracker(cache);
+	tracker.Transition(texture, EResourceState::CopyDest, 0u);
+	tracker.Transition(texture, EResourceState::RenderTarget, 1u);
+	tracker.Transition(texture, EResourceState::PixelShaderResource, 0u);
+	tracker.Transition(texture, EResourceState::Common, 1u);
+
+	const auto flushed = Flush(tracker);
+	CHECK(flushed.Barriers.size() == 1u);
+	CHECK(IsTransition(flushed.Barriers[ 0 ], texture, EResourceState::Common, EResourceState::PixelShaderResource, 0u));
+
+	//~ every subresource of another texture moved the same way one at a time
+	const auto other = MakeHandle(2u);
+	cache.Register(other, EResourceState::Common, 4u);
+	for (std::uint32_t i = 0u; i < 4u; ++i) tracker.Transition(other, EResourceState::CopySource, i);
+
+	const auto uniform = Flush(tracker);
+	CHECK(uniform.Barriers.size() == 1u);
+	CHECK(IsTransition(uniform.Barriers[ 0 ], other, EResourceState::Common, EResourceState::CopySource));
+	CHECK(tracker.GetStats().Merged == 5u);
+}
@@ -0,0 +1,234 @@
+#include "host_test.h"
+
+#include "framework/render_manager/shader_cache.h"
+#include "utility/thread/job_system.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace framework;
+
+namespace
+{
+	//~ bytecode is the entry name, every call is counted per entry
+	class CountingCompiler final : public IShaderCompiler
+	{
+	public:
+		explicit CountingCompiler(std::uint64_t id) : m_nId(id) {}
+
+		std::uint64_t GetCompilerId() const noexcept override { return m_nId; }
+
+		bool Compile(const SHADER_COMPILE_DESC& desc, std::vector<std::uint8_t>& bytecode, std::string& errors) override
+		{
+			{
+				std::lock_guard lock(m_mutex);
+				++m_calls[ desc.Entry ];
+			}
+
+			//~ slow enough for identical requests on other workers to overlap
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			if (desc.Entry == "broken")
+			{
+				errors = "error X3000: syntax error";
+				return false;
+			}
+			bytecode.assign(desc.Entry.begin(), desc.Entry.end());
+			return true;
+		}
+
+		std::uint32_t GetCalls(const std::string& entry) const
+		{
+			std::lock_guard lock(m_mutex);
+			const auto it = m_calls.find(entry);
+			return it == m_calls.end() ? 0u : it->second;
+		}
+
+		std::uint32_t GetTotalCalls() const
+		{
+			std::lock_guard lock(m_mutex);
+			std::uint32_t total = 0u;
+			for (const auto& [entry, calls] : m_calls) total += calls;
+			return total;
+		}
+
+	private:
+		std::uint64_t m_nId{ 0u };
+		std::unordered_map<std::string, std::uint32_t> m_calls{};
+		mutable std::mutex m_mutex{};
+	};
+
+	//~ a fresh directory per test, sources under src/ and bytecode under cache/
+	std::filesystem::path MakeDirectory(const char* name)
+	{
+		const auto directory = std::filesystem::temp_directory_path() / "framework_host_tests" / name;
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory / "src");
+		return directory;
+	}
+
+	void WriteText(const std::filesystem::path& path, const std::string& text)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << text;
+	}
+
+	SHADER_COMPILE_DESC MakeDesc(const std::filesystem::path& path, const char* entry)
+	{
+		SHADER_COMPILE_DESC desc{};
+		desc.Path	= path;
+		desc.Entry	= entry;
+		desc.Target = "vs_5_1";
+		return desc;
+	}
+} // namespace
+
+HOST_TEST(ShaderCacheHitsOnTheSecondCompile)
+{
+	const auto directory = MakeDirectory("shader_cache_hits");
+	WriteText(directory / "src" / "color.hlsl", "float4 VS() : SV_Position { return 0; }\n");
+
+	auto compiler = std::make_unique<CountingCompiler>(1u);
+	auto* counter = compiler.get();
+	ShaderCache cache(std::move(compiler), directory / "cache");
+
+	const auto desc	  = MakeDesc(directory / "src" / "color.hlsl", "VS");
+	const auto first  = cache.Compile(desc);
+	const auto second = cache.Compile(desc);
+
+	CHECK(first.IsValid());
+	CHECK(first.Source	== EShaderCacheSource::Compiled);
+	CHECK(second.Source == EShaderCacheSource::Memory);
+	CHECK(second.Key	== first.Key);
+	CHECK(second.Bytecode == first.Bytecode);
+	CHECK(counter->GetCalls("VS") == 1u);
+	CHECK(std::filesystem::exists(cache.GetFilePath(first.Key)));
+
+	//~ after the run the file answers without the compiler
+	cache.ClearMemory();
+	const auto third = cache.Compile(desc);
+	CHECK(third.Source == EShaderCacheSource::Disk);
+	CHECK(*third.Bytecode == *first.Bytecode);
+	CHECK(counter->GetCalls("VS") == 1u);
+
+	//~ failures are not kept, the next request compiles again
+	CHECK(!cache.Compile(MakeDesc(directory / "src" / "color.hlsl", "broken")).IsValid());
+	CHECK(cache.Compile(MakeDesc(directory / "src" / "color.hlsl", "broken")).Errors == "error X3000: syntax error");
+	CHECK(counter->GetCalls("broken") == 2u);
+
+	const auto stats = cache.GetStats();
+	CHECK(stats.Requests   == 5u);
+	CHECK(stats.MemoryHits == 1u);
+	CHECK(stats.DiskHits   == 1u);
+	CHECK(stats.Compiled   == 1u);
+	CHECK(stats.Failed	   == 2u);
+}
+
+HOST_TEST(ShaderCacheKeyFollowsIncludes)
+{
+	const auto directory = MakeDirectory("shader_cache_includes");
+	const auto source	 = directory / "src" / "lit.hlsl";
+	WriteText(source, "#include \"common/light.hlsli\"\n  #  include <missing.hlsli>\nfloat4 PS() : SV_Target { return Light(); }\n");
+	std::filesystem::create_directories(directory / "src" / "common");
+	WriteText(directory / "src" / "common" / "light.hlsli", "float4 Light() { return 1; }\n");
+
+	ShaderCache cache(std::make_unique<CountingCompiler>(1u), directory / "cache");
+	const auto desc = MakeDesc(source, "PS");
+
+	std::vector<std::filesystem::path> dependencies{};
+	const auto before = cache.ComputeKey(desc, &dependencies);
+	CHECK(cache.ComputeKey(desc) == before);
+
+	CHECK(dependencies.size() == 3u);
+	CHECK(dependencies[ 0 ] == source.lexically_normal());
+	CHECK(dependencies[ 1 ] == (directory / "src" / "common" / "light.hlsli").lexically_normal());
+	CHECK(dependencies[ 2 ].filename() == "missing.hlsli");
+
+	WriteText(directory / "src" / "common" / "light.hlsli", "float4 Light() { return 2; }\n");
+	CHECK(cache.ComputeKey(desc) != before);
+
+	//~ a new include joins the dependencies and the key
+	WriteText(directory / "src" / "common" / "light.hlsli", "#include \"shadow.hlsli\"\nfloat4 Light() { return 2; }\n");
+	WriteText(directory / "src" / "common" / "shadow.hlsli", "float Shadow() { return 1; }\n");
+	const auto withShadow = cache.ComputeKey(desc, &dependencies);
+	CHECK(dependencies.size() == 4u);
+	CHECK(std::find(dependencies.begin(), dependencies.end(),
+					(directory / "src" / "common" / "shadow.hlsli").lexically_normal()) != dependencies.end());
+
+	//~ the missing include showing up counts as an edit as well
+	WriteText(directory / "src" / "missing.hlsli", "\n");
+	CHECK(cache.ComputeKey(desc) != withShadow);
+
+	//~ defines are part of the key
+	auto defined = desc;
+	defined.Defines.push_back({ "SHADOWS" });
+	CHECK(cache.ComputeKey(defined) != cache.ComputeKey(desc));
+}
+
+HOST_TEST(ShaderCacheKeysIncludeTheCompilerId)
+{
+	const auto directory = MakeDirectory("shader_cache_compiler");
+	WriteText(directory / "src" / "color.hlsl", "float4 VS() : SV_Position { return 0; }\n");
+	const auto desc = MakeDesc(directory / "src" / "color.hlsl", "VS");
+
+	std::uint64_t oldKey = 0u;
+	{
+		ShaderCache cache(std::make_unique<CountingCompiler>(1u), directory / "cache");
+		oldKey = cache.Compile(desc).Key;
+	}
+
+	auto compiler = std::make_unique<CountingCompiler>(2u);
+	auto* counter = compiler.get();
+	ShaderCache cache(std::move(compiler), directory / "cache");
+
+	//~ the old file is still there but belongs to the other compiler
+	const auto result = cache.Compile(desc);
+	CHECK(result.Key != oldKey);
+	CHECK(result.Source == EShaderCacheSource::Compiled);
+	CHECK(counter->GetCalls("VS") == 1u);
+	CHECK(std::filesystem::exists(cache.GetFilePath(oldKey)));
+	CHECK(cache.GetStats().DiskHits == 0u);
+}
+
+HOST_TEST(ShaderCacheCompilesParallelMissesOnce)
+{
+	const auto directory = MakeDirectory("shader_cache_parallel");
+	WriteText(directory / "src" / "color.hlsl", "float4 VS() : SV_Position { return 0; }\n");
+
+	auto compiler = std::make_unique<CountingCompiler>(1u);
+	auto* counter = compiler.get();
+	JobSystem jobs(4u);
+	ShaderCache cache(std::move(compiler), directory / "cache", &jobs);
+
+	const char* entries[]{ "A", "B", "C", "D", "E" };
+	std::vector<SHADER_COMPILE_DESC> descs{};
+	for (std::uint32_t i = 0u; i < 40u; ++i)
+	{
+		descs.push_back(MakeDesc(directory / "src" / "color.hlsl", entries[ i % 5u ]));
+	}
+
+	const auto results = cache.CompileAll(descs);
+	CHECK(results.size() == descs.size());
+
+	bool valid = true;
+	for (std::uint32_t i = 0u; i < results.size(); ++i)
+	{
+		valid &= results[ i ].IsValid() && results[ i ].Key == results[ i % 5u ].Key;
+		valid &= std::string(results[ i ].Bytecode->begin(), results[ i ].Bytecode->end()) == descs[ i ].Entry;
+	}
+	CHECK(valid);
+
+	for (const char* entry : entries) CHECK(counter->GetCalls(entry) == 1u);
+	CHECK(counter->GetTotalCalls() == 5u);
+
+	const auto stats = cache.GetStats();
+	CHECK(stats.Compiled   == 5u);
+	CHECK(stats.MemoryHits == 35u);
+}
@@ -0,0 +1,148 @@
+#include "host_test.h"
+
+#include "framework/scene/transform_system.h"
+#include "utility/thread/job_system.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace DirectX;
+using namespace framework;
+
+namespace
+{
+	bool Near(float a, float b) noexcept { return std::fabs(a - b) < 1.0e-5f; }
+
+	bool Translation(const TransformSystem& transforms, TransformId id, float x, float y, float z)
+	{
+		const auto& world = transforms.GetWorld(id);
+		return Near(world._41, x) && Near(world._42, y) && Near(world._43, z);
+	}
+
+	//~ a few roots with chains of children under them, deterministic
+	void BuildHierarchy(TransformSystem& transforms, std::uint32_t count)
+	{
+		std::uint32_t seed = 0x2545f491u;
+		auto next = [&seed]()
+		{
+			seed ^= seed << 13u;
+			seed ^= seed >> 17u;
+			seed ^= seed << 5u;
+			return seed;
+		};
+
+		transforms.Reserve(count);
+		for (std::uint32_t i = 0u; i < count; ++i)
+		{
+			const float angle  = static_cast<float>(next() % 628u) * 0.01f;
+			const XMFLOAT3 pos = { static_cast<float>(next() % 100u) * 0.1f, 1.f, -2.f };
+			const XMFLOAT4 rot = { 0.f, std::sin(angle * 0.5f), 0.f, std::cos(angle * 0.5f) };
+			const TransformId parent = i < 16u ? INVALID_TRANSFORM : next() % i;
+			transforms.Create(pos, rot, { 1.f, 1.f, 1.f }, parent);
+		}
+	}
+} // namespace
+
+HOST_TEST(ChildWorldComposesWithTheParent)
+{
+	TransformSystem transforms{};
+
+	//~ a quarter turn about y takes +x to -z
+	const float half = std::sqrt(0.5f);
+	const auto parent = transforms.Create({ 1.f, 2.f, 3.f }, { 0.f, half, 0.f, half });
+	const auto child  = transforms.Create({ 1.f, 0.f, 0.f }, { 0.f, 0.f, 0.f, 1.f }, { 1.f, 1.f, 1.f }, parent);
+	const auto scaled = transforms.Create({ 0.f, 1.f, 0.f }, { 0.f, 0.f, 0.f, 1.f }, { 2.f, 2.f, 2.f });
+	const auto leaf	  = transforms.Create({ 0.f, 1.f, 0.f }, { 0.f, 0.f, 0.f, 1.f }, { 1.f, 1.f, 1.f }, scaled);
+	transforms.Update();
+
+	CHECK(transforms.GetParent(child) == parent);
+	CHECK(Translation(transforms, parent, 1.f, 2.f, 3.f));
+	CHECK(Translation(transforms, child,  1.f, 2.f, 2.f));
+	CHECK(Translation(transforms, leaf,	  0.f, 3.f, 0.f));
+}
+
+HOST_TEST(OnlyChangedBranchesAreRebuilt)
+{
+	TransformSystem transforms{};
+	const auto root	   = transforms.Create({ 0.f, 0.f, 0.f });
+	const auto child   = transforms.Create({ 1.f, 0.f, 0.f }, { 0.f, 0.f, 0.f, 1.f }, { 1.f, 1.f, 1.f }, root);
+	const auto sibling = transforms.Create({ 5.f, 0.f, 0.f });
+
+	transforms.Update();
+	CHECK(transforms.GetChangedCount() == 3u);
+
+	transforms.Update();
+	CHECK(transforms.GetChangedCount() == 0u);
+
+	transforms.SetPosition(root, { 0.f, 4.f, 0.f });
+	transforms.Update();
+	CHECK(transforms.GetChangedCount() == 2u);
+	CHECK(transforms.HasWorldChanged(root));
+	CHECK(transforms.HasWorldChanged(child));
+	CHECK(!transforms.HasWorldChanged(sibling));
+	CHECK(Translation(transforms, child, 1.f, 4.f, 0.f));
+}
+
+HOST_TEST(ParallelUpdateMatchesSerial)
+{
+	constexpr std::uint32_t count = 20'000u;
+
+	TransformSystem serial{}, parallel{};
+	BuildHierarchy(serial, count);
+	BuildHierarchy(parallel, count);
+
+	JobSystem jobs(4u);
+	serial	.Update();
+	parallel.Update(&jobs, 64u);
+
+	for (std::uint32_t frame = 0u; frame < 3u; ++frame)
+	{
+		for (TransformId id = frame; id < count; id += 7u)
+		{
+			const XMFLOAT3 pos = { static_cast<float>(frame), static_cast<float>(id % 13u), 0.5f };
+			serial	.SetPosition(id, pos);
+			parallel.SetPosition(id, pos);
+		}
+		serial	.Update();
+		parallel.Update(&jobs, 64u);
+
+		CHECK(serial.GetChangedCount() == parallel.GetChangedCount());
+		bool same = true;
+		for (TransformId id = 0u; id < count; ++id)
+		{
+			same &= std::memcmp(&serial.GetWorld(id), &parallel.GetWorld(id), sizeof(XMFLOAT4X4)) == 0;
+		}
+		CHECK(same);
+	}
+}
+
+HOST_TEST(WorldsAreWrittenTransposedAtTheStride)
+{
+	constexpr std::uint32_t count  = 1'000u;
+	constexpr std::size_t	stride = 256u;
+
+	TransformSystem transforms{};
+	BuildHierarchy(transforms, count);
+	transforms.Update();
+
+	JobSystem jobs(2u);
+	for (JobSystem* pool : { static_cast<JobSystem*>(nullptr), &jobs })
+	{
+		std::vector<XMFLOAT4X4A> buffer(count * stride / sizeof(XMFLOAT4X4A));
+		auto* dst = reinterpret_cast<std::uint8_t*>(buffer.data());
+		transforms.WriteWorldsTransposed(dst, stride, 0u, count, pool);
+
+		bool transposed = true;
+		for (TransformId id = 0u; id < count; ++id)
+		{
+			XMFLOAT4X4 written{};
+			std::memcpy(&written, dst + id * stride, sizeof(written));
+
+			const auto& world = transforms.GetWorld(id);
+			for (int r = 0; r < 4; ++r)
+				for (int c = 0; c < 4; ++c) transposed &= written.m[ r ][ c ] == world.m[ c ][ r ];
+		}
+		CHECK(transposed);
+	}
+}
@@ -0,0 +1,137 @@
+#include "host_test.h"
+
+#include "framework/render_manager/upload_ring.h"
+
+using namespace framework;
+
+namespace
+{
+	constexpr std::uint64_t BLOCK = UploadRing::BLOCK_ALIGNMENT;
+} // namespace
+
+HOST_TEST(RingWrapsWhenABlockDoesNotFitBeforeTheEnd)
+{
+	HostUploadMemory memory(4u * BLOCK);
+	UploadRing ring(&memory);
+
+	const auto first  = ring.AllocateBlock(2u * BLOCK);
+	const auto second = ring.AllocateBlock(BLOCK);
+	CHECK(first == 0u);
+	CHECK(second == 2u * BLOCK);
+
+	//~ one block is left at the end, too small for the next request
+	CHECK(ring.AllocateBlock(2u * BLOCK) == UPLOAD_INVALID_OFFSET);
+
+	ring.RetireBlock(first, 1u);
+	ring.Reclaim(1u);
+
+	//~ the front was freed, the block starts over there and the end stays padding
+	CHECK(ring.AllocateBlock(BLOCK + 1u) == 0u);
+	CHECK(ring.GetStats().Used == 3u * BLOCK);
+	CHECK(ring.AllocateBlock(BLOCK) == UPLOAD_INVALID_OFFSET);
+}
+
+HOST_TEST(RingIsFullWhenTheHeadReachesTheTail)
+{
+	HostUploadMemory memory(4u * BLOCK);
+	UploadRing ring(&memory);
+
+	std::uint64_t blocks[ 4 ]{};
+	for (auto& block : blocks) block = ring.AllocateBlock(BLOCK);
+	CHECK(blocks[ 3 ] == 3u * BLOCK);
+	CHECK(ring.AllocateBlock(1u) == UPLOAD_INVALID_OFFSET);
+
+	ring.RetireBlock(blocks[ 0 ], 1u);
+	ring.Reclaim(1u);
+	CHECK(ring.AllocateBlock(BLOCK) == 0u);
+
+	//~ the head wrapped onto the tail, nothing is free
+	CHECK(ring.AllocateBlock(1u) == UPLOAD_INVALID_OFFSET);
+
+	const auto stats = ring.GetStats();
+	CHECK(stats.Used			  == stats.Capacity);
+	CHECK(stats.BlocksInFlight	  == 4u);
+	CHECK(stats.FailedAllocations == 2u);
+}
+
+HOST_TEST(ReclaimWaitsForTheFrontBlock)
+{
+	HostUploadMemory memory(4u * BLOCK);
+	UploadRing ring(&memory);
+
+	const auto first  = ring.AllocateBlock(BLOCK);
+	const auto second = ring.AllocateBlock(BLOCK);
+
+	//~ the later frame finished first, its block stays behind the unretired front
+	ring.RetireBlock(second, 1u);
+	ring.Reclaim(1u);
+	CHECK(ring.GetStats().BlocksInFlight == 2u);
+
+	ring.RetireBlock(first, 2u);
+	ring.Reclaim(1u);
+	CHECK(ring.GetStats().BlocksInFlight == 2u);
+
+	ring.Reclaim(2u);
+	CHECK(ring.GetStats().BlocksInFlight == 0u);
+	CHECK(ring.GetStats().Used == 0u);
+	CHECK(ring.GetStats().PeakUsed == 2u * BLOCK);
+}
+
+HOST_TEST(LargeRequestsGetABlockOfTheirOwn)
+{
+	HostUploadMemory memory(64u * BLOCK);
+	UploadRing ring(&memory);
+	LinearUploadAllocator allocator(&ring, 2u * BLOCK);
+
+	const auto small = allocator.Allocate(64u);
+	const auto large = allocator.Allocate(5u * BLOCK, UPLOAD_ALIGN_CONSTANT);
+	const auto after = allocator.Allocate(64u);
+
+	CHECK(small.IsValid() && large.IsValid() && after.IsValid());
+	CHECK(small.Offset == 0u);
+	CHECK(large.Offset == 2u * BLOCK);
+	CHECK(large.Size   == 5u * BLOCK);
+	CHECK(after.Offset == 7u * BLOCK);
+	CHECK(allocator.GetBlockCount() == 3u);
+
+	CHECK(static_cast<std::uint8_t*>(large.Cpu) == memory.GetCpuBase() + large.Offset);
+	CHECK(large.Gpu == HostUploadMemory::FAKE_GPU_BASE + large.Offset);
+}
+
+HOST_TEST(RetireResetsTheCursor)
+{
+	HostUploadMemory memory(8u * BLOCK);
+	UploadRing ring(&memory);
+	LinearUploadAllocator allocator(&ring, BLOCK);
+
+	const auto first = allocator.Allocate(24u);
+	const auto constant = allocator.Allocate(16u, UPLOAD_ALIGN_CONSTANT);
+	CHECK(constant.Offset == first.Offset + UPLOAD_ALIGN_CONSTANT);
+	CHECK(allocator.GetAllocatedBytes() == 40u);
+
+	allocator.Retire(1u);
+	CHECK(allocator.GetAllocatedBytes() == 0u);
+	CHECK(allocator.GetBlockCount()		== 0u);
+
+	//~ the next frame starts a fresh block, the retired one is still in flight
+	const auto next = allocator.Allocate(24u);
+	CHECK(next.Offset == BLOCK);
+
+	ring.Reclaim(1u);
+	CHECK(ring.GetStats().BlocksInFlight == 1u);
+}
+
+HOST_TEST(FullRingFailsTheLinearAllocation)
+{
+	HostUploadMemory memory(2u * BLOCK);
+	UploadRing ring(&memory);
+	LinearUploadAllocator allocator(&ring, BLOCK);
+
+	CHECK(allocator.Allocate(BLOCK).IsValid());
+	CHECK(allocator.Allocate(BLOCK).IsValid());
+
+	const auto failed = allocator.Allocate(16u);
+	CHECK(!failed.IsValid());
+	CHECK(failed.Cpu == nullptr);
+	CHECK(ring.GetStats().FailedAllocations == 1u);
+}
@@ -0,0 +1,294 @@
+//~ Headless timing harness for framework::FramePipeline. Runs the four DrawShapes stages
+//~ (simulate, build packets, record, submit) over synthetic render items against the
+//~ recording backend, once in sequence on one thread and once through the pipeline.
+//~ usage: frame_pipeline_harness [items] [frames] [ring depth]
+//~ Both runs must produce the same command stream for every frame, the exit code is 1 otherwise.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "framework/render_manager/backend/recording_backend.h"
+#include "framework/render_manager/frame_pipeline.h"
+#include "framework/render_manager/state_hash.h"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr float		    DELTA_TIME	= 1.f / 60.f;
+	constexpr std::uint32_t WARMUP_FRAMES = 8u;
+	constexpr std::uint32_t PIPELINES	= 8u;
+	constexpr std::uint32_t GEOMETRIES	= 64u;
+
+	typedef struct _HARNESS_ITEM
+	{
+		float		  Position[ 3 ]{};
+		float		  Angle	  { 0.f };
+		float		  Spin	  { 0.f };
+		std::uint32_t Pipeline{ 0u };
+		std::uint32_t Geometry{ 0u };
+	} HARNESS_ITEM;
+
+	typedef struct _HARNESS_PACKET
+	{
+		std::uint64_t Key  { 0u };
+		std::uint32_t Item { 0u };
+	} HARNESS_PACKET;
+
+	//~ what a FrameResource carries between the stages
+	typedef struct _HARNESS_SLOT
+	{
+		std::vector<float>			Worlds{}; //~ 16 floats per item
+		std::vector<HARNESS_PACKET> Packets{};
+		framework::RecordingCommandRecorder Recorder{};
+	} HARNESS_SLOT;
+
+	/// <summary>
+	/// The four stages over one frame ring. Only Simulate touches the items, every later stage
+	/// reads what the previous one left in the ticket's slot.
+	/// </summary>
+	class HarnessFrame
+	{
+	public:
+		HarnessFrame(std::uint32_t itemCount, std::uint32_t ringDepth, std::uint32_t frameCount)
+			: m_slots(ringDepth)
+			, m_hashes(frameCount + WARMUP_FRAMES)
+			, m_nItemCount(itemCount)
+		{
+			for (auto& slot : m_slots)
+			{
+				slot.Worlds .resize(std::size_t(itemCount) * 16u);
+				slot.Packets.resize(itemCount);
+			}
+			ResetItems();
+		}
+
+		void ResetItems()
+		{
+			std::uint32_t seed = 0x9e3779b9u;
+			auto next = [&seed]()
+			{
+				seed ^= seed << 13u;
+				seed ^= seed >> 17u;
+				seed ^= seed << 5u;
+				return seed;
+			};
+
+			m_items.assign(m_nItemCount, {});
+			for (auto& item : m_items)
+			{
+				for (float& p : item.Position) p = static_cast<float>(next() % 2000u) * 0.1f - 100.f;
+				item.Spin	  = static_cast<float>(next() % 628u) * 0.01f;
+				item.Pipeline = next() % PIPELINES;
+				item.Geometry = next() % GEOMETRIES;
+			}
+		}
+
+		void Simulate(const framework::FRAME_TICKET& ticket)
+		{
+			auto& worlds = m_slots[ ticket.FrameIndex ].Worlds;
+			for (std::uint32_t i = 0u; i < m_nItemCount; ++i)
+			{
+				auto& item = m_items[ i ];
+				item.Angle += item.Spin * ticket.DeltaTime;
+
+				//~ rotation about y then a small wobble about x, translation in the last row
+				const float c  = std::cos(item.Angle), s  = std::sin(item.Angle);
+				const float cw = std::cos(item.Angle * 0.5f), sw = std::sin(item.Angle * 0.5f);
+
+				float* m = &worlds[ std::size_t(i) * 16u ];
+				m[ 0 ]	= c;		 m[ 1 ]	 = 0.f;	 m[ 2 ]	 = -s;		m[ 3 ]	= 0.f;
+				m[ 4 ]	= s * sw;	 m[ 5 ]	 = cw;	 m[ 6 ]	 = c * sw;	m[ 7 ]	= 0.f;
+				m[ 8 ]	= s * cw;	 m[ 9 ]	 = -sw;	 m[ 10 ] = c * cw;	m[ 11 ] = 0.f;
+				m[ 12 ] = item.Position[ 0 ];
+				m[ 13 ] = item.Position[ 1 ] + std::sin(item.Angle) * 0.25f;
+				m[ 14 ] = item.Position[ 2 ];
+				m[ 15 ] = 1.f;
+			}
+		}
+
+		void BuildPackets(const framework::FRAME_TICKET& ticket)
+		{
+			auto& slot = m_slots[ ticket.FrameIndex ];
+			for (std::uint32_t i = 0u; i < m_nItemCount; ++i)
+			{
+				//~ pipeline, geometry, then front to back on the view depth
+				const float depth = slot.Worlds[ std::size_t(i) * 16u + 14u ] + 100.f;
+				const auto	depthBits = static_cast<std::uint64_t>(std::clamp(depth, 0.f, 255.f) * 256.f);
+
+				slot.Packets[ i ].Key  = (std::uint64_t(m_items[ i ].Pipeline) << 56u)
+									   | (std::uint64_t(m_items[ i ].Geometry) << 40u)
+									   | (depthBits << 24u) | i;
+				slot.Packets[ i ].Item = i;
+			}
+			std::sort(slot.Packets.begin(), slot.Packets.end(),
+					  [](const HARNESS_PACKET& a, const HARNESS_PACKET& b) { return a.Key < b.Key; });
+		}
+
+		void Record(const framework::FRAME_TICKET& ticket)
+		{
+			auto& slot	   = m_slots[ ticket.FrameIndex ];
+			auto& recorder = slot.Recorder;
+			recorder.Reset();
+
+			const float clear[ 4 ] = { 0.1f, 0.1f, 0.1f, 1.f };
+			recorder.TransitionResource(BackBuffer(), framework::EResourceState::Present, framework::EResourceState::RenderTarget);
+			recorder.ClearRenderTarget({ 0x1000u }, clear);
+			recorder.ClearDepthStencil({ 0x2000u }, 1.f, 0u);
+			recorder.SetRenderTarget  ({ 0x1000u }, { 0x2000u });
+			recorder.SetPrimitiveTopology(framework::EPrimitiveTopology::TriangleList);
+
+			std::uint32_t pipeline = ~0u, geometry = ~0u;
+			for (const auto& packet : slot.Packets)
+			{
+				const auto& item = m_items[ packet.Item ];
+				if (item.Pipeline != pipeline)
+				{
+					pipeline = item.Pipeline;
+					recorder.SetPipelineState(Handle(0x100u + pipeline));
+				}
+				if (item.Geometry != geometry)
+				{
+					geometry = item.Geometry;
+					const framework::GpuVirtualAddress base = 0x10000000ull + std::uint64_t(geometry) * 0x10000ull;
+					recorder.SetVertexBuffer(0u, { base, 0x8000u, 32u });
+					recorder.SetIndexBuffer ({ base + 0x8000u, 0x8000u, framework::EIndexFormat::Uint16 });
+				}
+				recorder.SetGraphicsRoot32BitConstants(0u, 16u, &slot.Worlds[ std::size_t(packet.Item) * 16u ], 0u);
+				recorder.DrawIndexedInstanced(36u, 1u, 0u, 0, 0u);
+			}
+			recorder.TransitionResource(BackBuffer(), framework::EResourceState::RenderTarget, framework::EResourceState::Present);
+		}
+
+		void Submit(const framework::FRAME_TICKET& ticket)
+		{
+			auto& slot = m_slots[ ticket.FrameIndex ];
+
+			framework::ICommandRecorder* lists[] = { &slot.Recorder };
+			m_device.ExecuteCommandLists(lists, 1u);
+			m_device.Present(0u, 0u);
+			m_device.Signal();
+
+			const auto& stream = slot.Recorder.GetStream();
+			m_hashes[ ticket.FrameNumber ] = framework::HashBytes(stream.data(), stream.size());
+		}
+
+		//~ Getters
+		const std::vector<std::uint64_t>& GetHashes() const noexcept { return m_hashes; }
+
+	private:
+		static framework::GpuPipelineHandle Handle(std::uintptr_t value) noexcept
+		{
+			return reinterpret_cast<framework::GpuPipelineHandle>(value);
+		}
+
+		static framework::GpuResourceHandle BackBuffer() noexcept
+		{
+			return reinterpret_cast<framework::GpuResourceHandle>(std::uintptr_t(0xb0u));
+		}
+
+	private:
+		std::vector<HARNESS_ITEM>		 m_items {};
+		std::vector<HARNESS_SLOT>		 m_slots {};
+		std::vector<std::uint64_t>		 m_hashes{}; //~ per frame number, written by Submit
+		framework::RecordingRenderDevice m_device{};
+		std::uint32_t					 m_nItemCount{ 0u };
+	};
+
+	double RunSerial(HarnessFrame& frame, std::uint32_t ringDepth, std::uint32_t frameCount)
+	{
+		frame.ResetItems();
+
+		Clock::time_point start{};
+		for (std::uint32_t n = 0u; n < frameCount + WARMUP_FRAMES; ++n)
+		{
+			if (n == WARMUP_FRAMES) start = Clock::now();
+
+			framework::FRAME_TICKET ticket{};
+			ticket.FrameNumber = n;
+			ticket.FrameIndex  = n % ringDepth;
+			ticket.DeltaTime   = DELTA_TIME;
+
+			frame.Simulate	  (ticket);
+			frame.BuildPackets(ticket);
+			frame.Record	  (ticket);
+			frame.Submit	  (ticket);
+		}
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frameCount;
+	}
+
+	double RunPipelined(HarnessFrame& frame, std::uint32_t ringDepth, std::uint32_t frameCount,
+						std::vector<framework::FRAME_STAGE_STATS>& stats)
+	{
+		frame.ResetItems();
+
+		framework::FramePipeline pipeline(ringDepth);
+		pipeline.AddStage("Simulate",	   [&frame](const framework::FRAME_TICKET& t) { frame.Simulate	  (t); });
+		pipeline.AddStage("Build Packets", [&frame](const framework::FRAME_TICKET& t) { frame.BuildPackets(t); });
+		pipeline.AddStage("Record",		   [&frame](const framework::FRAME_TICKET& t) { frame.Record	  (t); });
+		pipeline.AddStage("Submit",		   [&frame](const framework::FRAME_TICKET& t) { frame.Submit	  (t); });
+		pipeline.Start();
+
+		for (std::uint32_t n = 0u; n < WARMUP_FRAMES; ++n) pipeline.Tick(DELTA_TIME);
+		pipeline.Flush();
+
+		const auto start = Clock::now();
+		for (std::uint32_t n = 0u; n < frameCount; ++n) pipeline.Tick(DELTA_TIME);
+		pipeline.Flush();
+		const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frameCount;
+
+		stats = pipeline.GetStats();
+		pipeline.Stop();
+		return ms;
+	}
+
+	std::uint32_t ParseCount(int argc, char** argv, int index, std::uint32_t fallback)
+	{
+		if (argc <= index) return fallback;
+		const long value = std::strtol(argv[ index ], nullptr, 10);
+		return value > 0 ? static_cast<std::uint32_t>(value) : fallback;
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	const std::uint32_t itemCount  = ParseCount(argc, argv, 1, 20'000u);
+	const std::uint32_t frameCount = ParseCount(argc, argv, 2, 240u);
+	const std::uint32_t ringDepth  = ParseCount(argc, argv, 3, 3u);
+
+	HarnessFrame frame(itemCount, ringDepth, frameCount);
+
+	const double serialMs = RunSerial(frame, ringDepth, frameCount);
+	const auto	 serialHashes = frame.GetHashes();
+
+	std::vector<framework::FRAME_STAGE_STATS> stats{};
+	const double pipelinedMs = RunPipelined(frame, ringDepth, frameCount, stats);
+
+	std::cout << std::fixed << std::setprecision(3)
+			  << "frame pipeline: " << itemCount << " items, " << frameCount << " frames, ring depth " << ringDepth
+			  << ", " << std::thread::hardware_concurrency() << " hardware threads\n"
+			  << "  serial    " << serialMs	   << " ms/frame\n"
+			  << "  pipelined " << pipelinedMs << " ms/frame, " << std::setprecision(2)
+			  << (pipelinedMs > 0.0 ? serialMs / pipelinedMs : 0.0) << "x\n" << std::setprecision(3);
+
+	for (const auto& stage : stats)
+	{
+		std::cout << "    " << std::left << std::setw(14) << stage.Name << std::right
+				  << stage.AverageMs << " ms avg over " << stage.Executions << " frames\n";
+	}
+
+	if (frame.GetHashes() != serialHashes)
+	{
+		std::cerr << "pipelined frames recorded a different command stream than the serial run\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+//~ Host build stand-in for src/utility/logger/logger.h, picked up first by the headless
+//~ tools. The real logger needs <format> and the Win32 console, the tools only need the
+//~ line. Supports the part of the format syntax the framework uses:
+//~ {} and {:[fill][<>^][width][.precision][f]}
+namespace logger_config
+{
+	enum class LogLevel : std::uint8_t
+	{
+		Trace = 0,
+		Debug,
+		Info,
+		Warn,
+		Error,
+		Fatal
+	};
+
+	enum class LogCategory : std::uint8_t
+	{
+		General = 0,
+		System,
+		Render,
+		Physics,
+		Audio,
+		AI,
+		Network,
+		IO,
+		Asset,
+		Scripting,
+		Editor,
+		Gameplay
+	};
+} // namespace logger_config
+
+namespace host_format
+{
+	typedef struct _FORMAT_SPEC
+	{
+		char Fill	  { ' ' };
+		char Align	  { 0 };  //~ '<', '>', '^' or 0 for the type default
+		int	 Width	  { 0 };
+		int	 Precision{ -1 };
+	} FORMAT_SPEC;
+
+	inline FORMAT_SPEC ParseSpec(std::string_view spec)
+	{
+		FORMAT_SPEC result{};
+		std::size_t i = 0u;
+
+		auto isAlign = [](char c) { return c == '<' || c == '>' || c == '^'; };
+		if (spec.size() >= 2u && isAlign(spec[ 1 ]))
+		{
+			result.Fill	 = spec[ 0 ];
+			result.Align = spec[ 1 ];
+			i = 2u;
+		}
+		else if (!spec.empty() && isAlign(spec[ 0 ]))
+		{
+			result.Align = spec[ 0 ];
+			i = 1u;
+		}
+
+		while (i < spec.size() && spec[ i ] >= '0' && spec[ i ] <= '9')
+		{
+			result.Width = result.Width * 10 + (spec[ i++ ] - '0');
+		}
+
+		if (i < spec.size() && spec[ i ] == '.')
+		{
+			result.Precision = 0;
+			while (++i < spec.size() && spec[ i ] >= '0' && spec[ i ] <= '9')
+			{
+				result.Precision = result.Precision * 10 + (spec[ i ] - '0');
+			}
+		}
+		return result;
+	}
+
+	template<typename T>
+	void Write(std::string& out, const FORMAT_SPEC& spec, const T& value)
+	{
+		using Type = std::remove_cvref_t<T>;
+
+		std::ostringstream field{};
+		bool bNumeric = false;
+		if constexpr (std::is_same_v<Type, bool>)
+		{
+			field << (value ? "true" : "false");
+		}
+		else if constexpr (std::is_floating_point_v<Type>)
+		{
+			if (spec.Precision >= 0) field << std::fixed << std::setprecision(spec.Precision);
+			field << value;
+			bNumeric = true;
+		}
+		else if constexpr (std::is_enum_v<Type>)
+		{
+			field << static_cast<long long>(value);
+			bNumeric = true;
+		}
+		else if constexpr (std::is_integral_v<Type> && !std::is_same_v<Type, char>)
+		{
+			//~ + so std::uint8_t prints as a number like std::format does
+			field << +value;
+			bNumeric = true;
+		}
+		else
+		{
+			field << value;
+		}
+
+		const std::string text = field.str();
+		const std::size_t width = static_cast<std::size_t>(spec.Width);
+		if (text.size() >= width)
+		{
+			out += text;
+			return;
+		}
+
+		const std::size_t padding = width - text.size();
+		const char align = spec.Align ? spec.Align : (bNumeric ? '>' : '<');
+
+		const std::size_t before = align == '>' ? padding : align == '^' ? padding / 2u : 0u;
+		out.append(before, spec.Fill);
+		out += text;
+		out.append(padding - before, spec.Fill);
+	}
+
+	//~ copies fmt up to the next replacement field, returns false once fmt is consumed
+	inline bool NextField(std::string& out, std::string_view& fmt, FORMAT_SPEC& spec)
+	{
+		while (!fmt.empty())
+		{
+			const char c = fmt.front();
+			if ((c == '{' || c == '}') && fmt.size() >= 2u && fmt[ 1 ] == c)
+			{
+				out += c;
+				fmt.remove_prefix(2u);
+				continue;
+			}
+
+			if (c == '{')
+			{
+				const std::size_t close = fmt.find('}');
+				if (close == std::string_view::npos) break;
+
+				const std::string_view field = fmt.substr(1u, close - 1u);
+				const std::size_t colon = field.find(':');
+				spec = colon == std::string_view::npos ? FORMAT_SPEC{} : ParseSpec(field.substr(colon + 1u));
+
+				fmt.remove_prefix(close + 1u);
+				return true;
+			}
+
+			out += c;
+			fmt.remove_prefix(1u);
+		}
+
+		out.append(fmt);
+		fmt = {};
+		return false;
+	}
+
+	inline void Format(std::string& out, std::string_view fmt)
+	{
+		FORMAT_SPEC spec{};
+		while (NextField(out, fmt, spec)) {}
+	}
+
+	template<typename T, typename... Rest>
+	void Format(std::string& out, std::string_view fmt, const T& value, const Rest&... rest)
+	{
+		FORMAT_SPEC spec{};
+		if (!NextField(out, fmt, spec)) return;
+
+		Write(out, spec, value);
+		Format(out, fmt, rest...);
+	}
+} // namespace host_format
+
+/// <summary>
+/// Same static calls as the framework logger, prints one plain line per message to stdout.
+/// </summary>
+class logger final
+{
+public:
+	logger() = delete;
+
+	template<class... Args>
+	static void trace(std::string_view fmt, const Args&... args) { write("trace", fmt, args...); }
+
+	template<class... Args>
+	static void debug(std::string_view fmt, const Args&... args) { write("debug", fmt, args...); }
+
+	template<class... Args>
+	static void debug(logger_config::LogCategory, std::string_view fmt, const Args&... args) { write("debug", fmt, args...); }
+
+	template<class... Args>
+	static void info(std::string_view fmt, const Args&... args) { write("info", fmt, args...); }
+
+	template<class... Args>
+	static void info(logger_config::LogCategory, std::string_view fmt, const Args&... args) { write("info", fmt, args...); }
+
+	template<class... Args>
+	static void warning(std::string_view fmt, const Args&... args) { write("warn", fmt, args...); }
+
+	template<class... Args>
+	static void warning(logger_config::LogCategory, std::string_view fmt, const Args&... args) { write("warn", fmt, args...); }
+
+	template<class... Args>
+	static void success(std::string_view fmt, const Args&... args) { write("ok", fmt, args...); }
+
+	template<class... Args>
+	static void success(logger_config::LogCategory, std::string_view fmt, const Args&... args) { write("ok", fmt, args...); }
+
+	template<class... Args>
+	static void error(std::string_view fmt, const Args&... args) { write("error", fmt, args...); }
+
+	template<class... Args>
+	static void error(logger_config::LogCategory, std::string_view fmt, const Args&... args) { write("error", fmt, args...); }
+
+private:
+	template<class... Args>
+	static void write(const char* level, std::string_view fmt, const Args&... args)
+	{
+		std::string line{};
+		host_format::Format(line, fmt, args...);
+		std::printf("[%s] %s\n", level, line.c_str());
+		std::fflush(stdout);
+	}
+};
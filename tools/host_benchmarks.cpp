@@ -0,0 +1,69 @@
+//~ Runs the framework benchmarks headless, the same ones DrawShapes runs on 'B'.
+//~ usage: host_benchmarks [name...], no name runs all of them. Results go to stdout.
+
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "framework/render_manager/dynamic_geometry_benchmark.h"
+#include "framework/render_manager/instance_benchmark.h"
+#include "framework/render_manager/recording_benchmark.h"
+#include "framework/render_manager/render_queue_benchmark.h"
+#include "framework/render_manager/root_binding_benchmark.h"
+#include "framework/render_manager/tlsf_benchmark.h"
+#include "framework/scene/bvh_benchmark.h"
+#include "framework/scene/occlusion_benchmark.h"
+#include "framework/scene/transform_benchmark.h"
+#include "utility/thread/job_system.h"
+
+namespace
+{
+	typedef struct _HOST_BENCHMARK
+	{
+		const char*								   Name{ nullptr };
+		std::function<void(framework::JobSystem*)> Run {};
+	} HOST_BENCHMARK;
+
+	std::vector<HOST_BENCHMARK> GetBenchmarks()
+	{
+		return
+		{
+			{ "transform",        [](framework::JobSystem* jobs) { framework::RunTransformBenchmark(jobs); } },
+			{ "instance",         [](framework::JobSystem*)      { framework::RunInstanceBenchmark(); } },
+			{ "render_queue",     [](framework::JobSystem*)      { framework::RunRenderQueueBenchmark(); } },
+			{ "bvh",              [](framework::JobSystem* jobs) { framework::RunBvhBenchmark(jobs); } },
+			{ "occlusion",        [](framework::JobSystem*)      { framework::RunOcclusionBenchmark(); } },
+			{ "dynamic_geometry", [](framework::JobSystem*)      { framework::RunDynamicGeometryBenchmark(); } },
+			{ "tlsf",             [](framework::JobSystem*)      { framework::RunTlsfBenchmark(); } },
+			{ "root_binding",     [](framework::JobSystem*)      { framework::RunRootBindingBenchmark(); } },
+			{ "recording",        [](framework::JobSystem* jobs) { framework::RunRecordingBenchmark(jobs); } },
+		};
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	const auto benchmarks = GetBenchmarks();
+
+	for (int i = 1; i < argc; ++i)
+	{
+		bool known = false;
+		for (const auto& benchmark : benchmarks) known |= std::strcmp(benchmark.Name, argv[ i ]) == 0;
+		if (known) continue;
+
+		std::cerr << "unknown benchmark " << argv[ i ] << ", one of:";
+		for (const auto& benchmark : benchmarks) std::cerr << " " << benchmark.Name;
+		std::cerr << "\n";
+		return 2;
+	}
+
+	framework::JobSystem jobs{};
+	for (const auto& benchmark : benchmarks)
+	{
+		bool selected = argc == 1;
+		for (int i = 1; i < argc; ++i) selected |= std::strcmp(benchmark.Name, argv[ i ]) == 0;
+		if (selected) benchmark.Run(&jobs);
+	}
+	return 0;
+}
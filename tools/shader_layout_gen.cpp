@@ -0,0 +1,89 @@
+//~ Writes the C++ mirrors of the cbuffers the layers fill, see SHADER_LAYOUT_JOB.
+//~ usage: shader_layout_gen <repository root>, the shader_layouts target passes it.
+//~ Headers are only rewritten when their text changes so nothing rebuilds for nothing.
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "framework/render_manager/shader_reflection.h"
+
+namespace
+{
+	typedef struct _LAYOUT_HEADER
+	{
+		std::filesystem::path					  Output{}; //~ relative to the repository root
+		std::vector<framework::SHADER_LAYOUT_JOB> Jobs	{}; //~ sources relative to the root, which is how the application sees them
+	} LAYOUT_HEADER;
+
+	std::vector<LAYOUT_HEADER> GetLayoutHeaders()
+	{
+		return
+		{
+			{
+				"src/application/layer/chapter_6/generated/shader_layouts.h",
+				{
+					{ "shaders/chapter_6/common.hlsli", "cbPrimary", "PrimaryConstants", {} },
+				}
+			},
+			{
+				"src/application/layer/chapter_7/generated/shader_layouts.h",
+				{
+					{ "shaders/chapter_7/common.hlsli", "cbPass",	   "PassConstants",		{} },
+					{ "shaders/chapter_7/vertex.hlsl",	"cbPerObject", "ConstantData",		{ { "OBJECT_BUFFER", "0" } } },
+					{ "shaders/chapter_7/vertex.hlsl",	"cbPerObject", "ObjectIdConstants", { { "OBJECT_BUFFER", "1" } } },
+				}
+			},
+		};
+	}
+
+	bool WriteIfChanged(const std::filesystem::path& path, const std::string& text)
+	{
+		{
+			std::ifstream stream(path, std::ios::binary);
+			const std::string current{ std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+			if (stream && current == text) return false;
+		}
+
+		std::filesystem::create_directories(path.parent_path());
+		std::ofstream(path, std::ios::binary | std::ios::trunc) << text;
+		return true;
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	if (argc != 2)
+	{
+		std::cerr << "usage: shader_layout_gen <repository root>\n";
+		return 2;
+	}
+
+	std::error_code error{};
+	std::filesystem::current_path(argv[ 1 ], error);
+	if (error)
+	{
+		std::cerr << "cannot enter " << argv[ 1 ] << ": " << error.message() << "\n";
+		return 2;
+	}
+
+	int result = 0;
+	for (const auto& header : GetLayoutHeaders())
+	{
+		std::vector<std::string> errors{};
+		const auto text = framework::GenerateLayoutHeader(header.Jobs, "tools/shader_layout_gen.cpp", errors);
+		if (!errors.empty())
+		{
+			for (const auto& message : errors) std::cerr << header.Output.generic_string() << ": " << message << "\n";
+			result = 1;
+			continue; //~ keep the last good header
+		}
+
+		const bool written = WriteIfChanged(header.Output, text);
+		std::cout << header.Output.generic_string() << (written ? " written\n" : " up to date\n");
+	}
+	return result;
+}